@@ -12,6 +12,62 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Identificador de un comando encolado (0 = ninguno)
+ */
+typedef uint16_t MotionId;
+
+#define MOTION_NO_DEPENDENCY        0
+#define MOTION_STEP_NO_DEPENDENCY   (-1)
+
+// Qué medir mientras el paso está activo
+#define MOTION_LEARN_NONE           0  // Nada
+#define MOTION_LEARN_TRAVEL         1  // Llegada confirmada por el operador (B1)
+#define MOTION_LEARN_DROP           2  // Caída detectada por el sensor capacitivo
+
+/**
+ * @brief Paso de un script de movimiento
+ *
+ * depends_on es el índice de otro paso del mismo script que debe terminar
+ * antes de que éste arranque. Los pasos del mismo servo se ejecutan siempre
+ * en orden; los de servos distintos sin dependencia corren en paralelo.
+ */
+typedef struct {
+  uint8_t servo;          // Servo (1-5)
+  uint8_t angle;          // Ángulo objetivo (0-180°)
+  uint16_t duration_ms;   // Tiempo que el servo queda ocupado
+  int8_t depends_on;      // Índice de paso previo (-1 = ninguno)
+  uint8_t learn;          // MOTION_LEARN_* (tiempos aprendidos)
+} MotionStep;
+
+/**
+ * @brief Estadísticas del planificador de movimientos
+ */
+typedef struct {
+  uint8_t depth;                 // Comandos pendientes + en ejecución
+  uint8_t max_depth;             // Máxima profundidad observada
+  uint32_t completed;            // Comandos completados
+  uint32_t rejected;             // Comandos rechazados por cola llena
+  uint32_t last_completion_tick; // Tick del último comando completado
+  uint32_t last_script_ms;       // Duración del último script completado
+  uint32_t last_drop_tick;       // Tick en que el último residuo dejó la plataforma
+} MotionStats;
+
+/**
+ * @brief Resultado de un pedido de depósito
+ */
+typedef enum {
+  DEPOSIT_QUEUED = 0,     // Secuencia encolada hacia su contenedor
+  DEPOSIT_DIVERTED,       // Encolada hacia otro contenedor (el suyo está lleno)
+  DEPOSIT_HELD,           // Contenedor lleno: el objeto queda en la plataforma
+  DEPOSIT_REJECTED,       // Contenedor lleno (o todos): no se deposita
+  DEPOSIT_FAILED          // Material no válido o cola llena
+} DepositResult;
+
 // ============================================================================
 // FUNCIONES PÚBLICAS
 // ============================================================================
@@ -23,41 +79,45 @@ void actuators_init(void);
 
 /**
  * @brief Deposita material en el contenedor correspondiente
+ *
+ * Antes de encolar consulta el nivel en caché del contenedor; si está
+ * lleno aplica BIN_FULL_POLICY (rechazar, retener o desviar).
+ *
  * @param material Tipo de material a depositar
- * @return true si se ejecutó correctamente
+ * @return Resultado (DEPOSIT_QUEUED o DEPOSIT_DIVERTED si se encoló)
  */
-bool actuators_deposit_material(MaterialType material);
+DepositResult actuators_deposit_material(MaterialType material);
 
 /**
- * @brief Mueve la plataforma a una posición específica
+ * @brief Encola el movimiento de la plataforma a una posición específica
  * @param angle Ángulo de inclinación (0-180°)
- * @return true si se movió correctamente
+ * @return true si se encoló correctamente
  */
 bool actuators_move_platform(uint8_t angle);
 
 /**
- * @brief Abre la tapa de un contenedor
+ * @brief Encola la apertura de la tapa de un contenedor
  * @param material Tipo de material (contenedor)
- * @return true si se abrió correctamente
+ * @return true si se encoló correctamente
  */
 bool actuators_open_container(MaterialType material);
 
 /**
- * @brief Cierra la tapa de un contenedor
+ * @brief Encola el cierre de la tapa de un contenedor
  * @param material Tipo de material (contenedor)
- * @return true si se cerró correctamente
+ * @return true si se encoló correctamente
  */
 bool actuators_close_container(MaterialType material);
 
 /**
- * @brief Ejecuta secuencia completa de depósito
+ * @brief Encola la secuencia completa de depósito
  * @param material Tipo de material
- * @return true si se completó correctamente
+ * @return true si se encoló correctamente
  */
 bool actuators_execute_deposit_sequence(MaterialType material);
 
 /**
- * @brief Mueve un servo específico
+ * @brief Mueve un servo específico (escritura inmediata del CCR)
  * @param servo Servo a mover (1-5)
  * @param angle Ángulo objetivo (0-180°)
  * @return true si se movió correctamente
@@ -65,19 +125,122 @@ bool actuators_execute_deposit_sequence(MaterialType material);
 bool actuators_move_servo(uint8_t servo, uint8_t angle);
 
 /**
- * @brief Convierte ángulo a valor PWM
- * @param angle Ángulo (0-180°)
- * @return Valor PWM (1000-2000)
+ * @brief Encola un movimiento de servo
+ * @param servo Servo a mover (1-5)
+ * @param angle Ángulo objetivo (0-180°)
+ * @param duration_ms Tiempo que el servo queda ocupado tras el comando
+ * @param depends_on Comando que debe terminar antes (MOTION_NO_DEPENDENCY)
+ * @return Identificador del comando (0 si la cola está llena)
+ */
+MotionId actuators_enqueue(uint8_t servo, uint8_t angle, uint16_t duration_ms, MotionId depends_on);
+
+/**
+ * @brief Encola un script completo de forma atómica
+ * @param steps Pasos del script
+ * @param count Cantidad de pasos
+ * @return Identificador del último paso (0 si no hay lugar en la cola)
+ */
+MotionId actuators_run_script(const MotionStep *steps, uint8_t count);
+
+/**
+ * @brief Avanza el planificador (llamar periódicamente desde el loop principal)
+ */
+void actuators_update(void);
+
+/**
+ * @brief Indica si hay movimientos pendientes o en ejecución
+ * @return true si la cola no está vacía
+ */
+bool actuators_is_busy(void);
+
+/**
+ * @brief Obtiene la profundidad actual de la cola
+ * @return Comandos pendientes + en ejecución
+ */
+uint8_t actuators_get_queue_depth(void);
+
+/**
+ * @brief Obtiene el tick de finalización de un comando
+ * @param id Identificador devuelto por actuators_enqueue
+ * @return Tick de finalización (0 si no terminó o ya no se conoce)
+ */
+uint32_t actuators_get_completion_tick(MotionId id);
+
+/**
+ * @brief Obtiene estadísticas del planificador
+ * @return Copia de las estadísticas
+ */
+MotionStats actuators_get_motion_stats(void);
+
+/**
+ * @brief Deshabilita ya el PWM de todos los servos (caída de alimentación)
+ *
+ * Reduce el consumo para alargar el margen del guardado de emergencia.
+ * Los canales se rehabilitan solos en el próximo movimiento.
+ */
+void actuators_release_all(void);
+
+/**
+ * @brief Obtiene el tiempo acumulado con PWM habilitado de un servo
+ *
+ * Los canales se liberan SERVO_HOLD_MS después de su último movimiento
+ * y se rehabilitan automáticamente al encolar el siguiente.
+ *
+ * @param servo Servo (1-5)
+ * @return Tiempo en ms desde el arranque (0 si el servo no es válido)
+ */
+uint32_t actuators_get_servo_on_ms(uint8_t servo);
+
+/**
+ * @brief Obtiene el tiempo de movimiento seguro para un servo y ángulo
+ *
+ * Usa la tabla aprendida si tiene suficientes muestras; si no, el
+ * peor caso configurado (parámetros t_abrir, t_inclinar, t_cerrar).
+ *
+ * @param servo Servo (1-5)
+ * @param angle Ángulo objetivo (0-180°)
+ * @return Tiempo en ms
+ */
+uint16_t actuators_get_move_delay(uint8_t servo, uint8_t angle);
+
+/**
+ * @brief Obtiene la espera de caída segura para un contenedor
+ * @param material Tipo de material (contenedor)
+ * @return Tiempo en ms
+ */
+uint16_t actuators_get_drop_delay(MaterialType material);
+
+/**
+ * @brief Encola la calibración de tiempos con confirmación del operador
+ *
+ * Ejecuta la prueba de servos; el operador presiona B1 cuando cada servo
+ * llega a su posición. Al terminar, la tabla se guarda en Flash.
+ */
+void actuators_calibrate_timing(void);
+
+/**
+ * @brief Guarda la tabla de tiempos aprendidos en Flash
+ * @return true si se guardó correctamente
+ */
+bool actuators_save_timing(void);
+
+/**
+ * @brief Descarta los tiempos aprendidos (vuelve al peor caso configurado)
+ */
+void actuators_reset_timing(void);
+
+/**
+ * @brief Muestra la tabla de tiempos aprendidos
  */
-uint16_t actuators_angle_to_pwm(uint8_t angle);
+void actuators_show_timing(void);
 
 /**
- * @brief Establece posición de reposo de todos los servos
+ * @brief Encola la posición de reposo de todos los servos
  */
 void actuators_set_rest_position(void);
 
 /**
- * @brief Prueba todos los servos
+ * @brief Encola la prueba de todos los servos
  */
 void actuators_test_all_servos(void);
 
@@ -0,0 +1,229 @@
+/**
+ * @file board.h
+ * @brief Capa de placa: lo que cambia entre microcontroladores
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * La aplicación (sensores, servos, estadísticas, Flash de datos...) es la
+ * misma para todas las placas. Lo que depende del chip vive en un par
+ * board_<placa>.h/.c:
+ *
+ *   - board_<placa>.h: HAL de la familia, pines, canales de ADC y timers,
+ *     mapa de la Flash de datos y handles de periféricos
+ *   - board_<placa>.c: relojes e inicialización, arranque del ADC, borrado
+ *     y programación de Flash, velocidad de I2C, recepción de la consola,
+ *     aviso de caída de alimentación y modo de bajo consumo
+ *
+ * La placa se elige al compilar, con una sola definición:
+ *
+ *   BOARD_F410RB   Nucleo STM32F410RB (por defecto)
+ *   BOARD_L433     Nucleo STM32L433RC-P
+ *   BOARD_HOST     PC (herramientas de Tools/, Flash simulada en RAM)
+ *
+ * Cada board_<placa>.c compila vacío si no es la placa elegida, así que
+ * los tres pueden estar en la lista de fuentes de cualquier compilación.
+ *
+ * Las interrupciones calientes (SysTick con las animaciones de los LEDs y
+ * sus tablas, el DMA del ADC) y el clasificador corren desde la RAM
+ * (BOARD_RAM_FUNC, BOARD_RAM_DATA) junto con la tabla de vectores. Así no
+ * pagan los estados de espera de la Flash y siguen atendiéndose mientras
+ * se borra un sector. El PVD, la consola y I2C1 también entran a la RAM
+ * durante un borrado: la recepción y el corte de los servos se atienden
+ * ahí, y lo que necesita la HAL (transmisión, eventos de I2C, guardado de
+ * emergencia) queda frenado en el periférico hasta que termina.
+ */
+
+#ifndef BOARD_H
+#define BOARD_H
+
+// ============================================================================
+// CÓDIGO EN RAM
+// ============================================================================
+// El .ld de STM32CubeIDE ya copia .RamFunc* a la RAM junto con .data. Con
+// -DBOARD_NO_RAM_CODE todo queda en la Flash, para comparar con "prof".
+#if defined(BOARD_HOST) || defined(BOARD_NO_RAM_CODE)
+#define BOARD_RAM_FUNC
+#define BOARD_RAM_DATA
+#define BOARD_HOT_CODE  "Flash"
+#else
+#define BOARD_RAM_FUNC  __attribute__((section(".RamFunc"), noinline))
+#define BOARD_RAM_DATA  __attribute__((section(".RamFunc.data")))  // Tablas const
+#define BOARD_HOT_CODE  "RAM"
+#endif
+
+#if defined(BOARD_L433)
+#include "board_l433.h"
+#elif defined(BOARD_HOST)
+#include "board_host.h"
+#else
+#ifndef BOARD_F410RB
+#define BOARD_F410RB
+#endif
+#include "board_f410rb.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// EVENTOS DE LA CONSOLA (board_console_irq)
+// ============================================================================
+#define BOARD_CONSOLE_RX            0x01u  // Llegó un byte
+#define BOARD_CONSOLE_IDLE          0x02u  // La línea quedó ociosa (fin de ráfaga)
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Relojes y periféricos de la placa (después de HAL_Init)
+ */
+void board_init(void);
+
+/**
+ * @brief Nombre de la placa para la consola
+ */
+const char *board_name(void);
+
+/**
+ * @brief Arranca la conversión continua de los canales analógicos
+ *
+ * El buffer recibe una muestra de 12 bits por canal, en el orden de
+ * SensorAnalogData, y se actualiza solo (DMA circular).
+ *
+ * @param buffer Destino (ADC_BUFFER_SIZE muestras)
+ * @param count Cantidad de muestras
+ */
+void board_adc_start(uint16_t *buffer, uint16_t count);
+
+/**
+ * @brief Atiende el DMA del ADC (medio buffer y buffer completo) desde la RAM
+ * @return false si hay un error de transferencia: lo atiende la HAL
+ */
+bool board_adc_dma_irq(void);
+
+/**
+ * @brief Borra las unidades de borrado que cubren [address, address + size)
+ *
+ * La espera corre desde la RAM. Mientras dura, sólo se atienden las
+ * interrupciones de BOARD_RAM_IRQS (SysTick, DMA del ADC, PVD, consola e
+ * I2C1); las demás quedan pendientes hasta el final. Sólo borra dentro de
+ * [BOARD_FLASH_DATA_START, BOARD_FLASH_DATA_END).
+ *
+ * @return false si la Flash informó un error o el rango no es de datos
+ */
+bool board_flash_erase(uint32_t address, uint32_t size);
+
+/**
+ * @brief Cantidad de borrados hechos desde el arranque
+ *
+ * Quien mide plazos con HAL_GetTick la usa para descontar un borrado que
+ * frenó su transacción (ver board_i2c_irq_hold).
+ */
+uint32_t board_flash_erase_count(void);
+
+/**
+ * @brief Duración del último borrado y lo que avanzó HAL_GetTick mientras tanto
+ *
+ * Si SysTick siguió corriendo (código en RAM) las dos cifras coinciden.
+ *
+ * @param duration_us Duración medida con el contador de ciclos
+ * @param tick_ms Milisegundos que contó SysTick
+ */
+void board_flash_erase_timing(uint32_t *duration_us, uint32_t *tick_ms);
+
+/**
+ * @brief Programa datos en Flash borrada
+ *
+ * La dirección tiene que estar alineada a BOARD_FLASH_WRITE_UNIT; la
+ * última unidad se completa con 0xFF. Una unidad se programa una sola
+ * vez entre borrados.
+ *
+ * @return false si la dirección no está alineada o la HAL informó un error
+ */
+bool board_flash_program(uint32_t address, const void *data, uint32_t len);
+
+/**
+ * @brief Reprograma la velocidad de I2C1 (sólo con el bus libre)
+ * @param speed_hz Velocidad en Hz
+ */
+void board_i2c_set_speed(uint32_t speed_hz);
+
+/**
+ * @brief Velocidad actual de I2C1 en Hz
+ */
+uint32_t board_i2c_get_speed(void);
+
+/**
+ * @brief Frena I2C1 si hay un borrado en curso (desde la RAM, en sus IRQ)
+ *
+ * Apaga las interrupciones del periférico hasta el final del borrado: el
+ * maestro estira SCL mientras tanto y la transacción sigue donde quedó.
+ *
+ * @return true si hay un borrado en curso: no llamar a la HAL
+ */
+bool board_i2c_irq_hold(void);
+
+/**
+ * @brief Escribe en la consola esperando a que salga todo
+ */
+void board_console_write(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Habilita la recepción por interrupción de la consola
+ *
+ * Se puede llamar en cada iteración: la HAL apaga la interrupción de
+ * recepción al procesar un error y esto la vuelve a encender.
+ */
+void board_console_rx_enable(void);
+
+/**
+ * @brief Atiende la interrupción de recepción de la consola
+ *
+ * Limpia los eventos de recepción y de línea ociosa (y los errores) antes
+ * de que los vea la HAL.
+ *
+ * @param byte Byte recibido (válido con BOARD_CONSOLE_RX)
+ * @return Eventos BOARD_CONSOLE_*
+ */
+uint8_t board_console_irq(uint8_t *byte);
+
+/**
+ * @brief Frena la transmisión de la consola si hay un borrado en curso
+ *
+ * Corre desde la RAM en la IRQ de la consola, después de board_console_irq:
+ * apaga las interrupciones de transmisión hasta el final del borrado.
+ *
+ * @return true si hay un borrado en curso: no llamar a la HAL
+ */
+bool board_console_tx_hold(void);
+
+/**
+ * @brief Habilita el aviso de caída de alimentación (board_power_fail)
+ */
+void board_pvd_enable(void);
+
+/**
+ * @brief Atiende la interrupción del PVD desde la RAM
+ *
+ * Llama a board_power_fail. Durante un borrado corta los servos en los
+ * registros de los timers y deja board_power_fail para cuando termina.
+ */
+void board_pvd_irq(void);
+
+/**
+ * @brief Caída de alimentación detectada por el PVD (la define la aplicación)
+ *
+ * Corre en la interrupción del PVD (board_pvd_irq), en la Flash.
+ */
+void board_power_fail(void);
+
+/**
+ * @brief Espera con el núcleo dormido hasta que pasen ms milisegundos
+ *
+ * Despierta con cada interrupción (SysTick, UART, I2C, DMA) y vuelve a
+ * dormir hasta cumplir el plazo.
+ */
+void board_sleep_ms(uint32_t ms);
+
+#endif // BOARD_H
@@ -0,0 +1,177 @@
+/**
+ * @file board_f410rb.h
+ * @brief Placa Nucleo STM32F410RB: pines, periféricos y mapa de Flash
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * ADC1 por DMA2 Stream 0 (circular), servos en TIM1 y TIM5, LCD en I2C1
+ * y consola en USART1. Flash de 128 KB en sectores (4 de 16 KB y 1 de
+ * 64 KB) que se programan de a byte.
+ */
+
+#ifndef BOARD_F410RB_H
+#define BOARD_F410RB_H
+
+#include "stm32f4xx_hal.h"
+
+#define BOARD_NAME                  "Nucleo STM32F410RB"
+
+// ============================================================================
+// CONFIGURACIÓN DE PINES GPIO
+// ============================================================================
+
+// Sensores Digitales
+#define SENSOR_INDUCTIVO_PORT       GPIOA
+#define SENSOR_INDUCTIVO_PIN        GPIO_PIN_0
+
+#define SENSOR_CAPACITIVO_PORT      GPIOA
+#define SENSOR_CAPACITIVO_PIN       GPIO_PIN_1
+
+#define SENSOR_PIR_PORT             GPIOA
+#define SENSOR_PIR_PIN              GPIO_PIN_2
+
+// LEDs Indicadores
+#define LED_METAL_PORT              GPIOC
+#define LED_METAL_PIN               GPIO_PIN_2
+
+#define LED_PAPEL_PORT              GPIOC
+#define LED_PAPEL_PIN               GPIO_PIN_3
+
+#define LED_PLASTICO_PORT           GPIOC
+#define LED_PLASTICO_PIN            GPIO_PIN_4
+
+#define LED_VIDRIO_PORT             GPIOC
+#define LED_VIDRIO_PIN              GPIO_PIN_5
+
+#define LED_ERROR_PORT              GPIOC
+#define LED_ERROR_PIN               GPIO_PIN_6
+
+#define LED_SISTEMA_PORT            GPIOC
+#define LED_SISTEMA_PIN             GPIO_PIN_7
+
+// Sensores Ultrasónicos (TRIG)
+#define US_METAL_TRIG_PORT          GPIOB
+#define US_METAL_TRIG_PIN           GPIO_PIN_0
+
+#define US_PAPEL_TRIG_PORT          GPIOB
+#define US_PAPEL_TRIG_PIN           GPIO_PIN_10
+
+#define US_PLASTICO_TRIG_PORT       GPIOB
+#define US_PLASTICO_TRIG_PIN        GPIO_PIN_12
+
+#define US_VIDRIO_TRIG_PORT         GPIOB
+#define US_VIDRIO_TRIG_PIN          GPIO_PIN_14
+
+// Sensores Ultrasónicos (ECHO)
+#define US_METAL_ECHO_PORT          GPIOB
+#define US_METAL_ECHO_PIN           GPIO_PIN_1
+
+#define US_PAPEL_ECHO_PORT          GPIOB
+#define US_PAPEL_ECHO_PIN           GPIO_PIN_11
+
+#define US_PLASTICO_ECHO_PORT       GPIOB
+#define US_PLASTICO_ECHO_PIN        GPIO_PIN_13
+
+#define US_VIDRIO_ECHO_PORT         GPIOB
+#define US_VIDRIO_ECHO_PIN          GPIO_PIN_15
+
+// Botón de confirmación del operador (B1 de la Nucleo, activo en bajo)
+#define CALIB_BUTTON_PORT           GPIOC
+#define CALIB_BUTTON_PIN            GPIO_PIN_13
+
+// Bus I2C1 (recuperación manual de SCL/SDA, ver i2c_bus.c)
+#define I2C_BUS_SCL_PORT            GPIOB
+#define I2C_BUS_SCL_PIN             GPIO_PIN_6
+#define I2C_BUS_SDA_PORT            GPIOB
+#define I2C_BUS_SDA_PIN             GPIO_PIN_9
+
+// ============================================================================
+// CANALES ADC (Sensores Analógicos)
+// ============================================================================
+#define ADC_CHANNEL_LDR             ADC_CHANNEL_3  // PA3
+#define ADC_CHANNEL_MIC             ADC_CHANNEL_4  // PA4
+#define ADC_CHANNEL_EXTRA1          ADC_CHANNEL_5  // PA5 (peso/humedad)
+#define ADC_CHANNEL_EXTRA2          ADC_CHANNEL_6  // PA6 (gas)
+
+// ============================================================================
+// CANALES PWM (Servomotores)
+// ============================================================================
+
+// Timer A: TIM1 (APB2)
+#define BOARD_SERVO_TIM_A           htim1
+#define BOARD_SERVO_TIM_A_APB2      true
+#define BOARD_SERVO_TIM_A_NAME      "TIM1"
+#define TIM_SERVO_PLATAFORMA        TIM_CHANNEL_1  // PA8
+#define TIM_SERVO_METAL             TIM_CHANNEL_2  // PA9
+#define TIM_SERVO_PAPEL             TIM_CHANNEL_3  // PA10
+
+// Timer B: TIM5 (APB1, en lugar de Timer 4)
+#define BOARD_SERVO_TIM_B           htim5
+#define BOARD_SERVO_TIM_B_APB2      false
+#define BOARD_SERVO_TIM_B_NAME      "TIM5"
+#define TIM_SERVO_PLASTICO          TIM_CHANNEL_1  // PB6
+#define TIM_SERVO_VIDRIO            TIM_CHANNEL_2  // PB7
+
+// ============================================================================
+// ALIMENTACIÓN
+// ============================================================================
+#define BOARD_PVD_LEVEL             PWR_PVDLEVEL_7 // ~2.9 V: aviso de caída de alimentación
+
+// Margen de corte después del aviso PVD: el regulador de 3.3 V ya está en
+// caída y VDD baja con lo que queda en el condensador de la fuente de 5 V
+// (lista de materiales), con los servos ya sin pulso
+#define BOARD_HOLDUP_CAP_UF         470    // Condensador de la entrada de 5 V
+#define BOARD_HOLDUP_LOAD_MA        150    // MCU, ST-LINK, LCD, sensores y servos en reposo
+#define BOARD_HOLDUP_PVD_MV         2850   // Umbral de bajada del PVD (hoja de datos, típico)
+#define BOARD_HOLDUP_MIN_MV         2700   // Programar de a palabra (x32) pide VDD >= 2.7 V
+
+// ============================================================================
+// MAPA DE FLASH DE DATOS (sectores 0-3 de 16 KB, 4 de 64 KB)
+// ============================================================================
+// Código en los sectores 0 (vectores, arranque y HAL) y 4 (aplicación):
+// STM32F410RBTX_FLASH.ld reparte el código y falla al enlazar si invade
+// los sectores de datos 1-3
+#define BOARD_FLASH_WRITE_UNIT      1           // Programación de a byte
+#define BOARD_FLASH_DATA_START      0x08004000  // Sólo se borra entre estas direcciones
+#define BOARD_FLASH_DATA_END        0x08010000
+
+// Imagen de datos persistentes escrita alternadamente en dos páginas (A/B)
+#define FLASH_PAGE_A_ADDR           0x08004000  // Sector 1 (16 KB)
+#define FLASH_PAGE_B_ADDR           0x08008000  // Sector 2 (16 KB)
+#define FLASH_STORE_PAGE_SIZE       0x4000      // Tamaño útil por página
+
+// Registro de eventos por clasificación
+#define EVENT_LOG_ADDR              0x0800C000  // Sector 3 (16 KB)
+#define EVENT_LOG_SIZE              0x4000
+#define EVENT_LOG_SEGMENTS          1           // Sin otro sector libre: al llenarse se borra en reposo
+
+// ============================================================================
+// HANDLES DE PERIFÉRICOS (CubeMX)
+// ============================================================================
+extern ADC_HandleTypeDef hadc1;
+extern I2C_HandleTypeDef hi2c1;
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim5;  // Cambiado de htim4 a htim5
+extern UART_HandleTypeDef huart1; // Cambiado de huart2 a huart1
+
+#define BOARD_CONSOLE_UART          huart1
+
+// ============================================================================
+// INTERRUPCIONES EN RAM
+// ============================================================================
+#define BOARD_VECTOR_COUNT          114    // 16 del núcleo + 98 IRQ (startup_stm32f410rbtx.s)
+#define BOARD_VECTOR_ALIGN          512    // VTOR: potencia de 2 que cubre la tabla
+
+// Siguen habilitadas durante un borrado (handlers en la RAM)
+#define BOARD_RAM_IRQS              { DMA2_Stream0_IRQn, PVD_IRQn, USART1_IRQn, \
+                                      I2C1_EV_IRQn, I2C1_ER_IRQn }
+
+// Definidas en stm32f4xx_it.c; el atributo de la declaración las lleva a la RAM
+BOARD_RAM_FUNC void SysTick_Handler(void);
+BOARD_RAM_FUNC void PVD_IRQHandler(void);
+BOARD_RAM_FUNC void DMA2_Stream0_IRQHandler(void);
+BOARD_RAM_FUNC void I2C1_EV_IRQHandler(void);
+BOARD_RAM_FUNC void I2C1_ER_IRQHandler(void);
+BOARD_RAM_FUNC void USART1_IRQHandler(void);
+
+#endif // BOARD_F410RB_H
@@ -0,0 +1,201 @@
+/**
+ * @file board_host.h
+ * @brief Placa de PC: la aplicación compilada para las herramientas de Tools/
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Sin HAL de ST: sólo los tipos que usan los encabezados de la aplicación.
+ * La Flash de datos es RAM mapeada en la misma dirección que en la placa
+ * (los módulos la leen por puntero) y aplica las reglas de una Flash real:
+ * sólo se programa lo borrado, de a BOARD_FLASH_WRITE_UNIT bytes alineados.
+ * HAL_GetTick() y HAL_Delay() los pone cada herramienta (tiempo simulado).
+ *
+ * BOARD_HOST_WRITE_UNIT elige la unidad de programación: 1 como la F410RB
+ * u 8 como la L433 (por defecto, la más estricta), y BOARD_HOST_LOG_SEGMENTS
+ * los segmentos del registro de eventos: 1 como la F410RB o 2 como la L433.
+ */
+
+#ifndef BOARD_HOST_H
+#define BOARD_HOST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BOARD_NAME                  "PC"
+
+// ============================================================================
+// HAL MÍNIMA
+// ============================================================================
+
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR = 1,
+  HAL_BUSY = 2,
+  HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+typedef enum {
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET = 1
+} GPIO_PinState;
+
+// Sólo se usan por puntero o como extern
+typedef struct { uint32_t odr; } GPIO_TypeDef;
+typedef struct { int unused; } ADC_HandleTypeDef;
+typedef struct { int unused; } I2C_HandleTypeDef;
+typedef struct { int unused; } TIM_HandleTypeDef;
+typedef struct { int unused; } UART_HandleTypeDef;
+
+extern GPIO_TypeDef board_host_gpio[3];
+#define GPIOA                       (&board_host_gpio[0])
+#define GPIOB                       (&board_host_gpio[1])
+#define GPIOC                       (&board_host_gpio[2])
+#define GPIO_PIN(n)                 ((uint16_t)(1u << (n)))
+
+#define TIM_CHANNEL_1               0x00u
+#define TIM_CHANNEL_2               0x04u
+#define TIM_CHANNEL_3               0x08u
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+
+// Sin interrupciones reales: las secciones críticas no hacen nada
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __disable_irq(void) {}
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+
+// ============================================================================
+// PINES (los de la F410RB; en la PC sólo identifican la señal)
+// ============================================================================
+#define SENSOR_INDUCTIVO_PORT       GPIOA
+#define SENSOR_INDUCTIVO_PIN        GPIO_PIN(0)
+#define SENSOR_CAPACITIVO_PORT      GPIOA
+#define SENSOR_CAPACITIVO_PIN       GPIO_PIN(1)
+#define SENSOR_PIR_PORT             GPIOA
+#define SENSOR_PIR_PIN              GPIO_PIN(2)
+
+#define LED_METAL_PORT              GPIOC
+#define LED_METAL_PIN               GPIO_PIN(2)
+#define LED_PAPEL_PORT              GPIOC
+#define LED_PAPEL_PIN               GPIO_PIN(3)
+#define LED_PLASTICO_PORT           GPIOC
+#define LED_PLASTICO_PIN            GPIO_PIN(4)
+#define LED_VIDRIO_PORT             GPIOC
+#define LED_VIDRIO_PIN              GPIO_PIN(5)
+#define LED_ERROR_PORT              GPIOC
+#define LED_ERROR_PIN               GPIO_PIN(6)
+#define LED_SISTEMA_PORT            GPIOC
+#define LED_SISTEMA_PIN             GPIO_PIN(7)
+
+#define US_METAL_TRIG_PORT          GPIOB
+#define US_METAL_TRIG_PIN           GPIO_PIN(0)
+#define US_PAPEL_TRIG_PORT          GPIOB
+#define US_PAPEL_TRIG_PIN           GPIO_PIN(10)
+#define US_PLASTICO_TRIG_PORT       GPIOB
+#define US_PLASTICO_TRIG_PIN        GPIO_PIN(12)
+#define US_VIDRIO_TRIG_PORT         GPIOB
+#define US_VIDRIO_TRIG_PIN          GPIO_PIN(14)
+#define US_METAL_ECHO_PORT          GPIOB
+#define US_METAL_ECHO_PIN           GPIO_PIN(1)
+#define US_PAPEL_ECHO_PORT          GPIOB
+#define US_PAPEL_ECHO_PIN           GPIO_PIN(11)
+#define US_PLASTICO_ECHO_PORT       GPIOB
+#define US_PLASTICO_ECHO_PIN        GPIO_PIN(13)
+#define US_VIDRIO_ECHO_PORT         GPIOB
+#define US_VIDRIO_ECHO_PIN          GPIO_PIN(15)
+
+#define CALIB_BUTTON_PORT           GPIOC
+#define CALIB_BUTTON_PIN            GPIO_PIN(13)
+
+#define I2C_BUS_SCL_PORT            GPIOB
+#define I2C_BUS_SCL_PIN             GPIO_PIN(6)
+#define I2C_BUS_SDA_PORT            GPIOB
+#define I2C_BUS_SDA_PIN             GPIO_PIN(9)
+
+// ============================================================================
+// SERVOS
+// ============================================================================
+#define BOARD_SERVO_TIM_A           htim1
+#define BOARD_SERVO_TIM_A_APB2      true
+#define BOARD_SERVO_TIM_A_NAME      "TIM1"
+#define TIM_SERVO_PLATAFORMA        TIM_CHANNEL_1
+#define TIM_SERVO_METAL             TIM_CHANNEL_2
+#define TIM_SERVO_PAPEL             TIM_CHANNEL_3
+
+#define BOARD_SERVO_TIM_B           htim2
+#define BOARD_SERVO_TIM_B_APB2      false
+#define BOARD_SERVO_TIM_B_NAME      "TIM2"
+#define TIM_SERVO_PLASTICO          TIM_CHANNEL_1
+#define TIM_SERVO_VIDRIO            TIM_CHANNEL_2
+
+// ============================================================================
+// ALIMENTACIÓN (margen de corte de la L433; en la PC no hay PVD)
+// ============================================================================
+#define BOARD_HOLDUP_CAP_UF         470
+#define BOARD_HOLDUP_LOAD_MA        150
+#define BOARD_HOLDUP_PVD_MV         2850
+#define BOARD_HOLDUP_MIN_MV         1800
+
+// ============================================================================
+// MAPA DE FLASH DE DATOS (el de la L433: 256 KB en páginas de 2 KB)
+// ============================================================================
+#ifndef BOARD_HOST_WRITE_UNIT
+#define BOARD_HOST_WRITE_UNIT       8
+#endif
+#ifndef BOARD_HOST_LOG_SEGMENTS
+#define BOARD_HOST_LOG_SEGMENTS     2
+#endif
+
+#define BOARD_FLASH_BASE            0x08000000
+#define BOARD_FLASH_SIZE            0x40000
+#define BOARD_FLASH_ERASE_UNIT      0x800
+#define BOARD_FLASH_WRITE_UNIT      BOARD_HOST_WRITE_UNIT
+#define BOARD_FLASH_DATA_START      0x08030000
+#define BOARD_FLASH_DATA_END        0x08040000
+
+#define EVENT_LOG_ADDR              0x08030000
+#define EVENT_LOG_SIZE              0x8000
+#define EVENT_LOG_SEGMENTS          BOARD_HOST_LOG_SEGMENTS
+
+#define FLASH_PAGE_A_ADDR           0x08038000
+#define FLASH_PAGE_B_ADDR           0x0803C000
+#define FLASH_STORE_PAGE_SIZE       0x4000
+
+// ============================================================================
+// HANDLES DE PERIFÉRICOS (board_host.c)
+// ============================================================================
+extern ADC_HandleTypeDef hadc1;
+extern I2C_HandleTypeDef hi2c1;
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim2;
+extern UART_HandleTypeDef huart1;
+
+#define BOARD_CONSOLE_UART          huart1
+
+// ============================================================================
+// ENTRADAS SIMULADAS
+// ============================================================================
+
+/**
+ * @brief Fija la lectura de un canal analógico (índice de SensorAnalogData)
+ */
+void board_host_set_analog(uint8_t index, uint16_t value);
+
+/**
+ * @brief Cantidad de programaciones rechazadas (no alineadas o sin borrar)
+ */
+uint32_t board_host_flash_violations(void);
+
+/**
+ * @brief Simula un corte de alimentación durante una escritura de Flash
+ * @param units Unidades de programación que todavía se escriben; las
+ *        siguientes no cambian la Flash y fallan hasta board_host_power_restore()
+ */
+void board_host_flash_cut_after(uint32_t units);
+
+/**
+ * @brief Vuelve la alimentación: la Flash se programa otra vez
+ */
+void board_host_power_restore(void);
+
+#endif // BOARD_HOST_H
@@ -0,0 +1,190 @@
+/**
+ * @file board_l433.h
+ * @brief Placa Nucleo STM32L433RC-P: pines, periféricos y mapa de Flash
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * ADC1 con sobremuestreo por hardware y DMA1 Channel 1 (circular), servos
+ * en TIM1 y TIM2 (no hay TIM5), LCD en I2C1 y consola en USART2 (puerto
+ * virtual del ST-LINK). Flash de 256 KB en páginas de 2 KB que se
+ * programan de a doble palabra (64 bits con ECC).
+ */
+
+#ifndef BOARD_L433_H
+#define BOARD_L433_H
+
+#include "stm32l4xx_hal.h"
+
+#define BOARD_NAME                  "Nucleo STM32L433RC-P"
+
+// ============================================================================
+// CONFIGURACIÓN DE PINES GPIO
+// ============================================================================
+
+// Sensores Digitales (PA2/PA3 son de la consola)
+#define SENSOR_INDUCTIVO_PORT       GPIOA
+#define SENSOR_INDUCTIVO_PIN        GPIO_PIN_0
+
+#define SENSOR_CAPACITIVO_PORT      GPIOA
+#define SENSOR_CAPACITIVO_PIN       GPIO_PIN_1
+
+#define SENSOR_PIR_PORT             GPIOA
+#define SENSOR_PIR_PIN              GPIO_PIN_4
+
+// LEDs Indicadores (PC0-PC3 son entradas analógicas)
+#define LED_METAL_PORT              GPIOC
+#define LED_METAL_PIN               GPIO_PIN_4
+
+#define LED_PAPEL_PORT              GPIOC
+#define LED_PAPEL_PIN               GPIO_PIN_5
+
+#define LED_PLASTICO_PORT           GPIOC
+#define LED_PLASTICO_PIN            GPIO_PIN_6
+
+#define LED_VIDRIO_PORT             GPIOC
+#define LED_VIDRIO_PIN              GPIO_PIN_7
+
+#define LED_ERROR_PORT              GPIOC
+#define LED_ERROR_PIN               GPIO_PIN_8
+
+#define LED_SISTEMA_PORT            GPIOC
+#define LED_SISTEMA_PIN             GPIO_PIN_9
+
+// Sensores Ultrasónicos (TRIG)
+#define US_METAL_TRIG_PORT          GPIOB
+#define US_METAL_TRIG_PIN           GPIO_PIN_0
+
+#define US_PAPEL_TRIG_PORT          GPIOB
+#define US_PAPEL_TRIG_PIN           GPIO_PIN_10
+
+#define US_PLASTICO_TRIG_PORT       GPIOB
+#define US_PLASTICO_TRIG_PIN        GPIO_PIN_12
+
+#define US_VIDRIO_TRIG_PORT         GPIOB
+#define US_VIDRIO_TRIG_PIN          GPIO_PIN_14
+
+// Sensores Ultrasónicos (ECHO)
+#define US_METAL_ECHO_PORT          GPIOB
+#define US_METAL_ECHO_PIN           GPIO_PIN_1
+
+#define US_PAPEL_ECHO_PORT          GPIOB
+#define US_PAPEL_ECHO_PIN           GPIO_PIN_11
+
+#define US_PLASTICO_ECHO_PORT       GPIOB
+#define US_PLASTICO_ECHO_PIN        GPIO_PIN_13
+
+#define US_VIDRIO_ECHO_PORT         GPIOB
+#define US_VIDRIO_ECHO_PIN          GPIO_PIN_15
+
+// Botón de confirmación del operador (B1 de la Nucleo, activo en bajo)
+#define CALIB_BUTTON_PORT           GPIOC
+#define CALIB_BUTTON_PIN            GPIO_PIN_13
+
+// Bus I2C1 en PB8/PB9 (D15/D14 del conector Arduino), AF4
+#define I2C_BUS_SCL_PORT            GPIOB
+#define I2C_BUS_SCL_PIN             GPIO_PIN_8
+#define I2C_BUS_SDA_PORT            GPIOB
+#define I2C_BUS_SDA_PIN             GPIO_PIN_9
+
+// Consola USART2 en PA2/PA3, AF7
+#define CONSOLE_TX_PORT             GPIOA
+#define CONSOLE_TX_PIN              GPIO_PIN_2
+#define CONSOLE_RX_PORT             GPIOA
+#define CONSOLE_RX_PIN              GPIO_PIN_3
+
+// ============================================================================
+// CANALES ADC (Sensores Analógicos)
+// ============================================================================
+#define ADC_CHANNEL_LDR             ADC_CHANNEL_1  // PC0
+#define ADC_CHANNEL_MIC             ADC_CHANNEL_2  // PC1
+#define ADC_CHANNEL_EXTRA1          ADC_CHANNEL_3  // PC2 (peso/humedad)
+#define ADC_CHANNEL_EXTRA2          ADC_CHANNEL_4  // PC3 (gas)
+#define ADC_INPUTS_PORT             GPIOC
+#define ADC_INPUTS_PINS             (GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3)
+
+// Sobremuestreo por hardware: 16 conversiones promediadas por muestra,
+// el resultado sigue siendo de 12 bits (ADC_RESOLUTION no cambia)
+#define BOARD_ADC_OVERSAMPLING      ADC_OVERSAMPLING_RATIO_16
+#define BOARD_ADC_OVERSAMPLING_SHIFT ADC_RIGHTBITSHIFT_4
+
+// ============================================================================
+// CANALES PWM (Servomotores)
+// ============================================================================
+
+// Timer A: TIM1 (APB2)
+#define BOARD_SERVO_TIM_A           htim1
+#define BOARD_SERVO_TIM_A_APB2      true
+#define BOARD_SERVO_TIM_A_NAME      "TIM1"
+#define TIM_SERVO_PLATAFORMA        TIM_CHANNEL_1  // PA8
+#define TIM_SERVO_METAL             TIM_CHANNEL_2  // PA9
+#define TIM_SERVO_PAPEL             TIM_CHANNEL_3  // PA10
+
+// Timer B: TIM2 (APB1)
+#define BOARD_SERVO_TIM_B           htim2
+#define BOARD_SERVO_TIM_B_APB2      false
+#define BOARD_SERVO_TIM_B_NAME      "TIM2"
+#define TIM_SERVO_PLASTICO          TIM_CHANNEL_1  // PA15
+#define TIM_SERVO_VIDRIO            TIM_CHANNEL_2  // PB3
+
+// ============================================================================
+// ALIMENTACIÓN
+// ============================================================================
+#define BOARD_PVD_LEVEL             PWR_PVDLEVEL_6 // ~2.9 V: aviso de caída de alimentación
+
+// Margen de corte después del aviso PVD: el regulador de 3.3 V ya está en
+// caída y VDD baja con lo que queda en el condensador de la fuente de 5 V
+// (lista de materiales), con los servos ya sin pulso
+#define BOARD_HOLDUP_CAP_UF         470    // Condensador de la entrada de 5 V
+#define BOARD_HOLDUP_LOAD_MA        150    // MCU, ST-LINK, LCD, sensores y servos en reposo
+#define BOARD_HOLDUP_PVD_MV         2850   // Umbral de bajada del PVD (hoja de datos, típico)
+#define BOARD_HOLDUP_MIN_MV         1800   // La Flash programa en todo el rango; BOR0 resetea a ~1.7 V
+
+// ============================================================================
+// MAPA DE FLASH DE DATOS (páginas de 2 KB, banco único)
+// ============================================================================
+// 0x08000000-0x0802FFFF (192 KB): código (el .ld debe terminar FLASH en 0x08030000)
+#define BOARD_FLASH_WRITE_UNIT      8           // Doble palabra (con ECC)
+#define BOARD_FLASH_DATA_START      0x08030000  // Sólo se borra entre estas direcciones
+#define BOARD_FLASH_DATA_END        0x08040000
+
+// Registro de eventos por clasificación
+#define EVENT_LOG_ADDR              0x08030000  // Páginas 96-111 (32 KB)
+#define EVENT_LOG_SIZE              0x8000
+#define EVENT_LOG_SEGMENTS          2           // 16 KB cada uno: el anterior sigue legible
+
+// Imagen de datos persistentes escrita alternadamente en dos páginas (A/B)
+#define FLASH_PAGE_A_ADDR           0x08038000  // Páginas 112-119 (16 KB)
+#define FLASH_PAGE_B_ADDR           0x0803C000  // Páginas 120-127 (16 KB)
+#define FLASH_STORE_PAGE_SIZE       0x4000      // Tamaño útil por página
+
+// ============================================================================
+// HANDLES DE PERIFÉRICOS (board_l433.c)
+// ============================================================================
+extern ADC_HandleTypeDef hadc1;
+extern DMA_HandleTypeDef hdma_adc1;
+extern I2C_HandleTypeDef hi2c1;
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim2;
+extern UART_HandleTypeDef huart2;
+
+#define BOARD_CONSOLE_UART          huart2
+
+// ============================================================================
+// INTERRUPCIONES EN RAM
+// ============================================================================
+#define BOARD_VECTOR_COUNT          99     // 16 del núcleo + 83 IRQ (startup_stm32l433rctxp.s)
+#define BOARD_VECTOR_ALIGN          512    // VTOR: potencia de 2 que cubre la tabla
+
+// Siguen habilitadas durante un borrado (handlers en la RAM)
+#define BOARD_RAM_IRQS              { DMA1_Channel1_IRQn, PVD_PVM_IRQn, USART2_IRQn, \
+                                      I2C1_EV_IRQn, I2C1_ER_IRQn }
+
+// Definidas en stm32l4xx_it.c; el atributo de la declaración las lleva a la RAM
+BOARD_RAM_FUNC void SysTick_Handler(void);
+BOARD_RAM_FUNC void PVD_PVM_IRQHandler(void);
+BOARD_RAM_FUNC void DMA1_Channel1_IRQHandler(void);
+BOARD_RAM_FUNC void I2C1_EV_IRQHandler(void);
+BOARD_RAM_FUNC void I2C1_ER_IRQHandler(void);
+BOARD_RAM_FUNC void USART2_IRQHandler(void);
+
+#endif // BOARD_L433_H
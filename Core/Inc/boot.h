@@ -0,0 +1,80 @@
+/**
+ * @file boot.h
+ * @brief Arranque por etapas: lo crítico primero, el resto en segundo plano
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * main() inicializa sólo lo que hace falta para detectar y depositar
+ * (sensores, clasificador, servos, parámetros, registro) y registra con
+ * boot_defer() lo demás: arranque del LCD, bienvenida, informes por
+ * consola. boot_service() ejecuta una tarea diferida por iteración del
+ * loop, y sólo con los servos quietos, así que nunca demora un depósito.
+ *
+ * También mide el arranque: fin de la etapa crítica, momento en que el
+ * sistema puede detectar (servos en reposo) y primera detección. Los
+ * tiempos se cuentan desde HAL_Init() ('boot' en la consola).
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Tarea de inicialización diferida
+ *
+ * La estructura es del cliente y tiene que seguir válida después de
+ * registrarla (se guarda el puntero).
+ */
+typedef struct {
+  const char *name;
+  void (*run)(void);
+  uint32_t done_ms;            // Momento en que se ejecutó (0 = pendiente)
+  uint32_t duration_us;
+} BootTask;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Registra una tarea para después de la etapa crítica (en orden)
+ * @param task Tarea
+ * @return false si no hay lugar (BOOT_MAX_TASKS)
+ */
+bool boot_defer(BootTask *task);
+
+/**
+ * @brief Marca el fin de la etapa crítica (llamar justo antes del loop)
+ */
+void boot_critical_done(void);
+
+/**
+ * @brief Avanza el arranque (llamar una vez por iteración del loop)
+ * @param idle true si los servos están quietos y no hay depósito pendiente
+ */
+void boot_service(bool idle);
+
+/**
+ * @brief Indica si ya se puede detectar (etapa crítica y servos en reposo)
+ */
+bool boot_is_ready(void);
+
+/**
+ * @brief Registra una detección (sólo cuenta la primera)
+ * @param tick HAL_GetTick() de la detección
+ */
+void boot_record_detection(uint32_t tick);
+
+/**
+ * @brief Muestra los tiempos del arranque y de cada tarea diferida
+ */
+void boot_show_status(void);
+
+#endif // BOOT_H
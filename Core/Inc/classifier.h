@@ -19,12 +19,13 @@
 
 /**
  * @brief Resultado de la clasificación
+ *
+ * El nombre del material sale de classifier_get_material_description.
  */
 typedef struct {
   MaterialType material;        // Tipo de material identificado
   bool isValid;                // true si la clasificación es válida
   float confidence;            // Confianza (0-100%)
-  char description[20];        // Descripción del material
 } ClassificationResult;
 
 // ============================================================================
@@ -34,6 +35,16 @@ typedef struct {
 #define MIN_CONFIDENCE_THRESHOLD    60.0f  // Mínimo 60% de confianza
 #define HIGH_CONFIDENCE_THRESHOLD   80.0f  // Alta confianza 80%+
 
+// Bonificación por lecturas analógicas crudas (ADC 12 bits; ajustables, ver params.h)
+#define BONUS_MIC_METAL_MIN         3000   // Metal: micrófono sobre esto
+#define BONUS_LDR_VIDRIO_MIN        3500   // Vidrio: LDR sobre esto
+#define BONUS_LDR_PLASTICO_MIN      1500   // Plástico: LDR entre mín y máx
+#define BONUS_LDR_PLASTICO_MAX      3000
+#define BONUS_MIC_PLASTICO_MIN      1000   // Plástico: micrófono entre mín y máx
+#define BONUS_MIC_PLASTICO_MAX      2500
+#define BONUS_LDR_PAPEL_MAX         1500   // Papel: LDR bajo esto
+#define BONUS_MIC_PAPEL_MAX         1500   // Papel: micrófono bajo esto
+
 // ============================================================================
 // FUNCIONES PÚBLICAS
 // ============================================================================
@@ -1,10 +1,10 @@
 /**
  * @file config.h
- * @brief Configuración del sistema - Versión STM32F410RB
+ * @brief Configuración del sistema (independiente de la placa)
  * @author Smart Waste Manager
  * @date 2025
  *
- * Placa: Nucleo STM32F410RB
+ * Placas: Nucleo STM32F410RB y STM32L433RC-P (ver board.h)
  * Materiales: Metal, Papel, Plástico, Vidrio (4 tipos)
  * Servos: 5 (1 plataforma + 4 tapas)
  */
@@ -12,99 +12,36 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
-#include "stm32f4xx_hal.h"
+#include "board.h"
+#include "quantile.h"
 #include <stdbool.h>
 #include <stdint.h>
 
+// Pines, canales de ADC y de timers y mapa de la Flash de datos: board_<placa>.h
+
 // ============================================================================
-// CONFIGURACIÓN DE PINES GPIO - STM32F410RB
+// LEDS INDICADORES
 // ============================================================================
-
-// Sensores Digitales
-#define SENSOR_INDUCTIVO_PORT       GPIOA
-#define SENSOR_INDUCTIVO_PIN        GPIO_PIN_0
-
-#define SENSOR_CAPACITIVO_PORT      GPIOA
-#define SENSOR_CAPACITIVO_PIN       GPIO_PIN_1
-
-#define SENSOR_PIR_PORT             GPIOA
-#define SENSOR_PIR_PIN              GPIO_PIN_2
-
-// LEDs Indicadores
-#define LED_METAL_PORT              GPIOC
-#define LED_METAL_PIN               GPIO_PIN_2
-
-#define LED_PAPEL_PORT              GPIOC
-#define LED_PAPEL_PIN               GPIO_PIN_3
-
-#define LED_PLASTICO_PORT           GPIOC
-#define LED_PLASTICO_PIN            GPIO_PIN_4
-
-#define LED_VIDRIO_PORT             GPIOC
-#define LED_VIDRIO_PIN              GPIO_PIN_5
-
-#define LED_ERROR_PORT              GPIOC
-#define LED_ERROR_PIN               GPIO_PIN_6
-
-#define LED_SISTEMA_PORT            GPIOC
-#define LED_SISTEMA_PIN             GPIO_PIN_7
-
-// Sensores Ultrasónicos (TRIG)
-#define US_METAL_TRIG_PORT          GPIOB
-#define US_METAL_TRIG_PIN           GPIO_PIN_0
-
-#define US_PAPEL_TRIG_PORT          GPIOB
-#define US_PAPEL_TRIG_PIN           GPIO_PIN_10
-
-#define US_PLASTICO_TRIG_PORT       GPIOB
-#define US_PLASTICO_TRIG_PIN        GPIO_PIN_12
-
-#define US_VIDRIO_TRIG_PORT         GPIOB
-#define US_VIDRIO_TRIG_PIN          GPIO_PIN_14
-
-// Sensores Ultrasónicos (ECHO)
-#define US_METAL_ECHO_PORT          GPIOB
-#define US_METAL_ECHO_PIN           GPIO_PIN_1
-
-#define US_PAPEL_ECHO_PORT          GPIOB
-#define US_PAPEL_ECHO_PIN           GPIO_PIN_11
-
-#define US_PLASTICO_ECHO_PORT       GPIOB
-#define US_PLASTICO_ECHO_PIN        GPIO_PIN_13
-
-#define US_VIDRIO_ECHO_PORT         GPIOB
-#define US_VIDRIO_ECHO_PIN          GPIO_PIN_15
+#define LED_STEP_MS                 10     // Unidad de duración de los pasos de las animaciones
 
 // ============================================================================
-// CANALES ADC (Sensores Analógicos)
+// SENSORES ANALÓGICOS
 // ============================================================================
-#define ADC_CHANNEL_LDR             ADC_CHANNEL_3  // PA3
-#define ADC_CHANNEL_MIC             ADC_CHANNEL_4  // PA4
-#define ADC_CHANNEL_EXTRA1          ADC_CHANNEL_5  // PA5 (peso/humedad)
-#define ADC_CHANNEL_EXTRA2          ADC_CHANNEL_6  // PA6 (gas)
-
-#define ADC_BUFFER_SIZE             4
-#define ADC_RESOLUTION              4095  // 12-bit (0-4095)
+#define ADC_BUFFER_SIZE             4      // LDR, micrófono, extra 1, extra 2
+#define ADC_RESOLUTION              4095   // 12-bit (0-4095)
 
 // ============================================================================
-// CANALES PWM (Servomotores)
+// SERVOMOTORES
 // ============================================================================
 
-// Timer 1
-#define TIM_SERVO_PLATAFORMA        TIM_CHANNEL_1  // PA8
-#define TIM_SERVO_METAL             TIM_CHANNEL_2  // PA9
-#define TIM_SERVO_PAPEL             TIM_CHANNEL_3  // PA10
-
-// Timer 5 (en lugar de Timer 4)
-#define TIM_SERVO_PLASTICO          TIM_CHANNEL_1  // PB6
-#define TIM_SERVO_VIDRIO            TIM_CHANNEL_2  // PB7
-
-// Valores PWM para servos (20ms period, ARR=20000)
+// Valores PWM para servos (en us; servo_driver los convierte a ticks)
 #define SERVO_MIN_PULSE             1000  // 1 ms  (0°)
 #define SERVO_MAX_PULSE             2000  // 2 ms  (180°)
 #define SERVO_CENTER_PULSE          1500  // 1.5 ms (90°)
+#define SERVO_PWM_PERIOD_US         20000 // 20 ms (50 Hz)
+#define SERVO_TIMER_TICK_HZ         1000000 // Tick objetivo de los timers de servos (1 us)
 
-// Posiciones específicas de los servos
+// Posiciones específicas de los servos (por defecto; ajustables, ver params.h)
 #define SERVO_PLAT_HORIZONTAL       90     // Posición horizontal (reposo)
 #define SERVO_PLAT_METAL            45     // Inclina hacia metal
 #define SERVO_PLAT_PAPEL            135    // Inclina hacia papel
@@ -114,18 +51,113 @@
 #define SERVO_TAPA_CERRADA          0      // Tapa cerrada
 #define SERVO_TAPA_ABIERTA          90     // Tapa abierta
 
+// Identificadores de servos (índice usado por actuators_move_servo)
+#define SERVO_COUNT                 5
+#define SERVO_ID_PLATAFORMA         1
+#define SERVO_ID_METAL              2
+#define SERVO_ID_PAPEL              3
+#define SERVO_ID_PLASTICO           4
+#define SERVO_ID_VIDRIO             5
+
 // ============================================================================
 // CONSTANTES DEL SISTEMA
 // ============================================================================
 #define CLASSIFICATION_DELAY_MS     2000   // Tiempo para clasificar
+#define MAIN_LOOP_PERIOD_MS         10     // Período del loop principal (resolución de la cola de servos)
 #define SERVO_MOVE_DELAY_MS         500    // Tiempo para movimiento de servo
 #define ULTRASONIC_TIMEOUT_US       10000  // Timeout para sensor ultrasónico (10ms)
 
-// Tiempos de operación (ms)
+// Umbrales de sensores analógicos (% de la escala del ADC; ajustables, ver params.h)
+#define LDR_OPACO_MAX_PCT           20.0f  // Bajo esto: opaco (papel, metal)
+#define LDR_MEDIO_MAX_PCT           60.0f  // Bajo esto: translúcido (plástico)
+#define MIC_BAJO_MAX_PCT            30.0f  // Bajo esto: sonido bajo (papel)
+#define MIC_MEDIO_MAX_PCT           70.0f  // Bajo esto: sonido medio (plástico)
+
+// Tiempos de operación (ms; los de movimiento son ajustables, ver params.h)
 #define SERVO_DELAY_OPEN            500    // Tiempo para abrir tapa
 #define SERVO_DELAY_TILT            1000   // Tiempo para inclinar plataforma
 #define SERVO_DELAY_DROP            2000   // Tiempo para que caiga el residuo
 #define SERVO_DELAY_CLOSE           500    // Tiempo para cerrar tapa
+#define SERVO_DELAY_REST            1000   // Tiempo para llegar a reposo
+#define SERVO_DELAY_TEST            1000   // Tiempo por posición en la prueba
+#define SERVO_HOLD_MS               500    // PWM activo tras el último movimiento antes de liberar el canal
+
+// Cola de movimientos de servos
+#define MOTION_QUEUE_SIZE           32     // Comandos en cola (pendientes + activos)
+
+// Tiempos de servos aprendidos en operación
+#define SERVO_TIMING_BUCKETS        5      // Ángulos 0/45/90/135/180 (pasos de 45°)
+#define SERVO_TIMING_MIN_SAMPLES    3      // Muestras antes de usar el tiempo aprendido
+#define SERVO_TIMING_MARGIN_MS      100    // Margen mínimo sobre la envolvente medida
+#define SERVO_TIMING_MIN_DROP_MS    300    // Espera mínima para la caída del residuo
+#define SERVO_TIMING_SAVE_MS        600000 // Guardar aprendizaje como máximo cada 10 min
+
+// Estimación de llenado de contenedores
+#define CONTAINER_EMPTY_CM          50.0f  // Distancia del ultrasónico al fondo (vacío)
+#define CONTAINER_FULL_CM           10.0f  // Distancia con el contenedor lleno
+#define FILL_SAMPLE_PERIOD_MS       60000  // Lectura de niveles (sólo en reposo)
+#define FILL_WINDOW                 32     // Lecturas en la ventana deslizante
+#define FILL_OUTLIER_PCT            10.0f  // Residuo máximo frente al ajuste (% de nivel)
+#define FILL_EMPTY_DROP_PCT         30.0f  // Caída de nivel que indica un vaciado
+
+// Bloqueo de contenedores llenos (nivel en caché, sin medir en el depósito)
+#define BIN_FULL_PCT                90.0f  // Nivel a partir del cual no se deposita
+#define BIN_CLEAR_PCT               75.0f  // Nivel por debajo del cual vuelve a aceptar
+#define BIN_FULL_POLICY             BIN_POLICY_HOLD  // Ver BinFullPolicy
+
+// Historial de estadísticas (horas/días de operación: no hay RTC)
+#define STATS_MATERIALS             4      // Metal, papel, plástico, vidrio
+#define STATS_HOURS_HISTORY         168    // Últimos 7 días, por hora
+#define STATS_DAYS_HISTORY          90     // Últimos 90 días, por día
+
+// Persistencia de estadísticas (se mantienen en RAM)
+#define STATS_FLUSH_INTERVAL_MS     300000 // Guardar en Flash como máximo cada 5 min
+
+// Margen de corte tras el aviso PVD: C·ΔV/I con los valores de board_<placa>.h
+// (uF·mV/mA = us). El guardado por aviso PVD (sólo contadores) tiene que entrar
+#define STATS_HOLDUP_US             ((uint32_t)BOARD_HOLDUP_CAP_UF * \
+                                     (BOARD_HOLDUP_PVD_MV - BOARD_HOLDUP_MIN_MV) / BOARD_HOLDUP_LOAD_MA)
+#define STATS_HOLDUP_BUDGET_US      (STATS_HOLDUP_US * 3 / 4)  // 25% de reserva (tolerancia del condensador)
+
+// Telemetría binaria por la consola (tramas COBS, ver telemetry.h)
+#define TELEMETRY_PROTOCOL_VERSION  1
+#define TELEMETRY_STATION_ID        1      // Identifica la estación ante el gateway
+#define TELEMETRY_PERIOD_MS         5000   // Estadísticas, niveles y perfil
+#define TELEMETRY_TX_BUFFER         512    // Cola de transmisión por interrupción (bytes)
+#define TELEMETRY_AUTOSTART         0      // 1 = transmitir desde el arranque ('telem on')
+
+// Bus I2C1 (cola de transacciones, ver i2c_bus.h)
+#define I2C_BUS_SPEED_STANDARD      100000 // Hz
+#define I2C_BUS_SPEED_FAST          400000 // Hz (velocidad de MX_I2C1_Init)
+#define I2C_BUS_QUEUE_SIZE          8      // Transacciones en espera
+#define I2C_BUS_TIMEOUT_MS          5      // Margen sobre la duración teórica de una transacción
+
+// LCD 16x2 HD44780 por I2C1 (módulo PCF8574)
+#define LCD_I2C_ADDRESS             0x27   // 7 bits (0x3F en módulos PCF8574A)
+#define LCD_I2C_SPEED_HZ            I2C_BUS_SPEED_STANDARD  // PCF8574: 100 kHz máx. según datasheet
+#define LCD_ROWS                    2
+#define LCD_COLS                    16
+#define LCD_TX_BUFFER               160    // Bytes por transferencia (pantalla completa: 140)
+#define LCD_FLUSH_TIMEOUT_MS        50     // Espera máxima de lcd_flush()
+#define LCD_RETRY_MS                5000   // Reintento tras un error del módulo
+#define LCD_POWER_ON_MS             50     // Espera del HD44780 desde el arranque (datasheet: >40 ms)
+
+// Capa de visualización (modelo + salidas)
+#define DISPLAY_MAX_SINKS           6      // Salidas registradas (LEDs, LCD, UART, telemetría...)
+#define DISPLAY_LINE_MAX            (LCD_COLS * 2 + 1)  // Bytes por línea (UTF-8: acentos de 2 bytes)
+#define DISPLAY_UART_MIRROR         0      // 1 = copiar la pantalla a la consola desde el arranque
+
+// Consola de comandos (UART de la placa, BOARD_CONSOLE_UART)
+#define SHELL_RX_BUFFER             128    // Cola de recepción de la IRQ (bytes)
+#define SHELL_LINE_MAX              64     // Largo máximo de una línea de comando
+
+// Arranque por etapas (boot.c)
+#define BOOT_MAX_TASKS              6      // Tareas diferidas hasta después de la etapa crítica
+
+// Memoria: sin heap, cada módulo declara sus buffers como arreglos estáticos
+#define HEAP_FREE_BUILD             1      // 1 = malloc/_sbrk detienen el sistema (ver sysmem.c)
+#define PROFILER_STACK_PAINT        0xC5C5C5C5u  // Marca de la RAM libre bajo la pila
+#define PROFILER_STACK_PAINT_GUARD  64     // Bytes bajo el SP que no se pintan al arrancar
 
 // ============================================================================
 // TIPOS DE MATERIALES
@@ -180,6 +212,15 @@ typedef enum {
   SOUND_ALTO = 2              // Metal, Vidrio
 } SoundLevel;
 
+// ============================================================================
+// POLÍTICA ANTE CONTENEDOR LLENO
+// ============================================================================
+typedef enum {
+  BIN_POLICY_REJECT = 0,      // No depositar y avisar en el display
+  BIN_POLICY_HOLD = 1,        // Retener el objeto en la plataforma hasta el vaciado
+  BIN_POLICY_DIVERT = 2       // Depositar en el contenedor libre más vacío
+} BinFullPolicy;
+
 /**
  * @brief Estructura para niveles de llenado de contenedores - 4 contenedores
  */
@@ -202,17 +243,20 @@ typedef struct {
   uint32_t clasificaciones_erroneas; // Errores de clasificación
   float promedio_confianza;        // Promedio de confianza
   uint32_t tiempo_operacion_horas; // Horas de operación
+  uint32_t tiempo_operacion_ms;    // Parte de la hora en curso (ms)
+  
+  // Historial por material (metal, papel, plástico, vidrio) en anillos:
+  // la hora de operación h va en [h % STATS_HOURS_HISTORY] y el día d
+  // en [d % STATS_DAYS_HISTORY]
+  uint16_t por_hora[STATS_HOURS_HISTORY][STATS_MATERIALS];
+  uint16_t por_dia[STATS_DAYS_HISTORY][STATS_MATERIALS];
+  
+  // Distribuciones para percentiles (p50/p90/p99)
+  QuantileSketch dist_confianza;   // Confianza (%) de todas las clasificaciones
+  QuantileSketch dist_ciclo_ms;    // Detección → plataforma libre otra vez
+  QuantileSketch dist_latencia_ms; // Detección → residuo en el contenedor
 } Statistics;
 
-// ============================================================================
-// VARIABLES EXTERNAS (HANDLES)
-// ============================================================================
-
-extern ADC_HandleTypeDef hadc1;
-extern TIM_HandleTypeDef htim1;
-extern TIM_HandleTypeDef htim5;  // Cambiado de htim4 a htim5
-extern UART_HandleTypeDef huart1; // Cambiado de huart2 a huart1
-
 // ============================================================================
 // MACROS DE UTILIDAD
 // ============================================================================
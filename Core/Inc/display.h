@@ -3,6 +3,12 @@
  * @brief Módulo de visualización (LCD y LEDs)
  * @author Smart Waste Manager
  * @date 2025
+ *
+ * Las funciones display_show_* sólo modifican un modelo en RAM (texto de
+ * la pantalla y estado de los LEDs). display_service() lo entrega una vez
+ * por iteración del loop a cada salida registrada (LEDs, LCD por I2C,
+ * copia por consola, telemetría): varias actualizaciones en la misma
+ * iteración cuestan un solo refresco por salida.
  */
 
 #ifndef DISPLAY_H
@@ -10,19 +16,99 @@
 
 #include "config.h"
 #include "classifier.h"
+#include "leds.h"
 #include "statistics.h"
 #include <stdbool.h>
 #include <stdint.h>
 
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+#define DISPLAY_CHANGED_TEXT    0x01
+#define DISPLAY_CHANGED_LEDS    0x02
+
+/**
+ * @brief Lo que muestra el sistema, independiente de las salidas
+ */
+typedef struct {
+  char text[LCD_ROWS][DISPLAY_LINE_MAX];       // UTF-8, hasta LCD_COLS caracteres
+  uint8_t leds;                                // Nivel final de cada LED (bit = LedId)
+  uint8_t leds_animated;                       // LEDs con una animación iniciada
+  uint8_t leds_changed;                        // LEDs modificados en este refresco
+  const LedPattern *led_pattern[LED_COUNT];    // Animación a iniciar (NULL = nivel fijo)
+} DisplayModel;
+
+/**
+ * @brief Salida de la capa de visualización
+ *
+ * La estructura es del cliente y tiene que seguir válida después de
+ * registrarla (se guarda el puntero).
+ */
+typedef struct {
+  const char *name;
+  void (*render)(const DisplayModel *model, uint8_t changed);   // DISPLAY_CHANGED_*
+  bool enabled;
+  uint32_t renders;                            // Refrescos entregados
+} DisplaySink;
+
 // ============================================================================
 // FUNCIONES PÚBLICAS
 // ============================================================================
 
 /**
- * @brief Inicializa el módulo de visualización
+ * @brief Inicializa el módulo de visualización y registra LEDs, LCD y consola
+ * @note No espera al LCD: el panel se arranca después con display_start_lcd()
  */
 void display_init(void);
 
+/**
+ * @brief Arranca el LCD (bloquea ~10 ms) y le entrega la pantalla actual
+ * @note Tarea diferida del arranque: lo que se mostró antes no se pierde
+ */
+void display_start_lcd(void);
+
+/**
+ * @brief Registra una salida adicional
+ * @param sink Salida (no se copia)
+ * @return false si no hay lugar (DISPLAY_MAX_SINKS)
+ */
+bool display_add_sink(DisplaySink *sink);
+
+/**
+ * @brief Habilita o deshabilita una salida por nombre
+ * @param name Nombre de la salida
+ * @param enabled true para habilitarla
+ * @return false si no existe
+ */
+bool display_set_sink_enabled(const char *name, bool enabled);
+
+/**
+ * @brief Entrega los cambios del modelo a las salidas
+ * @note Llamar una vez por iteración del loop principal (no bloquea)
+ */
+void display_service(void);
+
+/**
+ * @brief Entrega los cambios y espera a que el LCD los muestre
+ * @note Bloquea (como mucho unos ms): para el arranque y las pruebas
+ */
+void display_flush(void);
+
+/**
+ * @brief Fija el nivel de un LED en el modelo
+ * @param led LED
+ * @param on true para encender
+ */
+void display_set_led(LedId led, bool on);
+
+/**
+ * @brief Inicia una animación en un LED del modelo
+ * @param led LED
+ * @param pattern Animación (el nivel final es el de su último paso)
+ */
+void display_play_led(LedId led, const LedPattern *pattern);
+
 /**
  * @brief Muestra mensaje de bienvenida
  */
@@ -91,7 +177,7 @@ void display_test_leds(void);
 void display_test_lcd(void);
 
 /**
- * @brief Muestra diagnóstico completo
+ * @brief Muestra diagnóstico completo (LEDs, LCD, salidas y refrescos)
  */
 void display_diagnostic(void);
 
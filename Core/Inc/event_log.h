@@ -0,0 +1,101 @@
+/**
+ * @file event_log.h
+ * @brief Registro de eventos en Flash: un registro por clasificación
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include "config.h"
+#include "classifier.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Ubica el segmento activo y su final, descarta un registro cortado
+ *        por un reinicio y marca el inicio de una nueva sesión
+ *
+ * Si la Flash del registro no se puede preparar, el registro queda
+ * deshabilitado (las clasificaciones no se registran).
+ */
+void event_log_init(void);
+
+/**
+ * @brief Registra una clasificación
+ *
+ * Si hubo depósito, el registro se escribe cuando termina la secuencia
+ * (para incluir su duración); si no, se escribe de inmediato.
+ *
+ * @param result Resultado de la clasificación
+ * @param digital Sensores digitales usados
+ * @param analog Sensores analógicos usados
+ * @param deposited true si se encoló la secuencia de depósito
+ */
+void event_log_classification(const ClassificationResult *result, SensorDigitalData digital,
+                              SensorAnalogData analog, bool deposited);
+
+/**
+ * @brief Escribe el registro pendiente cuando el depósito terminó y
+ *        avanza el volcado en curso
+ * @note Llamar en cada iteración del loop principal
+ */
+void event_log_update(void);
+
+/**
+ * @brief Borra el siguiente segmento cuando el activo está por llenarse
+ *
+ * Las clasificaciones nunca esperan un borrado: si el activo se llena
+ * antes de que esto corra, se pierden (y se cuentan) hasta el próximo
+ * reposo. Con más de un segmento, el anterior sigue legible. Bloquea lo
+ * que dure el borrado del segmento: llamar en reposo. No borra durante
+ * un volcado.
+ *
+ * @return true si el siguiente segmento está borrado
+ */
+bool event_log_prepare(void);
+
+/**
+ * @brief Obtiene la cantidad de clasificaciones registradas en Flash
+ * @return Cantidad de registros en los segmentos legibles
+ */
+uint32_t event_log_get_count(void);
+
+/**
+ * @brief Empieza a enviar el registro crudo por UART (binario)
+ *
+ * Formato, por cada segmento legible del más viejo al activo: línea
+ * "EVLOG <bytes>", bloques "EVLOG DATA <offset> <bytes>" seguidos de esos
+ * bytes del segmento (con su encabezado) y una línea "EVLOG END <crc32>"
+ * para verificar la transferencia. Entre bloques puede aparecer otra
+ * salida de la consola.
+ *
+ * El envío avanza desde event_log_update() por la cola de transmisión
+ * por interrupción, sin bloquear el loop. Mientras dura no se borra
+ * ningún segmento (event_log_prepare() espera).
+ *
+ * @return false si ya hay un volcado en curso
+ */
+bool event_log_dump(void);
+
+/**
+ * @brief Empieza a imprimir el registro decodificado (CSV) por UART
+ *
+ * Avanza igual que event_log_dump(), de a una línea.
+ *
+ * @return false si ya hay un volcado en curso
+ */
+bool event_log_print(void);
+
+/**
+ * @brief Indica si hay un volcado en curso
+ * @return true hasta que se encoló la última línea
+ */
+bool event_log_is_dumping(void);
+
+#endif // EVENT_LOG_H
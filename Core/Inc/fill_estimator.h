@@ -0,0 +1,98 @@
+/**
+ * @file fill_estimator.h
+ * @brief Estimación de velocidad de llenado y tiempo hasta lleno por contenedor
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef FILL_ESTIMATOR_H
+#define FILL_ESTIMATOR_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Estimación de llenado de un contenedor
+ */
+typedef struct {
+  bool valid;              // Hay suficientes lecturas y la velocidad es positiva
+  uint8_t samples;         // Lecturas en la ventana
+  float level_pct;         // Nivel actual según el ajuste (0-100%)
+  float rate_pct_h;        // Velocidad de llenado (%/h)
+  float hours_to_full;     // Estimación central
+  float hours_min;         // Banda: con la velocidad + 2 errores estándar
+  float hours_max;         // Banda: con la velocidad - 2 errores estándar (-1 = sin cota)
+  float pct_per_item;      // Llenado por ítem depositado (0 si no se pudo estimar)
+} FillEstimate;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Vacía las ventanas de los 4 contenedores
+ */
+void fill_init(void);
+
+/**
+ * @brief Lee los ultrasónicos cada FILL_SAMPLE_PERIOD_MS y actualiza
+ * @param stats Estadísticas (contadores de depósitos por material)
+ * @note Llamar en reposo: cada lectura bloquea hasta 4 × 10 ms
+ */
+void fill_update(Statistics *stats);
+
+/**
+ * @brief Agrega una lectura de un contenedor y recalcula su ajuste
+ * @param material Contenedor
+ * @param distance_cm Distancia medida por el ultrasónico (<0 = timeout)
+ * @param items Depósitos acumulados de ese material
+ * @param tick Tick de la lectura
+ */
+void fill_add_reading(MaterialType material, float distance_cm, uint32_t items, uint32_t tick);
+
+/**
+ * @brief Obtiene la estimación de un contenedor
+ * @param material Contenedor
+ * @return Estimación (valid = false si no hay datos suficientes)
+ */
+FillEstimate fill_get_estimate(MaterialType material);
+
+/**
+ * @brief Indica si un contenedor está lleno (con histéresis)
+ *
+ * Usa el nivel en caché: se bloquea al llegar a BIN_FULL_PCT y se libera
+ * al bajar de BIN_CLEAR_PCT. No dispara una medición.
+ *
+ * @param material Contenedor
+ * @return true si no se debe depositar en él
+ */
+bool fill_is_full(MaterialType material);
+
+/**
+ * @brief Suma al nivel en caché lo que aporta un depósito
+ *
+ * Entre lecturas de los ultrasónicos el nivel avanza con el % por ítem
+ * estimado, para que el bloqueo no espere a la próxima lectura.
+ *
+ * @param material Contenedor donde se depositó
+ */
+void fill_record_deposit(MaterialType material);
+
+/**
+ * @brief Elige el contenedor libre más vacío distinto de uno lleno
+ * @param material Contenedor lleno
+ * @return Contenedor alternativo o MATERIAL_NINGUNO si todos están llenos
+ */
+MaterialType fill_get_alternate_bin(MaterialType material);
+
+/**
+ * @brief Muestra nivel, velocidad y tiempo hasta lleno de los 4 contenedores
+ */
+void fill_show_status(void);
+
+#endif // FILL_ESTIMATOR_H
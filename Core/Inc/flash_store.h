@@ -0,0 +1,159 @@
+/**
+ * @file flash_store.h
+ * @brief Imagen A/B de registros persistentes en la Flash de datos y CRC
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef FLASH_STORE_H
+#define FLASH_STORE_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// REGISTROS PERSISTENTES
+// ============================================================================
+
+/**
+ * @brief Tipos de registro guardados en la imagen A/B
+ *
+ * Cada registro lleva su propia versión: si la estructura de un módulo
+ * cambia, se sube su versión y el registro viejo se descarta al cargar.
+ */
+typedef enum {
+  FLASH_RECORD_STATS = 1,          // Statistics
+  FLASH_RECORD_SERVO_TIMING = 2,   // Tiempos de servos aprendidos
+  FLASH_RECORD_PARAMS = 3,         // Parámetros ajustables (clave/valor)
+  FLASH_RECORD_STATS_COUNTERS = 4  // Contadores de Statistics (agregado por aviso PVD)
+} FlashRecordType;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Selecciona la imagen válida más reciente entre las páginas A y B
+ *
+ * Sólo se aceptan imágenes con encabezado, CRC y marca de commit
+ * correctos, así que una escritura interrumpida nunca se carga.
+ *
+ * @return true si se encontró una imagen válida
+ */
+bool flash_store_init(void);
+
+/**
+ * @brief Lee un registro de la imagen activa
+ * @param type Tipo de registro
+ * @param version Versión esperada del registro
+ * @param data Destino
+ * @param len Tamaño esperado en bytes
+ * @return true si el registro existe con esa versión y tamaño
+ */
+bool flash_store_read_record(FlashRecordType type, uint8_t version, void *data, uint16_t len);
+
+/**
+ * @brief Lee un registro de largo variable de la imagen activa
+ * @param type Tipo de registro
+ * @param version Versión esperada del registro
+ * @param data Destino
+ * @param max_len Capacidad del destino en bytes
+ * @param len Bytes leídos
+ * @return true si el registro existe con esa versión y entra en el destino
+ */
+bool flash_store_read_record_var(FlashRecordType type, uint8_t version, void *data,
+                                 uint16_t max_len, uint16_t *len);
+
+/**
+ * @brief Escribe un registro en una imagen nueva en la otra página
+ *
+ * Copia el resto de los registros de la imagen activa, escribe el
+ * nuevo y marca el commit al final. Si se corta la alimentación antes
+ * del commit, la imagen anterior sigue siendo la activa. Devuelve false
+ * sin escribir si otra escritura está en curso (llamada desde una IRQ).
+ *
+ * @param type Tipo de registro
+ * @param version Versión del registro
+ * @param data Datos
+ * @param len Tamaño en bytes
+ * @return true si la nueva imagen quedó confirmada
+ */
+bool flash_store_write_record(FlashRecordType type, uint8_t version, const void *data, uint16_t len);
+
+/**
+ * @brief Agrega un registro chico detrás de la imagen activa, sin copiarla
+ *
+ * Sólo programa el registro, su CRC y su commit en la parte borrada que
+ * queda al final de la página activa: la duración depende de len y no
+ * del tamaño de la imagen. Es el guardado de la IRQ del aviso PVD. La
+ * próxima imagen completa (en la otra página) descarta lo agregado.
+ * Devuelve false sin escribir si no hay imagen activa, si no queda lugar
+ * o si otra escritura está en curso.
+ *
+ * @param type Tipo de registro
+ * @param version Versión del registro
+ * @param data Datos
+ * @param len Tamaño en bytes
+ * @return true si el registro quedó confirmado
+ */
+bool flash_store_append_record(FlashRecordType type, uint8_t version, const void *data, uint16_t len);
+
+/**
+ * @brief Lee el último registro agregado con flash_store_append_record()
+ *
+ * Un registro agregado siempre es más nuevo que la imagen que tiene
+ * delante. Los que quedaron sin commit o con CRC inválido se saltean.
+ *
+ * @param type Tipo de registro
+ * @param version Versión esperada del registro
+ * @param data Destino
+ * @param len Tamaño esperado en bytes
+ * @return true si hay uno confirmado con ese tipo, versión y tamaño
+ */
+bool flash_store_read_appended(FlashRecordType type, uint8_t version, void *data, uint16_t len);
+
+/**
+ * @brief Borra la página inactiva si todavía no lo está
+ *
+ * Con la página de reserva ya borrada, una escritura de registro sólo
+ * programa palabras y no frena el loop lo que dura un borrado. Bloquea
+ * lo que dure el borrado de la página: llamar en reposo.
+ *
+ * @return true si la página de reserva quedó lista
+ */
+bool flash_store_prepare(void);
+
+/**
+ * @brief Indica si la próxima escritura no necesita borrar
+ * @return true si la página de reserva está borrada
+ */
+bool flash_store_is_ready(void);
+
+/**
+ * @brief Muestra la página activa y su número de secuencia
+ */
+void flash_store_show_status(void);
+
+/**
+ * @brief Calcula CRC-32 (polinomio IEEE 802.3)
+ * @param data Datos
+ * @param len Cantidad de bytes
+ * @return CRC-32 de los datos
+ */
+uint32_t flash_store_crc32(const void *data, uint32_t len);
+
+/**
+ * @brief Continúa un CRC-32 con más datos
+ *
+ * flash_store_crc32_update(flash_store_crc32(a, n), b, m) es el CRC de a
+ * seguido de b; empezando desde 0 es igual a flash_store_crc32().
+ *
+ * @param crc CRC de los datos anteriores
+ * @param data Datos
+ * @param len Cantidad de bytes
+ * @return CRC-32 de todos los datos
+ */
+uint32_t flash_store_crc32_update(uint32_t crc, const void *data, uint32_t len);
+
+#endif // FLASH_STORE_H
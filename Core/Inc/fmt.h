@@ -0,0 +1,65 @@
+/**
+ * @file fmt.h
+ * @brief Formateo de texto sólo con enteros (reemplazo de printf/sprintf)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Sin heap ni estado global: se puede llamar desde cualquier contexto.
+ * Soporta %d %i %u %x %X %c %s %p %% con banderas (- 0 + espacio),
+ * ancho y precisión (también '*') y los modificadores h, l, ll y z.
+ * %f se resuelve en punto fijo: como mucho 9 decimales y parte entera
+ * hasta 4294967295 (más que eso se muestra como "ovf").
+ *
+ * Con FMT_REPLACE_STDIO = 1 este módulo también define printf, sprintf,
+ * snprintf, puts y putchar, así que el formateo de newlib (con su
+ * soporte de float y el buffer de stdout en el heap) no se enlaza.
+ */
+
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef FMT_REPLACE_STDIO
+#define FMT_REPLACE_STDIO       1
+#endif
+
+#define FMT_PRINTF_CHUNK        64     // Buffer en la pila de fmt_printf (bytes por _write)
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Formatea en un buffer (siempre termina en '\0' si size > 0)
+ * @param buf Destino
+ * @param size Tamaño del destino
+ * @param format Formato estilo printf
+ * @param args Argumentos
+ * @return Largo que tendría el texto completo (como vsnprintf)
+ */
+int fmt_vsnprintf(char *buf, size_t size, const char *format, va_list args);
+
+/**
+ * @brief Formatea en un buffer (ver fmt_vsnprintf)
+ */
+int fmt_snprintf(char *buf, size_t size, const char *format, ...)
+  __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Formatea y escribe por la consola (_write) en bloques de FMT_PRINTF_CHUNK
+ * @param format Formato estilo printf
+ * @param args Argumentos
+ * @return Caracteres escritos
+ */
+int fmt_vprintf(const char *format, va_list args);
+
+/**
+ * @brief Formatea y escribe por la consola (ver fmt_vprintf)
+ */
+int fmt_printf(const char *format, ...)
+  __attribute__((format(printf, 1, 2)));
+
+#endif // FMT_H
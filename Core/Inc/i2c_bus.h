@@ -0,0 +1,142 @@
+/**
+ * @file i2c_bus.h
+ * @brief Administrador del bus I2C1: cola de transacciones por interrupción
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Los clientes (LCD, sensores de peso o temperatura) encolan
+ * transacciones y reciben un aviso al terminar. La siguiente arranca
+ * desde la IRQ de fin de la anterior, sin esperar al loop principal.
+ * Cada transacción indica la velocidad máxima de su dispositivo: el bus
+ * trabaja en modo rápido (400 kHz) y baja a 100 kHz sólo para los que
+ * no lo soportan. Los timeouts y la liberación del bus (9 pulsos de
+ * SCL + STOP) se hacen desde i2c_bus_service(), nunca en la IRQ.
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+typedef enum {
+  I2C_BUS_OK = 0,
+  I2C_BUS_NACK = 1,         // El dispositivo no respondió
+  I2C_BUS_ERROR = 2,        // Error de bus o arbitraje (se libera el bus)
+  I2C_BUS_TIMEOUT = 3       // No terminó a tiempo (se libera el bus)
+} I2cBusStatus;
+
+/**
+ * @brief Aviso de fin de transacción
+ * @note Se llama desde la IRQ de I2C1: sólo guardar el resultado y volver
+ */
+typedef void (*I2cBusCallback)(I2cBusStatus status, void *context);
+
+/**
+ * @brief Transacción: escritura, lectura o escritura + lectura (START repetido)
+ *
+ * La cola guarda el puntero: la estructura y los buffers tienen que
+ * seguir válidos hasta el aviso de fin.
+ */
+typedef struct {
+  uint8_t address;          // Dirección de 7 bits
+  uint32_t speed_hz;        // Máximo del dispositivo (I2C_BUS_SPEED_*)
+  uint8_t *tx;
+  uint16_t tx_len;
+  uint8_t *rx;
+  uint16_t rx_len;
+  I2cBusCallback done;      // Puede ser NULL
+  void *context;
+} I2cTransaction;
+
+/**
+ * @brief Contadores del bus
+ */
+typedef struct {
+  uint32_t transactions;    // Terminadas (con o sin error)
+  uint32_t bytes;           // Datos transferidos (sin contar direcciones)
+  uint32_t nacks;
+  uint32_t errors;
+  uint32_t timeouts;
+  uint32_t recoveries;      // Liberaciones del bus
+  uint32_t rejected;        // Cola llena
+  uint8_t queue_max;        // Profundidad máxima de la cola
+  float utilization_pct;    // Ocupación del bus en la última ventana
+  float utilization_max_pct;
+} I2cBusStats;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Prepara la cola y libera el bus si quedó tomado (SDA en bajo)
+ * @note Llamar después de MX_I2C1_Init() y profiler_init()
+ */
+void i2c_bus_init(void);
+
+/**
+ * @brief Encola una transacción (arranca enseguida si el bus está libre)
+ * @param transaction Transacción (no se copia)
+ * @return false si la cola está llena
+ */
+bool i2c_bus_submit(I2cTransaction *transaction);
+
+/**
+ * @brief Escritura bloqueante con el bus libre
+ * @note Sólo para la inicialización de dispositivos al arrancar
+ * @param address Dirección de 7 bits
+ * @param speed_hz Velocidad máxima del dispositivo
+ * @param data Datos
+ * @param len Cantidad de bytes
+ * @return true si el dispositivo aceptó todos los bytes
+ */
+bool i2c_bus_write_blocking(uint8_t address, uint32_t speed_hz, uint8_t *data, uint16_t len);
+
+/**
+ * @brief Vencimiento de transacciones, liberación del bus y ocupación
+ * @note Llamar en cada iteración del loop principal (no bloquea)
+ */
+void i2c_bus_service(void);
+
+/**
+ * @brief Indica si no hay transacciones en curso ni en cola
+ * @return true si el bus está libre
+ */
+bool i2c_bus_is_idle(void);
+
+/**
+ * @brief Fin de la escritura en curso
+ * @note Llamar desde HAL_I2C_MasterTxCpltCallback
+ */
+void i2c_bus_tx_complete(void);
+
+/**
+ * @brief Fin de la lectura en curso
+ * @note Llamar desde HAL_I2C_MasterRxCpltCallback
+ */
+void i2c_bus_rx_complete(void);
+
+/**
+ * @brief Error en la transacción en curso (NACK, bus, arbitraje)
+ * @note Llamar desde HAL_I2C_ErrorCallback
+ */
+void i2c_bus_error(void);
+
+/**
+ * @brief Obtiene los contadores del bus
+ * @return Copia de los contadores
+ */
+I2cBusStats i2c_bus_get_stats(void);
+
+/**
+ * @brief Muestra velocidad, ocupación y errores del bus
+ */
+void i2c_bus_show_status(void);
+
+#endif // I2C_BUS_H
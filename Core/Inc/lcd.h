@@ -1,11 +1,103 @@
+/**
+ * @file lcd.h
+ * @brief Driver de LCD 16x2 HD44780 por I2C (módulo PCF8574)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Las funciones de escritura sólo cambian un framebuffer en RAM.
+ * lcd_service() compara ese framebuffer con lo que ya muestra el panel y
+ * manda únicamente las celdas que cambiaron, todas en una sola
+ * transacción encolada en el bus I2C (i2c_bus): el loop principal nunca
+ * espera al bus.
+ */
+
 #ifndef LCD_H
 #define LCD_H
 
+#include "config.h"
+#include <stdbool.h>
 #include <stdint.h>
 
-void lcd_init(void);
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Contadores del bus para medir el costo de cada actualización
+ */
+typedef struct {
+  uint32_t transfers;     // Transferencias I2C completadas
+  uint32_t cells;         // Caracteres enviados
+  uint32_t bus_bytes;     // Bytes en el bus (incluye el de dirección)
+  uint16_t last_bytes;    // Bytes de la última transferencia
+  uint32_t errors;        // NACK, error de bus o timeout
+} LcdStats;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializa el HD44780 en modo 4 bits
+ * @note Bloquea ~10 ms (esperas del controlador), más lo que falte para
+ *       LCD_POWER_ON_MS desde el arranque. Hasta entonces lcd_service()
+ *       no envía nada
+ * @return true si el módulo respondió
+ */
+bool lcd_init(void);
+
+/**
+ * @brief Llena el framebuffer con espacios
+ */
 void lcd_clear(void);
+
+/**
+ * @brief Posiciona el cursor de escritura del framebuffer
+ * @param row Fila (0-1)
+ * @param col Columna (0-15)
+ */
 void lcd_set_cursor(uint8_t row, uint8_t col);
+
+/**
+ * @brief Escribe texto en el framebuffer desde el cursor (corta en la columna 16)
+ * @param text Texto UTF-8 (acentos y ñ se adaptan a la ROM del HD44780)
+ */
 void lcd_print(const char *text);
 
+/**
+ * @brief Reemplaza una fila completa (rellena con espacios)
+ * @param row Fila (0-1)
+ * @param text Texto UTF-8
+ */
+void lcd_write_line(uint8_t row, const char *text);
+
+/**
+ * @brief Envía al panel las celdas que cambiaron
+ * @note Llamar en cada iteración del loop principal (no bloquea)
+ */
+void lcd_service(void);
+
+/**
+ * @brief Espera a que el panel muestre el framebuffer actual
+ * @note Bloquea (como mucho unos ms): para el arranque y las pruebas
+ */
+void lcd_flush(void);
+
+/**
+ * @brief Olvida el contenido del panel: la próxima actualización lo redibuja entero
+ */
+void lcd_invalidate(void);
+
+/**
+ * @brief Indica si el módulo respondió en la última transferencia
+ * @return true si el LCD está presente
+ */
+bool lcd_is_present(void);
+
+/**
+ * @brief Obtiene los contadores del bus
+ * @return Copia de los contadores
+ */
+LcdStats lcd_get_stats(void);
+
 #endif // LCD_H
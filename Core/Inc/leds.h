@@ -1,12 +1,100 @@
+/**
+ * @file leds.h
+ * @brief LEDs indicadores con animaciones por tabla de pasos
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Cada LED reproduce su propia animación, todas a la vez. Las animaciones
+ * avanzan desde SysTick: entre un paso y el siguiente sólo se descuenta
+ * un contador, así que ni el loop principal ni la IRQ pierden tiempo
+ * esperando (antes cada parpadeo era un HAL_Delay).
+ */
+
 #ifndef LEDS_H
 #define LEDS_H
 
 #include "config.h"
+#include <stdbool.h>
 #include <stdint.h>
 
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+typedef enum {
+  LED_ID_METAL = 0,
+  LED_ID_PAPEL = 1,
+  LED_ID_PLASTICO = 2,
+  LED_ID_VIDRIO = 3,
+  LED_ID_ERROR = 4,
+  LED_ID_SISTEMA = 5,
+  LED_COUNT = 6
+} LedId;
+
+/**
+ * @brief Paso de una animación: nivel del LED durante un tiempo
+ */
+typedef struct {
+  uint8_t on;               // 1 = encendido
+  uint8_t time;             // Duración en unidades de LED_STEP_MS (1-255)
+} LedStep;
+
+/**
+ * @brief Animación: tabla de pasos que se repite
+ *
+ * Al terminar, el LED queda con el nivel del último paso. SysTick lee la
+ * tabla desde la RAM: una animación nueva se declara con BOARD_RAM_DATA
+ * (pasos y LedPattern) para no frenarse durante un borrado de Flash.
+ */
+typedef struct {
+  const LedStep *steps;
+  uint8_t count;
+  uint8_t repeat;           // Veces que se reproduce la tabla (0 = sin fin)
+} LedPattern;
+
+// ============================================================================
+// ANIMACIONES PREDEFINIDAS
+// ============================================================================
+
+extern const LedPattern led_pattern_detecting;   // 3 parpadeos, queda encendido
+extern const LedPattern led_pattern_sound;       // Parpadeo rápido de 200 ms
+extern const LedPattern led_pattern_alert;       // 3 destellos, queda encendido
+extern const LedPattern led_pattern_heartbeat;   // Latido sin fin
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Configura los pines de los LEDs y los apaga
+ */
 void leds_init(void);
-void leds_on(uint8_t led);     // led: define por config (LED_METAL, LED_PLASTIC, ...)
-void leds_off(uint8_t led);
-void leds_off_all(void);
+
+/**
+ * @brief Fija el nivel de un LED (detiene su animación)
+ * @param led LED
+ * @param on true para encender
+ */
+void leds_set(LedId led, bool on);
+
+/**
+ * @brief Inicia una animación en un LED (reemplaza la que tuviera)
+ * @param led LED
+ * @param pattern Animación (debe seguir válida mientras se reproduce)
+ */
+void leds_play(LedId led, const LedPattern *pattern);
+
+/**
+ * @brief Indica si un LED está reproduciendo una animación
+ * @param led LED
+ * @return true si la animación no terminó
+ */
+bool leds_is_playing(LedId led);
+
+/**
+ * @brief Base de tiempo de las animaciones
+ * @note Llamar desde SysTick_Handler (cada 1 ms)
+ */
+void leds_tick(void);
 
 #endif // LEDS_H
@@ -0,0 +1,159 @@
+/**
+ * @file params.h
+ * @brief Parámetros ajustables en operación (umbrales y tiempos)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Los #define de config.h son los valores por defecto; los módulos leen
+ * siempre la copia en RAM, que se puede cambiar desde la consola UART.
+ *
+ * Los valores que difieren del defecto se guardan en Flash como pares
+ * clave/valor (registro FLASH_RECORD_PARAMS de la imagen A/B). Cada
+ * parámetro tiene una clave numérica fija: agregar o quitar parámetros
+ * no invalida lo guardado, las claves desconocidas se ignoran y las que
+ * faltan o quedan fuera de rango toman el valor por defecto.
+ */
+
+#ifndef PARAMS_H
+#define PARAMS_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Valores vigentes de los parámetros ajustables
+ */
+typedef struct {
+  float confianza_min;            // Confianza mínima para depositar (%)
+  float ldr_opaco_max;            // LDR bajo este % = opaco
+  float ldr_medio_max;            // LDR bajo este % = translúcido
+  float mic_bajo_max;             // Micrófono bajo este % = sonido bajo
+  float mic_medio_max;            // Micrófono bajo este % = sonido medio
+  float bin_lleno_pct;            // Bloqueo de contenedor lleno
+  float bin_libre_pct;            // Liberación del bloqueo (histéresis)
+  uint32_t bin_politica;          // BinFullPolicy
+  uint32_t servo_hold_ms;         // PWM activo tras el último movimiento
+  uint32_t fill_periodo_ms;       // Lectura de niveles
+  uint32_t stats_flush_ms;        // Guardado periódico de estadísticas
+  uint32_t telemetria_periodo_ms; // Mensajes periódicos (0 = sólo ítems)
+  
+  // Bonificación del clasificador (lecturas crudas del ADC)
+  uint32_t bono_mic_metal_min;
+  uint32_t bono_ldr_vidrio_min;
+  uint32_t bono_ldr_plastico_min;
+  uint32_t bono_ldr_plastico_max;
+  uint32_t bono_mic_plastico_min;
+  uint32_t bono_mic_plastico_max;
+  uint32_t bono_ldr_papel_max;
+  uint32_t bono_mic_papel_max;
+  
+  // Ángulos de los servos (grados)
+  uint32_t plat_horizontal;
+  uint32_t plat_metal;
+  uint32_t plat_papel;
+  uint32_t plat_plastico;
+  uint32_t plat_vidrio;
+  uint32_t tapa_cerrada;
+  uint32_t tapa_abierta;
+  
+  // Peor caso de cada movimiento (ms, antes de aprender tiempos)
+  uint32_t delay_abrir_ms;
+  uint32_t delay_inclinar_ms;
+  uint32_t delay_caida_ms;
+  uint32_t delay_cerrar_ms;
+  uint32_t delay_reposo_ms;
+} SystemParams;
+
+typedef enum {
+  PARAM_FLOAT = 0,
+  PARAM_U32 = 1
+} ParamType;
+
+/**
+ * @brief Descripción de un parámetro para la consola
+ */
+typedef struct {
+  uint8_t key;              // Clave en Flash (fija, no reutilizar)
+  const char *name;         // Nombre en la consola
+  ParamType type;
+  void *value;              // Campo de SystemParams
+  float def;                // Valor por defecto (config.h)
+  float min;
+  float max;
+  const char *description;
+} ParamInfo;
+
+extern SystemParams params;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Carga los valores por defecto y aplica los guardados en Flash
+ * @note Llamar después de flash_store_init()
+ */
+void params_init(void);
+
+/**
+ * @brief Vuelve todos los parámetros a su valor por defecto (sólo en RAM)
+ */
+void params_reset(void);
+
+/**
+ * @brief Guarda en Flash los parámetros que difieren del defecto
+ *
+ * La imagen A/B se confirma de una vez: un corte durante la escritura
+ * deja vigente el juego anterior completo. Puede borrar un sector
+ * (bloquea): llamar en reposo.
+ *
+ * @return true si el registro quedó confirmado
+ */
+bool params_save(void);
+
+/**
+ * @brief Indica si hay cambios sin guardar
+ * @return true si algún parámetro cambió desde la última carga o guardado
+ */
+bool params_is_dirty(void);
+
+/**
+ * @brief Busca un parámetro por nombre
+ * @param name Nombre del parámetro
+ * @return Descripción o NULL si no existe
+ */
+const ParamInfo *params_find(const char *name);
+
+/**
+ * @brief Obtiene un parámetro por índice (para recorrer la tabla)
+ * @param index Índice (0 a params_count() - 1)
+ * @return Descripción o NULL si el índice no existe
+ */
+const ParamInfo *params_get_info(uint8_t index);
+
+/**
+ * @brief Cantidad de parámetros ajustables
+ * @return Entradas de la tabla
+ */
+uint8_t params_count(void);
+
+/**
+ * @brief Cambia un parámetro validando su rango (sólo en RAM)
+ * @param name Nombre del parámetro
+ * @param text Valor en texto
+ * @return true si el nombre existe y el valor es válido
+ */
+bool params_set(const char *name, const char *text);
+
+/**
+ * @brief Imprime un parámetro (o todos si name es NULL)
+ * @param name Nombre del parámetro o NULL
+ */
+void params_print(const char *name);
+
+#endif // PARAMS_H
@@ -0,0 +1,63 @@
+/**
+ * @file profiler.h
+ * @brief Medición de tiempos (contador de ciclos DWT) y uso de la pila
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * La pila se pinta al arrancar con PROFILER_STACK_PAINT: la marca más
+ * profunda que falte es el máximo que llegó a usar. El peor caso estático
+ * (llamadas + interrupciones) lo calcula Tools/stack_budget al compilar.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "config.h"
+#include <stdint.h>
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Habilita el contador de ciclos (DWT->CYCCNT)
+ */
+void profiler_init(void);
+
+/**
+ * @brief Lee el contador de ciclos
+ * @return Ciclos de CPU (desborda cada ~43 s a 100 MHz)
+ */
+uint32_t profiler_cycles(void);
+
+/**
+ * @brief Convierte ciclos a microsegundos con el reloj actual
+ * @param cycles Ciclos medidos (diferencia entre dos lecturas)
+ * @return Tiempo en us
+ */
+uint32_t profiler_cycles_to_us(uint32_t cycles);
+
+/**
+ * @brief Pinta la RAM libre debajo de la pila (desde el fin de .bss)
+ * @note Llamar primero en main(), antes de habilitar interrupciones
+ */
+void profiler_stack_paint(void);
+
+/**
+ * @brief Máximo de pila usado desde el arranque (busca la marca más profunda)
+ * @return Bytes desde _estack
+ */
+uint32_t profiler_stack_used(void);
+
+/**
+ * @brief Pila reservada por el enlazador (_Min_Stack_Size)
+ * @return Bytes
+ */
+uint32_t profiler_stack_budget(void);
+
+/**
+ * @brief Muestra el uso máximo de la pila frente a lo reservado
+ */
+void profiler_show_stack(void);
+
+#endif // PROFILER_H
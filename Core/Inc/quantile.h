@@ -0,0 +1,61 @@
+/**
+ * @file quantile.h
+ * @brief Cuantiles aproximados en memoria constante (histograma de bins fijos)
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef QUANTILE_H
+#define QUANTILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+#define QUANTILE_BINS           64
+
+/**
+ * @brief Histograma para estimar cuantiles de un flujo de valores enteros
+ *
+ * Lineal: bin = valor / ancho (ej. confianza 0-100 en pasos de 2).
+ * Logarítmico: 4 bins por octava, error relativo < 12.5% hasta 131071
+ * (ej. tiempos en ms). Cuando un bin satura, todos se dividen por 2:
+ * la forma de la distribución se conserva y pesa más lo reciente.
+ */
+typedef struct {
+  uint16_t bins[QUANTILE_BINS];
+  uint32_t count;               // Valores agregados (no se divide)
+  uint16_t linear_width;        // 0 = logarítmico
+  uint16_t reserved;
+} QuantileSketch;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializa un histograma vacío
+ * @param sketch Histograma
+ * @param linear_width Ancho de bin lineal (0 para escala logarítmica)
+ */
+void quantile_init(QuantileSketch *sketch, uint16_t linear_width);
+
+/**
+ * @brief Agrega un valor (O(1))
+ * @param sketch Histograma
+ * @param value Valor (se satura en el último bin)
+ */
+void quantile_add(QuantileSketch *sketch, uint32_t value);
+
+/**
+ * @brief Estima un percentil
+ * @param sketch Histograma
+ * @param percent Percentil (1-100)
+ * @return Valor central del bin que contiene el percentil (0 si está vacío)
+ */
+uint32_t quantile_get(const QuantileSketch *sketch, uint8_t percent);
+
+#endif // QUANTILE_H
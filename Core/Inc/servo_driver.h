@@ -0,0 +1,79 @@
+/**
+ * @file servo_driver.h
+ * @brief Base de tiempo PWM unificada para los servos (timers A y B de la placa)
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef SERVO_DRIVER_H
+#define SERVO_DRIVER_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Configura los timers de servos a partir de su reloj real y arranca el PWM
+ *
+ * Calcula prescaler y período para SERVO_PWM_PERIOD_US, precalcula la
+ * tabla ángulo → CCR de cada timer y arranca los 5 canales.
+ */
+void servo_driver_init(void);
+
+/**
+ * @brief Escribe el CCR correspondiente a un ángulo
+ * @param servo Servo (1-5)
+ * @param angle Ángulo (0-180°)
+ * @return true si el servo es válido
+ */
+bool servo_driver_set_angle(uint8_t servo, uint8_t angle);
+
+/**
+ * @brief Habilita la salida PWM de un servo con el último CCR escrito
+ * @param servo Servo (1-5)
+ * @return true si el servo es válido
+ */
+bool servo_driver_enable(uint8_t servo);
+
+/**
+ * @brief Deshabilita la salida PWM de un servo (sin pulsos, sin torque)
+ * @param servo Servo (1-5)
+ * @return true si el servo es válido
+ */
+bool servo_driver_disable(uint8_t servo);
+
+/**
+ * @brief Indica si la salida PWM de un servo está habilitada
+ * @param servo Servo (1-5)
+ * @return true si el canal está generando pulsos
+ */
+bool servo_driver_is_enabled(uint8_t servo);
+
+/**
+ * @brief Obtiene el CCR de un ángulo para el timer de un servo
+ * @param servo Servo (1-5)
+ * @param angle Ángulo (0-180°)
+ * @return Valor de CCR (0 si el servo no es válido)
+ */
+uint16_t servo_driver_angle_to_ccr(uint8_t servo, uint8_t angle);
+
+/**
+ * @brief Verifica con los registros reales que los 5 canales den 20 ms
+ *        de período y pulsos de 1 a 2 ms
+ *
+ * Mide la frecuencia de cada contador contra DWT->CYCCNT durante 5 ms
+ * (bloquea unos 10 ms); requiere profiler_init().
+ * @return true si todos los canales están dentro de tolerancia
+ */
+bool servo_driver_verify(void);
+
+/**
+ * @brief Muestra la configuración de cada timer
+ */
+void servo_driver_show_status(void);
+
+#endif // SERVO_DRIVER_H
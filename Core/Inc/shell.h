@@ -0,0 +1,42 @@
+/**
+ * @file shell.h
+ * @brief Consola de comandos por UART (recepción por interrupción)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * La IRQ de la UART sólo guarda bytes en una cola y marca el fin de cada
+ * ráfaga (línea ociosa). El loop principal arma las líneas y ejecuta como
+ * mucho un comando por iteración; los comandos que imprimen mucho o usan
+ * los servos esperan a que la plataforma esté libre.
+ */
+
+#ifndef SHELL_H
+#define SHELL_H
+
+#include "config.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Habilita la recepción por interrupción de la consola
+ * @param stats Estadísticas del sistema (para los comandos stats/reset)
+ */
+void shell_init(Statistics *stats);
+
+/**
+ * @brief Atiende la recepción de la consola (BOARD_CONSOLE_UART)
+ * @note Llamar desde la IRQ de la UART de consola antes de HAL_UART_IRQHandler
+ */
+void shell_uart_irq(void);
+
+/**
+ * @brief Procesa los bytes recibidos y ejecuta el comando de la línea
+ * @note Llamar en cada iteración del loop principal (no bloquea)
+ */
+void shell_service(void);
+
+#endif // SHELL_H
@@ -11,6 +11,19 @@
 #include "config.h"
 #include "classifier.h"
 
+// ============================================================================
+// TIPOS DE DATOS
+// ============================================================================
+
+/**
+ * @brief Distribuciones con percentiles
+ */
+typedef enum {
+  STATS_DIST_CONFIDENCE = 0,   // Confianza (%)
+  STATS_DIST_CYCLE_MS,         // Detección → plataforma libre (ms)
+  STATS_DIST_LATENCY_MS        // Detección → residuo en el contenedor (ms)
+} StatsDistribution;
+
 // ============================================================================
 // FUNCIONES PÚBLICAS
 // ============================================================================
@@ -28,6 +41,33 @@ void statistics_init(Statistics *stats);
  */
 void statistics_update(Statistics *stats, ClassificationResult result);
 
+/**
+ * @brief Registra una clasificación rechazada (sólo su confianza)
+ * @param stats Puntero a estructura de estadísticas
+ * @param result Resultado de clasificación
+ */
+void statistics_record_rejected(Statistics *stats, ClassificationResult result);
+
+/**
+ * @brief Marca el inicio de un ítem depositado para medir ciclo y latencia
+ *
+ * Los tiempos se toman en statistics_service() cuando termina la
+ * secuencia de depósito.
+ *
+ * @param stats Puntero a estructura de estadísticas
+ * @param detect_tick Tick de la detección de presencia
+ */
+void statistics_item_started(Statistics *stats, uint32_t detect_tick);
+
+/**
+ * @brief Obtiene un percentil aproximado de una distribución
+ * @param stats Puntero a estructura de estadísticas
+ * @param distribution Distribución
+ * @param percent Percentil (1-100)
+ * @return Valor estimado (0 si no hay datos)
+ */
+uint32_t statistics_get_percentile(Statistics *stats, StatsDistribution distribution, uint8_t percent);
+
 /**
  * @brief Obtiene el promedio de confianza
  * @param stats Puntero a estructura de estadísticas
@@ -51,12 +91,80 @@ uint32_t statistics_get_total(Statistics *stats);
 uint32_t statistics_get_material_count(Statistics *stats, MaterialType material);
 
 /**
- * @brief Guarda estadísticas en Flash
+ * @brief Obtiene los ítems de un material en una hora de operación
+ * @param stats Puntero a estructura de estadísticas
+ * @param hours_ago Horas hacia atrás (0 = hora en curso, hasta 167)
+ * @param material Tipo de material
+ * @return Cantidad en esa hora (0 si está fuera del historial)
+ */
+uint16_t statistics_get_hourly(Statistics *stats, uint16_t hours_ago, MaterialType material);
+
+/**
+ * @brief Obtiene los ítems de un material en un día de operación
+ * @param stats Puntero a estructura de estadísticas
+ * @param days_ago Días hacia atrás (0 = día en curso, hasta 89)
+ * @param material Tipo de material
+ * @return Cantidad en ese día (0 si está fuera del historial)
+ */
+uint16_t statistics_get_daily(Statistics *stats, uint16_t days_ago, MaterialType material);
+
+/**
+ * @brief Guarda estadísticas en Flash (y mide el tiempo del guardado)
  * @param stats Puntero a estructura de estadísticas
  * @return true si se guardó correctamente
  */
 bool statistics_save_to_flash(Statistics *stats);
 
+/**
+ * @brief Acumula el tiempo de operación y guarda en Flash si hay cambios
+ *        y pasó params.stats_flush_ms
+ * @param stats Puntero a estructura de estadísticas
+ * @note Llamar en cada iteración del loop principal
+ */
+void statistics_service(Statistics *stats);
+
+/**
+ * @brief Guarda en Flash ya mismo si hay cambios (ej. antes de apagar)
+ * @param stats Puntero a estructura de estadísticas
+ * @return true si no había cambios o se guardaron correctamente
+ */
+bool statistics_flush(Statistics *stats);
+
+/**
+ * @brief Guarda los contadores desde la IRQ del PVD (caída de alimentación)
+ *
+ * No imprime nada ni escribe la imagen completa: agrega sólo los
+ * contadores, el promedio y el tiempo de operación detrás de la imagen
+ * activa (flash_store_append_record()), así que su duración no depende del
+ * historial. El historial y los percentiles desde el último guardado
+ * periódico se pierden. Si no queda lugar o la Flash está ocupada no
+ * escribe nada y cuenta el aviso como descartado.
+ */
+void statistics_emergency_flush(void);
+
+/**
+ * @brief Ejecuta el guardado del aviso PVD a pedido y muestra su tiempo
+ *
+ * Mismo camino que statistics_emergency_flush() aunque no haya cambios,
+ * para medirlo en la placa sin cortar la alimentación.
+ */
+void statistics_test_emergency_flush(void);
+
+/**
+ * @brief Muestra los tiempos medidos de los guardados
+ *
+ * El del aviso PVD se compara con STATS_HOLDUP_BUDGET_US; el periódico
+ * corre en el loop y sólo se informa.
+ */
+void statistics_show_flush_budget(void);
+
+/**
+ * @brief Obtiene el tiempo medido del guardado periódico
+ * @param last_us Último guardado (us)
+ * @param max_us Máximo observado (us)
+ */
+void statistics_get_flush_time(uint32_t *last_us, uint32_t *max_us);
+
 /**
  * @brief Carga estadísticas desde Flash
  * @param stats Puntero a estructura de estadísticas
@@ -76,5 +184,11 @@ void statistics_reset(Statistics *stats);
  */
 void statistics_print(Statistics *stats);
 
+/**
+ * @brief Imprime las últimas 24 horas, la hora y el día pico por UART
+ * @param stats Puntero a estructura de estadísticas
+ */
+void statistics_print_history(Statistics *stats);
+
 #endif // STATISTICS_H
 
@@ -0,0 +1,128 @@
+/**
+ * @file telemetry.h
+ * @brief Telemetría binaria por UART (tramas COBS con CRC-32)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Cada trama viaja como 0x00 | COBS(carga útil | CRC-32) | 0x00. El 0x00
+ * inicial separa la trama de cualquier texto de printf que la preceda.
+ *
+ * Carga útil (little endian):
+ *   [0] versión del protocolo   [1] tipo de mensaje
+ *   [2] estación                [3] secuencia (mod 256)
+ *   [4..7] tick (ms)            [8..] cuerpo según el tipo
+ *
+ * El CRC-32 (IEEE 802.3) cubre encabezado y cuerpo.
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "config.h"
+#include "classifier.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// TIPOS DE MENSAJE
+// ============================================================================
+
+/**
+ * @brief Tipos de mensaje (el formato de cada cuerpo es fijo por versión)
+ */
+typedef enum {
+  TELEMETRY_MSG_ITEM = 1,      // Una clasificación (8 bytes)
+  TELEMETRY_MSG_STATS = 2,     // Contadores y percentiles (38 bytes)
+  TELEMETRY_MSG_LEVELS = 3,    // Nivel y llenado de los 4 contenedores (24 bytes)
+  TELEMETRY_MSG_PROFILE = 4,   // Tiempos del loop, guardado y cola (31 bytes)
+  TELEMETRY_MSG_DISPLAY = 5    // LEDs y texto de la pantalla (34 bytes)
+} TelemetryMessageType;
+
+#define TELEMETRY_NO_DEPOSIT    0xFF   // outcome de un ítem que no se intentó depositar
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+/**
+ * @brief Inicializa la cola de transmisión
+ */
+void telemetry_init(void);
+
+/**
+ * @brief Habilita o deshabilita la telemetría
+ * @param enabled true para transmitir tramas
+ */
+void telemetry_set_enabled(bool enabled);
+
+/**
+ * @brief Indica si la telemetría está habilitada
+ * @return true si se transmiten tramas
+ */
+bool telemetry_is_enabled(void);
+
+/**
+ * @brief Cambia el período de los mensajes periódicos
+ * @param period_ms Período en ms (0 = sólo eventos de ítem)
+ */
+void telemetry_set_period(uint32_t period_ms);
+
+/**
+ * @brief Envía los mensajes periódicos cuando vence el período
+ * @param stats Estadísticas del sistema
+ * @note Llamar en cada iteración del loop principal (no bloquea)
+ */
+void telemetry_service(Statistics *stats);
+
+/**
+ * @brief Registra la duración de una iteración del loop principal
+ * @param cycles Ciclos de CPU de la iteración (sin la espera final)
+ */
+void telemetry_record_loop(uint32_t cycles);
+
+/**
+ * @brief Envía el evento de una clasificación
+ * @param result Resultado de la clasificación
+ * @param digital Sensores digitales usados
+ * @param analog Sensores analógicos usados
+ * @param outcome DepositResult del depósito o TELEMETRY_NO_DEPOSIT
+ */
+void telemetry_send_item(const ClassificationResult *result, SensorDigitalData digital,
+                         SensorAnalogData analog, uint8_t outcome);
+
+/**
+ * @brief Bytes que todavía entran en la cola de transmisión
+ * @return Bytes libres
+ */
+uint16_t telemetry_tx_free(void);
+
+/**
+ * @brief Encola bytes sin trama en la cola de transmisión por interrupción
+ *
+ * Para salidas largas de la consola (volcado del registro) que no deben
+ * bloquear el loop. No depende de que la telemetría esté activada.
+ *
+ * @param data Bytes
+ * @param len Cantidad
+ * @return false sin encolar nada si no entran completos
+ */
+bool telemetry_write(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief Espera a que se vacíe la cola de transmisión
+ * @note La usa _write() para que el texto no se mezcle dentro de una trama
+ */
+void telemetry_wait_idle(void);
+
+/**
+ * @brief Avanza la cola al terminar un bloque (desde HAL_UART_TxCpltCallback)
+ */
+void telemetry_tx_complete(void);
+
+/**
+ * @brief Muestra tramas enviadas, descartadas, uso de la cola y tiempos
+ *        del loop desde el último mensaje de perfil
+ */
+void telemetry_show_status(void);
+
+#endif // TELEMETRY_H
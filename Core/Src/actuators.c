@@ -6,7 +6,62 @@
  */
 
 #include "actuators.h"
+#include "classifier.h"
+#include "fill_estimator.h"
+#include "flash_store.h"
+#include "params.h"
+#include "sensors.h"
+#include "servo_driver.h"
 #include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+typedef enum {
+  MOTION_FREE = 0,     // Slot libre
+  MOTION_PENDING,      // Esperando servo o dependencia
+  MOTION_ACTIVE,       // Servo en movimiento
+  MOTION_DONE          // Completado (se conserva el tick de fin)
+} MotionState;
+
+typedef struct {
+  MotionId id;
+  MotionId depends_on;
+  uint8_t servo;
+  uint8_t angle;
+  uint16_t duration_ms;
+  MotionState state;
+  uint8_t learn;         // MOTION_LEARN_*
+  bool measured;         // Ya se tomó la muestra de este paso
+  uint32_t start_tick;
+  uint32_t done_tick;
+} MotionSlot;
+
+typedef struct {
+  uint16_t envelope_ms;  // Envolvente superior de los tiempos medidos
+  uint8_t samples;       // Muestras acumuladas (satura en 255)
+  uint8_t reserved;
+} ServoTimingEntry;
+
+// Tabla persistente: recorrido por servo/ángulo y caída por contenedor
+// (el contenedor se identifica por el ángulo de la plataforma)
+typedef struct {
+  ServoTimingEntry travel[SERVO_COUNT][SERVO_TIMING_BUCKETS];
+  ServoTimingEntry drop[SERVO_TIMING_BUCKETS];
+} ServoTimingTable;
+
+// Alimentación PWM de cada servo
+typedef struct {
+  bool powered;          // Canal PWM habilitado
+  uint32_t on_since;     // Tick en que se habilitó
+  uint32_t last_active;  // Último tick con un comando activo o pendiente
+  uint32_t on_ms;        // Tiempo acumulado con PWM habilitado (cerrado)
+} ServoPower;
+
+#define SERVO_TIMING_VERSION    2   // Versión del registro en flash_store
 
 // ============================================================================
 // VARIABLES PRIVADAS
@@ -14,12 +69,30 @@
 
 static bool actuators_initialized = false;
 
-// Posiciones actuales de los servos
-static uint8_t platform_angle = SERVO_PLAT_HORIZONTAL;
-static uint8_t metal_cover_angle = SERVO_TAPA_CERRADA;
-static uint8_t papel_cover_angle = SERVO_TAPA_CERRADA;
-static uint8_t plastico_cover_angle = SERVO_TAPA_CERRADA;
-static uint8_t vidrio_cover_angle = SERVO_TAPA_CERRADA;
+// Posiciones actuales de los servos (índice = servo - 1)
+static uint8_t servo_angle[SERVO_COUNT];
+
+// Alimentación de los canales PWM (índice = servo - 1)
+static ServoPower servo_power[SERVO_COUNT];
+static uint32_t servo_power_start = 0;
+
+// Cola de movimientos
+static MotionSlot motion_queue[MOTION_QUEUE_SIZE];
+static MotionId motion_next_id = 1;
+static MotionStats motion_stats = {0};
+static uint32_t motion_script_start = 0;
+
+// Tiempos aprendidos
+static ServoTimingTable timing_table;
+static bool timing_dirty = false;
+static bool timing_calibrating = false;
+static uint32_t timing_last_save = 0;
+static bool calib_button_was_pressed = false;
+
+#define REST_SCRIPT_STEPS   SERVO_COUNT
+#define TEST_STEPS_PER_SERVO 4
+
+static void actuators_load_timing(void);
 
 // ============================================================================
 // INICIALIZACIÓN
@@ -28,28 +101,27 @@ static uint8_t vidrio_cover_angle = SERVO_TAPA_CERRADA;
 void actuators_init(void) {
   if (actuators_initialized) return;
   
+  actuators_initialized = true;
+  
+  // servo_driver_init() deja los canales habilitados
+  servo_power_start = HAL_GetTick();
+  for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+    servo_angle[i] = (uint8_t)((i + 1 == SERVO_ID_PLATAFORMA) ? params.plat_horizontal : params.tapa_cerrada);
+    servo_power[i].powered = servo_driver_is_enabled(i + 1);
+    servo_power[i].on_since = servo_power_start;
+    servo_power[i].last_active = servo_power_start;
+    servo_power[i].on_ms = 0;
+  }
+  
+  // Recuperar tiempos aprendidos
+  actuators_load_timing();
+  
   // Establecer posición de reposo
   actuators_set_rest_position();
   
-  actuators_initialized = true;
   printf("Actuadores inicializados\r\n");
 }
 
-// ============================================================================
-// CONVERSIÓN ÁNGULO A PWM
-// ============================================================================
-
-uint16_t actuators_angle_to_pwm(uint8_t angle) {
-  // Limitar ángulo a 0-180°
-  if (angle > 180) angle = 180;
-  
-  // Convertir ángulo a pulso PWM (1000-2000 us)
-  // 0° = 1000 us, 90° = 1500 us, 180° = 2000 us
-  uint16_t pulse = SERVO_MIN_PULSE + ((angle * (SERVO_MAX_PULSE - SERVO_MIN_PULSE)) / 180);
-  
-  return pulse;
-}
-
 // ============================================================================
 // MOVIMIENTO DE SERVOS
 // ============================================================================
@@ -60,189 +132,598 @@ bool actuators_move_servo(uint8_t servo, uint8_t angle) {
     return false;
   }
   
-  uint16_t pwm_value = actuators_angle_to_pwm(angle);
-  
-  switch (servo) {
-    case 1: // Plataforma (TIM1_CH1)
-      __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_1, pwm_value);
-      platform_angle = angle;
-      break;
-      
-    case 2: // Metal (TIM1_CH2)
-      __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_2, pwm_value);
-      metal_cover_angle = angle;
-      break;
-      
-    case 3: // Papel (TIM1_CH3)
-      __HAL_TIM_SET_COMPARE(&htim1, TIM_CHANNEL_3, pwm_value);
-      papel_cover_angle = angle;
-      break;
-      
-    case 4: // Plástico (TIM5_CH1) - CORREGIDO
-      __HAL_TIM_SET_COMPARE(&htim5, TIM_CHANNEL_1, pwm_value);
-      plastico_cover_angle = angle;
-      break;
-      
-    case 5: // Vidrio (TIM5_CH2) - CORREGIDO
-      __HAL_TIM_SET_COMPARE(&htim5, TIM_CHANNEL_2, pwm_value);
-      vidrio_cover_angle = angle;
-      break;
-      
-    default:
-      printf("Error: Servo %d no válido\r\n", servo);
-      return false;
+  // El driver convierte el ángulo a ticks según la base de tiempo de cada timer
+  if (!servo_driver_set_angle(servo, angle)) {
+    printf("Error: Servo %d no válido\r\n", servo);
+    return false;
+  }
+  
+  // Rehabilitar el canal si estaba liberado
+  ServoPower *power = &servo_power[servo - 1];
+  uint32_t now = HAL_GetTick();
+  power->last_active = now;
+  if (!power->powered) {
+    servo_driver_enable(servo);
+    power->powered = true;
+    power->on_since = now;
   }
   
+  servo_angle[servo - 1] = angle;
   return true;
 }
 
 // ============================================================================
-// MOVIMIENTO DE PLATAFORMA
+// LIBERACIÓN DE CANALES EN REPOSO
 // ============================================================================
 
-bool actuators_move_platform(uint8_t angle) {
-  printf("Moviendo plataforma a %d°\r\n", angle);
+// Deshabilita el PWM de los servos sin comandos tras params.servo_hold_ms
+static void actuators_power_gating(uint32_t now) {
+  bool in_use[SERVO_COUNT] = {false};
   
-  bool success = actuators_move_servo(1, angle);
-  if (success) {
-    HAL_Delay(SERVO_DELAY_TILT);
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *slot = &motion_queue[i];
+    if (slot->state == MOTION_PENDING || slot->state == MOTION_ACTIVE) {
+      in_use[slot->servo - 1] = true;
+    }
   }
   
-  return success;
+  for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+    ServoPower *power = &servo_power[i];
+    
+    // Un servo con comandos pendientes mantiene la posición (ej. tapa abierta)
+    if (in_use[i]) {
+      power->last_active = now;
+      continue;
+    }
+    
+    if (power->powered && (now - power->last_active) >= params.servo_hold_ms) {
+      servo_driver_disable(i + 1);
+      power->on_ms += now - power->on_since;
+      power->powered = false;
+    }
+  }
+}
+
+void actuators_release_all(void) {
+  uint32_t now = HAL_GetTick();
+  
+  for (uint8_t i = 0; i < SERVO_COUNT; i++) {
+    ServoPower *power = &servo_power[i];
+    if (power->powered) {
+      servo_driver_disable(i + 1);
+      power->on_ms += now - power->on_since;
+      power->powered = false;
+    }
+  }
+}
+
+uint32_t actuators_get_servo_on_ms(uint8_t servo) {
+  if (servo < 1 || servo > SERVO_COUNT) return 0;
+  
+  ServoPower *power = &servo_power[servo - 1];
+  uint32_t on_ms = power->on_ms;
+  if (power->powered) {
+    on_ms += HAL_GetTick() - power->on_since;
+  }
+  return on_ms;
 }
 
 // ============================================================================
-// CONTROL DE CONTENEDORES
+// PLANIFICADOR DE MOVIMIENTOS
 // ============================================================================
 
-bool actuators_open_container(MaterialType material) {
-  printf("Abriendo contenedor de %s\r\n", classifier_get_material_description(material));
+// Comparación de ids tolerante al desborde del contador
+static bool motion_id_before(MotionId a, MotionId b) {
+  return (int16_t)(a - b) < 0;
+}
+
+static bool motion_is_queued(MotionSlot *slot) {
+  return slot->state == MOTION_PENDING || slot->state == MOTION_ACTIVE;
+}
+
+static MotionSlot *motion_find(MotionId id) {
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    if (motion_queue[i].state != MOTION_FREE && motion_queue[i].id == id) {
+      return &motion_queue[i];
+    }
+  }
+  return NULL;
+}
+
+static uint8_t motion_free_slots(void) {
+  uint8_t free_slots = 0;
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    if (!motion_is_queued(&motion_queue[i])) free_slots++;
+  }
+  return free_slots;
+}
+
+// Busca un slot libre; si no hay, recicla el completado más antiguo
+static MotionSlot *motion_alloc(void) {
+  MotionSlot *oldest_done = NULL;
   
-  uint8_t servo = 0;
-  switch (material) {
-    case MATERIAL_METAL:    servo = 2; break;
-    case MATERIAL_PAPEL:    servo = 3; break;
-    case MATERIAL_PLASTICO: servo = 4; break;
-    case MATERIAL_VIDRIO:   servo = 5; break;
-    default:
-      printf("Error: Material no válido para contenedor\r\n");
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *slot = &motion_queue[i];
+    if (slot->state == MOTION_FREE) return slot;
+    if (slot->state == MOTION_DONE &&
+        (oldest_done == NULL || motion_id_before(slot->id, oldest_done->id))) {
+      oldest_done = slot;
+    }
+  }
+  
+  return oldest_done;
+}
+
+// Un comando puede arrancar si su servo está libre, no hay un comando
+// anterior del mismo servo esperando y su dependencia ya terminó
+static bool motion_can_start(MotionSlot *cmd) {
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *other = &motion_queue[i];
+    if (other == cmd || !motion_is_queued(other)) continue;
+    
+    if (other->servo == cmd->servo &&
+        (other->state == MOTION_ACTIVE || motion_id_before(other->id, cmd->id))) {
+      return false;
+    }
+    if (cmd->depends_on != MOTION_NO_DEPENDENCY && other->id == cmd->depends_on) {
       return false;
+    }
+  }
+  return true;
+}
+
+static MotionId motion_push(uint8_t servo, uint8_t angle, uint16_t duration_ms,
+                           MotionId depends_on, uint8_t learn) {
+  if (servo < 1 || servo > SERVO_COUNT) {
+    printf("Error: Servo %d no válido\r\n", servo);
+    return MOTION_NO_DEPENDENCY;
+  }
+  
+  MotionSlot *slot = motion_alloc();
+  if (slot == NULL) {
+    motion_stats.rejected++;
+    printf("Error: Cola de movimientos llena\r\n");
+    return MOTION_NO_DEPENDENCY;
   }
   
-  bool success = actuators_move_servo(servo, SERVO_TAPA_ABIERTA);
-  if (success) {
-    HAL_Delay(SERVO_DELAY_OPEN);
+  if (motion_stats.depth == 0) {
+    motion_script_start = HAL_GetTick();
   }
   
-  return success;
+  slot->id = motion_next_id++;
+  if (motion_next_id == MOTION_NO_DEPENDENCY) motion_next_id = 1;
+  slot->depends_on = depends_on;
+  slot->servo = servo;
+  slot->angle = (angle > 180) ? 180 : angle;
+  slot->duration_ms = duration_ms;
+  slot->state = MOTION_PENDING;
+  slot->learn = learn;
+  slot->measured = false;
+  slot->start_tick = 0;
+  slot->done_tick = 0;
+  
+  motion_stats.depth++;
+  if (motion_stats.depth > motion_stats.max_depth) {
+    motion_stats.max_depth = motion_stats.depth;
+  }
+  
+  return slot->id;
 }
 
-bool actuators_close_container(MaterialType material) {
-  printf("Cerrando contenedor de %s\r\n", classifier_get_material_description(material));
+MotionId actuators_enqueue(uint8_t servo, uint8_t angle, uint16_t duration_ms, MotionId depends_on) {
+  return motion_push(servo, angle, duration_ms, depends_on, MOTION_LEARN_NONE);
+}
+
+MotionId actuators_run_script(const MotionStep *steps, uint8_t count) {
+  MotionId ids[MOTION_QUEUE_SIZE];
   
-  uint8_t servo = 0;
-  switch (material) {
-    case MATERIAL_METAL:    servo = 2; break;
-    case MATERIAL_PAPEL:    servo = 3; break;
-    case MATERIAL_PLASTICO: servo = 4; break;
-    case MATERIAL_VIDRIO:   servo = 5; break;
-    default:
-      printf("Error: Material no válido para contenedor\r\n");
-      return false;
+  if (steps == NULL || count == 0 || count > MOTION_QUEUE_SIZE) {
+    return MOTION_NO_DEPENDENCY;
+  }
+  
+  // El script se encola completo o no se encola
+  if (motion_free_slots() < count) {
+    motion_stats.rejected += count;
+    printf("Error: Sin lugar en la cola para script de %d pasos\r\n", count);
+    return MOTION_NO_DEPENDENCY;
+  }
+  
+  for (uint8_t i = 0; i < count; i++) {
+    MotionId dep = MOTION_NO_DEPENDENCY;
+    if (steps[i].depends_on >= 0 && steps[i].depends_on < i) {
+      dep = ids[steps[i].depends_on];
+    }
+    ids[i] = motion_push(steps[i].servo, steps[i].angle, steps[i].duration_ms, dep, steps[i].learn);
+  }
+  
+  return ids[count - 1];
+}
+
+static void timing_learn(uint32_t now);
+static void timing_housekeeping(uint32_t now);
+
+void actuators_update(void) {
+  uint32_t now = HAL_GetTick();
+  
+  // Medir tiempos reales de los pasos marcados
+  timing_learn(now);
+  
+  // 1. Completar movimientos cuyo tiempo expiró
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *slot = &motion_queue[i];
+    if (slot->state == MOTION_ACTIVE && (now - slot->start_tick) >= slot->duration_ms) {
+      slot->state = MOTION_DONE;
+      slot->done_tick = now;
+      if (slot->learn == MOTION_LEARN_DROP && !slot->measured) {
+        // El sensor no vio la caída: se toma el fin de la espera
+        motion_stats.last_drop_tick = now;
+      }
+      motion_stats.depth--;
+      motion_stats.completed++;
+      motion_stats.last_completion_tick = now;
+      if (motion_stats.depth == 0) {
+        motion_stats.last_script_ms = now - motion_script_start;
+      }
+    }
   }
   
-  bool success = actuators_move_servo(servo, SERVO_TAPA_CERRADA);
-  if (success) {
-    HAL_Delay(SERVO_DELAY_CLOSE);
+  // 2. Arrancar todos los comandos independientes que estén listos
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *slot = &motion_queue[i];
+    if (slot->state == MOTION_PENDING && motion_can_start(slot)) {
+      actuators_move_servo(slot->servo, slot->angle);
+      slot->state = MOTION_ACTIVE;
+      slot->start_tick = now;
+    }
   }
   
-  return success;
+  // 3. Liberar canales PWM de servos en reposo
+  actuators_power_gating(now);
+  
+  // 4. Cierre de calibración y guardado del aprendizaje
+  timing_housekeeping(now);
+}
+
+bool actuators_is_busy(void) {
+  return motion_stats.depth > 0;
+}
+
+uint8_t actuators_get_queue_depth(void) {
+  return motion_stats.depth;
+}
+
+uint32_t actuators_get_completion_tick(MotionId id) {
+  MotionSlot *slot = motion_find(id);
+  if (slot == NULL || slot->state != MOTION_DONE) return 0;
+  return slot->done_tick;
+}
+
+MotionStats actuators_get_motion_stats(void) {
+  return motion_stats;
 }
 
 // ============================================================================
-// SECUENCIA COMPLETA DE DEPÓSITO
+// TIEMPOS APRENDIDOS
 // ============================================================================
 
-bool actuators_execute_deposit_sequence(MaterialType material) {
-  printf("Iniciando secuencia de depósito para %s\r\n", classifier_get_material_description(material));
+static uint8_t timing_bucket(uint8_t angle) {
+  uint8_t bucket = (angle + 22) / 45;
+  return (bucket < SERVO_TIMING_BUCKETS) ? bucket : SERVO_TIMING_BUCKETS - 1;
+}
+
+static uint16_t timing_worst_case(uint8_t servo, uint8_t angle) {
+  if (servo == SERVO_ID_PLATAFORMA) return (uint16_t)params.delay_inclinar_ms;
+  return (uint16_t)((angle >= params.tapa_abierta) ? params.delay_abrir_ms : params.delay_cerrar_ms);
+}
+
+// Envolvente + margen, acotada entre el mínimo y el peor caso
+static uint16_t timing_safe_delay(const ServoTimingEntry *entry, uint16_t worst, uint16_t floor) {
+  if (entry->samples < SERVO_TIMING_MIN_SAMPLES) return worst;
   
-  // 1. Mover plataforma a posición del material
-  uint8_t platform_angle = 0;
-  switch (material) {
-    case MATERIAL_METAL:    platform_angle = SERVO_PLAT_METAL; break;
-    case MATERIAL_PAPEL:    platform_angle = SERVO_PLAT_PAPEL; break;
-    case MATERIAL_PLASTICO: platform_angle = SERVO_PLAT_PLASTICO; break;
-    case MATERIAL_VIDRIO:   platform_angle = SERVO_PLAT_VIDRIO; break;
-    default:
-      printf("Error: Material no válido\r\n");
-      return false;
+  uint16_t margin = entry->envelope_ms / 4;
+  if (margin < SERVO_TIMING_MARGIN_MS) margin = SERVO_TIMING_MARGIN_MS;
+  
+  uint32_t delay = (uint32_t)entry->envelope_ms + margin;
+  if (delay < floor) delay = floor;
+  if (delay > worst) delay = worst;
+  
+  return (uint16_t)delay;
+}
+
+// Sube de inmediato ante una muestra más lenta y baja de a 1/8 ante una
+// más rápida, de modo que la envolvente sigue al peor caso reciente
+static void timing_record(ServoTimingEntry *entry, uint32_t sample_ms) {
+  if (sample_ms > 0xFFFF) sample_ms = 0xFFFF;
+  
+  if (entry->samples == 0 || sample_ms > entry->envelope_ms) {
+    entry->envelope_ms = (uint16_t)sample_ms;
+  } else {
+    entry->envelope_ms -= (entry->envelope_ms - sample_ms) / 8;
   }
   
-  if (!actuators_move_platform(platform_angle)) {
+  if (entry->samples < 255) entry->samples++;
+  timing_dirty = true;
+}
+
+static void timing_learn(uint32_t now) {
+  bool pressed = HAL_GPIO_ReadPin(CALIB_BUTTON_PORT, CALIB_BUTTON_PIN) == GPIO_PIN_RESET;
+  bool confirmed = pressed && !calib_button_was_pressed;
+  calib_button_was_pressed = pressed;
+  
+  for (uint8_t i = 0; i < MOTION_QUEUE_SIZE; i++) {
+    MotionSlot *slot = &motion_queue[i];
+    if (slot->state != MOTION_ACTIVE || slot->measured) continue;
+    
+    uint8_t bucket = timing_bucket(slot->angle);
+    
+    if (slot->learn == MOTION_LEARN_TRAVEL && confirmed) {
+      // El operador confirma que el servo llegó
+      timing_record(&timing_table.travel[slot->servo - 1][bucket], now - slot->start_tick);
+      slot->measured = true;
+    } else if (slot->learn == MOTION_LEARN_DROP && !sensors_read_digital().capacitivo) {
+      // El residuo dejó la plataforma
+      timing_record(&timing_table.drop[bucket], now - slot->start_tick);
+      slot->measured = true;
+      motion_stats.last_drop_tick = now;
+    }
+  }
+}
+
+static void timing_housekeeping(uint32_t now) {
+  if (motion_stats.depth > 0) return;
+  
+  if (timing_calibrating) {
+    timing_calibrating = false;
+    printf("Calibración de tiempos completada\r\n");
+    actuators_save_timing();
+    actuators_show_timing();
+  } else if (timing_dirty && (now - timing_last_save) >= SERVO_TIMING_SAVE_MS) {
+    // Guardar lo aprendido en operación sólo con los servos en reposo
+    actuators_save_timing();
+  }
+}
+
+static void actuators_load_timing(void) {
+  if (!flash_store_read_record(FLASH_RECORD_SERVO_TIMING, SERVO_TIMING_VERSION,
+                               &timing_table, sizeof(timing_table))) {
+    memset(&timing_table, 0, sizeof(timing_table));
+    printf("Tiempos de servos: usando valores por defecto\r\n");
+  } else {
+    printf("Tiempos de servos cargados desde Flash\r\n");
+  }
+  
+  timing_dirty = false;
+}
+
+bool actuators_save_timing(void) {
+  timing_last_save = HAL_GetTick();
+  
+  if (!flash_store_write_record(FLASH_RECORD_SERVO_TIMING, SERVO_TIMING_VERSION,
+                                &timing_table, sizeof(timing_table))) {
     return false;
   }
   
-  // 2. Abrir tapa del contenedor
-  if (!actuators_open_container(material)) {
+  timing_dirty = false;
+  printf("Tiempos de servos guardados en Flash\r\n");
+  return true;
+}
+
+void actuators_reset_timing(void) {
+  memset(&timing_table, 0, sizeof(timing_table));
+  timing_dirty = true;
+  printf("Tiempos de servos reseteados\r\n");
+}
+
+uint16_t actuators_get_move_delay(uint8_t servo, uint8_t angle) {
+  if (servo < 1 || servo > SERVO_COUNT) return (uint16_t)params.delay_inclinar_ms;
+  
+  const ServoTimingEntry *entry = &timing_table.travel[servo - 1][timing_bucket(angle)];
+  return timing_safe_delay(entry, timing_worst_case(servo, angle), 0);
+}
+
+static uint8_t actuators_platform_angle(MaterialType material) {
+  switch (material) {
+    case MATERIAL_METAL:    return (uint8_t)params.plat_metal;
+    case MATERIAL_PAPEL:    return (uint8_t)params.plat_papel;
+    case MATERIAL_PLASTICO: return (uint8_t)params.plat_plastico;
+    case MATERIAL_VIDRIO:   return (uint8_t)params.plat_vidrio;
+    default:                return (uint8_t)params.plat_horizontal;
+  }
+}
+
+uint16_t actuators_get_drop_delay(MaterialType material) {
+  const ServoTimingEntry *entry = &timing_table.drop[timing_bucket(actuators_platform_angle(material))];
+  return timing_safe_delay(entry, (uint16_t)params.delay_caida_ms, SERVO_TIMING_MIN_DROP_MS);
+}
+
+void actuators_calibrate_timing(void) {
+  printf("Calibración de tiempos: presione B1 cuando cada servo llegue a su posición\r\n");
+  
+  actuators_test_all_servos();
+  timing_calibrating = actuators_is_busy();
+}
+
+void actuators_show_timing(void) {
+  static const uint8_t bucket_angle[SERVO_TIMING_BUCKETS] = { 0, 45, 90, 135, 180 };
+  
+  printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
+  printf("║              TIEMPOS DE SERVOS (ms / muestras)           ║\r\n");
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║ Servo │    0°    │   45°    │   90°    │   135°   │  180° \r\n");
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    printf("║   %d   ", servo);
+    for (uint8_t b = 0; b < SERVO_TIMING_BUCKETS; b++) {
+      printf("│ %4d/%-3d ", actuators_get_move_delay(servo, bucket_angle[b]),
+             timing_table.travel[servo - 1][b].samples);
+    }
+    printf("\r\n");
+  }
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║ Caída: Metal %d | Papel %d | Plástico %d | Vidrio %d ms\r\n",
+         actuators_get_drop_delay(MATERIAL_METAL), actuators_get_drop_delay(MATERIAL_PAPEL),
+         actuators_get_drop_delay(MATERIAL_PLASTICO), actuators_get_drop_delay(MATERIAL_VIDRIO));
+  printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
+}
+
+// ============================================================================
+// MOVIMIENTO DE PLATAFORMA
+// ============================================================================
+
+bool actuators_move_platform(uint8_t angle) {
+  printf("Moviendo plataforma a %d°\r\n", angle);
+  
+  return actuators_enqueue(SERVO_ID_PLATAFORMA, angle, actuators_get_move_delay(SERVO_ID_PLATAFORMA, angle),
+                           MOTION_NO_DEPENDENCY) != MOTION_NO_DEPENDENCY;
+}
+
+// ============================================================================
+// CONTROL DE CONTENEDORES
+// ============================================================================
+
+static uint8_t actuators_container_servo(MaterialType material) {
+  switch (material) {
+    case MATERIAL_METAL:    return SERVO_ID_METAL;
+    case MATERIAL_PAPEL:    return SERVO_ID_PAPEL;
+    case MATERIAL_PLASTICO: return SERVO_ID_PLASTICO;
+    case MATERIAL_VIDRIO:   return SERVO_ID_VIDRIO;
+    default:                return 0;
+  }
+}
+
+bool actuators_open_container(MaterialType material) {
+  printf("Abriendo contenedor de %s\r\n", classifier_get_material_description(material));
+  
+  uint8_t servo = actuators_container_servo(material);
+  if (servo == 0) {
+    printf("Error: Material no válido para contenedor\r\n");
     return false;
   }
   
-  // 3. Esperar a que caiga el material
-  printf("Esperando caída del material...\r\n");
-  HAL_Delay(SERVO_DELAY_DROP);
+  uint8_t angle = (uint8_t)params.tapa_abierta;
+  return actuators_enqueue(servo, angle, actuators_get_move_delay(servo, angle),
+                           MOTION_NO_DEPENDENCY) != MOTION_NO_DEPENDENCY;
+}
+
+bool actuators_close_container(MaterialType material) {
+  printf("Cerrando contenedor de %s\r\n", classifier_get_material_description(material));
   
-  // 4. Cerrar tapa del contenedor
-  if (!actuators_close_container(material)) {
+  uint8_t servo = actuators_container_servo(material);
+  if (servo == 0) {
+    printf("Error: Material no válido para contenedor\r\n");
     return false;
   }
   
-  // 5. Regresar plataforma a posición horizontal
-  if (!actuators_move_platform(SERVO_PLAT_HORIZONTAL)) {
+  uint8_t angle = (uint8_t)params.tapa_cerrada;
+  return actuators_enqueue(servo, angle, actuators_get_move_delay(servo, angle),
+                           MOTION_NO_DEPENDENCY) != MOTION_NO_DEPENDENCY;
+}
+
+// ============================================================================
+// SECUENCIA COMPLETA DE DEPÓSITO
+// ============================================================================
+
+bool actuators_execute_deposit_sequence(MaterialType material) {
+  printf("Iniciando secuencia de depósito para %s\r\n", classifier_get_material_description(material));
+  
+  uint8_t cover = actuators_container_servo(material);
+  if (cover == 0) {
+    printf("Error: Material no válido\r\n");
     return false;
   }
+  uint8_t platform_angle = actuators_platform_angle(material);
+  uint8_t level_angle = (uint8_t)params.plat_horizontal;
+  uint8_t open_angle = (uint8_t)params.tapa_abierta;
+  uint8_t closed_angle = (uint8_t)params.tapa_cerrada;
   
-  printf("Secuencia de depósito completada\r\n");
-  return true;
+  // Tiempos más ajustados que se midieron para cada servo/ángulo
+  uint16_t tilt_ms  = actuators_get_move_delay(SERVO_ID_PLATAFORMA, platform_angle);
+  uint16_t open_ms  = actuators_get_move_delay(cover, open_angle);
+  uint16_t drop_ms  = actuators_get_drop_delay(material);
+  uint16_t close_ms = actuators_get_move_delay(cover, closed_angle);
+  uint16_t level_ms = actuators_get_move_delay(SERVO_ID_PLATAFORMA, level_angle);
+  
+  // Inclinar plataforma y abrir tapa en paralelo, esperar la caída con la
+  // plataforma inclinada, y luego cerrar tapa y nivelar en paralelo
+  const MotionStep deposit_script[] = {
+    /* 0 */ { SERVO_ID_PLATAFORMA, platform_angle,        tilt_ms,  MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_NONE },
+    /* 1 */ { cover,               open_angle,            open_ms,  MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_NONE },
+    /* 2 */ { SERVO_ID_PLATAFORMA, platform_angle,        drop_ms,  1,                         MOTION_LEARN_DROP },
+    /* 3 */ { cover,               closed_angle,          close_ms, 2,                         MOTION_LEARN_NONE },
+    /* 4 */ { SERVO_ID_PLATAFORMA, level_angle,           level_ms, 2,                         MOTION_LEARN_NONE },
+  };
+  
+  return actuators_run_script(deposit_script, sizeof(deposit_script) / sizeof(deposit_script[0]))
+         != MOTION_NO_DEPENDENCY;
 }
 
 // ============================================================================
 // DEPÓSITO DE MATERIAL (FUNCIÓN PRINCIPAL)
 // ============================================================================
 
-bool actuators_deposit_material(MaterialType material) {
+DepositResult actuators_deposit_material(MaterialType material) {
   if (!actuators_initialized) {
     printf("Error: Actuadores no inicializados\r\n");
-    return false;
+    return DEPOSIT_FAILED;
   }
   
   // Verificar que el material sea válido
   if (material == MATERIAL_DESCONOCIDO || material == MATERIAL_NINGUNO) {
     printf("Error: Material no válido para depósito\r\n");
-    return false;
+    return DEPOSIT_FAILED;
   }
   
-  // Ejecutar secuencia completa
-  return actuators_execute_deposit_sequence(material);
+  // Bloqueo de contenedor lleno (nivel en caché, sin medir ahora)
+  MaterialType target = material;
+  if (fill_is_full(material)) {
+    const char *name = classifier_get_material_description(material);
+    
+    switch ((BinFullPolicy)params.bin_politica) {
+      case BIN_POLICY_DIVERT:
+        target = fill_get_alternate_bin(material);
+        if (target == MATERIAL_NINGUNO) {
+          printf("Contenedor de %s lleno y sin alternativa\r\n", name);
+          return DEPOSIT_REJECTED;
+        }
+        printf("Contenedor de %s lleno: desviando a %s\r\n",
+               name, classifier_get_material_description(target));
+        break;
+        
+      case BIN_POLICY_HOLD:
+        printf("Contenedor de %s lleno: objeto retenido\r\n", name);
+        return DEPOSIT_HELD;
+        
+      default:
+        printf("Contenedor de %s lleno: depósito rechazado\r\n", name);
+        return DEPOSIT_REJECTED;
+    }
+  }
+  
+  // Encolar secuencia completa
+  if (!actuators_execute_deposit_sequence(target)) return DEPOSIT_FAILED;
+  
+  fill_record_deposit(target);
+  return (target == material) ? DEPOSIT_QUEUED : DEPOSIT_DIVERTED;
 }
 
 // ============================================================================
 // POSICIÓN DE REPOSO
 // ============================================================================
 
+// Posición de reposo: los 5 servos en paralelo
+static void actuators_rest_script(MotionStep *steps) {
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    uint32_t angle = (servo == SERVO_ID_PLATAFORMA) ? params.plat_horizontal : params.tapa_cerrada;
+    steps[servo - 1] = (MotionStep){ servo, (uint8_t)angle, (uint16_t)params.delay_reposo_ms,
+                                     MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_NONE };
+  }
+}
+
 void actuators_set_rest_position(void) {
   printf("Estableciendo posición de reposo...\r\n");
   
-  // Plataforma horizontal
-  actuators_move_servo(1, SERVO_PLAT_HORIZONTAL);
-  
-  // Todas las tapas cerradas
-  actuators_move_servo(2, SERVO_TAPA_CERRADA); // Metal
-  actuators_move_servo(3, SERVO_TAPA_CERRADA); // Papel
-  actuators_move_servo(4, SERVO_TAPA_CERRADA); // Plástico
-  actuators_move_servo(5, SERVO_TAPA_CERRADA); // Vidrio
-  
-  HAL_Delay(1000); // Esperar a que se posicionen
-  printf("Posición de reposo establecida\r\n");
+  MotionStep rest_script[REST_SCRIPT_STEPS];
+  actuators_rest_script(rest_script);
+  actuators_run_script(rest_script, REST_SCRIPT_STEPS);
 }
 
 // ============================================================================
@@ -254,45 +735,56 @@ void actuators_test_all_servos(void) {
   printf("║                PRUEBA DE SERVOMOTORES                    ║\r\n");
   printf("╚══════════════════════════════════════════════════════════╝\r\n");
   
-  // Probar cada servo individualmente
-  for (uint8_t servo = 1; servo <= 5; servo++) {
-    printf("Probando servo %d...\r\n", servo);
-    
-    // Mover a 0°
-    actuators_move_servo(servo, 0);
-    HAL_Delay(1000);
-    
-    // Mover a 90°
-    actuators_move_servo(servo, 90);
-    HAL_Delay(1000);
-    
-    // Mover a 180°
-    actuators_move_servo(servo, 180);
-    HAL_Delay(1000);
-    
-    // Regresar a 90°
-    actuators_move_servo(servo, 90);
-    HAL_Delay(500);
+  // Cada servo recorre 0° → 90° → 180° → 90°, uno después del otro,
+  // y al final todos vuelven a reposo
+  MotionStep test_script[SERVO_COUNT * TEST_STEPS_PER_SERVO + REST_SCRIPT_STEPS];
+  uint8_t n = 0;
+  
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    int8_t prev_last = (int8_t)n - 1;
+    test_script[n++] = (MotionStep){ servo, 0,   SERVO_DELAY_TEST,     prev_last,                 MOTION_LEARN_TRAVEL };
+    test_script[n++] = (MotionStep){ servo, 90,  SERVO_DELAY_TEST,     MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_TRAVEL };
+    test_script[n++] = (MotionStep){ servo, 180, SERVO_DELAY_TEST,     MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_TRAVEL };
+    test_script[n++] = (MotionStep){ servo, 90,  SERVO_DELAY_TEST / 2, MOTION_STEP_NO_DEPENDENCY, MOTION_LEARN_TRAVEL };
   }
   
-  // Regresar a posición de reposo
-  actuators_set_rest_position();
+  int8_t last_test = (int8_t)n - 1;
+  actuators_rest_script(&test_script[n]);
+  for (uint8_t i = 0; i < REST_SCRIPT_STEPS; i++) {
+    test_script[n++].depends_on = last_test;
+  }
   
-  printf("Prueba de servos completada\r\n");
+  if (actuators_run_script(test_script, n) != MOTION_NO_DEPENDENCY) {
+    printf("Prueba de servos encolada (%d pasos)\r\n", n);
+  }
 }
 
 void actuators_show_status(void) {
   printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
   printf("║                ESTADO DE ACTUADORES                      ║\r\n");
   printf("╠══════════════════════════════════════════════════════════╣\r\n");
-  printf("║ Servo 1 (Plataforma): %3d°\r\n", platform_angle);
-  printf("║ Servo 2 (Metal):      %3d°\r\n", metal_cover_angle);
-  printf("║ Servo 3 (Papel):      %3d°\r\n", papel_cover_angle);
-  printf("║ Servo 4 (Plástico):   %3d°\r\n", plastico_cover_angle);
-  printf("║ Servo 5 (Vidrio):     %3d°\r\n", vidrio_cover_angle);
+  printf("║ Servo 1 (Plataforma): %3d°\r\n", servo_angle[SERVO_ID_PLATAFORMA - 1]);
+  printf("║ Servo 2 (Metal):      %3d°\r\n", servo_angle[SERVO_ID_METAL - 1]);
+  printf("║ Servo 3 (Papel):      %3d°\r\n", servo_angle[SERVO_ID_PAPEL - 1]);
+  printf("║ Servo 4 (Plástico):   %3d°\r\n", servo_angle[SERVO_ID_PLASTICO - 1]);
+  printf("║ Servo 5 (Vidrio):     %3d°\r\n", servo_angle[SERVO_ID_VIDRIO - 1]);
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║ Cola: %d (máx %d) | Completados: %lu | Rechazados: %lu\r\n",
+         motion_stats.depth, motion_stats.max_depth,
+         motion_stats.completed, motion_stats.rejected);
+  printf("║ Último script: %lu ms | Último fin: tick %lu\r\n",
+         motion_stats.last_script_ms, motion_stats.last_completion_tick);
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  uint32_t uptime_ms = HAL_GetTick() - servo_power_start;
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    uint32_t on_ms = actuators_get_servo_on_ms(servo);
+    uint32_t duty = uptime_ms ? (uint32_t)(((uint64_t)on_ms * 100) / uptime_ms) : 100;
+    printf("║ PWM servo %d: %s | Activo %lu s (%lu%%)\r\n", servo,
+           servo_power[servo - 1].powered ? "ON " : "OFF", on_ms / 1000, duty);
+  }
   printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
 }
 
 // ============================================================================
 // FIN DEL ARCHIVO
-// ============================================================================
\ No newline at end of file
+// ============================================================================
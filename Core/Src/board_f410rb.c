@@ -0,0 +1,423 @@
+/**
+ * @file board_f410rb.c
+ * @brief Placa Nucleo STM32F410RB: relojes, ADC, Flash, I2C, consola y energía
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "board.h"
+
+#if defined(BOARD_F410RB)
+
+#include "main.h"
+#include "adc.h"
+#include "dma.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "tim.h"
+#include "usart.h"
+#include "config.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// RELOJES E INICIALIZACIÓN
+// ============================================================================
+
+// HSI 16 MHz → PLL → SYSCLK 100 MHz, APB1 50 MHz, APB2 100 MHz
+static void board_clock_config(void) {
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  
+  /** Configure the main internal regulator output voltage
+  */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+  
+  /** Initializes the RCC Oscillators according to the specified parameters
+  * in the RCC_OscInitTypeDef structure.
+  */
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+  RCC_OscInitStruct.PLL.PLLM = 8;
+  RCC_OscInitStruct.PLL.PLLN = 100;
+  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
+  RCC_OscInitStruct.PLL.PLLQ = 4;
+  RCC_OscInitStruct.PLL.PLLR = 2;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  
+  /** Initializes the CPU, AHB and APB buses clocks
+  */
+  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
+                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+  
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_3) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+// ============================================================================
+// CÓDIGO EN RAM
+// ============================================================================
+
+#if !defined(BOARD_NO_RAM_CODE)
+extern const uint32_t g_pfnVectors[];   // startup_stm32f410rbtx.s
+static uint32_t ram_vectors[BOARD_VECTOR_COUNT] __attribute__((aligned(BOARD_VECTOR_ALIGN)));
+
+// Con la tabla en la Flash, entrar a cualquier interrupción durante un
+// borrado esperaría a que termine aunque el handler esté en la RAM
+static void board_ram_vectors(void) {
+  memcpy(ram_vectors, g_pfnVectors, sizeof(ram_vectors));
+  
+  __disable_irq();
+  SCB->VTOR = (uint32_t)(uintptr_t)ram_vectors;
+  __DSB();
+  __enable_irq();
+}
+#endif
+
+// Reemplaza a la de la HAL (__weak, en la Flash)
+BOARD_RAM_FUNC void HAL_IncTick(void) {
+  uwTick += (uint32_t)uwTickFreq;
+}
+
+void board_init(void) {
+#if !defined(BOARD_NO_RAM_CODE)
+  board_ram_vectors();
+#endif
+  board_clock_config();
+  
+  // Periféricos generados por CubeMX (adc.c, tim.c, i2c.c, usart.c...)
+  MX_GPIO_Init();
+  MX_DMA_Init();
+  MX_ADC1_Init();
+  MX_I2C1_Init();
+  MX_TIM1_Init();
+  MX_TIM5_Init();        // TIM5 en lugar de TIM4
+  MX_USART1_UART_Init(); // USART1 en lugar de USART2
+}
+
+const char *board_name(void) {
+  return BOARD_NAME;
+}
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+// DMA2 Stream 0 en modo circular: el buffer se actualiza solo
+void board_adc_start(uint16_t *buffer, uint16_t count) {
+  HAL_ADC_Start_DMA(&hadc1, (uint32_t *)buffer, count);
+}
+
+// Los callbacks de medio buffer y buffer completo están vacíos: alcanza con
+// limpiar las banderas. FIFO desactivada, así que FEIF0 no es un error
+BOARD_RAM_FUNC bool board_adc_dma_irq(void) {
+  uint32_t flags = DMA2->LISR & (DMA_LISR_TCIF0 | DMA_LISR_HTIF0 | DMA_LISR_TEIF0 |
+                                 DMA_LISR_DMEIF0 | DMA_LISR_FEIF0);
+  
+  if (flags & (DMA_LISR_TEIF0 | DMA_LISR_DMEIF0)) return false;
+  
+  DMA2->LIFCR = flags;  // Mismas posiciones en LIFCR
+  return true;
+}
+
+// ============================================================================
+// FLASH (sectores 0-3 de 16 KB y sector 4 de 64 KB)
+// ============================================================================
+
+static uint32_t board_flash_sector(uint32_t address) {
+  if (address < 0x08004000) return FLASH_SECTOR_0;
+  if (address < 0x08008000) return FLASH_SECTOR_1;
+  if (address < 0x0800C000) return FLASH_SECTOR_2;
+  if (address < 0x08010000) return FLASH_SECTOR_3;
+  return FLASH_SECTOR_4;
+}
+
+#define BOARD_FLASH_ERRORS  (FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+
+static uint32_t erase_last_us = 0;
+static uint32_t erase_last_ticks = 0;
+static uint32_t erase_count = 0;
+
+// Lo que las IRQ en RAM dejaron frenado durante el borrado
+static volatile bool erase_active = false;
+static volatile bool pvd_pending = false;
+static volatile uint32_t console_held = 0;   // Bits de USART1->CR1
+static volatile uint32_t i2c_held = 0;       // Bits de I2C1->CR2
+
+// Leer la Flash (instrucciones o datos) durante un borrado frena el bus
+// hasta que termina: la espera tiene que correr desde la RAM
+BOARD_RAM_FUNC static uint32_t board_flash_erase_sector(uint32_t sector) {
+  while (FLASH->SR & FLASH_SR_BSY) { }
+  
+  FLASH->CR = (FLASH->CR & ~(FLASH_CR_PSIZE | FLASH_CR_SNB)) |
+              FLASH_PSIZE_WORD | FLASH_CR_SER | (sector << FLASH_CR_SNB_Pos);
+  FLASH->CR |= FLASH_CR_STRT;
+  
+  while (FLASH->SR & FLASH_SR_BSY) { }
+  
+  FLASH->CR &= ~(FLASH_CR_SER | FLASH_CR_SNB);
+  return FLASH->SR & BOARD_FLASH_ERRORS;
+}
+
+// Las caches del ART pueden tener copias de lo que se acaba de borrar
+static void board_flash_flush_caches(void) {
+  if (FLASH->ACR & FLASH_ACR_ICEN) {
+    __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+    __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+    __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+  }
+  if (FLASH->ACR & FLASH_ACR_DCEN) {
+    __HAL_FLASH_DATA_CACHE_DISABLE();
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+  }
+}
+
+// Apaga en el NVIC todo menos BOARD_RAM_IRQS: una IRQ con el handler en la
+// Flash frenaría al núcleo (y a SysTick) hasta el final del borrado
+static void board_irq_mask_for_erase(uint32_t *enabled, uint32_t words) {
+  static const IRQn_Type ram_irqs[] = BOARD_RAM_IRQS;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  erase_active = true;
+  for (uint32_t i = 0; i < words; i++) {
+    uint32_t keep = 0;
+    for (uint32_t n = 0; n < sizeof(ram_irqs) / sizeof(ram_irqs[0]); n++) {
+      if (((uint32_t)ram_irqs[n] >> 5) == i) keep |= 1u << ((uint32_t)ram_irqs[n] & 31u);
+    }
+    enabled[i] = NVIC->ISER[i];
+    NVIC->ICER[i] = enabled[i] & ~keep;
+  }
+  __DSB();
+  __ISB();
+  
+  __set_PRIMASK(primask);
+}
+
+// Devuelve a la HAL lo que frenaron las IRQ en RAM: la transmisión de la
+// consola, I2C1 y el aviso del PVD (que vuelve a entrar como pendiente)
+static void board_irq_restore(const uint32_t *enabled, uint32_t words) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  erase_active = false;
+  erase_count++;
+  huart1.Instance->CR1 |= console_held;
+  hi2c1.Instance->CR2 |= i2c_held;
+  console_held = 0;
+  i2c_held = 0;
+  
+  for (uint32_t i = 0; i < words; i++) {
+    NVIC->ISER[i] = enabled[i];
+  }
+  if (pvd_pending) HAL_NVIC_SetPendingIRQ(PVD_IRQn);
+  
+  __set_PRIMASK(primask);
+}
+
+bool board_flash_erase(uint32_t address, uint32_t size) {
+  uint32_t enabled[sizeof(NVIC->ISER) / sizeof(NVIC->ISER[0])];
+  uint32_t words = sizeof(enabled) / sizeof(enabled[0]);
+  uint32_t errors = 0;
+  
+  // Nunca un sector de código (ver STM32F410RBTX_FLASH.ld)
+  if (size == 0 || address < BOARD_FLASH_DATA_START || address + size > BOARD_FLASH_DATA_END) return false;
+  
+  uint32_t first = board_flash_sector(address);
+  uint32_t last = board_flash_sector(address + size - 1);
+  uint32_t start = profiler_cycles();
+  uint32_t start_tick = HAL_GetTick();
+  
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(BOARD_FLASH_ERRORS);  // Un error viejo bloquea la operación
+  board_irq_mask_for_erase(enabled, words);
+  
+  for (uint32_t sector = first; sector <= last && errors == 0; sector++) {
+    errors = board_flash_erase_sector(sector);
+  }
+  
+  board_irq_restore(enabled, words);
+  HAL_FLASH_Lock();
+  board_flash_flush_caches();
+  
+  erase_last_us = profiler_cycles_to_us(profiler_cycles() - start);
+  erase_last_ticks = HAL_GetTick() - start_tick;
+  
+  if (errors != 0) {
+    printf("Error borrando Flash: 0x%02lX\r\n", errors);
+    return false;
+  }
+  
+  return true;
+}
+
+void board_flash_erase_timing(uint32_t *duration_us, uint32_t *tick_ms) {
+  *duration_us = erase_last_us;
+  *tick_ms = erase_last_ticks;
+}
+
+uint32_t board_flash_erase_count(void) {
+  return erase_count;
+}
+
+// De a palabra donde se puede (4x menos operaciones) y de a byte en los bordes
+bool board_flash_program(uint32_t address, const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  HAL_StatusTypeDef status = HAL_OK;
+  uint32_t offset = 0;
+  
+  HAL_FLASH_Unlock();
+  
+  while (offset < len && status == HAL_OK) {
+    uint32_t target = address + offset;
+    if ((target & 3u) == 0 && len - offset >= 4) {
+      uint32_t word;
+      memcpy(&word, &bytes[offset], 4);
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, target, word);
+      offset += 4;
+    } else {
+      status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_BYTE, target, bytes[offset]);
+      offset++;
+    }
+  }
+  
+  HAL_FLASH_Lock();
+  
+  if (status != HAL_OK) {
+    printf("Error escribiendo Flash: %d\r\n", status);
+    return false;
+  }
+  
+  return true;
+}
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+// Cambiar la velocidad sólo reprograma CCR/TRISE: HAL_I2C_Init no vuelve a
+// llamar a la MspInit con el periférico ya inicializado
+void board_i2c_set_speed(uint32_t speed_hz) {
+  hi2c1.Init.ClockSpeed = speed_hz;
+  hi2c1.Init.DutyCycle = I2C_DUTYCYCLE_2;
+  HAL_I2C_Init(&hi2c1);
+}
+
+uint32_t board_i2c_get_speed(void) {
+  return hi2c1.Init.ClockSpeed;
+}
+
+#define BOARD_I2C_IRQ_BITS  (I2C_CR2_ITEVTEN | I2C_CR2_ITBUFEN | I2C_CR2_ITERREN)
+
+// Con SB, ADDR, BTF o RXNE sin atender el maestro estira SCL: el esclavo espera
+BOARD_RAM_FUNC bool board_i2c_irq_hold(void) {
+  if (!erase_active) return false;
+  
+  i2c_held |= hi2c1.Instance->CR2 & BOARD_I2C_IRQ_BITS;
+  hi2c1.Instance->CR2 &= ~BOARD_I2C_IRQ_BITS;
+  return true;
+}
+
+// ============================================================================
+// CONSOLA (USART1)
+// ============================================================================
+
+void board_console_write(const uint8_t *data, uint16_t len) {
+  HAL_UART_Transmit(&huart1, (uint8_t *)data, len, HAL_MAX_DELAY);
+}
+
+void board_console_rx_enable(void) {
+  if ((huart1.Instance->CR1 & USART_CR1_RXNEIE) == 0) {
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_RXNE);
+  }
+  if ((huart1.Instance->CR1 & USART_CR1_IDLEIE) == 0) {
+    __HAL_UART_ENABLE_IT(&huart1, UART_IT_IDLE);
+  }
+}
+
+BOARD_RAM_FUNC uint8_t board_console_irq(uint8_t *byte) {
+  uint32_t sr = huart1.Instance->SR;
+  uint8_t events = 0;
+  
+  // Leer SR y luego DR limpia RXNE, IDLE y los errores (ORE/NE/FE)
+  if (sr & (USART_SR_RXNE | USART_SR_ORE | USART_SR_IDLE)) {
+    *byte = (uint8_t)(huart1.Instance->DR & 0xFF);
+    if (sr & USART_SR_RXNE) events |= BOARD_CONSOLE_RX;
+    if (sr & USART_SR_IDLE) events |= BOARD_CONSOLE_IDLE;
+  }
+  
+  return events;
+}
+
+// TXE y TC quedan levantados sin interrupción; la recepción sigue (shell_uart_irq)
+BOARD_RAM_FUNC bool board_console_tx_hold(void) {
+  if (!erase_active) return false;
+  
+  console_held |= huart1.Instance->CR1 & (USART_CR1_TXEIE | USART_CR1_TCIE);
+  huart1.Instance->CR1 &= ~(USART_CR1_TXEIE | USART_CR1_TCIE);
+  return true;
+}
+
+// ============================================================================
+// ALIMENTACIÓN
+// ============================================================================
+
+void board_pvd_enable(void) {
+  PWR_PVDTypeDef pvd_config = {0};
+  pvd_config.PVDLevel = BOARD_PVD_LEVEL;
+  pvd_config.Mode = PWR_PVD_MODE_IT_RISING;  // PVDO sube cuando VDD baja del umbral
+  HAL_PWR_ConfigPVD(&pvd_config);
+  HAL_PWR_EnablePVD();
+  HAL_NVIC_SetPriority(PVD_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(PVD_IRQn);
+}
+
+#define BOARD_SERVO_OUTPUTS  (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)
+
+// Lo mismo que HAL_TIM_PWM_Stop en cada canal, sin salir de la RAM
+BOARD_RAM_FUNC static void board_servo_outputs_off(void) {
+  BOARD_SERVO_TIM_A.Instance->CCER &= ~BOARD_SERVO_OUTPUTS;
+  BOARD_SERVO_TIM_B.Instance->CCER &= ~BOARD_SERVO_OUTPUTS;
+}
+
+// Reemplaza a HAL_PWR_PVD_IRQHandler. Durante un borrado no se puede
+// programar la Flash: los servos se cortan ya y el guardado espera al final
+BOARD_RAM_FUNC void board_pvd_irq(void) {
+  if (__HAL_PWR_PVD_EXTI_GET_FLAG()) {
+    __HAL_PWR_PVD_EXTI_CLEAR_FLAG();
+    pvd_pending = true;
+  }
+  if (!pvd_pending) return;
+  
+  if (erase_active) {
+    board_servo_outputs_off();
+    return;
+  }
+  pvd_pending = false;
+  board_power_fail();
+}
+
+// Modo Sleep: el núcleo se detiene y los periféricos (DMA, UART, I2C) siguen
+void board_sleep_ms(uint32_t ms) {
+  uint32_t start = HAL_GetTick();
+  while (HAL_GetTick() - start < ms) {
+    HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+  }
+}
+
+#endif // BOARD_F410RB
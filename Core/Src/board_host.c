@@ -0,0 +1,195 @@
+/**
+ * @file board_host.c
+ * @brief Placa de PC: Flash de datos en RAM y periféricos simulados
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "board.h"
+
+#if defined(BOARD_HOST)
+
+#include "config.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// ============================================================================
+// VARIABLES
+// ============================================================================
+
+GPIO_TypeDef board_host_gpio[3];
+ADC_HandleTypeDef hadc1;
+I2C_HandleTypeDef hi2c1;
+TIM_HandleTypeDef htim1;
+TIM_HandleTypeDef htim2;
+UART_HandleTypeDef huart1;
+
+static uint8_t *flash = NULL;
+static uint32_t flash_violations = 0;
+static uint32_t flash_units_left = UINT32_MAX;  // Unidades hasta el corte simulado
+static uint32_t flash_erases = 0;
+static uint32_t i2c_speed_hz = I2C_BUS_SPEED_FAST;
+static uint16_t *adc_buffer = NULL;
+static uint16_t adc_count = 0;
+
+// ============================================================================
+// INICIALIZACIÓN
+// ============================================================================
+
+void board_init(void) {
+  if (flash != NULL) return;
+  
+  // En la misma dirección que en el chip: los módulos guardan direcciones
+  // de Flash en uint32_t y las leen por puntero
+  void *region = mmap((void *)(uintptr_t)BOARD_FLASH_BASE, BOARD_FLASH_SIZE,
+                      PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE,
+                      -1, 0);
+  if (region != (void *)(uintptr_t)BOARD_FLASH_BASE) {
+    fprintf(stderr, "No se pudo mapear la Flash simulada en 0x%08X\n", BOARD_FLASH_BASE);
+    return;
+  }
+  
+  flash = region;
+  memset(flash, 0xFF, BOARD_FLASH_SIZE);
+}
+
+const char *board_name(void) {
+  return BOARD_NAME;
+}
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+void board_adc_start(uint16_t *buffer, uint16_t count) {
+  adc_buffer = buffer;
+  adc_count = count;
+  memset(buffer, 0, count * sizeof(uint16_t));
+}
+
+// En la PC no hay DMA: el buffer lo cargan las herramientas
+bool board_adc_dma_irq(void) {
+  return true;
+}
+
+void board_host_set_analog(uint8_t index, uint16_t value) {
+  if (adc_buffer != NULL && index < adc_count) adc_buffer[index] = value;
+}
+
+// ============================================================================
+// FLASH
+// ============================================================================
+
+static bool board_flash_in_range(uint32_t address, uint32_t len) {
+  return flash != NULL && address >= BOARD_FLASH_BASE &&
+         address - BOARD_FLASH_BASE + len <= BOARD_FLASH_SIZE;
+}
+
+bool board_flash_erase(uint32_t address, uint32_t size) {
+  if (size == 0 || flash == NULL || address < BOARD_FLASH_DATA_START || address + size > BOARD_FLASH_DATA_END) return false;
+  
+  uint32_t first = (address - BOARD_FLASH_BASE) / BOARD_FLASH_ERASE_UNIT;
+  uint32_t last = (address - BOARD_FLASH_BASE + size - 1) / BOARD_FLASH_ERASE_UNIT;
+  memset(&flash[first * BOARD_FLASH_ERASE_UNIT], 0xFF,
+         (last - first + 1) * BOARD_FLASH_ERASE_UNIT);
+  flash_erases++;
+  return true;
+}
+
+// El borrado simulado es instantáneo
+void board_flash_erase_timing(uint32_t *duration_us, uint32_t *tick_ms) {
+  *duration_us = 0;
+  *tick_ms = 0;
+}
+
+uint32_t board_flash_erase_count(void) {
+  return flash_erases;
+}
+
+bool board_flash_program(uint32_t address, const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  uint32_t padded = (len + BOARD_FLASH_WRITE_UNIT - 1) / BOARD_FLASH_WRITE_UNIT * BOARD_FLASH_WRITE_UNIT;
+  
+  if (address % BOARD_FLASH_WRITE_UNIT != 0 || !board_flash_in_range(address, padded)) {
+    flash_violations++;
+    return false;
+  }
+  
+  // Como en la L4 (ECC): sólo se programa una unidad completamente borrada
+  uint8_t *cell = &flash[address - BOARD_FLASH_BASE];
+  for (uint32_t i = 0; i < padded; i++) {
+    if (cell[i] != 0xFF) {
+      flash_violations++;
+      return false;
+    }
+  }
+  
+  for (uint32_t i = 0; i < padded; i++) {
+    // Un corte puede caer entre dos unidades de la misma llamada
+    if (i % BOARD_FLASH_WRITE_UNIT == 0 && flash_units_left != UINT32_MAX) {
+      if (flash_units_left == 0) return false;
+      flash_units_left--;
+    }
+    cell[i] = (i < len) ? bytes[i] : 0xFF;
+  }
+  return true;
+}
+
+uint32_t board_host_flash_violations(void) {
+  return flash_violations;
+}
+
+void board_host_flash_cut_after(uint32_t units) {
+  flash_units_left = units;
+}
+
+void board_host_power_restore(void) {
+  flash_units_left = UINT32_MAX;
+}
+
+// ============================================================================
+// I2C, CONSOLA Y ALIMENTACIÓN
+// ============================================================================
+
+void board_i2c_set_speed(uint32_t speed_hz) {
+  i2c_speed_hz = speed_hz;
+}
+
+uint32_t board_i2c_get_speed(void) {
+  return i2c_speed_hz;
+}
+
+// El borrado simulado no deja nada frenado
+bool board_i2c_irq_hold(void) {
+  return false;
+}
+
+void board_console_write(const uint8_t *data, uint16_t len) {
+  fwrite(data, 1, len, stdout);
+}
+
+void board_console_rx_enable(void) {
+}
+
+uint8_t board_console_irq(uint8_t *byte) {
+  (void)byte;
+  return 0;
+}
+
+bool board_console_tx_hold(void) {
+  return false;
+}
+
+void board_pvd_enable(void) {
+}
+
+// En la PC no hay PVD: los cortes se simulan con board_host_flash_cut_after
+void board_pvd_irq(void) {
+}
+
+void board_sleep_ms(uint32_t ms) {
+  HAL_Delay(ms);
+}
+
+#endif // BOARD_HOST
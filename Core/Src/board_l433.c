@@ -0,0 +1,559 @@
+/**
+ * @file board_l433.c
+ * @brief Placa Nucleo STM32L433RC-P: relojes, ADC, Flash, I2C, consola y energía
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * No hay proyecto CubeMX de la L433 con todos los periféricos: se
+ * inicializan acá con la HAL y los pines/relojes van en las MspInit de
+ * stm32l4xx_hal_msp.c.
+ */
+
+#include "board.h"
+
+#if defined(BOARD_L433)
+
+#include "main.h"
+#include "config.h"
+#include "profiler.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// HANDLES
+// ============================================================================
+
+ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+I2C_HandleTypeDef hi2c1;
+TIM_HandleTypeDef htim1;
+TIM_HandleTypeDef htim2;
+UART_HandleTypeDef huart2;
+
+// TIMINGR de I2C1 con PCLK1 = 80 MHz (valores de CubeMX, filtro analógico)
+#define BOARD_I2C_TIMING_100K       0x10909CEC
+#define BOARD_I2C_TIMING_400K       0x00702991
+
+static uint32_t i2c_speed_hz = I2C_BUS_SPEED_FAST;
+
+void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);  // stm32l4xx_hal_msp.c
+
+// ============================================================================
+// RELOJES
+// ============================================================================
+
+// HSI 16 MHz → PLL → SYSCLK 80 MHz, APB1 y APB2 80 MHz. El ADC usa PLLSAI1
+// (misma fuente HSI, ver HAL_ADC_MspInit)
+static void board_clock_config(void) {
+  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
+  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  
+  if (HAL_PWREx_ControlVoltageScaling(PWR_REGULATOR_VOLTAGE_SCALE1) != HAL_OK) {
+    Error_Handler();
+  }
+  
+  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
+  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
+  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+  RCC_OscInitStruct.PLL.PLLM = 1;
+  RCC_OscInitStruct.PLL.PLLN = 10;
+  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV7;
+  RCC_OscInitStruct.PLL.PLLQ = RCC_PLLQ_DIV2;
+  RCC_OscInitStruct.PLL.PLLR = RCC_PLLR_DIV2;
+  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK) {
+    Error_Handler();
+  }
+  
+  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK |
+                                RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_4) != HAL_OK) {
+    Error_Handler();
+  }
+}
+
+// ============================================================================
+// PERIFÉRICOS
+// ============================================================================
+
+// ADC1: los 4 canales en secuencia continua, cada resultado es el promedio
+// de 16 conversiones hecho por el sobremuestreador (sin costo de CPU)
+static void board_adc_init(void) {
+  ADC_ChannelConfTypeDef sConfig = {0};
+  static const uint32_t channels[ADC_BUFFER_SIZE] = {
+    ADC_CHANNEL_LDR, ADC_CHANNEL_MIC, ADC_CHANNEL_EXTRA1, ADC_CHANNEL_EXTRA2
+  };
+  static const uint32_t ranks[ADC_BUFFER_SIZE] = {
+    ADC_REGULAR_RANK_1, ADC_REGULAR_RANK_2, ADC_REGULAR_RANK_3, ADC_REGULAR_RANK_4
+  };
+  
+  hadc1.Instance = ADC1;
+  hadc1.Init.ClockPrescaler = ADC_CLOCK_ASYNC_DIV1;
+  hadc1.Init.Resolution = ADC_RESOLUTION_12B;
+  hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+  hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
+  hadc1.Init.EOCSelection = ADC_EOC_SEQ_CONV;
+  hadc1.Init.LowPowerAutoWait = DISABLE;
+  hadc1.Init.ContinuousConvMode = ENABLE;
+  hadc1.Init.NbrOfConversion = ADC_BUFFER_SIZE;
+  hadc1.Init.DiscontinuousConvMode = DISABLE;
+  hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+  hadc1.Init.ExternalTrigConvEdge = ADC_EXTERNALTRIGCONVEDGE_NONE;
+  hadc1.Init.DMAContinuousRequests = ENABLE;
+  hadc1.Init.Overrun = ADC_OVR_DATA_OVERWRITTEN;
+  hadc1.Init.OversamplingMode = ENABLE;
+  hadc1.Init.Oversampling.Ratio = BOARD_ADC_OVERSAMPLING;
+  hadc1.Init.Oversampling.RightBitShift = BOARD_ADC_OVERSAMPLING_SHIFT;
+  hadc1.Init.Oversampling.TriggeredMode = ADC_TRIGGEREDMODE_SINGLE_TRIGGER;
+  hadc1.Init.Oversampling.OversamplingStopReset = ADC_REGOVERSAMPLING_CONTINUED_MODE;
+  if (HAL_ADC_Init(&hadc1) != HAL_OK) {
+    Error_Handler();
+  }
+  
+  sConfig.SamplingTime = ADC_SAMPLETIME_47CYCLES_5;
+  sConfig.SingleDiff = ADC_SINGLE_ENDED;
+  sConfig.OffsetNumber = ADC_OFFSET_NONE;
+  sConfig.Offset = 0;
+  for (uint8_t i = 0; i < ADC_BUFFER_SIZE; i++) {
+    sConfig.Channel = channels[i];
+    sConfig.Rank = ranks[i];
+    if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK) {
+      Error_Handler();
+    }
+  }
+  
+  // Calibración de offset antes de la primera conversión
+  HAL_ADCEx_Calibration_Start(&hadc1, ADC_SINGLE_ENDED);
+}
+
+static void board_servo_timer_init(TIM_HandleTypeDef *htim, TIM_TypeDef *instance,
+                                   uint8_t channels) {
+  TIM_OC_InitTypeDef sConfigOC = {0};
+  static const uint32_t tim_channels[3] = { TIM_CHANNEL_1, TIM_CHANNEL_2, TIM_CHANNEL_3 };
+  
+  // Prescaler y período definitivos los calcula servo_driver_init()
+  htim->Instance = instance;
+  htim->Init.Prescaler = 79;
+  htim->Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim->Init.Period = SERVO_PWM_PERIOD_US - 1;
+  htim->Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim->Init.RepetitionCounter = 0;
+  htim->Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_PWM_Init(htim) != HAL_OK) {
+    Error_Handler();
+  }
+  
+  sConfigOC.OCMode = TIM_OCMODE_PWM1;
+  sConfigOC.Pulse = SERVO_CENTER_PULSE;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  for (uint8_t i = 0; i < channels; i++) {
+    if (HAL_TIM_PWM_ConfigChannel(htim, &sConfigOC, tim_channels[i]) != HAL_OK) {
+      Error_Handler();
+    }
+  }
+  
+  HAL_TIM_MspPostInit(htim);
+}
+
+static void board_i2c_init(void) {
+  hi2c1.Instance = I2C1;
+  hi2c1.Init.Timing = BOARD_I2C_TIMING_400K;
+  hi2c1.Init.OwnAddress1 = 0;
+  hi2c1.Init.AddressingMode = I2C_ADDRESSINGMODE_7BIT;
+  hi2c1.Init.DualAddressMode = I2C_DUALADDRESS_DISABLE;
+  hi2c1.Init.OwnAddress2 = 0;
+  hi2c1.Init.OwnAddress2Masks = I2C_OA2_NOMASK;
+  hi2c1.Init.GeneralCallMode = I2C_GENERALCALL_DISABLE;
+  hi2c1.Init.NoStretchMode = I2C_NOSTRETCH_DISABLE;
+  if (HAL_I2C_Init(&hi2c1) != HAL_OK) {
+    Error_Handler();
+  }
+  HAL_I2CEx_ConfigAnalogFilter(&hi2c1, I2C_ANALOGFILTER_ENABLE);
+  i2c_speed_hz = I2C_BUS_SPEED_FAST;
+}
+
+static void board_console_init(void) {
+  huart2.Instance = USART2;
+  huart2.Init.BaudRate = 115200;
+  huart2.Init.WordLength = UART_WORDLENGTH_8B;
+  huart2.Init.StopBits = UART_STOPBITS_1;
+  huart2.Init.Parity = UART_PARITY_NONE;
+  huart2.Init.Mode = UART_MODE_TX_RX;
+  huart2.Init.HwFlowCtl = UART_HWCONTROL_NONE;
+  huart2.Init.OverSampling = UART_OVERSAMPLING_16;
+  huart2.Init.OneBitSampling = UART_ONE_BIT_SAMPLE_DISABLE;
+  huart2.AdvancedInit.AdvFeatureInit = UART_ADVFEATURE_NO_INIT;
+  if (HAL_UART_Init(&huart2) != HAL_OK) {
+    Error_Handler();
+  }
+}
+
+// ============================================================================
+// CÓDIGO EN RAM
+// ============================================================================
+
+#if !defined(BOARD_NO_RAM_CODE)
+extern const uint32_t g_pfnVectors[];   // startup_stm32l433rctxp.s
+static uint32_t ram_vectors[BOARD_VECTOR_COUNT] __attribute__((aligned(BOARD_VECTOR_ALIGN)));
+
+// Con la tabla en la Flash, entrar a cualquier interrupción durante un
+// borrado esperaría a que termine aunque el handler esté en la RAM
+static void board_ram_vectors(void) {
+  memcpy(ram_vectors, g_pfnVectors, sizeof(ram_vectors));
+  
+  __disable_irq();
+  SCB->VTOR = (uint32_t)(uintptr_t)ram_vectors;
+  __DSB();
+  __enable_irq();
+}
+#endif
+
+// Reemplaza a la de la HAL (__weak, en la Flash)
+BOARD_RAM_FUNC void HAL_IncTick(void) {
+  uwTick += (uint32_t)uwTickFreq;
+}
+
+void board_init(void) {
+#if !defined(BOARD_NO_RAM_CODE)
+  board_ram_vectors();
+#endif
+  board_clock_config();
+  
+  // Los módulos configuran sus propios pines (sensores, LEDs, ultrasónicos)
+  __HAL_RCC_GPIOA_CLK_ENABLE();
+  __HAL_RCC_GPIOB_CLK_ENABLE();
+  __HAL_RCC_GPIOC_CLK_ENABLE();
+  
+  __HAL_RCC_DMA1_CLK_ENABLE();
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+  
+  board_adc_init();
+  board_i2c_init();
+  board_servo_timer_init(&htim1, TIM1, 3);
+  board_servo_timer_init(&htim2, TIM2, 2);
+  board_console_init();
+}
+
+const char *board_name(void) {
+  return BOARD_NAME;
+}
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+// DMA1 Channel 1 en modo circular: el buffer se actualiza solo
+void board_adc_start(uint16_t *buffer, uint16_t count) {
+  HAL_ADC_Start_DMA(&hadc1, (uint32_t *)buffer, count);
+}
+
+// Los callbacks de medio buffer y buffer completo están vacíos: alcanza con
+// limpiar las banderas (con el ADC continuo esta IRQ es la más frecuente)
+BOARD_RAM_FUNC bool board_adc_dma_irq(void) {
+  uint32_t flags = DMA1->ISR & (DMA_ISR_TCIF1 | DMA_ISR_HTIF1 | DMA_ISR_TEIF1);
+  
+  if (flags & DMA_ISR_TEIF1) return false;
+  
+  DMA1->IFCR = flags;  // CTCIF1/CHTIF1 en las mismas posiciones
+  return true;
+}
+
+// ============================================================================
+// FLASH (páginas de 2 KB, programación de a doble palabra)
+// ============================================================================
+
+static uint32_t erase_last_us = 0;
+static uint32_t erase_last_ticks = 0;
+static uint32_t erase_count = 0;
+
+// Lo que las IRQ en RAM dejaron frenado durante el borrado
+static volatile bool erase_active = false;
+static volatile bool pvd_pending = false;
+static volatile uint32_t console_held = 0;   // Bits de USART2->CR1
+static volatile uint32_t i2c_held = 0;       // Bits de I2C1->CR1
+
+// Leer la Flash (instrucciones o datos) durante un borrado frena el bus
+// hasta que termina: la espera tiene que correr desde la RAM
+BOARD_RAM_FUNC static uint32_t board_flash_erase_page(uint32_t page) {
+  while (FLASH->SR & FLASH_SR_BSY) { }
+  
+  FLASH->CR = (FLASH->CR & ~FLASH_CR_PNB) | FLASH_CR_PER | (page << FLASH_CR_PNB_Pos);
+  FLASH->CR |= FLASH_CR_STRT;
+  
+  while (FLASH->SR & FLASH_SR_BSY) { }
+  
+  FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PNB);
+  return FLASH->SR & FLASH_FLAG_ALL_ERRORS;
+}
+
+// Como HAL_FLASHEx_Erase: las caches se apagan durante el borrado y se
+// limpian antes de volver a encenderlas (pueden tener copias de lo borrado)
+static uint32_t board_flash_caches_off(void) {
+  uint32_t enabled = FLASH->ACR & (FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+  
+  if (enabled & FLASH_ACR_ICEN) __HAL_FLASH_INSTRUCTION_CACHE_DISABLE();
+  if (enabled & FLASH_ACR_DCEN) __HAL_FLASH_DATA_CACHE_DISABLE();
+  return enabled;
+}
+
+static void board_flash_caches_on(uint32_t enabled) {
+  if (enabled & FLASH_ACR_ICEN) {
+    __HAL_FLASH_INSTRUCTION_CACHE_RESET();
+    __HAL_FLASH_INSTRUCTION_CACHE_ENABLE();
+  }
+  if (enabled & FLASH_ACR_DCEN) {
+    __HAL_FLASH_DATA_CACHE_RESET();
+    __HAL_FLASH_DATA_CACHE_ENABLE();
+  }
+}
+
+// Apaga en el NVIC todo menos BOARD_RAM_IRQS: una IRQ con el handler en la
+// Flash frenaría al núcleo (y a SysTick) hasta el final del borrado
+static void board_irq_mask_for_erase(uint32_t *enabled, uint32_t words) {
+  static const IRQn_Type ram_irqs[] = BOARD_RAM_IRQS;
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  erase_active = true;
+  for (uint32_t i = 0; i < words; i++) {
+    uint32_t keep = 0;
+    for (uint32_t n = 0; n < sizeof(ram_irqs) / sizeof(ram_irqs[0]); n++) {
+      if (((uint32_t)ram_irqs[n] >> 5) == i) keep |= 1u << ((uint32_t)ram_irqs[n] & 31u);
+    }
+    enabled[i] = NVIC->ISER[i];
+    NVIC->ICER[i] = enabled[i] & ~keep;
+  }
+  __DSB();
+  __ISB();
+  
+  __set_PRIMASK(primask);
+}
+
+// Devuelve a la HAL lo que frenaron las IRQ en RAM: la transmisión de la
+// consola, I2C1 y el aviso del PVD (que vuelve a entrar como pendiente)
+static void board_irq_restore(const uint32_t *enabled, uint32_t words) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  erase_active = false;
+  erase_count++;
+  huart2.Instance->CR1 |= console_held;
+  hi2c1.Instance->CR1 |= i2c_held;
+  console_held = 0;
+  i2c_held = 0;
+  
+  for (uint32_t i = 0; i < words; i++) {
+    NVIC->ISER[i] = enabled[i];
+  }
+  if (pvd_pending) HAL_NVIC_SetPendingIRQ(PVD_PVM_IRQn);
+  
+  __set_PRIMASK(primask);
+}
+
+bool board_flash_erase(uint32_t address, uint32_t size) {
+  uint32_t enabled[sizeof(NVIC->ISER) / sizeof(NVIC->ISER[0])];
+  uint32_t words = sizeof(enabled) / sizeof(enabled[0]);
+  uint32_t errors = 0;
+  
+  // Nunca una página de código
+  if (size == 0 || address < BOARD_FLASH_DATA_START || address + size > BOARD_FLASH_DATA_END) return false;
+  
+  uint32_t first = (address - FLASH_BASE) / FLASH_PAGE_SIZE;
+  uint32_t last = (address - FLASH_BASE + size - 1) / FLASH_PAGE_SIZE;
+  uint32_t start = profiler_cycles();
+  uint32_t start_tick = HAL_GetTick();
+  
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);  // Un error viejo bloquea la operación
+  uint32_t caches = board_flash_caches_off();
+  board_irq_mask_for_erase(enabled, words);
+  
+  for (uint32_t page = first; page <= last && errors == 0; page++) {
+    errors = board_flash_erase_page(page);
+  }
+  
+  board_irq_restore(enabled, words);
+  board_flash_caches_on(caches);
+  HAL_FLASH_Lock();
+  
+  erase_last_us = profiler_cycles_to_us(profiler_cycles() - start);
+  erase_last_ticks = HAL_GetTick() - start_tick;
+  
+  if (errors != 0) {
+    printf("Error borrando Flash: 0x%04lX\r\n", errors);
+    return false;
+  }
+  
+  return true;
+}
+
+void board_flash_erase_timing(uint32_t *duration_us, uint32_t *tick_ms) {
+  *duration_us = erase_last_us;
+  *tick_ms = erase_last_ticks;
+}
+
+uint32_t board_flash_erase_count(void) {
+  return erase_count;
+}
+
+// Cada doble palabra lleva ECC: se escribe una sola vez, completa
+bool board_flash_program(uint32_t address, const void *data, uint32_t len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  HAL_StatusTypeDef status = HAL_OK;
+  
+  if (address % BOARD_FLASH_WRITE_UNIT != 0) return false;
+  
+  HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+  
+  for (uint32_t offset = 0; offset < len && status == HAL_OK; offset += 8) {
+    uint64_t dword = UINT64_MAX;
+    uint32_t chunk = (len - offset < 8) ? (len - offset) : 8;
+    memcpy(&dword, &bytes[offset], chunk);
+    
+    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, address + offset, dword);
+  }
+  
+  HAL_FLASH_Lock();
+  
+  if (status != HAL_OK) {
+    printf("Error escribiendo Flash: %d\r\n", status);
+    return false;
+  }
+  
+  return true;
+}
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+// El periférico de la L4 se programa con TIMINGR y hay que deshabilitarlo
+// para cambiarlo (HAL_I2C_Init lo hace sin pasar por la MspInit)
+void board_i2c_set_speed(uint32_t speed_hz) {
+  hi2c1.Init.Timing = (speed_hz <= I2C_BUS_SPEED_STANDARD) ? BOARD_I2C_TIMING_100K
+                                                          : BOARD_I2C_TIMING_400K;
+  HAL_I2C_Init(&hi2c1);
+  i2c_speed_hz = (speed_hz <= I2C_BUS_SPEED_STANDARD) ? I2C_BUS_SPEED_STANDARD
+                                                      : I2C_BUS_SPEED_FAST;
+}
+
+uint32_t board_i2c_get_speed(void) {
+  return i2c_speed_hz;
+}
+
+#define BOARD_I2C_IRQ_BITS  (I2C_CR1_TXIE | I2C_CR1_RXIE | I2C_CR1_ADDRIE | I2C_CR1_NACKIE | \
+                             I2C_CR1_STOPIE | I2C_CR1_TCIE | I2C_CR1_ERRIE)
+
+// Con TXIS, RXNE o TC sin atender el maestro estira SCL: el esclavo espera
+BOARD_RAM_FUNC bool board_i2c_irq_hold(void) {
+  if (!erase_active) return false;
+  
+  i2c_held |= hi2c1.Instance->CR1 & BOARD_I2C_IRQ_BITS;
+  hi2c1.Instance->CR1 &= ~BOARD_I2C_IRQ_BITS;
+  return true;
+}
+
+// ============================================================================
+// CONSOLA (USART2)
+// ============================================================================
+
+void board_console_write(const uint8_t *data, uint16_t len) {
+  HAL_UART_Transmit(&huart2, (uint8_t *)data, len, HAL_MAX_DELAY);
+}
+
+void board_console_rx_enable(void) {
+  if ((huart2.Instance->CR1 & USART_CR1_RXNEIE) == 0) {
+    __HAL_UART_ENABLE_IT(&huart2, UART_IT_RXNE);
+  }
+  if ((huart2.Instance->CR1 & USART_CR1_IDLEIE) == 0) {
+    __HAL_UART_ENABLE_IT(&huart2, UART_IT_IDLE);
+  }
+}
+
+// Leer RDR limpia RXNE; IDLE y los errores se limpian en ICR
+BOARD_RAM_FUNC uint8_t board_console_irq(uint8_t *byte) {
+  uint32_t isr = huart2.Instance->ISR;
+  uint8_t events = 0;
+  
+  if (isr & USART_ISR_RXNE) {
+    *byte = (uint8_t)(huart2.Instance->RDR & 0xFF);
+    events |= BOARD_CONSOLE_RX;
+  }
+  if (isr & USART_ISR_IDLE) {
+    events |= BOARD_CONSOLE_IDLE;
+  }
+  __HAL_UART_CLEAR_FLAG(&huart2, UART_CLEAR_IDLEF | UART_CLEAR_OREF | UART_CLEAR_NEF | UART_CLEAR_FEF);
+  
+  return events;
+}
+
+// TXE y TC quedan levantados sin interrupción; la recepción sigue (shell_uart_irq)
+BOARD_RAM_FUNC bool board_console_tx_hold(void) {
+  if (!erase_active) return false;
+  
+  console_held |= huart2.Instance->CR1 & (USART_CR1_TXEIE | USART_CR1_TCIE);
+  huart2.Instance->CR1 &= ~(USART_CR1_TXEIE | USART_CR1_TCIE);
+  return true;
+}
+
+// ============================================================================
+// ALIMENTACIÓN
+// ============================================================================
+
+void board_pvd_enable(void) {
+  PWR_PVDTypeDef pvd_config = {0};
+  pvd_config.PVDLevel = BOARD_PVD_LEVEL;
+  pvd_config.Mode = PWR_PVD_MODE_IT_RISING;  // PVDO sube cuando VDD baja del umbral
+  HAL_PWR_ConfigPVD(&pvd_config);
+  HAL_PWR_EnablePVD();
+  HAL_NVIC_SetPriority(PVD_PVM_IRQn, 0, 0);
+  HAL_NVIC_EnableIRQ(PVD_PVM_IRQn);
+}
+
+#define BOARD_SERVO_OUTPUTS  (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E)
+
+// Lo mismo que HAL_TIM_PWM_Stop en cada canal, sin salir de la RAM
+BOARD_RAM_FUNC static void board_servo_outputs_off(void) {
+  BOARD_SERVO_TIM_A.Instance->CCER &= ~BOARD_SERVO_OUTPUTS;
+  BOARD_SERVO_TIM_B.Instance->CCER &= ~BOARD_SERVO_OUTPUTS;
+}
+
+// Reemplaza a HAL_PWREx_PVD_PVM_IRQHandler (sólo se usa el PVD). Durante un
+// borrado no se puede programar la Flash: los servos se cortan ya y el
+// guardado espera al final
+BOARD_RAM_FUNC void board_pvd_irq(void) {
+  if (__HAL_PWR_PVD_EXTI_GET_FLAG()) {
+    __HAL_PWR_PVD_EXTI_CLEAR_FLAG();
+    pvd_pending = true;
+  }
+  if (!pvd_pending) return;
+  
+  if (erase_active) {
+    board_servo_outputs_off();
+    return;
+  }
+  pvd_pending = false;
+  board_power_fail();
+}
+
+// Modo Sleep: el núcleo se detiene y los periféricos (DMA, UART, I2C) siguen.
+// Con la Flash apagada en Sleep se ahorra su consumo sin perder el SysTick
+void board_sleep_ms(uint32_t ms) {
+  uint32_t start = HAL_GetTick();
+  
+  __HAL_FLASH_SLEEP_POWERDOWN_ENABLE();
+  while (HAL_GetTick() - start < ms) {
+    HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+  }
+  __HAL_FLASH_SLEEP_POWERDOWN_DISABLE();
+}
+
+#endif // BOARD_L433
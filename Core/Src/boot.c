@@ -0,0 +1,89 @@
+/**
+ * @file boot.c
+ * @brief Implementación del arranque por etapas
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "boot.h"
+#include "profiler.h"
+#include <stdio.h>
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static BootTask *tasks[BOOT_MAX_TASKS];
+static uint8_t task_count = 0;
+static uint8_t next_task = 0;
+
+// Tiempos desde HAL_Init() (0 = todavía no)
+static uint32_t critical_ms = 0;
+static uint32_t ready_ms = 0;
+static uint32_t first_detection_ms = 0;
+static uint32_t background_done_ms = 0;
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+bool boot_defer(BootTask *task) {
+  if (task == NULL || task->run == NULL || task_count >= BOOT_MAX_TASKS) return false;
+  
+  task->done_ms = 0;
+  task->duration_us = 0;
+  tasks[task_count++] = task;
+  return true;
+}
+
+void boot_critical_done(void) {
+  // Un tick de 0 se confundiría con "todavía no"
+  critical_ms = HAL_GetTick() | 1u;
+}
+
+void boot_service(bool idle) {
+  if (critical_ms == 0 || !idle) return;
+  
+  if (ready_ms == 0) {
+    ready_ms = HAL_GetTick() | 1u;
+    printf("Listo para detectar: %lu ms desde el arranque\r\n", ready_ms);
+    return;
+  }
+  
+  // Una tarea por vuelta: el loop sigue atendiendo sensores entre tareas
+  if (next_task >= task_count) return;
+  
+  BootTask *task = tasks[next_task++];
+  uint32_t start = profiler_cycles();
+  task->run();
+  task->duration_us = profiler_cycles_to_us(profiler_cycles() - start);
+  task->done_ms = HAL_GetTick() | 1u;
+  
+  if (next_task == task_count) background_done_ms = task->done_ms;
+}
+
+bool boot_is_ready(void) {
+  return ready_ms != 0;
+}
+
+void boot_record_detection(uint32_t tick) {
+  if (first_detection_ms == 0) first_detection_ms = tick | 1u;
+}
+
+void boot_show_status(void) {
+  printf("Arranque (ms desde HAL_Init): crítico %lu | listo %lu | fondo %lu | 1ª detección %lu\r\n",
+         critical_ms, ready_ms, background_done_ms, first_detection_ms);
+         
+  for (uint8_t i = 0; i < task_count; i++) {
+    const BootTask *task = tasks[i];
+    if (task->done_ms == 0) {
+      printf("  %-14s pendiente\r\n", task->name);
+    } else {
+      printf("  %-14s a los %lu ms, %lu us\r\n", task->name, task->done_ms, task->duration_us);
+    }
+  }
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -6,8 +6,8 @@
  */
 
 #include "classifier.h"
+#include "params.h"
 #include <stdio.h>
-#include <string.h>
 #include <math.h>
 
 // ============================================================================
@@ -31,17 +31,19 @@ void classifier_init(void) {
 // CLASIFICACIÓN PRINCIPAL
 // ============================================================================
 
-ClassificationResult classifier_classify(SensorDigitalData digital, SensorAnalogData analog) {
-  ClassificationResult result = {0};
+// El camino de clasificación corre desde la RAM, sin estados de espera de la
+// Flash (BOARD_RAM_FUNC, ver board.h); "prof" muestra cuántos ciclos cuesta.
+// No llama a nada que esté en la Flash: ni printf ni strcpy/memset (un
+// "= {0}" o un nombre copiado serían llamadas a newlib); el nombre del
+// material lo arma quien lo muestra
+BOARD_RAM_FUNC ClassificationResult classifier_classify(SensorDigitalData digital, SensorAnalogData analog) {
+  ClassificationResult result;
+  result.material = MATERIAL_DESCONOCIDO;
+  result.isValid = false;
+  result.confidence = 0.0f;
   
-  if (!classifier_initialized) {
-    printf("Error: Clasificador no inicializado\r\n");
-    result.material = MATERIAL_DESCONOCIDO;
-    result.isValid = false;
-    result.confidence = 0.0f;
-    strcpy(result.description, "Error");
-    return result;
-  }
+  // Sin classifier_init: no identificado (el arranque lo llama siempre)
+  if (!classifier_initialized) return result;
   
   // Clasificar translucidez y sonido
   TranslucencyLevel translucidez = sensors_classify_translucency(analog.ldr_laser);
@@ -52,32 +54,23 @@ ClassificationResult classifier_classify(SensorDigitalData digital, SensorAnalog
     // METAL: Inductivo=1, Capacitivo=1, Opaco, Sonido Alto
     result.material = MATERIAL_METAL;
     result.confidence = classifier_calculate_confidence(digital, analog, MATERIAL_METAL);
-    strcpy(result.description, "Metal");
   }
   else if (!digital.inductivo && digital.capacitivo && translucidez == TRANSLUCENCY_ALTO && sonido == SOUND_ALTO) {
     // VIDRIO: Inductivo=0, Capacitivo=1, Alto, Sonido Alto
     result.material = MATERIAL_VIDRIO;
     result.confidence = classifier_calculate_confidence(digital, analog, MATERIAL_VIDRIO);
-    strcpy(result.description, "Vidrio");
   }
   else if (!digital.inductivo && digital.capacitivo && translucidez == TRANSLUCENCY_MEDIO && sonido == SOUND_MEDIO) {
     // PLÁSTICO: Inductivo=0, Capacitivo=1, Medio, Sonido Medio
     result.material = MATERIAL_PLASTICO;
     result.confidence = classifier_calculate_confidence(digital, analog, MATERIAL_PLASTICO);
-    strcpy(result.description, "Plástico");
   }
   else if (!digital.inductivo && digital.capacitivo && translucidez == TRANSLUCENCY_OPACO && sonido == SOUND_BAJO) {
     // PAPEL: Inductivo=0, Capacitivo=1, Opaco, Sonido Bajo
     result.material = MATERIAL_PAPEL;
     result.confidence = classifier_calculate_confidence(digital, analog, MATERIAL_PAPEL);
-    strcpy(result.description, "Papel");
-  }
-  else {
-    // NO IDENTIFICADO
-    result.material = MATERIAL_DESCONOCIDO;
-    result.confidence = 0.0f;
-    strcpy(result.description, "Desconocido");
   }
+  // Si no: NO IDENTIFICADO (valores iniciales)
   
   // Validar resultado
   result.isValid = classifier_validate_result(result);
@@ -89,7 +82,7 @@ ClassificationResult classifier_classify(SensorDigitalData digital, SensorAnalog
 // CÁLCULO DE CONFIANZA
 // ============================================================================
 
-float classifier_calculate_confidence(SensorDigitalData digital, SensorAnalogData analog, MaterialType material) {
+BOARD_RAM_FUNC float classifier_calculate_confidence(SensorDigitalData digital, SensorAnalogData analog, MaterialType material) {
   float confidence = 0.0f;
   float sensor_matches = 0.0f;
   float total_sensors = 4.0f; // inductivo, capacitivo, translucidez, sonido
@@ -144,24 +137,24 @@ float classifier_calculate_confidence(SensorDigitalData digital, SensorAnalogDat
   switch (material) {
     case MATERIAL_METAL:
       // Metal debe tener valores altos en micrófono
-      if (analog.microfono > 3000) analog_bonus += 5.0f;
+      if (analog.microfono > params.bono_mic_metal_min) analog_bonus += 5.0f;
       break;
       
     case MATERIAL_VIDRIO:
       // Vidrio debe tener valores muy altos en LDR
-      if (analog.ldr_laser > 3500) analog_bonus += 5.0f;
+      if (analog.ldr_laser > params.bono_ldr_vidrio_min) analog_bonus += 5.0f;
       break;
       
     case MATERIAL_PLASTICO:
       // Plástico debe tener valores medios en ambos
-      if (analog.ldr_laser > 1500 && analog.ldr_laser < 3000) analog_bonus += 3.0f;
-      if (analog.microfono > 1000 && analog.microfono < 2500) analog_bonus += 3.0f;
+      if (analog.ldr_laser > params.bono_ldr_plastico_min && analog.ldr_laser < params.bono_ldr_plastico_max) analog_bonus += 3.0f;
+      if (analog.microfono > params.bono_mic_plastico_min && analog.microfono < params.bono_mic_plastico_max) analog_bonus += 3.0f;
       break;
       
     case MATERIAL_PAPEL:
       // Papel debe tener valores bajos en ambos
-      if (analog.ldr_laser < 1500) analog_bonus += 3.0f;
-      if (analog.microfono < 1500) analog_bonus += 3.0f;
+      if (analog.ldr_laser < params.bono_ldr_papel_max) analog_bonus += 3.0f;
+      if (analog.microfono < params.bono_mic_papel_max) analog_bonus += 3.0f;
       break;
       
     default:
@@ -181,14 +174,14 @@ float classifier_calculate_confidence(SensorDigitalData digital, SensorAnalogDat
 // VALIDACIÓN
 // ============================================================================
 
-bool classifier_validate_result(ClassificationResult result) {
+BOARD_RAM_FUNC bool classifier_validate_result(ClassificationResult result) {
   // Verificar que el material sea válido
   if (result.material == MATERIAL_DESCONOCIDO || result.material == MATERIAL_NINGUNO) {
     return false;
   }
   
   // Verificar confianza mínima
-  if (result.confidence < MIN_CONFIDENCE_THRESHOLD) {
+  if (result.confidence < params.confianza_min) {
     return false;
   }
   
@@ -231,7 +224,7 @@ void classifier_calibrate(void) {
   classifier_show_truth_table();
   
   printf("Umbrales de confianza:\r\n");
-  printf("  Mínimo: %.1f%%\r\n", MIN_CONFIDENCE_THRESHOLD);
+  printf("  Mínimo: %.1f%%\r\n", params.confianza_min);
   printf("  Alto:   %.1f%%\r\n", HIGH_CONFIDENCE_THRESHOLD);
   
   printf("Calibración completada\r\n");
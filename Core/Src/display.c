@@ -6,6 +6,9 @@
  */
 
 #include "display.h"
+#include "lcd.h"
+#include "leds.h"
+#include "fmt.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -15,48 +18,196 @@
 
 static bool display_initialized = false;
 
+static DisplayModel model;
+static uint8_t pending = 0;            // DISPLAY_CHANGED_* desde el último refresco
+
+static DisplaySink *sinks[DISPLAY_MAX_SINKS];
+static uint8_t sink_count = 0;
+
+// Actualizaciones del modelo frente a refrescos entregados
+static uint32_t model_updates = 0;
+static uint32_t model_frames = 0;
+
+static const char led_letters[LED_COUNT] = { 'M', 'P', 'L', 'V', 'E', 'S' };
+
 // ============================================================================
-// INICIALIZACIÓN
+// SALIDAS INCORPORADAS
 // ============================================================================
 
-void display_init(void) {
-  if (display_initialized) return;
+static void sink_leds_render(const DisplayModel *m, uint8_t changed) {
+  if (!(changed & DISPLAY_CHANGED_LEDS)) return;
   
-  // Configurar pines de LEDs como salida
-  GPIO_InitTypeDef GPIO_InitStruct = {0};
-  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
-  GPIO_InitStruct.Pull = GPIO_NOPULL;
-  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  for (uint8_t led = 0; led < LED_COUNT; led++) {
+    if (!(m->leds_changed & (1u << led))) continue;
+    
+    if (m->led_pattern[led] != NULL) {
+      leds_play((LedId)led, m->led_pattern[led]);
+    } else {
+      leds_set((LedId)led, (m->leds & (1u << led)) != 0);
+    }
+  }
+}
+
+// Sólo cambia el framebuffer: lcd_service() manda las diferencias
+static void sink_lcd_render(const DisplayModel *m, uint8_t changed) {
+  if (!(changed & DISPLAY_CHANGED_TEXT)) return;
   
-  // Configurar todos los LEDs
-  GPIO_InitStruct.Pin = LED_METAL_PIN;
-  HAL_GPIO_Init(LED_METAL_PORT, &GPIO_InitStruct);
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    lcd_write_line(row, m->text[row]);
+  }
+}
+
+static void sink_uart_render(const DisplayModel *m, uint8_t changed) {
+  char leds[LED_COUNT + 1];
+  for (uint8_t led = 0; led < LED_COUNT; led++) {
+    leds[led] = (m->leds & (1u << led)) ? led_letters[led] : '-';
+  }
+  leds[LED_COUNT] = '\0';
   
-  GPIO_InitStruct.Pin = LED_PAPEL_PIN;
-  HAL_GPIO_Init(LED_PAPEL_PORT, &GPIO_InitStruct);
+  printf("[LCD] %s | %s  [LEDs] %s\r\n", m->text[0], m->text[1], leds);
+}
+
+static DisplaySink sink_leds = { "leds", sink_leds_render, true, 0 };
+static DisplaySink sink_lcd = { "lcd", sink_lcd_render, true, 0 };
+static DisplaySink sink_uart = { "consola", sink_uart_render, DISPLAY_UART_MIRROR, 0 };
+
+// ============================================================================
+// MODELO
+// ============================================================================
+
+// Copia hasta LCD_COLS caracteres UTF-8 sin cortar una secuencia
+static void display_copy_line(char *dst, const char *src) {
+  const uint8_t *p = (const uint8_t *)src;
+  uint16_t len = 0;
+  uint8_t chars = 0;
   
-  GPIO_InitStruct.Pin = LED_PLASTICO_PIN;
-  HAL_GPIO_Init(LED_PLASTICO_PORT, &GPIO_InitStruct);
+  while (*p != '\0' && chars < LCD_COLS) {
+    uint8_t seq = 1;
+    while ((p[seq] & 0xC0) == 0x80) seq++;
+    if (len + seq >= DISPLAY_LINE_MAX) break;
+    
+    memcpy(&dst[len], p, seq);
+    len += seq;
+    p += seq;
+    chars++;
+  }
+  dst[len] = '\0';
+}
+
+static void display_set_text(uint8_t row, const char *text) {
+  char line[DISPLAY_LINE_MAX];
+  display_copy_line(line, (text != NULL) ? text : "");
   
-  GPIO_InitStruct.Pin = LED_VIDRIO_PIN;
-  HAL_GPIO_Init(LED_VIDRIO_PORT, &GPIO_InitStruct);
+  model_updates++;
+  if (strcmp(line, model.text[row]) == 0) return;
   
-  GPIO_InitStruct.Pin = LED_ERROR_PIN;
-  HAL_GPIO_Init(LED_ERROR_PORT, &GPIO_InitStruct);
+  strcpy(model.text[row], line);
+  pending |= DISPLAY_CHANGED_TEXT;
+}
+
+void display_set_led(LedId led, bool on) {
+  if (led >= LED_COUNT) return;
   
-  GPIO_InitStruct.Pin = LED_SISTEMA_PORT;
-  HAL_GPIO_Init(LED_SISTEMA_PORT, &GPIO_InitStruct);
+  uint8_t bit = 1u << led;
+  model_updates++;
+  // Con una animación en curso hay que detenerla aunque el nivel coincida
+  if (!(model.leds_animated & bit) && ((model.leds & bit) != 0) == on) return;
   
-  // Apagar todos los LEDs inicialmente
-  display_clear_leds();
+  model.leds = on ? (model.leds | bit) : (model.leds & ~bit);
+  model.leds_animated &= ~bit;
+  model.led_pattern[led] = NULL;
+  model.leds_changed |= bit;
+  pending |= DISPLAY_CHANGED_LEDS;
+}
+
+void display_play_led(LedId led, const LedPattern *pattern) {
+  if (led >= LED_COUNT || pattern == NULL || pattern->count == 0) return;
+  
+  uint8_t bit = 1u << led;
+  bool final_on = pattern->steps[pattern->count - 1].on != 0;
+  
+  model_updates++;
+  model.leds = final_on ? (model.leds | bit) : (model.leds & ~bit);
+  model.leds_animated |= bit;
+  model.led_pattern[led] = pattern;
+  model.leds_changed |= bit;
+  pending |= DISPLAY_CHANGED_LEDS;
+}
+
+// ============================================================================
+// INICIALIZACIÓN Y SALIDAS
+// ============================================================================
+
+void display_init(void) {
+  if (display_initialized) return;
+  
+  // Pines de los LEDs y motor de animaciones
+  leds_init();
+  
+  memset(&model, 0, sizeof(model));
+  sink_count = 0;
+  display_add_sink(&sink_leds);
+  display_add_sink(&sink_lcd);
+  display_add_sink(&sink_uart);
   
   // Encender LED del sistema
-  HAL_GPIO_WritePin(LED_SISTEMA_PORT, LED_SISTEMA_PIN, GPIO_PIN_SET);
+  display_set_led(LED_ID_SISTEMA, true);
   
   display_initialized = true;
+  display_service();
   printf("Display inicializado\r\n");
 }
 
+void display_start_lcd(void) {
+  if (!lcd_init()) {
+    printf("LCD: el módulo I2C no responde (0x%02X)\r\n", LCD_I2C_ADDRESS);
+  }
+  
+  // El texto ya estaba en el modelo: se vuelve a entregar al panel recién borrado
+  pending |= DISPLAY_CHANGED_TEXT;
+}
+
+bool display_add_sink(DisplaySink *sink) {
+  if (sink == NULL || sink->render == NULL || sink_count >= DISPLAY_MAX_SINKS) return false;
+  
+  sinks[sink_count++] = sink;
+  // La salida nueva recibe el estado completo en el próximo refresco
+  model.leds_changed = (1u << LED_COUNT) - 1;
+  pending |= DISPLAY_CHANGED_TEXT | DISPLAY_CHANGED_LEDS;
+  return true;
+}
+
+bool display_set_sink_enabled(const char *name, bool enabled) {
+  for (uint8_t i = 0; i < sink_count; i++) {
+    if (strcmp(sinks[i]->name, name) == 0) {
+      sinks[i]->enabled = enabled;
+      return true;
+    }
+  }
+  return false;
+}
+
+void display_service(void) {
+  if (!display_initialized || pending == 0) return;
+  
+  for (uint8_t i = 0; i < sink_count; i++) {
+    if (!sinks[i]->enabled) continue;
+    sinks[i]->render(&model, pending);
+    sinks[i]->renders++;
+  }
+  model_frames++;
+  
+  // Las animaciones ya se iniciaron: quedan los niveles finales
+  pending = 0;
+  model.leds_changed = 0;
+  memset(model.led_pattern, 0, sizeof(model.led_pattern));
+}
+
+void display_flush(void) {
+  display_service();
+  lcd_flush();
+}
+
 // ============================================================================
 // CONTROL DE LEDs
 // ============================================================================
@@ -70,23 +221,24 @@ void display_update_leds(MaterialType material) {
   // Encender LED correspondiente al material
   switch (material) {
     case MATERIAL_METAL:
-      HAL_GPIO_WritePin(LED_METAL_PORT, LED_METAL_PIN, GPIO_PIN_SET);
+      display_set_led(LED_ID_METAL, true);
       break;
       
     case MATERIAL_PAPEL:
-      HAL_GPIO_WritePin(LED_PAPEL_PORT, LED_PAPEL_PIN, GPIO_PIN_SET);
+      display_set_led(LED_ID_PAPEL, true);
       break;
       
     case MATERIAL_PLASTICO:
-      HAL_GPIO_WritePin(LED_PLASTICO_PORT, LED_PLASTICO_PIN, GPIO_PIN_SET);
+      display_set_led(LED_ID_PLASTICO, true);
       break;
       
     case MATERIAL_VIDRIO:
-      HAL_GPIO_WritePin(LED_VIDRIO_PORT, LED_VIDRIO_PIN, GPIO_PIN_SET);
+      display_set_led(LED_ID_VIDRIO, true);
       break;
       
     case MATERIAL_DESCONOCIDO:
-      HAL_GPIO_WritePin(LED_ERROR_PORT, LED_ERROR_PIN, GPIO_PIN_SET);
+      // Destellos que terminan con el LED encendido
+      display_play_led(LED_ID_ERROR, &led_pattern_alert);
       break;
       
     default:
@@ -98,11 +250,9 @@ void display_clear_leds(void) {
   if (!display_initialized) return;
   
   // Apagar todos los LEDs excepto el del sistema
-  HAL_GPIO_WritePin(LED_METAL_PORT, LED_METAL_PIN, GPIO_PIN_RESET);
-  HAL_GPIO_WritePin(LED_PAPEL_PORT, LED_PAPEL_PIN, GPIO_PIN_RESET);
-  HAL_GPIO_WritePin(LED_PLASTICO_PORT, LED_PLASTICO_PIN, GPIO_PIN_RESET);
-  HAL_GPIO_WritePin(LED_VIDRIO_PORT, LED_VIDRIO_PIN, GPIO_PIN_RESET);
-  HAL_GPIO_WritePin(LED_ERROR_PORT, LED_ERROR_PIN, GPIO_PIN_RESET);
+  for (uint8_t led = LED_ID_METAL; led <= LED_ID_ERROR; led++) {
+    display_set_led((LedId)led, false);
+  }
 }
 
 // ============================================================================
@@ -110,48 +260,59 @@ void display_clear_leds(void) {
 // ============================================================================
 
 void display_lcd_message(const char* line1, const char* line2) {
-  // Por ahora solo imprimir por UART
-  // En una implementación completa, aquí se enviaría al LCD I2C
-  printf("LCD: %s | %s\r\n", line1, line2);
+  display_set_text(0, line1);
+  display_set_text(1, line2);
 }
 
 void display_lcd_clear(void) {
-  printf("LCD: Limpiando pantalla\r\n");
+  display_set_text(0, "");
+  display_set_text(1, "");
 }
 
 // ============================================================================
 // MENSAJES DEL SISTEMA
 // ============================================================================
 
+// Nombre de la placa para el LCD: si no entra, sólo la última palabra (el chip)
+static const char *display_board_label(void) {
+  const char *name = board_name();
+  const char *last = strrchr(name, ' ');
+  return (strlen(name) > LCD_COLS && last != NULL) ? last + 1 : name;
+}
+
 void display_show_welcome(void) {
+  static const char title[] = "SMART WASTE MANAGER - ";
+  int width = (int)(sizeof(title) - 1 + strlen(board_name()));
+  int left = (width < 58) ? (58 - width) / 2 : 0;
+  int right = (width + left < 58) ? 58 - width - left : 0;
+  
   printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
-  printf("║            SMART WASTE MANAGER - STM32F410RB             ║\r\n");
+  printf("║%*s%s%s%*s║\r\n", left, "", title, board_name(), right, "");
   printf("║                  Sistema Iniciado                        ║\r\n");
   printf("╚══════════════════════════════════════════════════════════╝\r\n");
   
   display_lcd_message("Smart Waste", "Manager Ready");
-  HAL_GPIO_WritePin(LED_SISTEMA_PORT, LED_SISTEMA_PIN, GPIO_PIN_SET);
+  display_set_led(LED_ID_SISTEMA, true);
+  display_flush();
 }
 
 void display_show_detecting(void) {
   printf("Detectando material...\r\n");
   display_lcd_message("Detectando...", "Material");
   
-  // Parpadear LED del sistema
-  for (int i = 0; i < 3; i++) {
-    HAL_GPIO_TogglePin(LED_SISTEMA_PORT, LED_SISTEMA_PIN);
-    HAL_Delay(200);
-  }
+  // Parpadear LED del sistema (sigue solo desde SysTick)
+  display_play_led(LED_ID_SISTEMA, &led_pattern_detecting);
 }
 
 void display_show_result(ClassificationResult result) {
   if (result.isValid) {
+    const char *name = classifier_get_material_description(result.material);
     printf("✓ Material identificado: %s (%.1f%% confianza)\r\n", 
-           result.description, result.confidence);
-    
+           name, result.confidence);
+           
     char conf_str[10];
-    sprintf(conf_str, "%.0f%%", result.confidence);
-    display_lcd_message(result.description, conf_str);
+    fmt_snprintf(conf_str, sizeof(conf_str), "%.0f%%", result.confidence);
+    display_lcd_message(name, conf_str);
     
     // Actualizar LEDs
     display_update_leds(result.material);
@@ -182,9 +343,9 @@ void display_show_statistics(Statistics *stats) {
   printf("╚══════════════════════════════════════════════════════════╝\r\n");
   
   // Mostrar en LCD (resumido)
-  char line1[16], line2[16];
-  sprintf(line1, "Total: %lu", stats->total_clasificados);
-  sprintf(line2, "Conf: %.0f%%", stats->promedio_confianza);
+  char line1[LCD_COLS + 1], line2[LCD_COLS + 1];
+  fmt_snprintf(line1, sizeof(line1), "Total: %lu", stats->total_clasificados);
+  fmt_snprintf(line2, sizeof(line2), "Conf: %.0f%%", stats->promedio_confianza);
   display_lcd_message(line1, line2);
 }
 
@@ -199,9 +360,9 @@ void display_show_container_levels(ContainerLevels levels) {
   printf("╚══════════════════════════════════════════════════════════╝\r\n");
   
   // Mostrar en LCD
-  char line1[16], line2[16];
-  sprintf(line1, "M:%.0f P:%.0f", levels.metal, levels.papel);
-  sprintf(line2, "Pl:%.0f V:%.0f", levels.plastico, levels.vidrio);
+  char line1[LCD_COLS + 1], line2[LCD_COLS + 1];
+  fmt_snprintf(line1, sizeof(line1), "M:%.0f P:%.0f", levels.metal, levels.papel);
+  fmt_snprintf(line2, sizeof(line2), "Pl:%.0f V:%.0f", levels.plastico, levels.vidrio);
   display_lcd_message(line1, line2);
 }
 
@@ -213,34 +374,27 @@ void display_test_leds(void) {
   printf("Probando LEDs...\r\n");
   
   // Probar cada LED individualmente
-  HAL_GPIO_WritePin(LED_METAL_PORT, LED_METAL_PIN, GPIO_PIN_SET);
-  printf("LED Metal ON\r\n");
-  HAL_Delay(500);
-  HAL_GPIO_WritePin(LED_METAL_PORT, LED_METAL_PIN, GPIO_PIN_RESET);
-  
-  HAL_GPIO_WritePin(LED_PAPEL_PORT, LED_PAPEL_PIN, GPIO_PIN_SET);
-  printf("LED Papel ON\r\n");
-  HAL_Delay(500);
-  HAL_GPIO_WritePin(LED_PAPEL_PORT, LED_PAPEL_PIN, GPIO_PIN_RESET);
-  
-  HAL_GPIO_WritePin(LED_PLASTICO_PORT, LED_PLASTICO_PIN, GPIO_PIN_SET);
-  printf("LED Plástico ON\r\n");
-  HAL_Delay(500);
-  HAL_GPIO_WritePin(LED_PLASTICO_PORT, LED_PLASTICO_PIN, GPIO_PIN_RESET);
-  
-  HAL_GPIO_WritePin(LED_VIDRIO_PORT, LED_VIDRIO_PIN, GPIO_PIN_SET);
-  printf("LED Vidrio ON\r\n");
-  HAL_Delay(500);
-  HAL_GPIO_WritePin(LED_VIDRIO_PORT, LED_VIDRIO_PIN, GPIO_PIN_RESET);
-  
-  HAL_GPIO_WritePin(LED_ERROR_PORT, LED_ERROR_PIN, GPIO_PIN_SET);
-  printf("LED Error ON\r\n");
-  HAL_Delay(500);
-  HAL_GPIO_WritePin(LED_ERROR_PORT, LED_ERROR_PIN, GPIO_PIN_RESET);
-  
-  HAL_GPIO_WritePin(LED_SISTEMA_PORT, LED_SISTEMA_PIN, GPIO_PIN_SET);
-  printf("LED Sistema ON\r\n");
-  HAL_Delay(500);
+  static const char *const names[LED_COUNT] = {
+    "Metal", "Papel", "Plástico", "Vidrio", "Error", "Sistema"
+  };
+  for (uint8_t led = 0; led < LED_COUNT; led++) {
+    display_set_led((LedId)led, true);
+    display_service();
+    printf("LED %s ON\r\n", names[led]);
+    HAL_Delay(500);
+    display_set_led((LedId)led, led == LED_ID_SISTEMA);
+  }
+  
+  // Los seis a la vez, cada uno con su animación
+  printf("Animación simultánea\r\n");
+  for (uint8_t led = 0; led < LED_COUNT; led++) {
+    display_play_led((LedId)led, (led % 2) ? &led_pattern_heartbeat : &led_pattern_detecting);
+  }
+  display_service();
+  HAL_Delay(2000);
+  display_clear_leds();
+  display_set_led(LED_ID_SISTEMA, true);
+  display_service();
   
   printf("Prueba de LEDs completada\r\n");
 }
@@ -249,15 +403,19 @@ void display_test_lcd(void) {
   printf("Probando LCD...\r\n");
   
   display_lcd_message("Test LCD", "Linea 2");
+  display_flush();
   HAL_Delay(2000);
   
   display_lcd_message("Smart Waste", "Manager");
+  display_flush();
   HAL_Delay(2000);
   
-  display_lcd_message("STM32F410RB", "Ready");
+  display_lcd_message(display_board_label(), "Ready");
+  display_flush();
   HAL_Delay(2000);
   
   display_lcd_clear();
+  display_flush();
   printf("Prueba de LCD completada\r\n");
 }
 
@@ -278,7 +436,16 @@ void display_diagnostic(void) {
          HAL_GPIO_ReadPin(LED_ERROR_PORT, LED_ERROR_PIN) ? "ON" : "OFF");
   printf("║   Sistema (PC7):   %s\r\n", 
          HAL_GPIO_ReadPin(LED_SISTEMA_PORT, LED_SISTEMA_PIN) ? "ON" : "OFF");
-  printf("║ LCD: I2C configurado (simulado por UART)\r\n");
+  LcdStats lcd = lcd_get_stats();
+  printf("║ LCD (PCF8574 0x%02X): %s\r\n", LCD_I2C_ADDRESS,
+         lcd_is_present() ? "presente" : "no responde");
+  printf("║   %lu transferencias | %lu celdas | %lu bytes (última %u) | %lu errores\r\n",
+         lcd.transfers, lcd.cells, lcd.bus_bytes, lcd.last_bytes, lcd.errors);
+  printf("║ Refrescos: %lu actualizaciones en %lu refrescos\r\n", model_updates, model_frames);
+  for (uint8_t i = 0; i < sink_count; i++) {
+    printf("║   %-12s %s, %lu refrescos\r\n", sinks[i]->name,
+           sinks[i]->enabled ? "activa" : "inactiva", sinks[i]->renders);
+  }
   printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
 }
 
@@ -0,0 +1,710 @@
+/**
+ * @file event_log.c
+ * @brief Implementación del registro de eventos en Flash
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "event_log.h"
+#include "actuators.h"
+#include "flash_store.h"
+#include "telemetry.h"
+#include "fmt.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// FORMATO
+// ============================================================================
+//
+// El área se divide en EVENT_LOG_SEGMENTS segmentos que se usan en rueda:
+//
+// Segmento: [EventLogHeader][sesión][registro][registro]...[0xFF 0xFF ...]
+//
+// Cuando el activo se llena, el registro sigue en el siguiente, que se borró
+// antes en reposo (event_log_prepare()); los anteriores siguen legibles hasta
+// que les toca el turno. Cada segmento empieza con una marca de sesión, así
+// que se decodifica solo.
+//
+// Byte de encabezado de cada registro:
+//   0tttvsss  registro: t = tipo (0-5 material, 6 inicio de sesión),
+//             v = clasificación válida, s = inductivo/capacitivo/pir
+//             (en ese orden de bit 4 a bit 6, tipo en bits 0-2)
+//   1nnnnnnn  n bytes de un registro cortado que se saltean
+//   11111111  fin del registro (Flash borrada)
+//
+// Clasificación, después del encabezado (varints LEB128):
+//   dt         tiempo desde el registro anterior (EVENT_LOG_TICK_MS)
+//   confianza  1 byte (0-100)
+//   ldr, mic   diferencia zigzag con el registro anterior (ADC >> 6)
+//   duración   secuencia de depósito (EVENT_LOG_DURATION_MS, 0 = sin depósito)
+//
+// Cada registro ocupa unidades de programación enteras
+// (BOARD_FLASH_WRITE_UNIT): si no completa la última, la rellena un
+// salto. Con unidad de 1 byte (F4) no hay relleno.
+//
+// El cuerpo se escribe antes que el encabezado (la primera unidad): si se
+// corta la alimentación, el encabezado queda en 0xFF y el arranque lo
+// convierte en un salto.
+
+typedef struct {
+  uint32_t magic;          // EVENT_LOG_MAGIC
+  uint32_t sequence;       // Crece con cada segmento empezado
+} EventLogHeader;
+
+typedef struct {
+  uint8_t kind;            // 0-5 material, EVENT_LOG_KIND_*
+  uint8_t flags;           // Bits 3-6 del encabezado
+  uint32_t dt;             // En unidades de EVENT_LOG_TICK_MS
+  uint8_t confidence;
+  int8_t d_ldr;
+  int8_t d_mic;
+  uint32_t duration;       // En unidades de EVENT_LOG_DURATION_MS
+} EventRecord;
+
+typedef struct {
+  uint8_t header;
+  uint8_t confidence;
+  uint8_t ldr;
+  uint8_t mic;
+  uint32_t tick;
+} PendingEvent;
+
+typedef enum {
+  DUMP_IDLE = 0,
+  DUMP_RAW,                // event_log_dump()
+  DUMP_CSV                 // event_log_print()
+} DumpMode;
+
+// Volcado en curso: avanza desde event_log_update() a medida que se vacía
+// la cola de transmisión, sin bloquear el loop
+typedef struct {
+  DumpMode mode;
+  uint8_t segments[EVENT_LOG_SEGMENTS];
+  uint8_t count;
+  bool opened;             // Ya se envió el comienzo del volcado
+  uint8_t index;           // Segmento en curso
+  bool started;            // Ya se envió el comienzo del segmento
+  uint32_t address;        // Próximo byte a enviar o registro a decodificar
+  uint32_t end;            // Fin del segmento al empezarlo
+  uint32_t crc;            // RAW: CRC de lo enviado del segmento
+  uint32_t session;        // CSV: estado de la decodificación
+  uint32_t time_ms;
+  uint8_t ldr;
+  uint8_t mic;
+} DumpState;
+
+#define EVENT_LOG_MAGIC          0x474C5645  // "EVLG"
+#define EVENT_LOG_SEGMENT_SIZE   (EVENT_LOG_SIZE / EVENT_LOG_SEGMENTS)
+#define EVENT_LOG_TICK_MS        100
+#define EVENT_LOG_DURATION_MS    10
+#define EVENT_LOG_FEATURE_SHIFT  6            // ADC de 12 bits -> 6 bits
+#define EVENT_LOG_MAX_RECORD     16
+#define EVENT_LOG_MAX_SPAN       (EVENT_LOG_MAX_RECORD + BOARD_FLASH_WRITE_UNIT - 1)  // Con relleno
+#define EVENT_LOG_DUMP_CHUNK     256          // Entra con su línea en la cola de telemetry_write
+#define EVENT_LOG_LINE_MAX       128
+#define EVENT_LOG_PREPARE_MARGIN 1024         // Bytes libres con los que se borra el siguiente segmento
+
+#define EVENT_LOG_KIND_UNKNOWN   5
+#define EVENT_LOG_KIND_SESSION   6
+#define EVENT_LOG_KIND_SKIP      0xFE
+
+#define EVENT_LOG_BYTE_END       0xFF
+#define EVENT_LOG_BYTE_SKIP      0x80
+#define EVENT_LOG_FLAG_VALID     0x08
+#define EVENT_LOG_FLAG_INDUCTIVO 0x10
+#define EVENT_LOG_FLAG_CAPACITIVO 0x20
+#define EVENT_LOG_FLAG_PIR       0x40
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static bool log_enabled = false;          // false si la Flash del registro falló
+static uint8_t log_segment = 0;           // Segmento activo
+static uint32_t log_sequence = 0;
+static uint32_t log_write_addr = EVENT_LOG_ADDR + sizeof(EventLogHeader);
+static uint32_t log_end_addr = EVENT_LOG_ADDR + EVENT_LOG_SEGMENT_SIZE;
+static bool next_ready = false;           // Siguiente segmento ya borrado
+static uint32_t log_dropped = 0;          // Clasificaciones sin lugar esperando el borrado
+
+// Clasificaciones en todos los segmentos legibles y en cada uno, y fin de
+// los que ya no son el activo
+static uint32_t log_count = 0;
+static uint32_t segment_count[EVENT_LOG_SEGMENTS];
+static uint32_t segment_end[EVENT_LOG_SEGMENTS];
+
+// Bases para los deltas (se reinician con cada marca de sesión)
+static uint32_t log_last_tick = 0;
+static uint8_t log_last_ldr = 0;
+static uint8_t log_last_mic = 0;
+
+static PendingEvent pending;
+static bool pending_valid = false;
+
+static DumpState dump;
+
+// ============================================================================
+// CODIFICACIÓN
+// ============================================================================
+
+static uint8_t event_log_put_varint(uint8_t *buf, uint32_t value) {
+  uint8_t n = 0;
+  while (value >= 0x80) {
+    buf[n++] = (uint8_t)(value | 0x80);
+    value >>= 7;
+  }
+  buf[n++] = (uint8_t)value;
+  return n;
+}
+
+static const uint8_t *event_log_get_varint(const uint8_t *p, uint32_t *value) {
+  uint8_t shift = 0;
+  uint8_t byte;
+  *value = 0;
+  do {
+    byte = *p++;
+    *value |= (uint32_t)(byte & 0x7F) << shift;
+    shift += 7;
+  } while ((byte & 0x80) && shift < 35);
+  return p;
+}
+
+static uint32_t event_log_zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t event_log_unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static uint8_t event_log_kind(MaterialType material) {
+  return (material <= MATERIAL_VIDRIO) ? (uint8_t)material : EVENT_LOG_KIND_UNKNOWN;
+}
+
+// Decodifica el registro en address y devuelve la dirección del siguiente
+static uint32_t event_log_decode(uint32_t address, EventRecord *record) {
+  const uint8_t *p = (const uint8_t *)(uintptr_t)address;
+  uint8_t header = *p++;
+  
+  memset(record, 0, sizeof(*record));
+  
+  if (header & EVENT_LOG_BYTE_SKIP) {
+    record->kind = EVENT_LOG_KIND_SKIP;
+    return address + 1 + (header & 0x7F);
+  }
+  
+  record->kind = header & 0x07;
+  record->flags = header & 0x78;
+  if (record->kind == EVENT_LOG_KIND_SESSION) {
+    return address + 1;
+  }
+  
+  uint32_t value;
+  p = event_log_get_varint(p, &record->dt);
+  record->confidence = *p++;
+  p = event_log_get_varint(p, &value);
+  record->d_ldr = (int8_t)event_log_unzigzag(value);
+  p = event_log_get_varint(p, &value);
+  record->d_mic = (int8_t)event_log_unzigzag(value);
+  p = event_log_get_varint(p, &record->duration);
+  
+  return (uint32_t)(uintptr_t)p;
+}
+
+// ============================================================================
+// SEGMENTOS
+// ============================================================================
+
+static uint32_t event_log_segment_addr(uint8_t segment) {
+  return EVENT_LOG_ADDR + (uint32_t)segment * EVENT_LOG_SEGMENT_SIZE;
+}
+
+static const EventLogHeader *event_log_header(uint8_t segment) {
+  return (const EventLogHeader *)(uintptr_t)event_log_segment_addr(segment);
+}
+
+static bool event_log_segment_valid(uint8_t segment) {
+  return event_log_header(segment)->magic == EVENT_LOG_MAGIC;
+}
+
+static bool event_log_segment_blank(uint8_t segment) {
+  const uint32_t *words = (const uint32_t *)(uintptr_t)event_log_segment_addr(segment);
+  
+  for (uint32_t i = 0; i < EVENT_LOG_SEGMENT_SIZE / 4; i++) {
+    if (words[i] != 0xFFFFFFFF) return false;
+  }
+  
+  return true;
+}
+
+static uint8_t event_log_next(uint8_t segment) {
+  return (uint8_t)((segment + 1) % EVENT_LOG_SEGMENTS);
+}
+
+// Fin de lo escrito en un segmento legible
+static uint32_t event_log_segment_used(uint8_t segment) {
+  return (segment == log_segment) ? log_write_addr : segment_end[segment];
+}
+
+// Segmentos legibles del más viejo al activo
+static uint8_t event_log_readable(uint8_t *segments) {
+  uint8_t n = 0;
+  
+  for (uint8_t i = 1; i <= EVENT_LOG_SEGMENTS; i++) {
+    uint8_t segment = (uint8_t)((log_segment + i) % EVENT_LOG_SEGMENTS);
+    if (event_log_segment_valid(segment)) segments[n++] = segment;
+  }
+  
+  return n;
+}
+
+// ============================================================================
+// ESCRITURA
+// ============================================================================
+
+static uint8_t event_log_round_unit(uint8_t len) {
+  return (uint8_t)((len + BOARD_FLASH_WRITE_UNIT - 1) / BOARD_FLASH_WRITE_UNIT * BOARD_FLASH_WRITE_UNIT);
+}
+
+// Cuerpo primero y encabezado al final (cada unidad se programa una vez)
+static bool event_log_append(const uint8_t *record, uint8_t len) {
+  uint8_t buf[EVENT_LOG_MAX_SPAN];
+  uint8_t total = event_log_round_unit(len);
+  
+  memcpy(buf, record, len);
+  if (total > len) {
+    buf[len] = EVENT_LOG_BYTE_SKIP | (uint8_t)(total - len - 1);
+    memset(&buf[len + 1], EVENT_LOG_BYTE_END, total - len - 1);
+  }
+  
+  if (total > BOARD_FLASH_WRITE_UNIT &&
+      !board_flash_program(log_write_addr + BOARD_FLASH_WRITE_UNIT, &buf[BOARD_FLASH_WRITE_UNIT],
+                           total - BOARD_FLASH_WRITE_UNIT)) {
+    return false;
+  }
+  if (!board_flash_program(log_write_addr, buf, BOARD_FLASH_WRITE_UNIT)) {
+    return false;
+  }
+  
+  log_write_addr += total;
+  return true;
+}
+
+// Marca de sesión: reinicia las bases de tiempo y de features
+static void event_log_start_session(void) {
+  uint8_t marker = EVENT_LOG_KIND_SESSION;
+  event_log_append(&marker, 1);
+  
+  log_last_tick = HAL_GetTick();
+  log_last_ldr = 0;
+  log_last_mic = 0;
+}
+
+// Empieza un segmento ya borrado: sólo programa el encabezado, sin borrar
+static bool event_log_start_segment(uint8_t segment, uint32_t sequence) {
+  EventLogHeader header = { EVENT_LOG_MAGIC, sequence };
+  uint32_t base = event_log_segment_addr(segment);
+  
+  if (!board_flash_program(base, &header, sizeof(header))) return false;
+  
+  segment_end[log_segment] = log_write_addr;
+  log_segment = segment;
+  log_sequence = sequence;
+  log_write_addr = base + sizeof(EventLogHeader);
+  log_end_addr = base + EVENT_LOG_SEGMENT_SIZE;
+  next_ready = false;
+  event_log_start_session();
+  return true;
+}
+
+static bool event_log_full(void) {
+  return log_write_addr + EVENT_LOG_MAX_SPAN > log_end_addr;
+}
+
+static void event_log_write(const PendingEvent *event, uint32_t duration_ms) {
+  if (!log_enabled) return;
+  
+  // Sin lugar: seguir en el siguiente segmento si ya está borrado. Nunca se
+  // borra acá (camino de la clasificación); hasta que event_log_prepare()
+  // lo borre en reposo, el registro se pierde y se cuenta
+  if (event_log_full() &&
+      (!next_ready || !event_log_start_segment(event_log_next(log_segment), log_sequence + 1))) {
+    log_dropped++;
+    return;
+  }
+  
+  // Delta de tiempo cuantizado, acumulando el redondeo en la base
+  int32_t elapsed = (int32_t)(event->tick - log_last_tick);
+  uint32_t dt = (elapsed > 0) ? (uint32_t)elapsed / EVENT_LOG_TICK_MS : 0;
+  log_last_tick += dt * EVENT_LOG_TICK_MS;
+  
+  uint8_t record[EVENT_LOG_MAX_RECORD];
+  uint8_t len = 0;
+  record[len++] = event->header;
+  len += event_log_put_varint(&record[len], dt);
+  record[len++] = event->confidence;
+  len += event_log_put_varint(&record[len], event_log_zigzag((int32_t)event->ldr - log_last_ldr));
+  len += event_log_put_varint(&record[len], event_log_zigzag((int32_t)event->mic - log_last_mic));
+  len += event_log_put_varint(&record[len], duration_ms / EVENT_LOG_DURATION_MS);
+  
+  if (event_log_append(record, len)) {
+    log_last_ldr = event->ldr;
+    log_last_mic = event->mic;
+    segment_count[log_segment]++;
+    log_count++;
+  }
+}
+
+bool event_log_prepare(void) {
+  if (!log_enabled || next_ready) return next_ready;
+  
+  // El volcado en curso lee los segmentos directo de Flash
+  if (dump.mode != DUMP_IDLE) return false;
+  
+  // El siguiente segmento es el más viejo: se borra recién cuando el activo
+  // está por llenarse, para que siga legible el mayor tiempo posible. Con un
+  // solo segmento, cuando ya no entra nada (y se pierde todo lo anterior)
+  uint32_t margin = (EVENT_LOG_SEGMENTS > 1) ? EVENT_LOG_PREPARE_MARGIN : EVENT_LOG_MAX_SPAN;
+  if (log_write_addr + margin <= log_end_addr) return false;
+  
+  uint8_t next = event_log_next(log_segment);
+  if (!event_log_segment_blank(next) &&
+      !board_flash_erase(event_log_segment_addr(next), EVENT_LOG_SEGMENT_SIZE)) {
+    log_enabled = false;
+    printf("Error: No se pudo borrar el registro de eventos (deshabilitado)\r\n");
+    return false;
+  }
+  
+  log_count -= segment_count[next];
+  segment_count[next] = 0;
+  next_ready = true;
+  
+  // Si el activo ya está lleno se sigue ahora (con un solo segmento, siempre)
+  if (event_log_full() && !event_log_start_segment(next, log_sequence + 1)) {
+    log_enabled = false;
+    printf("Error: No se pudo escribir el registro de eventos (deshabilitado)\r\n");
+  }
+  
+  return next_ready;
+}
+
+// ============================================================================
+// INICIALIZACIÓN
+// ============================================================================
+
+// Bytes escritos después de un encabezado en 0xFF (registro cortado)
+static uint8_t event_log_torn_length(uint32_t address) {
+  const uint8_t *p = (const uint8_t *)(uintptr_t)address;
+  uint8_t torn = 0;
+  
+  for (uint8_t i = 1; i < EVENT_LOG_MAX_SPAN && address + i < log_end_addr; i++) {
+    if (p[i] != EVENT_LOG_BYTE_END) torn = i;
+  }
+  
+  return torn;
+}
+
+// Recorre un segmento hasta el primer byte borrado contando clasificaciones.
+// En el activo, un registro cortado por un reinicio se convierte en un salto
+static uint32_t event_log_scan(uint8_t segment, bool repair) {
+  uint32_t address = event_log_segment_addr(segment) + sizeof(EventLogHeader);
+  uint32_t end = event_log_segment_addr(segment) + EVENT_LOG_SEGMENT_SIZE;
+  segment_count[segment] = 0;
+  
+  while (address < end) {
+    if (*(const uint8_t *)(uintptr_t)address == EVENT_LOG_BYTE_END) {
+      uint8_t torn = repair ? event_log_torn_length(address) : 0;
+      if (torn == 0) break;
+      
+      // Su primera unidad está borrada: se programa como salto
+      uint8_t skip = EVENT_LOG_BYTE_SKIP | (uint8_t)(event_log_round_unit(torn + 1) - 1);
+      board_flash_program(address, &skip, 1);
+      printf("Registro de eventos: descartado registro incompleto\r\n");
+    }
+    
+    EventRecord record;
+    address = event_log_decode(address, &record);
+    if (record.kind < EVENT_LOG_KIND_SESSION) segment_count[segment]++;
+  }
+  
+  return address;
+}
+
+void event_log_init(void) {
+  // Activo: el segmento válido con la secuencia más nueva
+  int8_t active = -1;
+  for (uint8_t segment = 0; segment < EVENT_LOG_SEGMENTS; segment++) {
+    if (!event_log_segment_valid(segment)) continue;
+    if (active < 0 || (int32_t)(event_log_header(segment)->sequence - event_log_header(active)->sequence) > 0) {
+      active = (int8_t)segment;
+    }
+  }
+  
+  log_enabled = true;
+  log_dropped = 0;
+  log_count = 0;
+  memset(segment_count, 0, sizeof(segment_count));
+  
+  if (active < 0) {
+    // Registro nuevo: empieza en el segmento 0 (único borrado fuera de reposo)
+    log_segment = 0;
+    log_write_addr = EVENT_LOG_ADDR + sizeof(EventLogHeader);
+    if ((!event_log_segment_blank(0) && !board_flash_erase(EVENT_LOG_ADDR, EVENT_LOG_SEGMENT_SIZE)) ||
+        !event_log_start_segment(0, 0)) {
+      log_enabled = false;
+      printf("Error: Registro de eventos no disponible (falla de Flash)\r\n");
+      return;
+    }
+  } else {
+    log_segment = (uint8_t)active;
+    log_sequence = event_log_header(active)->sequence;
+    log_end_addr = event_log_segment_addr(log_segment) + EVENT_LOG_SEGMENT_SIZE;
+    
+    for (uint8_t segment = 0; segment < EVENT_LOG_SEGMENTS; segment++) {
+      if (segment == log_segment || !event_log_segment_valid(segment)) continue;
+      segment_end[segment] = event_log_scan(segment, false);
+      log_count += segment_count[segment];
+    }
+    log_write_addr = event_log_scan(log_segment, true);
+    log_count += segment_count[log_segment];
+    
+    uint8_t next = event_log_next(log_segment);
+    next_ready = (next != log_segment) && event_log_segment_blank(next);
+    
+    if (!event_log_full()) {
+      event_log_start_session();
+    } else if (next_ready) {
+      event_log_start_segment(next, log_sequence + 1);
+    }
+  }
+  
+  printf("Registro de eventos: %lu clasificaciones, %lu bytes libres en el segmento %d de %d\r\n",
+         (unsigned long)log_count, (unsigned long)(log_end_addr - log_write_addr), log_segment + 1,
+         EVENT_LOG_SEGMENTS);
+}
+
+// ============================================================================
+// EVENTOS
+// ============================================================================
+
+void event_log_classification(const ClassificationResult *result, SensorDigitalData digital,
+                              SensorAnalogData analog, bool deposited) {
+  // No debería quedar uno pendiente, pero no se pierde: se escribe como está
+  if (pending_valid) {
+    event_log_write(&pending, HAL_GetTick() - pending.tick);
+    pending_valid = false;
+  }
+  
+  float confidence = result->confidence;
+  if (confidence < 0.0f) confidence = 0.0f;
+  if (confidence > 100.0f) confidence = 100.0f;
+  
+  pending.header = event_log_kind(result->material);
+  if (result->isValid)     pending.header |= EVENT_LOG_FLAG_VALID;
+  if (digital.inductivo)   pending.header |= EVENT_LOG_FLAG_INDUCTIVO;
+  if (digital.capacitivo)  pending.header |= EVENT_LOG_FLAG_CAPACITIVO;
+  if (digital.pir)         pending.header |= EVENT_LOG_FLAG_PIR;
+  pending.confidence = (uint8_t)(confidence + 0.5f);
+  pending.ldr = (uint8_t)(analog.ldr_laser >> EVENT_LOG_FEATURE_SHIFT);
+  pending.mic = (uint8_t)(analog.microfono >> EVENT_LOG_FEATURE_SHIFT);
+  pending.tick = HAL_GetTick();
+  
+  if (deposited) {
+    pending_valid = true;
+  } else {
+    event_log_write(&pending, 0);
+  }
+}
+
+static void event_log_dump_service(void);
+
+void event_log_update(void) {
+  event_log_dump_service();
+  
+  if (!pending_valid || actuators_is_busy()) return;
+  
+  // La secuencia de depósito terminó: su duración es la del último script
+  event_log_write(&pending, actuators_get_motion_stats().last_script_ms);
+  pending_valid = false;
+}
+
+uint32_t event_log_get_count(void) {
+  return log_count;
+}
+
+// ============================================================================
+// VOLCADO POR UART
+// ============================================================================
+
+// Formatea una línea y la encola completa, o nada si todavía no entra
+static bool event_log_dump_line(const char *format, ...)
+  __attribute__((format(printf, 1, 2)));
+
+static bool event_log_dump_line(const char *format, ...) {
+  char line[EVENT_LOG_LINE_MAX];
+  va_list args;
+  
+  va_start(args, format);
+  int len = fmt_vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  
+  if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+  return telemetry_write((const uint8_t *)line, (uint16_t)len);
+}
+
+// Un bloque crudo: encabezado y bytes juntos, directo desde Flash
+static bool event_log_dump_raw_chunk(void) {
+  uint32_t base = event_log_segment_addr(dump.segments[dump.index]);
+  uint32_t chunk = dump.end - dump.address;
+  if (chunk > EVENT_LOG_DUMP_CHUNK) chunk = EVENT_LOG_DUMP_CHUNK;
+  
+  char line[EVENT_LOG_LINE_MAX];
+  int len = fmt_snprintf(line, sizeof(line), "EVLOG DATA %lu %lu\r\n",
+                         (unsigned long)(dump.address - base), (unsigned long)chunk);
+  if (telemetry_tx_free() < (uint32_t)len + chunk) return false;
+  
+  const uint8_t *data = (const uint8_t *)(uintptr_t)dump.address;
+  telemetry_write((const uint8_t *)line, (uint16_t)len);
+  telemetry_write(data, (uint16_t)chunk);
+  
+  dump.crc = flash_store_crc32_update(dump.crc, data, chunk);
+  dump.address += chunk;
+  return true;
+}
+
+// Una línea CSV (los registros de salto y de sesión no escriben nada)
+static bool event_log_dump_csv_record(void) {
+  EventRecord record;
+  uint32_t next = event_log_decode(dump.address, &record);
+  
+  if (record.kind == EVENT_LOG_KIND_SKIP) {
+    dump.address = next;
+    return true;
+  }
+  
+  if (record.kind == EVENT_LOG_KIND_SESSION) {
+    dump.session++;
+    dump.time_ms = 0;
+    dump.ldr = 0;
+    dump.mic = 0;
+    dump.address = next;
+    return true;
+  }
+  
+  uint32_t time_ms = dump.time_ms + record.dt * EVENT_LOG_TICK_MS;
+  uint8_t ldr = (uint8_t)(dump.ldr + record.d_ldr);
+  uint8_t mic = (uint8_t)(dump.mic + record.d_mic);
+  MaterialType material = (record.kind == EVENT_LOG_KIND_UNKNOWN) ? MATERIAL_DESCONOCIDO
+                                                                  : (MaterialType)record.kind;
+                                                                  
+  if (!event_log_dump_line("%lu,%lu.%lu,%s,%d,%d,%d,%d,%d,%d,%d,%lu\r\n",
+                           (unsigned long)dump.session, (unsigned long)(time_ms / 1000),
+                           (unsigned long)((time_ms % 1000) / 100),
+                           classifier_get_material_description(material),
+                           (record.flags & EVENT_LOG_FLAG_VALID) != 0,
+                           (record.flags & EVENT_LOG_FLAG_INDUCTIVO) != 0,
+                           (record.flags & EVENT_LOG_FLAG_CAPACITIVO) != 0,
+                           (record.flags & EVENT_LOG_FLAG_PIR) != 0,
+                           record.confidence,
+                           ldr << EVENT_LOG_FEATURE_SHIFT,
+                           mic << EVENT_LOG_FEATURE_SHIFT,
+                           (unsigned long)(record.duration * EVENT_LOG_DURATION_MS))) {
+    return false;
+  }
+  
+  // Las bases avanzan sólo si la línea salió
+  dump.time_ms = time_ms;
+  dump.ldr = ldr;
+  dump.mic = mic;
+  dump.address = next;
+  return true;
+}
+
+// Un paso del volcado; false si hay que esperar a que se vacíe la cola
+static bool event_log_dump_step(void) {
+  if (!dump.opened) {
+    if (dump.mode == DUMP_CSV &&
+        !event_log_dump_line("sesion,t_s,material,valida,ind,cap,pir,confianza,ldr,mic,deposito_ms\r\n")) {
+      return false;
+    }
+    
+    dump.opened = true;
+    return true;
+  }
+  
+  if (dump.index == dump.count) {
+    // Fin: el CSV cierra con el resumen
+    if (dump.mode == DUMP_CSV &&
+        !event_log_dump_line("# %lu clasificaciones en %d segmentos | segmento %lu | sin lugar: %lu%s\r\n",
+                             (unsigned long)log_count, dump.count, (unsigned long)log_sequence,
+                             (unsigned long)log_dropped,
+                             log_enabled ? "" : " | DESHABILITADO")) {
+      return false;
+    }
+    
+    dump.mode = DUMP_IDLE;
+    return false;
+  }
+  
+  uint8_t segment = dump.segments[dump.index];
+  uint32_t base = event_log_segment_addr(segment);
+  
+  if (!dump.started) {
+    // Lo que se escriba en el activo después de este punto queda afuera
+    dump.end = event_log_segment_used(segment);
+    
+    if (dump.mode == DUMP_RAW) {
+      if (!event_log_dump_line("EVLOG %lu\r\n", (unsigned long)(dump.end - base))) return false;
+      dump.address = base;
+      dump.crc = 0;
+    } else {
+      dump.address = base + sizeof(EventLogHeader);
+    }
+    
+    dump.started = true;
+    return true;
+  }
+  
+  if (dump.address < dump.end) {
+    return (dump.mode == DUMP_RAW) ? event_log_dump_raw_chunk() : event_log_dump_csv_record();
+  }
+  
+  if (dump.mode == DUMP_RAW && !event_log_dump_line("EVLOG END %08lX\r\n", (unsigned long)dump.crc)) return false;
+  
+  dump.index++;
+  dump.started = false;
+  return true;
+}
+
+// Avanza el volcado hasta llenar la cola de transmisión
+static void event_log_dump_service(void) {
+  while (dump.mode != DUMP_IDLE && event_log_dump_step()) {
+  }
+}
+
+static bool event_log_dump_start(DumpMode mode) {
+  if (dump.mode != DUMP_IDLE) return false;
+  
+  memset(&dump, 0, sizeof(dump));
+  dump.count = event_log_readable(dump.segments);
+  dump.mode = mode;
+  return true;
+}
+
+bool event_log_dump(void) {
+  return event_log_dump_start(DUMP_RAW);
+}
+
+bool event_log_print(void) {
+  return event_log_dump_start(DUMP_CSV);
+}
+
+bool event_log_is_dumping(void) {
+  return dump.mode != DUMP_IDLE;
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -0,0 +1,294 @@
+/**
+ * @file fill_estimator.c
+ * @brief Implementación de la estimación de llenado de contenedores
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "fill_estimator.h"
+#include "classifier.h"
+#include "params.h"
+#include "sensors.h"
+#include "statistics.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+#define FILL_CONTAINERS     4
+#define FILL_MIN_SAMPLES    3
+#define FILL_MAX_REJECTED   2      // Lecturas atípicas seguidas antes de aceptar
+#define FILL_MS_PER_HOUR    3600000.0f
+
+// Ventana deslizante de lecturas de un contenedor (anillo)
+typedef struct {
+  uint32_t tick[FILL_WINDOW];
+  float level[FILL_WINDOW];        // %
+  uint32_t items[FILL_WINDOW];     // Depósitos acumulados del material
+  uint8_t head;                    // Próxima posición a escribir
+  uint8_t count;
+  uint8_t rejected;                // Lecturas descartadas seguidas
+  bool full;                       // Bloqueado para depósitos (con histéresis)
+  float cached_pct;                // Nivel usado por el bloqueo
+  FillEstimate estimate;
+} FillWindow;
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static FillWindow windows[FILL_CONTAINERS];
+static uint32_t last_sample_tick = 0;
+static bool sampled = false;
+
+// Índice de ventana → contenedor
+static const MaterialType fill_materials[FILL_CONTAINERS] = {
+  MATERIAL_METAL, MATERIAL_PAPEL, MATERIAL_PLASTICO, MATERIAL_VIDRIO
+};
+
+// ============================================================================
+// FUNCIONES AUXILIARES
+// ============================================================================
+
+static int8_t fill_index(MaterialType material) {
+  switch (material) {
+    case MATERIAL_METAL:    return 0;
+    case MATERIAL_PAPEL:    return 1;
+    case MATERIAL_PLASTICO: return 2;
+    case MATERIAL_VIDRIO:   return 3;
+    default:                return -1;
+  }
+}
+
+static float fill_level_pct(float distance_cm) {
+  float level = (CONTAINER_EMPTY_CM - distance_cm) * 100.0f / (CONTAINER_EMPTY_CM - CONTAINER_FULL_CM);
+  if (level < 0.0f) level = 0.0f;
+  if (level > 100.0f) level = 100.0f;
+  return level;
+}
+
+static uint8_t fill_slot(const FillWindow *window, uint8_t i) {
+  // i = 0 es la lectura más vieja de la ventana
+  return (uint8_t)((window->head + FILL_WINDOW - window->count + i) % FILL_WINDOW);
+}
+
+// ============================================================================
+// AJUSTE LINEAL
+// ============================================================================
+
+// Mínimos cuadrados sobre la ventana (tiempo en horas relativo a la última lectura)
+static void fill_fit(FillWindow *window) {
+  FillEstimate *estimate = &window->estimate;
+  memset(estimate, 0, sizeof(*estimate));
+  estimate->samples = window->count;
+  estimate->hours_to_full = -1.0f;
+  estimate->hours_min = -1.0f;
+  estimate->hours_max = -1.0f;
+  
+  if (window->count == 0) return;
+  
+  uint8_t newest = fill_slot(window, window->count - 1);
+  estimate->level_pct = window->level[newest];
+  if (window->count < FILL_MIN_SAMPLES) return;
+  
+  uint32_t t_ref = window->tick[newest];
+  float n = (float)window->count;
+  float mean_t = 0.0f, mean_y = 0.0f, mean_i = 0.0f;
+  
+  for (uint8_t i = 0; i < window->count; i++) {
+    uint8_t slot = fill_slot(window, i);
+    mean_t -= (float)(t_ref - window->tick[slot]) / FILL_MS_PER_HOUR;
+    mean_y += window->level[slot];
+    mean_i += (float)(window->items[slot] - window->items[newest]);
+  }
+  mean_t /= n;
+  mean_y /= n;
+  mean_i /= n;
+  
+  float sxx = 0.0f, sxy = 0.0f, syy = 0.0f, sii = 0.0f, siy = 0.0f;
+  for (uint8_t i = 0; i < window->count; i++) {
+    uint8_t slot = fill_slot(window, i);
+    float dt = -(float)(t_ref - window->tick[slot]) / FILL_MS_PER_HOUR - mean_t;
+    float dy = window->level[slot] - mean_y;
+    float di = (float)(window->items[slot] - window->items[newest]) - mean_i;
+    sxx += dt * dt;
+    sxy += dt * dy;
+    syy += dy * dy;
+    sii += di * di;
+    siy += di * dy;
+  }
+  
+  if (sxx <= 0.0f) return;
+  
+  float slope = sxy / sxx;
+  float level_now = mean_y - slope * mean_t;
+  float sse = syy - slope * sxy;
+  if (sse < 0.0f) sse = 0.0f;
+  float slope_se = sqrtf(sse / (n - 2.0f) / sxx);
+  
+  if (level_now < 0.0f) level_now = 0.0f;
+  if (level_now > 100.0f) level_now = 100.0f;
+  estimate->level_pct = level_now;
+  estimate->rate_pct_h = slope;
+  
+  // Llenado por ítem: nivel contra depósitos acumulados
+  if (sii > 0.0f && siy > 0.0f) {
+    estimate->pct_per_item = siy / sii;
+  }
+  
+  if (slope <= 0.0f) return;
+  
+  // Tiempo hasta lleno con banda de ±2 errores estándar de la pendiente
+  float remaining = 100.0f - level_now;
+  float slope_low = slope - 2.0f * slope_se;
+  estimate->valid = true;
+  estimate->hours_to_full = remaining / slope;
+  estimate->hours_min = remaining / (slope + 2.0f * slope_se);
+  estimate->hours_max = (slope_low > 0.0f) ? remaining / slope_low : -1.0f;
+}
+
+// ============================================================================
+// BLOQUEO DE CONTENEDOR LLENO
+// ============================================================================
+
+static void fill_update_gate(FillWindow *window, float level_pct) {
+  window->cached_pct = level_pct;
+  
+  bool full = window->full ? (level_pct >= params.bin_libre_pct) : (level_pct >= params.bin_lleno_pct);
+  if (full != window->full) {
+    printf("Contenedor %s %s (%.0f%%)\r\n",
+           classifier_get_material_description(fill_materials[window - windows]),
+           full ? "lleno" : "disponible", level_pct);
+  }
+  window->full = full;
+}
+
+bool fill_is_full(MaterialType material) {
+  int8_t index = fill_index(material);
+  return index >= 0 && windows[index].full;
+}
+
+void fill_record_deposit(MaterialType material) {
+  int8_t index = fill_index(material);
+  if (index < 0) return;
+  
+  FillWindow *window = &windows[index];
+  fill_update_gate(window, window->cached_pct + window->estimate.pct_per_item);
+}
+
+MaterialType fill_get_alternate_bin(MaterialType material) {
+  int8_t best = -1;
+  
+  for (uint8_t i = 0; i < FILL_CONTAINERS; i++) {
+    if (fill_materials[i] == material || windows[i].full) continue;
+    if (best < 0 || windows[i].cached_pct < windows[best].cached_pct) best = (int8_t)i;
+  }
+  
+  return (best < 0) ? MATERIAL_NINGUNO : fill_materials[best];
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void fill_init(void) {
+  memset(windows, 0, sizeof(windows));
+  for (uint8_t i = 0; i < FILL_CONTAINERS; i++) {
+    fill_fit(&windows[i]);
+  }
+  sampled = false;
+}
+
+void fill_add_reading(MaterialType material, float distance_cm, uint32_t items, uint32_t tick) {
+  int8_t index = fill_index(material);
+  if (index < 0 || distance_cm < 0.0f) return;   // Timeout del ultrasónico
+  
+  FillWindow *window = &windows[index];
+  float level = fill_level_pct(distance_cm);
+  
+  if (window->count > 0) {
+    uint8_t newest = fill_slot(window, window->count - 1);
+    
+    if (level < window->level[newest] - FILL_EMPTY_DROP_PCT) {
+      // Contenedor vaciado: la ventana vieja ya no sirve
+      printf("Contenedor %s vaciado\r\n", classifier_get_material_description(material));
+      window->count = 0;
+      window->head = 0;
+      window->rejected = 0;
+    } else if (window->count >= FILL_MIN_SAMPLES) {
+      // Descartar ecos falsos que se alejan del ajuste actual
+      float hours = (float)(tick - window->tick[newest]) / FILL_MS_PER_HOUR;
+      float predicted = window->estimate.level_pct + window->estimate.rate_pct_h * hours;
+      if (fabsf(level - predicted) > FILL_OUTLIER_PCT && window->rejected < FILL_MAX_REJECTED) {
+        window->rejected++;
+        return;
+      }
+    }
+  }
+  
+  window->rejected = 0;
+  window->tick[window->head] = tick;
+  window->level[window->head] = level;
+  window->items[window->head] = items;
+  window->head = (window->head + 1) % FILL_WINDOW;
+  if (window->count < FILL_WINDOW) window->count++;
+  
+  fill_fit(window);
+  fill_update_gate(window, window->estimate.level_pct);
+}
+
+void fill_update(Statistics *stats) {
+  uint32_t now = HAL_GetTick();
+  if (sampled && (now - last_sample_tick) < params.fill_periodo_ms) return;
+  
+  sampled = true;
+  last_sample_tick = now;
+  
+  ContainerLevels levels = sensors_read_container_levels();
+  fill_add_reading(MATERIAL_METAL, levels.metal,
+                   statistics_get_material_count(stats, MATERIAL_METAL), now);
+  fill_add_reading(MATERIAL_PAPEL, levels.papel,
+                   statistics_get_material_count(stats, MATERIAL_PAPEL), now);
+  fill_add_reading(MATERIAL_PLASTICO, levels.plastico,
+                   statistics_get_material_count(stats, MATERIAL_PLASTICO), now);
+  fill_add_reading(MATERIAL_VIDRIO, levels.vidrio,
+                   statistics_get_material_count(stats, MATERIAL_VIDRIO), now);
+}
+
+FillEstimate fill_get_estimate(MaterialType material) {
+  int8_t index = fill_index(material);
+  if (index < 0) {
+    FillEstimate empty = {0};
+    return empty;
+  }
+  return windows[index].estimate;
+}
+
+void fill_show_status(void) {
+  printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
+  printf("║                LLENADO DE CONTENEDORES                   ║\r\n");
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  for (uint8_t i = 0; i < FILL_CONTAINERS; i++) {
+    FillEstimate e = windows[i].estimate;
+    printf("║ %-9s %5.1f%% | %+5.2f %%/h | %.2f %%/ítem | n=%d%s\r\n",
+           classifier_get_material_description(fill_materials[i]),
+           e.level_pct, e.rate_pct_h, e.pct_per_item, e.samples,
+           windows[i].full ? " | LLENO" : "");
+    if (!e.valid) {
+      printf("║           lleno en: sin estimación\r\n");
+    } else if (e.hours_max < 0.0f) {
+      printf("║           lleno en: %.1f h (%.1f h - sin cota)\r\n", e.hours_to_full, e.hours_min);
+    } else {
+      printf("║           lleno en: %.1f h (%.1f - %.1f h)\r\n",
+             e.hours_to_full, e.hours_min, e.hours_max);
+    }
+  }
+  printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -0,0 +1,426 @@
+/**
+ * @file flash_store.c
+ * @brief Implementación del acceso a la Flash de datos
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "flash_store.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// FORMATO DE LA IMAGEN
+// ============================================================================
+
+// Página: [encabezado][registro][registro]...[CRC][commit]
+// y después, en lo que queda borrado: [registro][CRC][commit]... agregados
+typedef struct {
+  uint32_t magic;          // FLASH_IMAGE_MAGIC
+  uint16_t version;        // Formato de la imagen
+  uint16_t record_count;   // Registros que siguen al encabezado
+  uint32_t sequence;       // Crece en cada escritura
+  uint32_t length;         // Bytes de registros (múltiplo de FLASH_STORE_ALIGN)
+} FlashImageHeader;
+
+// Encabezado y datos se rellenan juntos hasta múltiplo de FLASH_STORE_ALIGN
+typedef struct {
+  uint8_t type;            // FlashRecordType
+  uint8_t version;         // Versión del registro
+  uint16_t length;         // Bytes de datos (sin relleno)
+} FlashRecordHeader;
+
+#define FLASH_IMAGE_MAGIC       0x53574D44  // "SWMD"
+#define FLASH_IMAGE_VERSION     1
+#define FLASH_IMAGE_COMMIT      0x434F4D54  // "COMT"
+
+// Alineación de registros: palabra, o la unidad de programación si es mayor
+// (doble palabra en la L4). Con 4 el formato es el de siempre
+#define FLASH_STORE_ALIGN       (BOARD_FLASH_WRITE_UNIT > 4 ? BOARD_FLASH_WRITE_UNIT : 4)
+#define FLASH_ALIGN(n)          (((n) + FLASH_STORE_ALIGN - 1u) / FLASH_STORE_ALIGN * FLASH_STORE_ALIGN)
+#define FLASH_RECORD_SIZE(len)  FLASH_ALIGN(sizeof(FlashRecordHeader) + (len))
+
+// Cola de la imagen: CRC-32 del encabezado y los registros, y la marca de
+// commit que se escribe última, cada una en su propia unidad de programación
+#define FLASH_TRAILER_COMMIT    FLASH_STORE_ALIGN
+#define FLASH_TRAILER_SIZE      (2u * FLASH_STORE_ALIGN)
+#define FLASH_IMAGE_MAX_LENGTH  (FLASH_STORE_PAGE_SIZE - sizeof(FlashImageHeader) - FLASH_TRAILER_SIZE)
+
+// Un registro agregado lleva su propia cola (CRC del registro y commit)
+#define FLASH_APPEND_SIZE(len)  (FLASH_RECORD_SIZE(len) + FLASH_TRAILER_SIZE)
+#define FLASH_ERASED_WORD       0xFFFFFFFF
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static const uint32_t flash_pages[2] = { FLASH_PAGE_A_ADDR, FLASH_PAGE_B_ADDR };
+
+static int8_t active_page = -1;          // -1: ninguna imagen válida
+static uint32_t active_sequence = 0;
+static bool spare_ready = false;         // Página inactiva ya borrada
+static volatile bool store_busy = false; // Escritura en curso (el aviso PVD no debe reentrar)
+static uint32_t append_next = 0;         // Lugar libre detrás de la imagen activa (0: sin lugar)
+
+// ============================================================================
+// CRC-32
+// ============================================================================
+
+uint32_t flash_store_crc32(const void *data, uint32_t len) {
+  return flash_store_crc32_update(0, data, len);
+}
+
+uint32_t flash_store_crc32_update(uint32_t crc, const void *data, uint32_t len) {
+  // Tabla de 16 entradas (procesa de a medio byte)
+  static const uint32_t crc_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  const uint8_t *bytes = (const uint8_t *)data;
+  crc ^= 0xFFFFFFFF;
+  
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= bytes[i];
+    crc = (crc >> 4) ^ crc_table[crc & 0x0F];
+    crc = (crc >> 4) ^ crc_table[crc & 0x0F];
+  }
+  
+  return crc ^ 0xFFFFFFFF;
+}
+
+// ============================================================================
+// IMAGEN A/B
+// ============================================================================
+
+static const FlashImageHeader *flash_store_header(int8_t page) {
+  return (const FlashImageHeader *)(uintptr_t)flash_pages[page];
+}
+
+static uint32_t flash_store_trailer(int8_t page) {
+  const FlashImageHeader *header = flash_store_header(page);
+  return flash_pages[page] + sizeof(FlashImageHeader) + header->length;
+}
+
+// Una imagen terminó de escribirse si el encabezado es coherente y la marca
+// de commit está puesta: no lee más que el encabezado y la cola
+static bool flash_store_page_committed(int8_t page) {
+  const FlashImageHeader *header = flash_store_header(page);
+  
+  if (header->magic != FLASH_IMAGE_MAGIC ||
+      header->version != FLASH_IMAGE_VERSION ||
+      header->length > FLASH_IMAGE_MAX_LENGTH ||
+      header->length % FLASH_STORE_ALIGN != 0) {
+    return false;
+  }
+  
+  uint32_t trailer = flash_store_trailer(page);
+  return *(const uint32_t *)(uintptr_t)(trailer + FLASH_TRAILER_COMMIT) == FLASH_IMAGE_COMMIT;
+}
+
+static bool flash_store_page_crc_ok(int8_t page) {
+  const FlashImageHeader *header = flash_store_header(page);
+  uint32_t trailer = flash_store_trailer(page);
+  return *(const uint32_t *)(uintptr_t)trailer == flash_store_crc32(header, sizeof(FlashImageHeader) + header->length);
+}
+
+static bool flash_store_page_blank(int8_t page);
+static uint32_t flash_store_scan_appended(FlashRecordType type, uint8_t version, void *data, uint16_t len,
+                                          bool *found);
+
+// La candidata sale del commit y la secuencia; el CRC se calcula sólo sobre
+// ella, y sobre la otra página únicamente si no coincide
+bool flash_store_init(void) {
+  bool committed_a = flash_store_page_committed(0);
+  bool committed_b = flash_store_page_committed(1);
+  int8_t candidate = -1;
+  int8_t fallback = -1;
+  
+  if (committed_a && committed_b) {
+    // Comparación tolerante al desborde de la secuencia
+    int32_t diff = (int32_t)(flash_store_header(1)->sequence - flash_store_header(0)->sequence);
+    candidate = (diff > 0) ? 1 : 0;
+    fallback = (candidate == 0) ? 1 : 0;
+  } else if (committed_a) {
+    candidate = 0;
+  } else if (committed_b) {
+    candidate = 1;
+  }
+  
+  if (candidate >= 0 && flash_store_page_crc_ok(candidate)) {
+    active_page = candidate;
+  } else if (fallback >= 0 && flash_store_page_crc_ok(fallback)) {
+    printf("Flash: CRC de la imagen %c inválido, se usa la anterior\r\n", 'A' + candidate);
+    active_page = fallback;
+  } else {
+    active_page = -1;
+    active_sequence = 0;
+    append_next = 0;
+    spare_ready = flash_store_page_blank(0);
+    printf("Flash: sin imagen de datos válida\r\n");
+    return false;
+  }
+  
+  active_sequence = flash_store_header(active_page)->sequence;
+  spare_ready = flash_store_page_blank((active_page == 0) ? 1 : 0);
+  append_next = flash_store_scan_appended(0, 0, NULL, 0, NULL);
+  printf("Flash: imagen %c activa (secuencia %lu)\r\n", 'A' + active_page, (unsigned long)active_sequence);
+  return true;
+}
+
+// Busca un registro recorriendo la imagen activa
+static const FlashRecordHeader *flash_store_find(FlashRecordType type) {
+  if (active_page < 0) return NULL;
+  
+  const FlashImageHeader *header = flash_store_header(active_page);
+  uint32_t address = flash_pages[active_page] + sizeof(FlashImageHeader);
+  
+  for (uint16_t i = 0; i < header->record_count; i++) {
+    const FlashRecordHeader *record = (const FlashRecordHeader *)(uintptr_t)address;
+    if (record->type == type) return record;
+    address += FLASH_RECORD_SIZE(record->length);
+  }
+  
+  return NULL;
+}
+
+bool flash_store_read_record(FlashRecordType type, uint8_t version, void *data, uint16_t len) {
+  const FlashRecordHeader *record = flash_store_find(type);
+  
+  if (record == NULL || record->version != version || record->length != len) {
+    return false;
+  }
+  
+  memcpy(data, record + 1, len);
+  return true;
+}
+
+bool flash_store_read_record_var(FlashRecordType type, uint8_t version, void *data,
+                                 uint16_t max_len, uint16_t *len) {
+  const FlashRecordHeader *record = flash_store_find(type);
+  
+  if (record == NULL || record->version != version || record->length > max_len) {
+    return false;
+  }
+  
+  memcpy(data, record + 1, record->length);
+  *len = record->length;
+  return true;
+}
+
+// Registro en Flash: la primera unidad lleva el encabezado y el comienzo
+// de los datos (cada unidad se programa una sola vez)
+static bool flash_store_program_record(uint32_t address, FlashRecordType type, uint8_t version,
+                                       const void *data, uint16_t len) {
+  FlashRecordHeader record = { .type = type, .version = version, .length = len };
+  uint8_t first[FLASH_STORE_ALIGN];
+  uint16_t head = len;
+  if (head > FLASH_STORE_ALIGN - sizeof(record)) head = FLASH_STORE_ALIGN - sizeof(record);
+  memcpy(first, &record, sizeof(record));
+  memcpy(&first[sizeof(record)], data, head);
+  
+  return board_flash_program(address, first, sizeof(record) + head) &&
+         (len == head || board_flash_program(address + FLASH_STORE_ALIGN, (const uint8_t *)data + head, len - head));
+}
+
+static bool flash_store_write_image(FlashRecordType type, uint8_t version, const void *data, uint16_t len) {
+  int8_t target = (active_page == 0) ? 1 : 0;
+  uint32_t base = flash_pages[target];
+  
+  // Calcular el tamaño de la nueva imagen
+  FlashImageHeader header = {
+    .magic = FLASH_IMAGE_MAGIC,
+    .version = FLASH_IMAGE_VERSION,
+    .record_count = 1,
+    .sequence = active_sequence + 1,
+    .length = FLASH_RECORD_SIZE(len)
+  };
+  
+  if (active_page >= 0) {
+    const FlashImageHeader *old = flash_store_header(active_page);
+    uint32_t address = flash_pages[active_page] + sizeof(FlashImageHeader);
+    for (uint16_t i = 0; i < old->record_count; i++) {
+      const FlashRecordHeader *record = (const FlashRecordHeader *)(uintptr_t)address;
+      uint32_t size = FLASH_RECORD_SIZE(record->length);
+      if (record->type != type) {
+        header.record_count++;
+        header.length += size;
+      }
+      address += size;
+    }
+  }
+  
+  if (header.length > FLASH_IMAGE_MAX_LENGTH) {
+    printf("Error: Imagen de Flash demasiado grande (%lu bytes)\r\n", (unsigned long)header.length);
+    return false;
+  }
+  
+  // La página destino es la más vieja: la activa queda intacta.
+  // Si ya se borró en reposo, sólo queda programar
+  if (!spare_ready && !board_flash_erase(base, FLASH_STORE_PAGE_SIZE)) return false;
+  spare_ready = false;
+  
+  uint32_t address = base;
+  if (!board_flash_program(address, &header, sizeof(header))) return false;
+  address += sizeof(header);
+  
+  // Copiar los registros que no cambian
+  if (active_page >= 0) {
+    const FlashImageHeader *old = flash_store_header(active_page);
+    uint32_t source = flash_pages[active_page] + sizeof(FlashImageHeader);
+    for (uint16_t i = 0; i < old->record_count; i++) {
+      const FlashRecordHeader *record = (const FlashRecordHeader *)(uintptr_t)source;
+      uint32_t size = FLASH_RECORD_SIZE(record->length);
+      if (record->type != type) {
+        if (!board_flash_program(address, record, size)) return false;
+        address += size;
+      }
+      source += size;
+    }
+  }
+  
+  // Registro nuevo
+  if (!flash_store_program_record(address, type, version, data, len)) return false;
+  address += FLASH_RECORD_SIZE(len);
+  
+  // CRC sobre lo que quedó en Flash (verifica también la escritura) y commit al final
+  uint32_t crc = flash_store_crc32((const void *)(uintptr_t)base, sizeof(header) + header.length);
+  uint32_t commit = FLASH_IMAGE_COMMIT;
+  if (!board_flash_program(address, &crc, sizeof(crc)) ||
+      !board_flash_program(address + FLASH_TRAILER_COMMIT, &commit, sizeof(commit))) {
+    return false;
+  }
+  
+  // Lo que sigue a la cola está borrado: lo agregado a la imagen anterior queda atrás
+  active_page = target;
+  active_sequence = header.sequence;
+  append_next = address + FLASH_TRAILER_SIZE;
+  return true;
+}
+
+bool flash_store_write_record(FlashRecordType type, uint8_t version, const void *data, uint16_t len) {
+  if (store_busy) return false;
+  
+  store_busy = true;
+  bool ok = flash_store_write_image(type, version, data, len);
+  store_busy = false;
+  
+  return ok;
+}
+
+// ============================================================================
+// REGISTROS AGREGADOS
+// ============================================================================
+
+// Recorre lo agregado detrás de la imagen activa y devuelve el primer lugar
+// libre (0 si no queda). Con data copia el último registro confirmado de
+// ese tipo, versión y tamaño. Un encabezado dañado por un corte puede dar
+// cualquier largo: si se sale de la página, no se agrega más hasta la
+// próxima imagen
+static uint32_t flash_store_scan_appended(FlashRecordType type, uint8_t version, void *data, uint16_t len,
+                                          bool *found) {
+  if (active_page < 0) return 0;
+  
+  uint32_t end = flash_pages[active_page] + FLASH_STORE_PAGE_SIZE;
+  uint32_t address = flash_store_trailer(active_page) + FLASH_TRAILER_SIZE;
+  
+  while (address + FLASH_APPEND_SIZE(0) <= end) {
+    const FlashRecordHeader *record = (const FlashRecordHeader *)(uintptr_t)address;
+    if (*(const uint32_t *)(uintptr_t)address == FLASH_ERASED_WORD) return address;
+    
+    uint32_t size = FLASH_APPEND_SIZE(record->length);
+    if (address + size > end) return 0;
+    
+    uint32_t trailer = address + FLASH_RECORD_SIZE(record->length);
+    if (data != NULL && record->type == type && record->version == version && record->length == len &&
+        *(const uint32_t *)(uintptr_t)(trailer + FLASH_TRAILER_COMMIT) == FLASH_IMAGE_COMMIT &&
+        *(const uint32_t *)(uintptr_t)trailer == flash_store_crc32(record, sizeof(FlashRecordHeader) + len)) {
+      memcpy(data, record + 1, len);
+      *found = true;
+    }
+    address += size;
+  }
+  
+  return 0;
+}
+
+bool flash_store_append_record(FlashRecordType type, uint8_t version, const void *data, uint16_t len) {
+  if (store_busy || append_next == 0) return false;
+  
+  uint32_t address = append_next;
+  uint32_t end = flash_pages[active_page] + FLASH_STORE_PAGE_SIZE;
+  if (address + FLASH_APPEND_SIZE(len) > end) return false;
+  
+  store_busy = true;
+  
+  // El lugar se da por usado antes de programar: tras una falla no se
+  // vuelve a programar encima
+  append_next = address + FLASH_APPEND_SIZE(len);
+  uint32_t trailer = address + FLASH_RECORD_SIZE(len);
+  bool ok = flash_store_program_record(address, type, version, data, len);
+  if (ok) {
+    uint32_t crc = flash_store_crc32((const void *)(uintptr_t)address, sizeof(FlashRecordHeader) + len);
+    uint32_t commit = FLASH_IMAGE_COMMIT;
+    ok = board_flash_program(trailer, &crc, sizeof(crc)) &&
+         board_flash_program(trailer + FLASH_TRAILER_COMMIT, &commit, sizeof(commit));
+  }
+  
+  store_busy = false;
+  return ok;
+}
+
+bool flash_store_read_appended(FlashRecordType type, uint8_t version, void *data, uint16_t len) {
+  bool found = false;
+  flash_store_scan_appended(type, version, data, len, &found);
+  return found;
+}
+
+// ============================================================================
+// PÁGINA DE RESERVA
+// ============================================================================
+
+static bool flash_store_page_blank(int8_t page) {
+  const uint32_t *words = (const uint32_t *)(uintptr_t)flash_pages[page];
+  
+  for (uint32_t i = 0; i < FLASH_STORE_PAGE_SIZE / 4; i++) {
+    if (words[i] != 0xFFFFFFFF) return false;
+  }
+  
+  return true;
+}
+
+bool flash_store_prepare(void) {
+  if (spare_ready || store_busy) return spare_ready;
+  
+  int8_t spare = (active_page == 0) ? 1 : 0;
+  
+  store_busy = true;
+  spare_ready = flash_store_page_blank(spare) ||
+                board_flash_erase(flash_pages[spare], FLASH_STORE_PAGE_SIZE);
+  store_busy = false;
+  
+  return spare_ready;
+}
+
+bool flash_store_is_ready(void) {
+  return spare_ready;
+}
+
+void flash_store_show_status(void) {
+  if (active_page < 0) {
+    printf("Flash: sin imagen activa\r\n");
+    return;
+  }
+  
+  const FlashImageHeader *header = flash_store_header(active_page);
+  uint32_t free_bytes = append_next ? flash_pages[active_page] + FLASH_STORE_PAGE_SIZE - append_next : 0;
+  printf("Flash: imagen %c | secuencia %lu | %d registros | %lu bytes | reserva %s\r\n",
+         'A' + active_page, (unsigned long)active_sequence, header->record_count,
+         (unsigned long)header->length, spare_ready ? "borrada" : "pendiente");
+  printf("Flash: %lu bytes libres para agregar detrás de la imagen\r\n", (unsigned long)free_bytes);
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
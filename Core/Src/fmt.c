@@ -0,0 +1,399 @@
+/**
+ * @file fmt.c
+ * @brief Implementación del formateo de texto sólo con enteros
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "fmt.h"
+#include <stdbool.h>
+#include <string.h>
+
+// ============================================================================
+// SALIDA
+// ============================================================================
+
+// Destino del formateo: un buffer que, si tiene flush, se vacía al llenarse
+typedef struct FmtOut {
+  char *buf;
+  size_t size;                 // Lugar para caracteres (sin contar el '\0')
+  size_t len;
+  int total;                   // Caracteres generados (incluso los que no entraron)
+  void (*flush)(struct FmtOut *out);
+} FmtOut;
+
+#define FMT_FLAG_LEFT           0x01
+#define FMT_FLAG_ZERO           0x02
+#define FMT_FLAG_PLUS           0x04
+#define FMT_FLAG_SPACE          0x08
+
+static const uint32_t pow10_table[10] = {
+  1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+static void out_char(FmtOut *out, char c) {
+  if (out->len >= out->size && out->flush != NULL) out->flush(out);
+  if (out->len < out->size) out->buf[out->len++] = c;
+  out->total++;
+}
+
+static void out_repeat(FmtOut *out, char c, int count) {
+  while (count-- > 0) out_char(out, c);
+}
+
+// Campo completo: relleno, signo, ceros de precisión y dígitos
+static void out_field(FmtOut *out, const char *sign, const char *body, int body_len,
+                      int zeros, int width, uint8_t flags) {
+  int sign_len = (int)strlen(sign);
+  int pad = width - sign_len - zeros - body_len;
+  
+  if (!(flags & FMT_FLAG_LEFT) && !(flags & FMT_FLAG_ZERO)) out_repeat(out, ' ', pad);
+  for (int i = 0; i < sign_len; i++) out_char(out, sign[i]);
+  if (!(flags & FMT_FLAG_LEFT) && (flags & FMT_FLAG_ZERO)) out_repeat(out, '0', pad);
+  out_repeat(out, '0', zeros);
+  for (int i = 0; i < body_len; i++) out_char(out, body[i]);
+  if (flags & FMT_FLAG_LEFT) out_repeat(out, ' ', pad);
+}
+
+// ============================================================================
+// CONVERSIONES
+// ============================================================================
+
+// Dígitos de derecha a izquierda; devuelve el primero (sin '\0')
+static char *fmt_utoa(char *end, uint32_t value, uint8_t base, bool upper) {
+  const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  char *p = end;
+  do {
+    *--p = digits[value % base];
+    value /= base;
+  } while (value != 0);
+  return p;
+}
+
+// La división de 64 bits (libgcc) sólo se enlaza si alguien usa %ll
+static char *fmt_ulltoa(char *end, uint64_t value, uint8_t base, bool upper) {
+  if (value <= UINT32_MAX) return fmt_utoa(end, (uint32_t)value, base, upper);
+  
+  const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  char *p = end;
+  do {
+    *--p = digits[value % base];
+    value /= base;
+  } while (value != 0);
+  return p;
+}
+
+static const char *fmt_sign(bool negative, uint8_t flags) {
+  if (negative) return "-";
+  if (flags & FMT_FLAG_PLUS) return "+";
+  if (flags & FMT_FLAG_SPACE) return " ";
+  return "";
+}
+
+static void fmt_integer(FmtOut *out, uint64_t magnitude, bool negative, uint8_t base, bool upper,
+                        int width, int precision, uint8_t flags) {
+  char digits[24];
+  char *end = &digits[sizeof(digits)];
+  char *p = fmt_ulltoa(end, magnitude, base, upper);
+  int len = (int)(end - p);
+  
+  // Con precisión, el 0 se rellena con espacios y no con ceros (como printf)
+  if (precision >= 0) {
+    flags &= ~FMT_FLAG_ZERO;
+    if (precision == 0 && magnitude == 0) len = 0;
+  }
+  int zeros = (precision > len) ? precision - len : 0;
+  
+  out_field(out, fmt_sign(negative, flags), p, len, zeros, width, flags);
+}
+
+// Punto fijo sin operaciones de double (en el Cortex-M4 serían por software):
+// se separan mantisa y exponente, la parte fraccionaria queda como fracción
+// de 64 bits y se multiplica por 10^precision. El redondeo es al par más
+// cercano sobre el valor exacto, igual que printf
+static void fmt_fixed(FmtOut *out, double value, int width, int precision, uint8_t flags) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  bool negative = (bits >> 63) != 0;
+  int exponent = (int)((bits >> 52) & 0x7FF);
+  uint64_t mantissa = bits & ((1ULL << 52) - 1);
+  if (precision < 0) precision = 6;
+  if (precision > 9) precision = 9;
+  
+  const char *special = NULL;
+  if (exponent == 0x7FF) special = (mantissa != 0) ? "nan" : "inf";
+  else if (exponent - 1023 >= 32) special = "ovf";
+  if (special != NULL) {
+    out_field(out, fmt_sign(negative, flags), special, 3, 0, width, flags & ~FMT_FLAG_ZERO);
+    return;
+  }
+  
+  // value = mantissa * 2^-shift, con shift >= 21 porque value < 2^32
+  if (exponent != 0) mantissa |= 1ULL << 52;
+  int shift = 1075 - ((exponent != 0) ? exponent : 1);
+  uint32_t integer = (shift < 64) ? (uint32_t)(mantissa >> shift) : 0;
+  uint64_t fraction;   // Parte fraccionaria * 2^64
+  if (shift < 64) fraction = mantissa << (64 - shift);
+  else if (shift < 128) fraction = mantissa >> (shift - 64);
+  else fraction = 0;
+  
+  // fraction * scale = digits * 2^64 + rest, con multiplicaciones de 32x32
+  uint32_t scale = pow10_table[precision];
+  uint64_t low = (fraction & 0xFFFFFFFFu) * scale;
+  uint64_t high = (fraction >> 32) * scale;
+  uint64_t middle = (low >> 32) + (high & 0xFFFFFFFFu);
+  uint32_t digits = (uint32_t)((high >> 32) + (middle >> 32));
+  uint64_t rest = (middle << 32) | (low & 0xFFFFFFFFu);
+  
+  uint32_t last = (precision > 0) ? digits : integer;
+  if (rest > (1ULL << 63) || (rest == (1ULL << 63) && (last & 1))) {
+    if (++digits >= scale) {
+      digits = 0;
+      if (integer == UINT32_MAX) {
+        out_field(out, fmt_sign(negative, flags), "ovf", 3, 0, width, flags & ~FMT_FLAG_ZERO);
+        return;
+      }
+      integer++;
+    }
+  }
+  
+  char text[24];
+  char *end = &text[sizeof(text)];
+  char *p = end;
+  if (precision > 0) {
+    p = fmt_utoa(end, digits, 10, false);
+    while (end - p < precision) *--p = '0';
+    *--p = '.';
+  }
+  p = fmt_utoa(p, integer, 10, false);
+  
+  out_field(out, fmt_sign(negative, flags), p, (int)(end - p), 0, width, flags);
+}
+
+// ============================================================================
+// INTÉRPRETE DEL FORMATO
+// ============================================================================
+
+static void fmt_run(FmtOut *out, const char *format, va_list args) {
+  while (*format != '\0') {
+    if (*format != '%') {
+      out_char(out, *format++);
+      continue;
+    }
+    format++;
+    
+    // Banderas
+    uint8_t flags = 0;
+    for (;; format++) {
+      if (*format == '-') flags |= FMT_FLAG_LEFT;
+      else if (*format == '0') flags |= FMT_FLAG_ZERO;
+      else if (*format == '+') flags |= FMT_FLAG_PLUS;
+      else if (*format == ' ') flags |= FMT_FLAG_SPACE;
+      else if (*format != '#') break;
+    }
+    
+    // Ancho y precisión
+    int width = 0;
+    if (*format == '*') {
+      width = va_arg(args, int);
+      if (width < 0) {
+        flags |= FMT_FLAG_LEFT;
+        width = -width;
+      }
+      format++;
+    } else {
+      while (*format >= '0' && *format <= '9') width = width * 10 + (*format++ - '0');
+    }
+    
+    int precision = -1;
+    if (*format == '.') {
+      format++;
+      precision = 0;
+      if (*format == '*') {
+        precision = va_arg(args, int);
+        format++;
+      } else {
+        while (*format >= '0' && *format <= '9') precision = precision * 10 + (*format++ - '0');
+      }
+    }
+    
+    // Largo: l es de 32 bits en el Cortex-M; h y hh llegan promovidos a int
+    uint8_t longs = 0;
+    uint8_t shorts = 0;
+    while (*format == 'h' || *format == 'l' || *format == 'z') {
+      if (*format == 'l') longs++;
+      if (*format == 'h') shorts++;
+      format++;
+    }
+    
+    char conv = *format;
+    if (conv == '\0') break;
+    format++;
+    
+    switch (conv) {
+      case 'd':
+      case 'i': {
+        int64_t value = (longs >= 2) ? va_arg(args, long long) :
+                        (longs == 1) ? va_arg(args, long) : va_arg(args, int);
+        if (shorts == 1) value = (short)value;
+        if (shorts >= 2) value = (signed char)value;
+        uint64_t magnitude = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+        fmt_integer(out, magnitude, value < 0, 10, false, width, precision, flags);
+        break;
+      }
+      
+      case 'u':
+      case 'x':
+      case 'X': {
+        uint64_t value = (longs >= 2) ? va_arg(args, unsigned long long) :
+                         (longs == 1) ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+        if (shorts == 1) value = (unsigned short)value;
+        if (shorts >= 2) value = (unsigned char)value;
+        flags &= ~(FMT_FLAG_PLUS | FMT_FLAG_SPACE);
+        fmt_integer(out, value, false, (conv == 'u') ? 10 : 16, conv == 'X', width, precision, flags);
+        break;
+      }
+      
+      case 'p': {
+        uintptr_t value = (uintptr_t)va_arg(args, void *);
+        out_char(out, '0');
+        out_char(out, 'x');
+        fmt_integer(out, value, false, 16, false, 0, (int)(sizeof(void *) * 2), 0);
+        break;
+      }
+      
+      case 'f':
+      case 'F':
+        fmt_fixed(out, va_arg(args, double), width, precision, flags);
+        break;
+        
+      case 'c': {
+        char c = (char)va_arg(args, int);
+        out_field(out, "", &c, 1, 0, width, flags & FMT_FLAG_LEFT);
+        break;
+      }
+      
+      case 's': {
+        const char *s = va_arg(args, const char *);
+        if (s == NULL) s = "(null)";
+        int len = 0;
+        while (s[len] != '\0' && (precision < 0 || len < precision)) len++;
+        out_field(out, "", s, len, 0, width, flags & FMT_FLAG_LEFT);
+        break;
+      }
+      
+      case '%':
+        out_char(out, '%');
+        break;
+        
+      default:
+        // Conversión desconocida: se copia tal cual para que se note
+        out_char(out, '%');
+        out_char(out, conv);
+        break;
+    }
+  }
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+int fmt_vsnprintf(char *buf, size_t size, const char *format, va_list args) {
+  FmtOut out = { buf, (size > 0) ? size - 1 : 0, 0, 0, NULL };
+  fmt_run(&out, format, args);
+  if (size > 0) buf[out.len] = '\0';
+  return out.total;
+}
+
+int fmt_snprintf(char *buf, size_t size, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = fmt_vsnprintf(buf, size, format, args);
+  va_end(args);
+  return len;
+}
+
+// Definida en main.c: consola, después de las tramas de telemetría en cola
+int _write(int file, char *ptr, int len);
+
+static void fmt_console_flush(FmtOut *out) {
+  if (out->len > 0) _write(1, out->buf, (int)out->len);
+  out->len = 0;
+}
+
+int fmt_vprintf(const char *format, va_list args) {
+  char chunk[FMT_PRINTF_CHUNK];
+  FmtOut out = { chunk, sizeof(chunk), 0, 0, fmt_console_flush };
+  fmt_run(&out, format, args);
+  fmt_console_flush(&out);
+  return out.total;
+}
+
+int fmt_printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = fmt_vprintf(format, args);
+  va_end(args);
+  return len;
+}
+
+// ============================================================================
+// REEMPLAZO DE NEWLIB
+// ============================================================================
+
+#if FMT_REPLACE_STDIO
+
+// El compilador convierte printf("texto\n") en puts() y printf("x") en
+// putchar(): también se reemplazan para que newlib no entre por ahí
+
+int printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = fmt_vprintf(format, args);
+  va_end(args);
+  return len;
+}
+
+int vprintf(const char *format, va_list args) {
+  return fmt_vprintf(format, args);
+}
+
+int sprintf(char *buf, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = fmt_vsnprintf(buf, SIZE_MAX, format, args);
+  va_end(args);
+  return len;
+}
+
+int snprintf(char *buf, size_t size, const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  int len = fmt_vsnprintf(buf, size, format, args);
+  va_end(args);
+  return len;
+}
+
+int vsnprintf(char *buf, size_t size, const char *format, va_list args) {
+  return fmt_vsnprintf(buf, size, format, args);
+}
+
+int puts(const char *text) {
+  int len = (int)strlen(text);
+  _write(1, (char *)text, len);
+  _write(1, "\n", 1);
+  return len + 1;
+}
+
+int putchar(int c) {
+  char ch = (char)c;
+  _write(1, &ch, 1);
+  return (unsigned char)ch;
+}
+
+#endif // FMT_REPLACE_STDIO
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
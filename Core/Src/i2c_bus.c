@@ -0,0 +1,335 @@
+/**
+ * @file i2c_bus.c
+ * @brief Implementación del administrador del bus I2C1
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "i2c_bus.h"
+#include "profiler.h"
+#include <stdio.h>
+
+// ============================================================================
+// CONSTANTES PRIVADAS
+// ============================================================================
+
+#define I2C_BUS_WINDOW_MS       1000   // Ventana de la medición de ocupación
+#define I2C_BUS_RECOVERY_PULSES 9      // Un byte + ACK: suelta a un esclavo a mitad de byte
+#define I2C_BUS_RECOVERY_US     5      // Medio período de SCL durante la liberación (~100 kHz)
+
+typedef enum {
+  I2C_PHASE_TX = 0,
+  I2C_PHASE_RX = 1
+} I2cPhase;
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+// Cola: head lo mueve el loop (i2c_bus_submit), tail quien arranca la transacción
+static I2cTransaction *queue[I2C_BUS_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+static I2cTransaction *volatile active = NULL;
+static volatile I2cPhase active_phase = I2C_PHASE_TX;
+static uint32_t active_start_tick = 0;
+static uint32_t active_start_cycles = 0;
+static uint32_t active_timeout_ms = 0;
+static uint32_t active_erase_count = 0;     // board_flash_erase_count al arrancar
+
+static volatile bool recover_pending = false;
+static volatile uint32_t busy_us = 0;         // Ocupación acumulada en la ventana
+static uint32_t window_start = 0;
+
+static I2cBusStats bus_stats = {0};
+
+// ============================================================================
+// UTILIDADES
+// ============================================================================
+
+static uint8_t i2c_bus_queue_depth(void) {
+  return (uint8_t)((queue_head + I2C_BUS_QUEUE_SIZE - queue_tail) % I2C_BUS_QUEUE_SIZE);
+}
+
+// Sólo se reprograma el periférico si la velocidad cambia (board_<placa>.c)
+static void i2c_bus_set_speed(uint32_t speed_hz) {
+  if (speed_hz == 0 || speed_hz > I2C_BUS_SPEED_FAST) speed_hz = I2C_BUS_SPEED_FAST;
+  if (board_i2c_get_speed() == speed_hz) return;
+  
+  board_i2c_set_speed(speed_hz);
+}
+
+// Duración teórica (9 bits por byte, direcciones incluidas) + margen
+static uint32_t i2c_bus_timeout_ms(const I2cTransaction *t) {
+  uint32_t bytes = t->tx_len + t->rx_len + 2u;
+  uint32_t speed = (t->speed_hz > 0) ? t->speed_hz : I2C_BUS_SPEED_FAST;
+  return (bytes * 9u * 1000u) / speed + 1u + I2C_BUS_TIMEOUT_MS;
+}
+
+static void i2c_bus_delay_us(uint32_t us) {
+  uint32_t start = profiler_cycles();
+  uint32_t cycles = us * (SystemCoreClock / 1000000u);
+  while (profiler_cycles() - start < cycles) {
+  }
+}
+
+// ============================================================================
+// EJECUCIÓN (loop e IRQ)
+// ============================================================================
+
+// Cierra la transacción activa y avisa al cliente
+static void i2c_bus_finish(I2cBusStatus status) {
+  I2cTransaction *t = active;
+  if (t == NULL) return;
+  
+  active = NULL;
+  busy_us += profiler_cycles_to_us(profiler_cycles() - active_start_cycles);
+  
+  bus_stats.transactions++;
+  switch (status) {
+    case I2C_BUS_OK:      bus_stats.bytes += t->tx_len + t->rx_len; break;
+    case I2C_BUS_NACK:    bus_stats.nacks++; break;
+    case I2C_BUS_ERROR:   bus_stats.errors++; break;
+    case I2C_BUS_TIMEOUT: bus_stats.timeouts++; break;
+  }
+  
+  if (t->done != NULL) t->done(status, t->context);
+}
+
+static HAL_StatusTypeDef i2c_bus_start(I2cTransaction *t) {
+  uint16_t address = (uint16_t)(t->address << 1);
+  
+  i2c_bus_set_speed(t->speed_hz);
+  active = t;
+  active_start_tick = HAL_GetTick();
+  active_start_cycles = profiler_cycles();
+  active_timeout_ms = i2c_bus_timeout_ms(t);
+  active_erase_count = board_flash_erase_count();
+  
+  if (t->tx_len > 0 && t->rx_len > 0) {
+    // Escritura sin STOP y lectura con START repetido
+    active_phase = I2C_PHASE_TX;
+    return HAL_I2C_Master_Seq_Transmit_IT(&hi2c1, address, t->tx, t->tx_len, I2C_FIRST_FRAME);
+  }
+  if (t->tx_len > 0) {
+    active_phase = I2C_PHASE_TX;
+    return HAL_I2C_Master_Transmit_IT(&hi2c1, address, t->tx, t->tx_len);
+  }
+  active_phase = I2C_PHASE_RX;
+  return HAL_I2C_Master_Receive_IT(&hi2c1, address, t->rx, t->rx_len);
+}
+
+// Arranca la siguiente transacción de la cola si el bus está libre
+static void i2c_bus_start_next(void) {
+  if (active != NULL || recover_pending || queue_tail == queue_head) return;
+  
+  I2cTransaction *t = queue[queue_tail];
+  queue_tail = (queue_tail + 1) % I2C_BUS_QUEUE_SIZE;
+  
+  if (i2c_bus_start(t) != HAL_OK) {
+    // La HAL no aceptó la transferencia: liberar el bus antes de seguir
+    i2c_bus_finish(I2C_BUS_ERROR);
+    recover_pending = true;
+  }
+}
+
+void i2c_bus_tx_complete(void) {
+  I2cTransaction *t = active;
+  if (t == NULL) return;
+  
+  if (active_phase == I2C_PHASE_TX && t->rx_len > 0) {
+    active_phase = I2C_PHASE_RX;
+    if (HAL_I2C_Master_Seq_Receive_IT(&hi2c1, (uint16_t)(t->address << 1), t->rx, t->rx_len,
+                                      I2C_LAST_FRAME) != HAL_OK) {
+      i2c_bus_finish(I2C_BUS_ERROR);
+      recover_pending = true;
+    }
+    return;
+  }
+  
+  i2c_bus_finish(I2C_BUS_OK);
+  i2c_bus_start_next();
+}
+
+void i2c_bus_rx_complete(void) {
+  i2c_bus_finish(I2C_BUS_OK);
+  i2c_bus_start_next();
+}
+
+void i2c_bus_error(void) {
+  // Un NACK deja el bus en orden (la HAL ya generó el STOP); lo demás no
+  bool nack = HAL_I2C_GetError(&hi2c1) == HAL_I2C_ERROR_AF;
+  
+  i2c_bus_finish(nack ? I2C_BUS_NACK : I2C_BUS_ERROR);
+  if (nack) {
+    i2c_bus_start_next();
+  } else {
+    recover_pending = true;
+  }
+}
+
+// ============================================================================
+// LIBERACIÓN DEL BUS
+// ============================================================================
+
+// Un esclavo que quedó a mitad de un byte sostiene SDA en bajo: se le dan
+// pulsos de SCL hasta que lo suelte y se cierra con un STOP
+static void i2c_bus_recover(void) {
+  HAL_I2C_DeInit(&hi2c1);   // Pines a entrada e IRQ de I2C1 apagadas
+  
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_OD;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+  
+  HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+  HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+  GPIO_InitStruct.Pin = I2C_BUS_SCL_PIN;
+  HAL_GPIO_Init(I2C_BUS_SCL_PORT, &GPIO_InitStruct);
+  GPIO_InitStruct.Pin = I2C_BUS_SDA_PIN;
+  HAL_GPIO_Init(I2C_BUS_SDA_PORT, &GPIO_InitStruct);
+  i2c_bus_delay_us(I2C_BUS_RECOVERY_US);
+  
+  for (uint8_t i = 0; i < I2C_BUS_RECOVERY_PULSES; i++) {
+    if (HAL_GPIO_ReadPin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN) == GPIO_PIN_SET) break;
+    HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_RESET);
+    i2c_bus_delay_us(I2C_BUS_RECOVERY_US);
+    HAL_GPIO_WritePin(I2C_BUS_SCL_PORT, I2C_BUS_SCL_PIN, GPIO_PIN_SET);
+    i2c_bus_delay_us(I2C_BUS_RECOVERY_US);
+  }
+  
+  // STOP: SDA sube con SCL en alto
+  HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_RESET);
+  i2c_bus_delay_us(I2C_BUS_RECOVERY_US);
+  HAL_GPIO_WritePin(I2C_BUS_SDA_PORT, I2C_BUS_SDA_PIN, GPIO_PIN_SET);
+  i2c_bus_delay_us(I2C_BUS_RECOVERY_US);
+  
+  // Con el estado en RESET, HAL_I2C_Init vuelve a configurar pines e IRQ
+  HAL_I2C_Init(&hi2c1);
+  bus_stats.recoveries++;
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void i2c_bus_init(void) {
+  queue_head = 0;
+  queue_tail = 0;
+  active = NULL;
+  window_start = HAL_GetTick();
+  
+  // Un reset a mitad de una transferencia puede dejar a un esclavo con SDA en bajo
+  if (__HAL_I2C_GET_FLAG(&hi2c1, I2C_FLAG_BUSY)) {
+    i2c_bus_recover();
+  }
+  
+  printf("Bus I2C1: %lu kHz, cola de %d transacciones\r\n",
+         (unsigned long)(board_i2c_get_speed() / 1000), I2C_BUS_QUEUE_SIZE);
+}
+
+bool i2c_bus_submit(I2cTransaction *transaction) {
+  if (transaction == NULL || (transaction->tx_len == 0 && transaction->rx_len == 0)) return false;
+  
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  uint8_t next = (queue_head + 1) % I2C_BUS_QUEUE_SIZE;
+  bool queued = next != queue_tail;
+  if (queued) {
+    queue[queue_head] = transaction;
+    queue_head = next;
+    
+    uint8_t depth = i2c_bus_queue_depth();
+    if (depth > bus_stats.queue_max) bus_stats.queue_max = depth;
+    
+    i2c_bus_start_next();
+  } else {
+    bus_stats.rejected++;
+  }
+  
+  __set_PRIMASK(primask);
+  return queued;
+}
+
+bool i2c_bus_write_blocking(uint8_t address, uint32_t speed_hz, uint8_t *data, uint16_t len) {
+  if (!i2c_bus_is_idle()) return false;
+  
+  i2c_bus_set_speed(speed_hz);
+  bool ok = HAL_I2C_Master_Transmit(&hi2c1, (uint16_t)(address << 1), data, len, 10) == HAL_OK;
+  
+  bus_stats.transactions++;
+  if (ok) {
+    bus_stats.bytes += len;
+  } else {
+    bus_stats.nacks++;
+  }
+  return ok;
+}
+
+void i2c_bus_service(void) {
+  uint32_t now = HAL_GetTick();
+  
+  // Transacción vencida: la IRQ no va a llegar. Un borrado de la Flash la
+  // deja frenada (board_i2c_irq_hold): el plazo vuelve a contar desde ahí
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  if (active != NULL && board_flash_erase_count() != active_erase_count) {
+    active_erase_count = board_flash_erase_count();
+    active_start_tick = now;
+  }
+  if (active != NULL && now - active_start_tick > active_timeout_ms) {
+    i2c_bus_finish(I2C_BUS_TIMEOUT);
+    recover_pending = true;
+  }
+  __set_PRIMASK(primask);
+  
+  if (recover_pending && active == NULL) {
+    i2c_bus_recover();
+    recover_pending = false;
+    
+    __disable_irq();
+    i2c_bus_start_next();
+    __set_PRIMASK(primask);
+  }
+  
+  // Ocupación: tiempo con una transacción en curso sobre el de la ventana
+  uint32_t elapsed = now - window_start;
+  if (elapsed >= I2C_BUS_WINDOW_MS) {
+    __disable_irq();
+    uint32_t busy = busy_us;
+    busy_us = 0;
+    __set_PRIMASK(primask);
+    
+    bus_stats.utilization_pct = (float)busy / ((float)elapsed * 10.0f);
+    if (bus_stats.utilization_pct > bus_stats.utilization_max_pct) {
+      bus_stats.utilization_max_pct = bus_stats.utilization_pct;
+    }
+    window_start = now;
+  }
+}
+
+bool i2c_bus_is_idle(void) {
+  return active == NULL && queue_head == queue_tail;
+}
+
+I2cBusStats i2c_bus_get_stats(void) {
+  return bus_stats;
+}
+
+void i2c_bus_show_status(void) {
+  printf("Bus I2C1: %lu kHz | ocupación %.1f%% (máx %.1f%%) | cola %d (máx %d)\r\n",
+         (unsigned long)(board_i2c_get_speed() / 1000), bus_stats.utilization_pct, bus_stats.utilization_max_pct,
+         i2c_bus_queue_depth(), bus_stats.queue_max);
+  printf("  %lu transacciones | %lu bytes | NACK %lu | errores %lu | timeouts %lu | "
+         "liberaciones %lu | rechazadas %lu\r\n",
+         (unsigned long)bus_stats.transactions, (unsigned long)bus_stats.bytes,
+         (unsigned long)bus_stats.nacks, (unsigned long)bus_stats.errors,
+         (unsigned long)bus_stats.timeouts, (unsigned long)bus_stats.recoveries,
+         (unsigned long)bus_stats.rejected);
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -1,40 +1,350 @@
 /**
  * @file lcd.c
- * @brief Driver mínimo de LCD. Si no tenés LCD implementado, lo
- *        emulamos por UART (debug). Ajusta para tu controlador (HD44780, I2C, SPI...).
+ * @brief Implementación del driver de LCD HD44780 por I2C (PCF8574)
+ * @author Smart Waste Manager
+ * @date 2025
  */
 
 #include "lcd.h"
-#include "usart.h"
-#include <stdio.h>
+#include "i2c_bus.h"
+#include <string.h>
 
-// Usamos UART1 para debug si no hay pantalla física
-extern UART_HandleTypeDef huart1;
+// ============================================================================
+// MÓDULO PCF8574 Y COMANDOS HD44780
+// ============================================================================
 
-void lcd_init(void)
-{
-    // Si tu pantalla usa I2C/SPI/HAL, inicializar aquí.
-    // Por ahora mostramos mensaje por UART:
-    char *msg = "[LCD] init";
-    HAL_UART_Transmit(&huart1, (uint8_t*)msg, strlen(msg), HAL_MAX_DELAY);
+// Cada byte I2C fija las 8 salidas del PCF8574: P0-P3 control, P4-P7 = D4-D7
+#define LCD_PIN_RS              0x01
+#define LCD_PIN_EN              0x04
+#define LCD_PIN_BACKLIGHT       0x08
+
+#define LCD_CMD_CLEAR           0x01
+#define LCD_CMD_ENTRY_INC       0x06   // Cursor avanza, sin desplazar
+#define LCD_CMD_DISPLAY_ON      0x0C   // Display encendido, sin cursor
+#define LCD_CMD_4BIT_2LINES     0x28
+#define LCD_CMD_SET_DDRAM       0x80
+
+#define LCD_ADDRESS_UNKNOWN     0xFF
+#define LCD_RS_UNKNOWN          0xFF
+#define LCD_CELL_UNKNOWN        '\0'   // Nunca se escribe: fuerza el redibujo
+
+// Escribir un hueco de una celda sin cambios cuesta lo mismo que mover
+// el cursor (4 bytes) y evita alternar RS
+#define LCD_GAP_REWRITE         1
+
+typedef enum {
+  LCD_TX_IDLE = 0,
+  LCD_TX_BUSY,
+  LCD_TX_DONE,
+  LCD_TX_ERROR
+} LcdTxState;
+
+static const uint8_t lcd_row_address[LCD_ROWS] = { 0x00, 0x40 };
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static char fb_target[LCD_ROWS][LCD_COLS];    // Lo que pide la aplicación
+static char fb_panel[LCD_ROWS][LCD_COLS];     // Lo que muestra el panel (confirmado)
+static char fb_sending[LCD_ROWS][LCD_COLS];   // fb_panel + celdas en vuelo
+
+static uint8_t cursor_row = 0;
+static uint8_t cursor_col = 0;
+
+// Estado del controlador conocido tras la última transferencia
+static uint8_t panel_address = LCD_ADDRESS_UNKNOWN;
+static uint8_t panel_rs = LCD_RS_UNKNOWN;
+static uint8_t sending_address;
+static uint8_t sending_rs;
+
+static uint8_t tx_buffer[LCD_TX_BUFFER];
+static uint16_t tx_len = 0;
+static volatile LcdTxState tx_state = LCD_TX_IDLE;
+static uint16_t tx_cells = 0;
+static I2cTransaction tx_transaction;
+
+static bool lcd_started = false;      // lcd_init() ya configuró el controlador
+static bool lcd_present = false;
+static uint32_t retry_at = 0;
+static LcdStats lcd_stats = {0};
+
+// ============================================================================
+// CODIFICACIÓN
+// ============================================================================
+
+static void lcd_put_nibble(uint8_t nibble, uint8_t rs) {
+  uint8_t port = LCD_PIN_BACKLIGHT | (rs ? LCD_PIN_RS : 0) | (nibble << 4);
+  
+  // El HD44780 toma el dato en el flanco de bajada de EN
+  tx_buffer[tx_len++] = port | LCD_PIN_EN;
+  tx_buffer[tx_len++] = port;
+}
+
+static void lcd_put_byte(uint8_t value, uint8_t rs) {
+  // RS tiene que estar estable antes del flanco de subida de EN
+  if (rs != sending_rs) {
+    tx_buffer[tx_len++] = LCD_PIN_BACKLIGHT | (rs ? LCD_PIN_RS : 0);
+    sending_rs = rs;
+  }
+  
+  lcd_put_nibble(value >> 4, rs);
+  lcd_put_nibble(value & 0x0F, rs);
+}
+
+// El PCF8574 no pasa de 100 kHz: un byte I2C tarda ~90 us y entre dos
+// flancos de EN pasan dos, más que los 37 us que el HD44780 necesita por
+// comando o dato
+static void lcd_build_update(void) {
+  tx_len = 0;
+  tx_cells = 0;
+  sending_address = panel_address;
+  sending_rs = panel_rs;
+  memcpy(fb_sending, fb_panel, sizeof(fb_sending));
+  
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+      if (fb_target[row][col] == fb_panel[row][col]) continue;
+      
+      // Peor caso por celda: mover el cursor (1 + 4) y volver a datos (1 + 4)
+      if (tx_len + 10 > LCD_TX_BUFFER) return;
+      
+      uint8_t address = lcd_row_address[row] + col;
+      if (sending_address != address) {
+        uint8_t gap = address - sending_address;
+        bool same_row = sending_address != LCD_ADDRESS_UNKNOWN &&
+                        sending_address >= lcd_row_address[row] && address > sending_address;
+                        
+        if (same_row && gap <= LCD_GAP_REWRITE) {
+          // Reenviar las celdas sin cambios del hueco
+          for (uint8_t c = col - gap; c < col; c++) {
+            lcd_put_byte((uint8_t)fb_target[row][c], 1);
+            fb_sending[row][c] = fb_target[row][c];
+          }
+        } else {
+          lcd_put_byte(LCD_CMD_SET_DDRAM | address, 0);
+        }
+      }
+      
+      lcd_put_byte((uint8_t)fb_target[row][col], 1);
+      fb_sending[row][col] = fb_target[row][col];
+      sending_address = address + 1;
+      tx_cells++;
+    }
+  }
+}
+
+// ============================================================================
+// TEXTO
+// ============================================================================
+
+// Adapta UTF-8 a la ROM A00 del HD44780 (ASCII + ñ y ° propios)
+static uint8_t lcd_decode(const char **text) {
+  const uint8_t *p = (const uint8_t *)*text;
+  uint8_t c = *p++;
+  
+  if (c < 0x80) {
+    *text = (const char *)p;
+    return (c >= ' ') ? c : ' ';
+  }
+  
+  uint8_t next = *p;
+  if ((next & 0xC0) == 0x80) p++;
+  while ((*p & 0xC0) == 0x80) p++;   // Resto de una secuencia larga
+  *text = (const char *)p;
+  
+  if (c == 0xC3) {
+    switch (next) {
+      case 0xA1: case 0x81: return (next == 0xA1) ? 'a' : 'A';
+      case 0xA9: case 0x89: return (next == 0xA9) ? 'e' : 'E';
+      case 0xAD: case 0x8D: return (next == 0xAD) ? 'i' : 'I';
+      case 0xB3: case 0x93: return (next == 0xB3) ? 'o' : 'O';
+      case 0xBA: case 0x9A: case 0xBC: return (next == 0x9A) ? 'U' : 'u';
+      case 0xB1: case 0x91: return 0xEE;   // ñ
+      default: break;
+    }
+  } else if (c == 0xC2 && next == 0xB0) {
+    return 0xDF;                           // °
+  }
+  
+  return '?';
 }
 
-void lcd_clear(void)
-{
-    char *msg = "[LCD] clear";
-    HAL_UART_Transmit(&huart1, (uint8_t*)msg, strlen(msg), HAL_MAX_DELAY);
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+static bool lcd_send_blocking(void) {
+  bool ok = i2c_bus_write_blocking(LCD_I2C_ADDRESS, LCD_I2C_SPEED_HZ, tx_buffer, tx_len);
+  tx_len = 0;
+  return ok;
+}
+
+// Aviso del bus (desde la IRQ de I2C1)
+static void lcd_tx_done(I2cBusStatus status, void *context) {
+  (void)context;
+  if (tx_state == LCD_TX_BUSY) {
+    tx_state = (status == I2C_BUS_OK) ? LCD_TX_DONE : LCD_TX_ERROR;
+  }
+}
+
+bool lcd_init(void) {
+  // Arranque del HD44780 por instrucciones (datasheet, figura 24): sólo se
+  // espera lo que falte de los 40 ms desde que subió la alimentación
+  uint32_t uptime = HAL_GetTick();
+  if (uptime < LCD_POWER_ON_MS) HAL_Delay(LCD_POWER_ON_MS - uptime);
+  
+  tx_len = 0;
+  tx_buffer[tx_len++] = LCD_PIN_BACKLIGHT;
+  lcd_present = lcd_send_blocking();
+  
+  if (lcd_present) {
+    static const uint8_t wake_delay_ms[3] = { 5, 1, 1 };
+    for (uint8_t i = 0; i < 3; i++) {
+      lcd_put_nibble(0x03, 0);
+      lcd_send_blocking();
+      HAL_Delay(wake_delay_ms[i]);
+    }
+    lcd_put_nibble(0x02, 0);   // Modo 4 bits
+    
+    sending_rs = 0;
+    lcd_put_byte(LCD_CMD_4BIT_2LINES, 0);
+    lcd_put_byte(LCD_CMD_DISPLAY_ON, 0);
+    lcd_put_byte(LCD_CMD_ENTRY_INC, 0);
+    lcd_put_byte(LCD_CMD_CLEAR, 0);
+    lcd_present = lcd_send_blocking();
+    HAL_Delay(2);
+  }
+  
+  // Tras el borrado el panel muestra espacios con el cursor en 0
+  memset(fb_target, ' ', sizeof(fb_target));
+  memset(fb_panel, ' ', sizeof(fb_panel));
+  panel_address = 0;
+  panel_rs = 0;
+  tx_state = LCD_TX_IDLE;
+  lcd_started = true;
+  
+  if (!lcd_present) {
+    lcd_stats.errors++;
+    retry_at = HAL_GetTick() + LCD_RETRY_MS;
+    lcd_invalidate();
+  }
+  
+  return lcd_present;
+}
+
+void lcd_clear(void) {
+  memset(fb_target, ' ', sizeof(fb_target));
+  cursor_row = 0;
+  cursor_col = 0;
+}
+
+void lcd_set_cursor(uint8_t row, uint8_t col) {
+  cursor_row = (row < LCD_ROWS) ? row : LCD_ROWS - 1;
+  cursor_col = (col < LCD_COLS) ? col : LCD_COLS;
+}
+
+void lcd_print(const char *text) {
+  if (text == NULL) return;
+  
+  while (*text != '\0' && cursor_col < LCD_COLS) {
+    fb_target[cursor_row][cursor_col++] = (char)lcd_decode(&text);
+  }
+}
+
+void lcd_write_line(uint8_t row, const char *text) {
+  if (row >= LCD_ROWS) return;
+  
+  lcd_set_cursor(row, 0);
+  lcd_print(text);
+  while (cursor_col < LCD_COLS) {
+    fb_target[row][cursor_col++] = ' ';
+  }
+}
+
+void lcd_invalidate(void) {
+  memset(fb_panel, LCD_CELL_UNKNOWN, sizeof(fb_panel));
+  panel_address = LCD_ADDRESS_UNKNOWN;
+  panel_rs = LCD_RS_UNKNOWN;
 }
 
-void lcd_set_cursor(uint8_t row, uint8_t col)
-{
-    // Implementar según driver físico si es necesario.
-    (void)row;
-    (void)col;
+void lcd_service(void) {
+  uint32_t now = HAL_GetTick();
+  
+  switch (tx_state) {
+    case LCD_TX_BUSY:
+      // El bus avisa siempre, también si la transacción venció
+      return;
+      
+    case LCD_TX_ERROR:
+      // Sin respuesta: no se sabe qué quedó en el panel
+      lcd_present = false;
+      lcd_stats.errors++;
+      lcd_invalidate();
+      retry_at = now + LCD_RETRY_MS;
+      tx_state = LCD_TX_IDLE;
+      return;
+      
+    case LCD_TX_DONE:
+      memcpy(fb_panel, fb_sending, sizeof(fb_panel));
+      panel_address = sending_address;
+      panel_rs = sending_rs;
+      lcd_present = true;
+      lcd_stats.transfers++;
+      lcd_stats.cells += tx_cells;
+      lcd_stats.bus_bytes += tx_len + 1u;
+      lcd_stats.last_bytes = tx_len + 1u;
+      tx_state = LCD_TX_IDLE;
+      break;
+      
+    case LCD_TX_IDLE:
+    default:
+      break;
+  }
+  
+  if (!lcd_started) return;
+  if (!lcd_present && (int32_t)(now - retry_at) < 0) return;
+  if (memcmp(fb_target, fb_panel, sizeof(fb_panel)) == 0) return;
+  
+  lcd_build_update();
+  if (tx_len == 0) return;
+  
+  tx_transaction.address = LCD_I2C_ADDRESS;
+  tx_transaction.speed_hz = LCD_I2C_SPEED_HZ;
+  tx_transaction.tx = tx_buffer;
+  tx_transaction.tx_len = tx_len;
+  tx_transaction.rx = NULL;
+  tx_transaction.rx_len = 0;
+  tx_transaction.done = lcd_tx_done;
+  tx_transaction.context = NULL;
+  
+  // El estado se fija antes: el aviso de fin puede llegar enseguida.
+  // Con la cola llena se reintenta en la próxima vuelta del loop
+  tx_state = LCD_TX_BUSY;
+  if (!i2c_bus_submit(&tx_transaction)) {
+    tx_state = LCD_TX_IDLE;
+  }
 }
 
-void lcd_print(const char *text)
-{
-    char buf[128];
-    snprintf(buf, sizeof(buf), "[LCD] %s", text);
-    HAL_UART_Transmit(&huart1, (uint8_t*)buf, strlen(buf), HAL_MAX_DELAY);
+void lcd_flush(void) {
+  uint32_t start = HAL_GetTick();
+  
+  do {
+    i2c_bus_service();
+    lcd_service();
+  } while (lcd_present &&
+           (tx_state != LCD_TX_IDLE || memcmp(fb_target, fb_panel, sizeof(fb_panel)) != 0) &&
+           HAL_GetTick() - start < LCD_FLUSH_TIMEOUT_MS);
 }
+
+bool lcd_is_present(void) {
+  return lcd_present;
+}
+
+LcdStats lcd_get_stats(void) {
+  return lcd_stats;
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -1,99 +1,178 @@
 /**
  * @file leds.c
- * @brief Control básico de LEDs conectado a GPIO
- *
- * Requiere que en config.h estén definidos:
- *   LED_METAL_GPIO_Port, LED_METAL_Pin, etc.
+ * @brief Implementación de los LEDs indicadores y sus animaciones
+ * @author Smart Waste Manager
+ * @date 2025
  */
 
 #include "leds.h"
-#include "main.h"
-#include "gpio.h"
-
-// Define identificadores (si no están en config.h)
-#ifndef LED_METAL
-#define LED_METAL    0
-#define LED_PLASTIC  1
-#define LED_GLASS    2
-#define LED_PAPER    3
-#define LED_CARDBOARD 4
-#endif
-
-void leds_init(void)
-{
-    // Los pines deberían estar configurados por MX_GPIO_Init() en main.c
-    // acá no hay que hacer nada adicional salvo apagar todo.
-    leds_off_all();
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+typedef struct {
+  GPIO_TypeDef *port;
+  uint16_t pin;
+} LedPin;
+
+typedef struct {
+  const LedPattern *pattern;   // NULL = sin animación
+  uint8_t step;
+  uint8_t loops;               // Repeticiones que faltan (0 = sin fin)
+  uint16_t remaining_ms;       // Hasta el próximo paso
+} LedChannel;
+
+// Lo que lee leds_tick va en la RAM con él (ver board.h)
+static const LedPin led_pins[LED_COUNT] BOARD_RAM_DATA = {
+  { LED_METAL_PORT,    LED_METAL_PIN },
+  { LED_PAPEL_PORT,    LED_PAPEL_PIN },
+  { LED_PLASTICO_PORT, LED_PLASTICO_PIN },
+  { LED_VIDRIO_PORT,   LED_VIDRIO_PIN },
+  { LED_ERROR_PORT,    LED_ERROR_PIN },
+  { LED_SISTEMA_PORT,  LED_SISTEMA_PIN },
+};
+
+// ============================================================================
+// ANIMACIONES PREDEFINIDAS
+// ============================================================================
+
+static const LedStep steps_blink_200[] BOARD_RAM_DATA = { { 0, 10 }, { 1, 10 } };
+static const LedStep steps_blink_50[] BOARD_RAM_DATA = { { 0, 5 }, { 1, 5 } };
+static const LedStep steps_flash[] BOARD_RAM_DATA = { { 0, 15 }, { 1, 5 } };
+static const LedStep steps_heartbeat[] BOARD_RAM_DATA = { { 1, 10 }, { 0, 15 }, { 1, 10 }, { 0, 100 } };
+
+const LedPattern led_pattern_detecting BOARD_RAM_DATA = { steps_blink_200, 2, 3 };
+const LedPattern led_pattern_sound BOARD_RAM_DATA = { steps_blink_50, 2, 2 };
+const LedPattern led_pattern_alert BOARD_RAM_DATA = { steps_flash, 2, 3 };
+const LedPattern led_pattern_heartbeat BOARD_RAM_DATA = { steps_heartbeat, 4, 0 };
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static LedChannel channels[LED_COUNT];
+
+// Un único contador para todos los LEDs: los ms hasta el paso más próximo
+static volatile uint16_t countdown = 0;   // 0 = ninguna animación en curso
+static uint16_t armed = 0;                // Valor con el que se cargó countdown
+
+// ============================================================================
+// MOTOR DE ANIMACIONES
+// ============================================================================
+
+// BSRR directo: HAL_GPIO_WritePin está en la Flash
+BOARD_RAM_FUNC static void leds_write(LedId led, bool on) {
+  const LedPin *led_pin = &led_pins[led];
+  led_pin->port->BSRR = on ? led_pin->pin : (uint32_t)led_pin->pin << 16;
 }
 
-void leds_on(uint8_t led)
-{
-    switch (led) {
-#ifdef LED_METAL_GPIO_Port
-        case LED_METAL:
-            HAL_GPIO_WritePin(LED_METAL_GPIO_Port, LED_METAL_Pin, GPIO_PIN_SET);
-            break;
-#endif
-#ifdef LED_PLASTIC_GPIO_Port
-        case LED_PLASTIC:
-            HAL_GPIO_WritePin(LED_PLASTIC_GPIO_Port, LED_PLASTIC_Pin, GPIO_PIN_SET);
-            break;
-#endif
-#ifdef LED_GLASS_GPIO_Port
-        case LED_GLASS:
-            HAL_GPIO_WritePin(LED_GLASS_GPIO_Port, LED_GLASS_Pin, GPIO_PIN_SET);
-            break;
-#endif
-#ifdef LED_PAPER_GPIO_Port
-        case LED_PAPER:
-            HAL_GPIO_WritePin(LED_PAPER_GPIO_Port, LED_PAPER_Pin, GPIO_PIN_SET);
-            break;
-#endif
-        default:
-            break;
+BOARD_RAM_FUNC static void leds_apply_step(LedChannel *ch, LedId led) {
+  const LedStep *step = &ch->pattern->steps[ch->step];
+  uint8_t time = (step->time > 0) ? step->time : 1;
+  
+  leds_write(led, step->on != 0);
+  ch->remaining_ms = (uint16_t)time * LED_STEP_MS;
+}
+
+BOARD_RAM_FUNC static void leds_advance(LedChannel *ch, LedId led) {
+  if (++ch->step >= ch->pattern->count) {
+    ch->step = 0;
+    if (ch->loops > 0 && --ch->loops == 0) {
+      ch->pattern = NULL;   // Queda el nivel del último paso
+      return;
     }
+  }
+  leds_apply_step(ch, led);
 }
 
-void leds_off(uint8_t led)
-{
-    switch (led) {
-#ifdef LED_METAL_GPIO_Port
-        case LED_METAL:
-            HAL_GPIO_WritePin(LED_METAL_GPIO_Port, LED_METAL_Pin, GPIO_PIN_RESET);
-            break;
-#endif
-#ifdef LED_PLASTIC_GPIO_Port
-        case LED_PLASTIC:
-            HAL_GPIO_WritePin(LED_PLASTIC_GPIO_Port, LED_PLASTIC_Pin, GPIO_PIN_RESET);
-            break;
-#endif
-#ifdef LED_GLASS_GPIO_Port
-        case LED_GLASS:
-            HAL_GPIO_WritePin(LED_GLASS_GPIO_Port, LED_GLASS_Pin, GPIO_PIN_RESET);
-            break;
-#endif
-#ifdef LED_PAPER_GPIO_Port
-        case LED_PAPER:
-            HAL_GPIO_WritePin(LED_PAPER_GPIO_Port, LED_PAPER_Pin, GPIO_PIN_RESET);
-            break;
-#endif
-        default:
-            break;
+// Descuenta el tiempo transcurrido, avanza los pasos vencidos y vuelve a
+// cargar el contador con el próximo (se llama con las IRQ deshabilitadas
+// o desde SysTick)
+BOARD_RAM_FUNC static void leds_schedule(uint16_t elapsed) {
+  uint16_t next = 0;
+  
+  for (uint8_t i = 0; i < LED_COUNT; i++) {
+    LedChannel *ch = &channels[i];
+    if (ch->pattern == NULL) continue;
+    
+    ch->remaining_ms = (ch->remaining_ms > elapsed) ? ch->remaining_ms - elapsed : 0;
+    if (ch->remaining_ms == 0) {
+      leds_advance(ch, (LedId)i);
+      if (ch->pattern == NULL) continue;
     }
+    if (next == 0 || ch->remaining_ms < next) next = ch->remaining_ms;
+  }
+  
+  armed = next;
+  countdown = next;
+}
+
+BOARD_RAM_FUNC void leds_tick(void) {
+  if (countdown == 0 || --countdown > 0) return;
+  leds_schedule(armed);
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void leds_init(void) {
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+  GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  
+  for (uint8_t i = 0; i < LED_COUNT; i++) {
+    channels[i].pattern = NULL;
+    GPIO_InitStruct.Pin = led_pins[i].pin;
+    HAL_GPIO_Init(led_pins[i].port, &GPIO_InitStruct);
+    leds_write((LedId)i, false);
+  }
+  
+  countdown = 0;
+  armed = 0;
+}
+
+void leds_play(LedId led, const LedPattern *pattern) {
+  if (led >= LED_COUNT) return;
+  if (pattern == NULL || pattern->count == 0) {
+    leds_set(led, false);
+    return;
+  }
+  
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  // Lo que ya corrió del contador se descuenta a todos en leds_schedule:
+  // el LED nuevo lo suma para arrancar con su primer paso completo
+  uint16_t elapsed = (countdown > 0) ? armed - countdown : 0;
+  LedChannel *ch = &channels[led];
+  ch->pattern = pattern;
+  ch->step = 0;
+  ch->loops = pattern->repeat;
+  leds_apply_step(ch, led);
+  ch->remaining_ms += elapsed;
+  leds_schedule(elapsed);
+  
+  __set_PRIMASK(primask);
 }
 
-void leds_off_all(void)
-{
-#ifdef LED_METAL_GPIO_Port
-    HAL_GPIO_WritePin(LED_METAL_GPIO_Port, LED_METAL_Pin, GPIO_PIN_RESET);
-#endif
-#ifdef LED_PLASTIC_GPIO_Port
-    HAL_GPIO_WritePin(LED_PLASTIC_GPIO_Port, LED_PLASTIC_Pin, GPIO_PIN_RESET);
-#endif
-#ifdef LED_GLASS_GPIO_Port
-    HAL_GPIO_WritePin(LED_GLASS_GPIO_Port, LED_GLASS_Pin, GPIO_PIN_RESET);
-#endif
-#ifdef LED_PAPER_GPIO_Port
-    HAL_GPIO_WritePin(LED_PAPER_GPIO_Port, LED_PAPER_Pin, GPIO_PIN_RESET);
-#endif
+void leds_set(LedId led, bool on) {
+  if (led >= LED_COUNT) return;
+  
+  // El paso vencido de este LED, si lo había, sólo adelanta un recálculo
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  channels[led].pattern = NULL;
+  leds_write(led, on);
+  __set_PRIMASK(primask);
 }
+
+bool leds_is_playing(LedId led) {
+  return led < LED_COUNT && channels[led].pattern != NULL;
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -1,26 +1,31 @@
 /**
  * @file main.c
- * @brief Smart Waste Manager - STM32F410RB
+ * @brief Smart Waste Manager (placa elegida en board.h)
  * @author Pablo Coria
  * @date 2025
  */
 
 /* Includes ------------------------------------------------------------------*/
 #include "main.h"
-#include "adc.h"
-#include "dma.h"
-#include "i2c.h"
-#include "tim.h"
-#include "usart.h"
-#include "gpio.h"
 
 /* Private includes ----------------------------------------------------------*/
 #include "config.h"
 #include "sensors.h"
 #include "classifier.h"
 #include "actuators.h"
+#include "servo_driver.h"
 #include "display.h"
+#include "i2c_bus.h"
+#include "lcd.h"
 #include "statistics.h"
+#include "flash_store.h"
+#include "event_log.h"
+#include "profiler.h"
+#include "fill_estimator.h"
+#include "telemetry.h"
+#include "params.h"
+#include "shell.h"
+#include "boot.h"
 #include <stdio.h>
 
 /* Private typedef -----------------------------------------------------------*/
@@ -32,10 +37,17 @@ Statistics stats = {0};
 
 /* Private variables ---------------------------------------------------------*/
 uint16_t adc_buffer[ADC_BUFFER_SIZE];
-SystemState current_state = STATE_IDLE;
+static MaterialType held_material = MATERIAL_NINGUNO;  // Retenido por contenedor lleno
+static bool item_seen = false;  // Objeto ya clasificado: esperar a que deje la plataforma
 
 /* Private function prototypes -----------------------------------------------*/
-void SystemClock_Config(void);
+static void boot_show_banner(void);
+static void boot_print_statistics(void);
+
+// Inicialización que no hace falta para detectar: corre con los servos quietos
+static BootTask boot_lcd = { .name = "lcd", .run = display_start_lcd };
+static BootTask boot_banner = { .name = "banner", .run = boot_show_banner };
+static BootTask boot_stats = { .name = "estadisticas", .run = boot_print_statistics };
 
 /* Private user code ---------------------------------------------------------*/
 
@@ -45,30 +57,35 @@ void SystemClock_Config(void);
  */
 int main(void)
 {
+  // Marcar la RAM libre para medir el máximo de pila ('prof')
+  profiler_stack_paint();
+
   /* MCU Configuration--------------------------------------------------------*/
   HAL_Init();
-  SystemClock_Config();
 
-  /* Initialize all configured peripherals */
-  MX_GPIO_Init();
-  MX_DMA_Init();
-  MX_ADC1_Init();
-  MX_I2C1_Init();
-  MX_TIM1_Init();
-  MX_TIM5_Init();        // TIM5 en lugar de TIM4
-  MX_USART1_UART_Init(); // USART1 en lugar de USART2
+  /* Relojes y periféricos de la placa (board_<placa>.c) */
+  board_init();
 
   /* USER CODE BEGIN 2 */
   
   // Iniciar ADC con DMA
-  HAL_ADC_Start_DMA(&hadc1, (uint32_t*)adc_buffer, ADC_BUFFER_SIZE);
+  board_adc_start(adc_buffer, ADC_BUFFER_SIZE);
+
+  // Contador de ciclos para medir tiempos (servo_driver_init lo usa)
+  profiler_init();
+
+  // Configurar base de tiempo de los timers de servos e iniciar PWM
+  servo_driver_init();
+
+  // Cola de transacciones de I2C1 (libera el bus si quedó tomado)
+  i2c_bus_init();
+
+  // Seleccionar la imagen de datos persistentes (antes de cargar módulos)
+  flash_store_init();
+  event_log_init();
 
-  // Iniciar PWM para servos
-  HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);  // PA8 - Servo Plataforma
-  HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_2);  // PA9 - Servo Metal
-  HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_3);  // PA10 - Servo Papel
-  HAL_TIM_PWM_Start(&htim5, TIM_CHANNEL_1);  // PB6 - Servo Plástico
-  HAL_TIM_PWM_Start(&htim5, TIM_CHANNEL_2);  // PB7 - Servo Vidrio
+  // Parámetros ajustables: defecto de config.h + cambios guardados en Flash
+  params_init();
 
   // Inicializar módulos del sistema
   sensors_init();
@@ -76,15 +93,18 @@ int main(void)
   actuators_init();
   display_init();
   statistics_init(&stats);
+  fill_init();
+  telemetry_init();
+  shell_init(&stats);
 
-  // Mostrar mensaje de bienvenida
+  // Bienvenida en el modelo: el LCD la muestra al arrancar (tarea diferida)
   display_show_welcome();
-  HAL_Delay(2000);
 
-  printf("Smart Waste Manager STM32F410RB - Iniciado\r\n");
-  printf("Materiales: Metal, Papel, Plástico, Vidrio\r\n");
-  printf("Servos: TIM1 (3) + TIM5 (2)\r\n");
-  printf("UART: USART1 para debug\r\n");
+  // Lo demás corre desde el loop, una tarea por vuelta y sin servos en marcha
+  boot_defer(&boot_lcd);
+  boot_defer(&boot_banner);
+  boot_defer(&boot_stats);
+  boot_critical_done();
 
   /* USER CODE END 2 */
 
@@ -92,8 +112,56 @@ int main(void)
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-    // 1. Esperar detección
-    if (sensors_detect_presence()) {
+    uint32_t loop_start = profiler_cycles();
+
+    // Avanzar la cola de movimientos de los servos
+    actuators_update();
+    event_log_update();
+    statistics_service(&stats);
+    telemetry_service(&stats);
+    i2c_bus_service();
+    lcd_service();
+
+    // En reposo, dejar borrada la página de reserva para el guardado periódico
+    // y el siguiente segmento del registro, y muestrear el nivel de los contenedores
+    if (!actuators_is_busy()) {
+      flash_store_prepare();
+      event_log_prepare();
+      fill_update(&stats);
+    }
+
+    // Consola por UART (recepción por interrupción; 'help' lista los comandos)
+    shell_service();
+
+    // Arranque en segundo plano (LCD, informes) mientras no haya depósitos
+    boot_service(!actuators_is_busy());
+
+    // Objeto retenido por contenedor lleno: depositarlo cuando se vacíe
+    if (held_material != MATERIAL_NINGUNO && !actuators_is_busy()) {
+      if (!sensors_detect_presence()) {
+        printf("Objeto retenido retirado de la plataforma\r\n");
+        held_material = MATERIAL_NINGUNO;
+      } else if (!fill_is_full(held_material)) {
+        DepositResult outcome = actuators_deposit_material(held_material);
+        if (outcome == DEPOSIT_QUEUED || outcome == DEPOSIT_DIVERTED) {
+          statistics_item_started(&stats, HAL_GetTick());
+        }
+        held_material = MATERIAL_NINGUNO;
+      }
+    }
+
+    // Detección por flanco: un evento (estadística, registro, telemetría) por
+    // objeto. Uno rechazado o no identificado que queda en la plataforma no
+    // se vuelve a clasificar hasta que la presencia se apaga
+    if (item_seen && !actuators_is_busy() && !sensors_detect_presence()) {
+      item_seen = false;
+    }
+
+    // 1. Esperar detección (con la plataforma libre y sin objeto retenido ni ya clasificado)
+    if (held_material == MATERIAL_NINGUNO && !item_seen && !actuators_is_busy() && sensors_detect_presence()) {
+      item_seen = true;
+      uint32_t detect_tick = HAL_GetTick();
+      boot_record_detection(detect_tick);
       display_show_detecting();
 
       // 2. Leer sensores
@@ -104,79 +172,93 @@ int main(void)
       ClassificationResult result = classifier_classify(digital, analog);
 
       // 4. Validar
-      if (result.isValid && result.confidence > 60.0) {
-        // 5. Actuar
-        actuators_deposit_material(result.material);
-
-        // 6. Actualizar estadísticas
+      if (result.isValid) {
+        // 5. Actuar (encola la secuencia de depósito si el contenedor admite)
+        DepositResult outcome = actuators_deposit_material(result.material);
+        bool deposited = (outcome == DEPOSIT_QUEUED || outcome == DEPOSIT_DIVERTED);
+        if (outcome == DEPOSIT_HELD) held_material = result.material;
+        telemetry_send_item(&result, digital, analog, (uint8_t)outcome);
+
+        // 6. Actualizar estadísticas y registro de eventos
         statistics_update(&stats, result);
+        if (deposited) statistics_item_started(&stats, detect_tick);
+        event_log_classification(&result, digital, analog, deposited);
 
         // 7. Mostrar
-        display_show_result(result);
-        display_show_statistics(&stats);
+        if (outcome == DEPOSIT_HELD || outcome == DEPOSIT_REJECTED) {
+          display_show_error("Contenedor lleno");
+        } else {
+          display_show_result(result);
+          display_show_statistics(&stats);
+        }
       } else {
+        statistics_record_rejected(&stats, result);
+        event_log_classification(&result, digital, analog, false);
+        telemetry_send_item(&result, digital, analog, TELEMETRY_NO_DEPOSIT);
         display_show_error("No identificado");
       }
     }
 
-    HAL_Delay(100);
+    // Un solo refresco por salida con todo lo que cambió en esta iteración
+    display_service();
+
+    telemetry_record_loop(profiler_cycles() - loop_start);
+    board_sleep_ms(MAIN_LOOP_PERIOD_MS);
   }
   /* USER CODE END WHILE */
 }
 
-/**
- * @brief System Clock Configuration
- * @retval None
- */
-void SystemClock_Config(void)
-{
-  RCC_OscInitTypeDef RCC_OscInitStruct = {0};
-  RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
-
-  /** Configure the main internal regulator output voltage
-  */
-  __HAL_RCC_PWR_CLK_ENABLE();
-  __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
-
-  /** Initializes the RCC Oscillators according to the specified parameters
-  * in the RCC_OscInitTypeDef structure.
-  */
-  RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
-  RCC_OscInitStruct.HSIState = RCC_HSI_ON;
-  RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
-  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
-  RCC_OscInitStruct.PLL.PLLM = 8;
-  RCC_OscInitStruct.PLL.PLLN = 100;
-  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV2;
-  RCC_OscInitStruct.PLL.PLLQ = 4;
-  RCC_OscInitStruct.PLL.PLLR = 2;
-  if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
-  {
-    Error_Handler();
+/* USER CODE BEGIN 4 */
+
+// Presentación por consola (tarea diferida del arranque)
+static void boot_show_banner(void) {
+  printf("Smart Waste Manager %s - Iniciado\r\n", board_name());
+  printf("Materiales: Metal, Papel, Plástico, Vidrio\r\n");
+  printf("Servos: %s (3) + %s (2)\r\n", BOARD_SERVO_TIM_A_NAME, BOARD_SERVO_TIM_B_NAME);
+}
+
+// Resumen de las estadísticas cargadas (tarea diferida del arranque)
+static void boot_print_statistics(void) {
+  statistics_print(&stats);
+}
+
+// Redirigir printf a la consola (después de las tramas de telemetría en cola)
+int _write(int file, char *ptr, int len) {
+  telemetry_wait_idle();
+  board_console_write((const uint8_t*)ptr, (uint16_t)len);
+  return len;
+}
+
+// Fin de un bloque de telemetría transmitido por interrupción
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) {
+  if (huart == &BOARD_CONSOLE_UART) {
+    telemetry_tx_complete();
   }
+}
 
-  /** Initializes the CPU, AHB and APB buses clocks
-  */
-  RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
-                              |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
-  RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
-  RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
+// Fin de una transacción de I2C1: la cola arranca la siguiente
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  if (hi2c == &hi2c1) {
+    i2c_bus_tx_complete();
+  }
+}
 
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_3) != HAL_OK)
-  {
-    Error_Handler();
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+  if (hi2c == &hi2c1) {
+    i2c_bus_rx_complete();
   }
 }
 
-/* USER CODE BEGIN 4 */
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+  if (hi2c == &hi2c1) {
+    i2c_bus_error();
+  }
+}
 
-// Redirigir printf a USART1
-int _write(int file, char *ptr, int len) {
-  HAL_UART_Transmit(&huart1, (uint8_t*)ptr, len, HAL_MAX_DELAY);
-  return len;
+// Caída de alimentación (PVD): cortar los servos y guardar estadísticas
+void board_power_fail(void) {
+  actuators_release_all();
+  statistics_emergency_flush();
 }
 
 /* USER CODE END 4 */
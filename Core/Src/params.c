@@ -0,0 +1,287 @@
+/**
+ * @file params.c
+ * @brief Implementación de los parámetros ajustables
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "params.h"
+#include "classifier.h"
+#include "flash_store.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// FORMATO EN FLASH
+// ============================================================================
+
+// Registro: [clave u8][valor u32 LE] por cada parámetro distinto del defecto
+#define PARAMS_RECORD_VERSION   1
+#define PARAM_ENTRY_SIZE        5
+#define PARAMS_RECORD_MAX       (64 * PARAM_ENTRY_SIZE)   // Margen para claves de otras versiones
+
+// ============================================================================
+// VARIABLES
+// ============================================================================
+
+SystemParams params;
+
+static bool params_dirty = false;
+static uint8_t record_buffer[PARAMS_RECORD_MAX];
+
+static const ParamInfo param_table[] = {
+  { 1,  "conf_min",      PARAM_FLOAT, &params.confianza_min,         MIN_CONFIDENCE_THRESHOLD, 0,    100,     "Confianza mínima para depositar (%)" },
+  { 2,  "ldr_opaco",     PARAM_FLOAT, &params.ldr_opaco_max,         LDR_OPACO_MAX_PCT,        0,    100,     "LDR: límite opaco/translúcido (%)" },
+  { 3,  "ldr_medio",     PARAM_FLOAT, &params.ldr_medio_max,         LDR_MEDIO_MAX_PCT,        0,    100,     "LDR: límite translúcido/transparente (%)" },
+  { 4,  "mic_bajo",      PARAM_FLOAT, &params.mic_bajo_max,          MIC_BAJO_MAX_PCT,         0,    100,     "Micrófono: límite bajo/medio (%)" },
+  { 5,  "mic_medio",     PARAM_FLOAT, &params.mic_medio_max,         MIC_MEDIO_MAX_PCT,        0,    100,     "Micrófono: límite medio/alto (%)" },
+  { 6,  "bin_lleno",     PARAM_FLOAT, &params.bin_lleno_pct,         BIN_FULL_PCT,             1,    100,     "Contenedor lleno a partir de (%)" },
+  { 7,  "bin_libre",     PARAM_FLOAT, &params.bin_libre_pct,         BIN_CLEAR_PCT,            0,    100,     "Contenedor disponible bajo (%)" },
+  { 8,  "bin_politica",  PARAM_U32,   &params.bin_politica,          BIN_FULL_POLICY,          0,    2,       "Contenedor lleno: 0 rechazar, 1 retener, 2 desviar" },
+  { 9,  "servo_hold",    PARAM_U32,   &params.servo_hold_ms,         SERVO_HOLD_MS,            0,    10000,   "PWM activo tras moverse (ms)" },
+  { 10, "fill_periodo",  PARAM_U32,   &params.fill_periodo_ms,       FILL_SAMPLE_PERIOD_MS,    1000, 3600000, "Lectura de niveles (ms)" },
+  { 11, "stats_flush",   PARAM_U32,   &params.stats_flush_ms,        STATS_FLUSH_INTERVAL_MS,  1000, 3600000, "Guardado de estadísticas (ms)" },
+  { 12, "telem_periodo", PARAM_U32,   &params.telemetria_periodo_ms, TELEMETRY_PERIOD_MS,      0,    3600000, "Telemetría periódica (ms, 0 = sólo ítems)" },
+  { 13, "bono_metal",    PARAM_U32,   &params.bono_mic_metal_min,    BONUS_MIC_METAL_MIN,      0,    4095,    "Bono metal: micrófono sobre (ADC)" },
+  { 14, "bono_vidrio",   PARAM_U32,   &params.bono_ldr_vidrio_min,   BONUS_LDR_VIDRIO_MIN,     0,    4095,    "Bono vidrio: LDR sobre (ADC)" },
+  { 15, "bono_pl_ldr_min", PARAM_U32, &params.bono_ldr_plastico_min, BONUS_LDR_PLASTICO_MIN,   0,    4095,    "Bono plástico: LDR desde (ADC)" },
+  { 16, "bono_pl_ldr_max", PARAM_U32, &params.bono_ldr_plastico_max, BONUS_LDR_PLASTICO_MAX,   0,    4095,    "Bono plástico: LDR hasta (ADC)" },
+  { 17, "bono_pl_mic_min", PARAM_U32, &params.bono_mic_plastico_min, BONUS_MIC_PLASTICO_MIN,   0,    4095,    "Bono plástico: micrófono desde (ADC)" },
+  { 18, "bono_pl_mic_max", PARAM_U32, &params.bono_mic_plastico_max, BONUS_MIC_PLASTICO_MAX,   0,    4095,    "Bono plástico: micrófono hasta (ADC)" },
+  { 19, "bono_pa_ldr",   PARAM_U32,   &params.bono_ldr_papel_max,    BONUS_LDR_PAPEL_MAX,      0,    4095,    "Bono papel: LDR bajo (ADC)" },
+  { 20, "bono_pa_mic",   PARAM_U32,   &params.bono_mic_papel_max,    BONUS_MIC_PAPEL_MAX,      0,    4095,    "Bono papel: micrófono bajo (ADC)" },
+  { 21, "plat_reposo",   PARAM_U32,   &params.plat_horizontal,       SERVO_PLAT_HORIZONTAL,    0,    180,     "Plataforma horizontal (°)" },
+  { 22, "plat_metal",    PARAM_U32,   &params.plat_metal,            SERVO_PLAT_METAL,         0,    180,     "Plataforma hacia metal (°)" },
+  { 23, "plat_papel",    PARAM_U32,   &params.plat_papel,            SERVO_PLAT_PAPEL,         0,    180,     "Plataforma hacia papel (°)" },
+  { 24, "plat_plastico", PARAM_U32,   &params.plat_plastico,         SERVO_PLAT_PLASTICO,      0,    180,     "Plataforma hacia plástico (°)" },
+  { 25, "plat_vidrio",   PARAM_U32,   &params.plat_vidrio,           SERVO_PLAT_VIDRIO,        0,    180,     "Plataforma hacia vidrio (°)" },
+  { 26, "tapa_cerrada",  PARAM_U32,   &params.tapa_cerrada,          SERVO_TAPA_CERRADA,       0,    180,     "Tapa cerrada (°)" },
+  { 27, "tapa_abierta",  PARAM_U32,   &params.tapa_abierta,          SERVO_TAPA_ABIERTA,       0,    180,     "Tapa abierta (°)" },
+  { 28, "t_abrir",       PARAM_U32,   &params.delay_abrir_ms,        SERVO_DELAY_OPEN,         50,   10000,   "Abrir tapa, peor caso (ms)" },
+  { 29, "t_inclinar",    PARAM_U32,   &params.delay_inclinar_ms,     SERVO_DELAY_TILT,         50,   10000,   "Inclinar plataforma, peor caso (ms)" },
+  { 30, "t_caida",       PARAM_U32,   &params.delay_caida_ms,        SERVO_DELAY_DROP,         SERVO_TIMING_MIN_DROP_MS, 10000, "Caída del residuo, peor caso (ms)" },
+  { 31, "t_cerrar",      PARAM_U32,   &params.delay_cerrar_ms,       SERVO_DELAY_CLOSE,        50,   10000,   "Cerrar tapa, peor caso (ms)" },
+  { 32, "t_reposo",      PARAM_U32,   &params.delay_reposo_ms,       SERVO_DELAY_REST,         50,   10000,   "Llegar a reposo (ms)" },
+};
+
+#define PARAM_COUNT (sizeof(param_table) / sizeof(param_table[0]))
+
+// ============================================================================
+// ACCESO A LOS VALORES
+// ============================================================================
+
+static void params_store(const ParamInfo *info, float value) {
+  // Una sola palabra de 32 bits: el loop nunca ve un valor a medias
+  if (info->type == PARAM_FLOAT) {
+    *(float *)info->value = value;
+  } else {
+    *(uint32_t *)info->value = (uint32_t)value;
+  }
+}
+
+static float params_value(const ParamInfo *info) {
+  if (info->type == PARAM_FLOAT) return *(float *)info->value;
+  return (float)*(uint32_t *)info->value;
+}
+
+static bool params_valid(const ParamInfo *info, float value) {
+  if (!isfinite(value) || value < info->min || value > info->max) return false;
+  if (info->type == PARAM_U32 && value != (float)(uint32_t)value) return false;   // Sólo enteros
+  return true;
+}
+
+// Número decimal sin exponente ("-12", "0.75"). Reemplaza a strtof, que en
+// newlib reserva memoria en el heap para sus enteros grandes
+static bool params_parse(const char *text, float *value) {
+  const char *p = text;
+  bool negative = (*p == '-');
+  if (*p == '-' || *p == '+') p++;
+  
+  uint32_t integer = 0;
+  uint32_t fraction = 0;
+  uint32_t scale = 1;
+  bool digits = false;
+  
+  for (; *p >= '0' && *p <= '9'; p++) {
+    if (integer > (UINT32_MAX - 9) / 10) return false;
+    integer = integer * 10 + (uint32_t)(*p - '0');
+    digits = true;
+  }
+  if (*p == '.') {
+    for (p++; *p >= '0' && *p <= '9'; p++) {
+      if (scale < 1000000) {   // Más decimales no cambian un float
+        fraction = fraction * 10 + (uint32_t)(*p - '0');
+        scale *= 10;
+      }
+      digits = true;
+    }
+  }
+  if (!digits || *p != '\0') return false;
+  
+  *value = (float)integer + (float)fraction / (float)scale;
+  if (negative) *value = -*value;
+  return true;
+}
+
+static const ParamInfo *params_find_key(uint8_t key) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    if (param_table[i].key == key) return &param_table[i];
+  }
+  return NULL;
+}
+
+// ============================================================================
+// PERSISTENCIA
+// ============================================================================
+
+static void params_load(void) {
+  const uint8_t *buffer = record_buffer;
+  uint16_t len;
+  
+  if (!flash_store_read_record_var(FLASH_RECORD_PARAMS, PARAMS_RECORD_VERSION,
+                                   record_buffer, sizeof(record_buffer), &len)) {
+    printf("Parámetros: usando valores por defecto\r\n");
+    return;
+  }
+  
+  uint8_t loaded = 0;
+  uint8_t skipped = 0;
+  
+  for (uint16_t offset = 0; offset + PARAM_ENTRY_SIZE <= len; offset += PARAM_ENTRY_SIZE) {
+    const ParamInfo *info = params_find_key(buffer[offset]);
+    uint32_t raw;
+    memcpy(&raw, &buffer[offset + 1], sizeof(raw));
+    
+    float value;
+    if (info != NULL && info->type == PARAM_FLOAT) {
+      memcpy(&value, &raw, sizeof(value));
+    } else {
+      value = (float)raw;
+    }
+    
+    // Clave retirada o valor fuera del rango actual: queda el defecto
+    if (info == NULL || !params_valid(info, value)) {
+      skipped++;
+      continue;
+    }
+    
+    params_store(info, value);
+    loaded++;
+  }
+  
+  printf("Parámetros: %d cargados desde Flash", loaded);
+  if (skipped > 0) printf(" (%d descartados)", skipped);
+  printf("\r\n");
+}
+
+bool params_save(void) {
+  uint8_t *buffer = record_buffer;
+  uint16_t len = 0;
+  
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    const ParamInfo *info = &param_table[i];
+    float value = params_value(info);
+    if (value == info->def) continue;
+    
+    uint32_t raw;
+    if (info->type == PARAM_FLOAT) {
+      memcpy(&raw, &value, sizeof(raw));
+    } else {
+      raw = *(uint32_t *)info->value;
+    }
+    
+    buffer[len] = info->key;
+    memcpy(&buffer[len + 1], &raw, sizeof(raw));
+    len += PARAM_ENTRY_SIZE;
+  }
+  
+  if (!flash_store_write_record(FLASH_RECORD_PARAMS, PARAMS_RECORD_VERSION, buffer, len)) {
+    printf("Error: No se pudieron guardar los parámetros\r\n");
+    return false;
+  }
+  
+  params_dirty = false;
+  printf("Parámetros guardados en Flash (%d distintos del defecto)\r\n", len / PARAM_ENTRY_SIZE);
+  return true;
+}
+
+bool params_is_dirty(void) {
+  return params_dirty;
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void params_reset(void) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    params_store(&param_table[i], param_table[i].def);
+  }
+  params_dirty = true;
+}
+
+void params_init(void) {
+  params_reset();
+  params_load();
+  params_dirty = false;
+}
+
+const ParamInfo *params_find(const char *name) {
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    if (strcmp(param_table[i].name, name) == 0) return &param_table[i];
+  }
+  return NULL;
+}
+
+const ParamInfo *params_get_info(uint8_t index) {
+  return (index < PARAM_COUNT) ? &param_table[index] : NULL;
+}
+
+uint8_t params_count(void) {
+  return PARAM_COUNT;
+}
+
+bool params_set(const char *name, const char *text) {
+  const ParamInfo *info = params_find(name);
+  if (info == NULL || text == NULL) return false;
+  
+  float value;
+  if (!params_parse(text, &value)) return false;
+  if (!params_valid(info, value)) return false;
+  
+  params_store(info, value);
+  params_dirty = true;
+  return true;
+}
+
+static void params_print_one(const ParamInfo *info) {
+  char mark = (params_value(info) != info->def) ? '*' : ' ';
+  
+  if (info->type == PARAM_FLOAT) {
+    printf(" %c%-15s = %-8.1f %s\r\n", mark, info->name, *(float *)info->value, info->description);
+  } else {
+    printf(" %c%-15s = %-8lu %s\r\n", mark, info->name, *(uint32_t *)info->value, info->description);
+  }
+}
+
+void params_print(const char *name) {
+  if (name != NULL) {
+    const ParamInfo *info = params_find(name);
+    if (info == NULL) {
+      printf("Parámetro desconocido: %s\r\n", name);
+      return;
+    }
+    params_print_one(info);
+    return;
+  }
+  
+  for (uint8_t i = 0; i < PARAM_COUNT; i++) {
+    params_print_one(&param_table[i]);
+  }
+  printf("(* distinto del defecto%s)\r\n", params_dirty ? "; hay cambios sin guardar: 'save'" : "");
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -0,0 +1,69 @@
+/**
+ * @file profiler.c
+ * @brief Implementación de la medición de tiempos con DWT
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "profiler.h"
+#include <stdio.h>
+
+// Símbolos del .ld: fin de .bss, tope de la pila y su tamaño reservado
+extern uint32_t _end;
+extern uint32_t _estack;
+extern uint32_t _Min_Stack_Size;
+
+// ============================================================================
+// CONTADOR DE CICLOS
+// ============================================================================
+
+void profiler_init(void) {
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t profiler_cycles(void) {
+  return DWT->CYCCNT;
+}
+
+uint32_t profiler_cycles_to_us(uint32_t cycles) {
+  return (uint32_t)(((uint64_t)cycles * 1000000) / SystemCoreClock);
+}
+
+// ============================================================================
+// USO DE LA PILA
+// ============================================================================
+
+void profiler_stack_paint(void) {
+  // No se pinta el marco de esta función ni el de main()
+  uint32_t *top = (uint32_t *)(uintptr_t)(__get_MSP() - PROFILER_STACK_PAINT_GUARD);
+  
+  for (volatile uint32_t *p = &_end; p < top; p++) {
+    *p = PROFILER_STACK_PAINT;
+  }
+}
+
+uint32_t profiler_stack_used(void) {
+  uint32_t *p = &_end;
+  while (p < &_estack && *p == PROFILER_STACK_PAINT) p++;
+  return (uint32_t)((uint8_t *)&_estack - (uint8_t *)p);
+}
+
+uint32_t profiler_stack_budget(void) {
+  return (uint32_t)(uintptr_t)&_Min_Stack_Size;
+}
+
+void profiler_show_stack(void) {
+  uint32_t used = profiler_stack_used();
+  uint32_t budget = profiler_stack_budget();
+  uint32_t free_bytes = (uint32_t)((uint8_t *)&_estack - (uint8_t *)&_end);
+  
+  printf("Pila: máx %lu de %lu bytes reservados (%lu%%) | RAM libre para la pila: %lu%s\r\n",
+         used, budget, (budget > 0) ? used * 100 / budget : 0, free_bytes,
+         (used > budget) ? " | EXCEDIDA" : "");
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
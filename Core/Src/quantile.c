@@ -0,0 +1,104 @@
+/**
+ * @file quantile.c
+ * @brief Implementación de los histogramas de cuantiles
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "quantile.h"
+#include <string.h>
+
+// ============================================================================
+// ESCALA DE LOS BINS
+// ============================================================================
+
+#define QUANTILE_SUB_BITS       2     // 4 bins por octava
+#define QUANTILE_SUB_BINS       (1u << QUANTILE_SUB_BITS)
+
+// Índice de bit más alto (value > 0)
+static uint8_t quantile_log2(uint32_t value) {
+  uint8_t bit = 0;
+  while (value >>= 1) bit++;
+  return bit;
+}
+
+static uint8_t quantile_bin(const QuantileSketch *sketch, uint32_t value) {
+  uint32_t bin;
+  
+  if (sketch->linear_width > 0) {
+    bin = value / sketch->linear_width;
+  } else if (value < QUANTILE_SUB_BINS) {
+    bin = value;
+  } else {
+    // Octava y los 2 bits que siguen al más alto
+    uint8_t octave = quantile_log2(value);
+    uint32_t sub = (value >> (octave - QUANTILE_SUB_BITS)) & (QUANTILE_SUB_BINS - 1);
+    bin = (uint32_t)(octave - QUANTILE_SUB_BITS + 1) * QUANTILE_SUB_BINS + sub;
+  }
+  
+  return (bin < QUANTILE_BINS) ? (uint8_t)bin : QUANTILE_BINS - 1;
+}
+
+// Valor central de un bin
+static uint32_t quantile_bin_value(const QuantileSketch *sketch, uint8_t bin) {
+  if (sketch->linear_width > 0) {
+    return (uint32_t)bin * sketch->linear_width + sketch->linear_width / 2;
+  }
+  if (bin < QUANTILE_SUB_BINS) {
+    return bin;
+  }
+  
+  uint8_t octave = bin / QUANTILE_SUB_BINS + QUANTILE_SUB_BITS - 1;
+  uint32_t sub = bin % QUANTILE_SUB_BINS;
+  uint32_t width = 1u << (octave - QUANTILE_SUB_BITS);
+  uint32_t low = (1u << octave) + sub * width;
+  return low + width / 2;
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void quantile_init(QuantileSketch *sketch, uint16_t linear_width) {
+  memset(sketch, 0, sizeof(*sketch));
+  sketch->linear_width = linear_width;
+}
+
+void quantile_add(QuantileSketch *sketch, uint32_t value) {
+  uint8_t bin = quantile_bin(sketch, value);
+  
+  if (sketch->bins[bin] == UINT16_MAX) {
+    for (uint8_t i = 0; i < QUANTILE_BINS; i++) {
+      sketch->bins[i] >>= 1;
+    }
+  }
+  
+  sketch->bins[bin]++;
+  sketch->count++;
+}
+
+uint32_t quantile_get(const QuantileSketch *sketch, uint8_t percent) {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < QUANTILE_BINS; i++) {
+    total += sketch->bins[i];
+  }
+  if (total == 0) return 0;
+  
+  // Rango del percentil (redondeo hacia arriba)
+  uint32_t rank = (total * percent + 99) / 100;
+  if (rank == 0) rank = 1;
+  
+  uint32_t cumulative = 0;
+  for (uint8_t i = 0; i < QUANTILE_BINS; i++) {
+    cumulative += sketch->bins[i];
+    if (cumulative >= rank) {
+      return quantile_bin_value(sketch, i);
+    }
+  }
+  
+  return quantile_bin_value(sketch, QUANTILE_BINS - 1);
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
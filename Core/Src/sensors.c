@@ -7,6 +7,8 @@
 
 #include "sensors.h"
 #include "config.h"
+#include "leds.h"
+#include "params.h"
 #include <stdio.h>
 #include <math.h>
 
@@ -200,13 +202,13 @@ bool sensors_detect_presence(void) {
 // CLASIFICACIÓN DE TRANSLUCIDEZ
 // ============================================================================
 
-TranslucencyLevel sensors_classify_translucency(uint16_t ldr_value) {
+BOARD_RAM_FUNC TranslucencyLevel sensors_classify_translucency(uint16_t ldr_value) {
   // Convertir ADC (0-4095) a porcentaje (0-100%)
   float percentage = (float)ldr_value * 100.0f / ADC_RESOLUTION;
   
-  if (percentage < 20.0f) {
+  if (percentage < params.ldr_opaco_max) {
     return TRANSLUCENCY_OPACO;      // Papel, Metal
-  } else if (percentage < 60.0f) {
+  } else if (percentage < params.ldr_medio_max) {
     return TRANSLUCENCY_MEDIO;      // Plástico
   } else {
     return TRANSLUCENCY_ALTO;       // Vidrio
@@ -217,13 +219,13 @@ TranslucencyLevel sensors_classify_translucency(uint16_t ldr_value) {
 // CLASIFICACIÓN DE SONIDO
 // ============================================================================
 
-SoundLevel sensors_classify_sound(uint16_t mic_value) {
+BOARD_RAM_FUNC SoundLevel sensors_classify_sound(uint16_t mic_value) {
   // Convertir ADC (0-4095) a porcentaje (0-100%)
   float percentage = (float)mic_value * 100.0f / ADC_RESOLUTION;
   
-  if (percentage < 30.0f) {
+  if (percentage < params.mic_bajo_max) {
     return SOUND_BAJO;              // Papel
-  } else if (percentage < 70.0f) {
+  } else if (percentage < params.mic_medio_max) {
     return SOUND_MEDIO;             // Plástico
   } else {
     return SOUND_ALTO;              // Metal, Vidrio
@@ -239,13 +241,8 @@ void sensors_generate_sound(void) {
   
   printf("Generando sonido de prueba...\r\n");
   
-  // Implementación básica usando delay
-  uint32_t start_time = HAL_GetTick();
-  while ((HAL_GetTick() - start_time) < 200) { // 200ms
-    // Toggle LED del sistema como indicador
-    HAL_GPIO_TogglePin(LED_SISTEMA_PORT, LED_SISTEMA_PIN);
-    HAL_Delay(50);
-  }
+  // LED del sistema como indicador: 200 ms de parpadeo sin bloquear
+  leds_play(LED_ID_SISTEMA, &led_pattern_sound);
 }
 
 // ============================================================================
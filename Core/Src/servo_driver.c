@@ -0,0 +1,264 @@
+/**
+ * @file servo_driver.c
+ * @brief Implementación de la base de tiempo PWM de los servos
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "servo_driver.h"
+#include "profiler.h"
+#include <stdio.h>
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+#define SERVO_TIMER_A       0
+#define SERVO_TIMER_B       1
+#define SERVO_TIMER_COUNT   2
+
+#define SERVO_ANGLE_STEPS   181   // 0° a 180°
+
+// Ventana de medición del contador: un cuarto del período, así la cuenta no
+// da la vuelta aunque el timer corra hasta 4 veces más rápido de lo calculado
+#define SERVO_VERIFY_WINDOW_US  (SERVO_PWM_PERIOD_US / 4)
+
+typedef struct {
+  TIM_HandleTypeDef *htim;
+  bool on_apb2;          // TIM1 cuelga de APB2, TIM2/TIM5 de APB1
+  uint32_t clock_hz;     // Reloj de entrada del timer
+  uint32_t tick_hz;      // Frecuencia del contador tras el prescaler
+  uint32_t prescaler;    // Valor cargado en PSC
+  uint32_t period;       // Valor cargado en ARR
+  uint32_t measured_hz;  // Frecuencia del contador medida contra el DWT
+} ServoTimebase;
+
+typedef struct {
+  uint8_t timer;         // SERVO_TIMER_*
+  uint32_t channel;      // TIM_CHANNEL_*
+} ServoChannel;
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+static ServoTimebase servo_timers[SERVO_TIMER_COUNT] = {
+  { &BOARD_SERVO_TIM_A, BOARD_SERVO_TIM_A_APB2, 0, 0, 0, 0, 0 },
+  { &BOARD_SERVO_TIM_B, BOARD_SERVO_TIM_B_APB2, 0, 0, 0, 0, 0 },
+};
+
+// Índice = servo - 1
+static const ServoChannel servo_channels[SERVO_COUNT] = {
+  { SERVO_TIMER_A, TIM_SERVO_PLATAFORMA },
+  { SERVO_TIMER_A, TIM_SERVO_METAL },
+  { SERVO_TIMER_A, TIM_SERVO_PAPEL },
+  { SERVO_TIMER_B, TIM_SERVO_PLASTICO },
+  { SERVO_TIMER_B, TIM_SERVO_VIDRIO },
+};
+
+// Tabla ángulo → CCR precalculada para cada timer
+static uint16_t ccr_table[SERVO_TIMER_COUNT][SERVO_ANGLE_STEPS];
+
+// Último CCR escrito y estado de la salida de cada servo
+static uint16_t servo_ccr[SERVO_COUNT];
+static bool servo_enabled[SERVO_COUNT];
+
+// ============================================================================
+// BASE DE TIEMPO
+// ============================================================================
+
+// En STM32F4 y STM32L4 el timer recibe PCLKx si el prescaler de APB es 1, o 2×PCLKx
+static uint32_t servo_driver_timer_clock(bool on_apb2) {
+  RCC_ClkInitTypeDef clk_config;
+  uint32_t flash_latency;
+  HAL_RCC_GetClockConfig(&clk_config, &flash_latency);
+  
+  uint32_t pclk = on_apb2 ? HAL_RCC_GetPCLK2Freq() : HAL_RCC_GetPCLK1Freq();
+  uint32_t divider = on_apb2 ? clk_config.APB2CLKDivider : clk_config.APB1CLKDivider;
+  
+  return (divider == RCC_HCLK_DIV1) ? pclk : 2 * pclk;
+}
+
+static void servo_driver_setup_timer(ServoTimebase *timer) {
+  timer->clock_hz = servo_driver_timer_clock(timer->on_apb2);
+  
+  // Prescaler más cercano al tick objetivo y período con el tick real
+  uint32_t divider = (timer->clock_hz + SERVO_TIMER_TICK_HZ / 2) / SERVO_TIMER_TICK_HZ;
+  if (divider == 0) divider = 1;
+  timer->prescaler = divider - 1;
+  timer->tick_hz = timer->clock_hz / divider;
+  timer->period = (uint32_t)(((uint64_t)timer->tick_hz * SERVO_PWM_PERIOD_US) / 1000000) - 1;
+  
+  TIM_HandleTypeDef *htim = timer->htim;
+  htim->Init.Prescaler = timer->prescaler;
+  htim->Init.Period = timer->period;
+  __HAL_TIM_SET_PRESCALER(htim, timer->prescaler);
+  __HAL_TIM_SET_AUTORELOAD(htim, timer->period);
+  htim->Instance->EGR = TIM_EGR_UG;  // Cargar PSC ahora (está bufferizado)
+  
+  // Tabla ángulo → CCR con redondeo
+  for (uint16_t angle = 0; angle < SERVO_ANGLE_STEPS; angle++) {
+    uint32_t pulse_us = SERVO_MIN_PULSE + (angle * (SERVO_MAX_PULSE - SERVO_MIN_PULSE)) / 180;
+    ccr_table[timer - servo_timers][angle] =
+        (uint16_t)(((uint64_t)pulse_us * timer->tick_hz + 500000) / 1000000);
+  }
+}
+
+// ============================================================================
+// INICIALIZACIÓN
+// ============================================================================
+
+void servo_driver_init(void) {
+  for (uint8_t t = 0; t < SERVO_TIMER_COUNT; t++) {
+    servo_driver_setup_timer(&servo_timers[t]);
+  }
+  
+  // Arrancar los 5 canales en la posición central
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    servo_driver_set_angle(servo, 90);
+    servo_driver_enable(servo);
+  }
+  
+  if (!servo_driver_verify()) {
+    printf("Error: Base de tiempo de servos fuera de tolerancia\r\n");
+  }
+}
+
+// ============================================================================
+// CONVERSIÓN Y ESCRITURA
+// ============================================================================
+
+uint16_t servo_driver_angle_to_ccr(uint8_t servo, uint8_t angle) {
+  if (servo < 1 || servo > SERVO_COUNT) return 0;
+  if (angle > 180) angle = 180;
+  
+  return ccr_table[servo_channels[servo - 1].timer][angle];
+}
+
+bool servo_driver_set_angle(uint8_t servo, uint8_t angle) {
+  if (servo < 1 || servo > SERVO_COUNT) return false;
+  
+  const ServoChannel *ch = &servo_channels[servo - 1];
+  servo_ccr[servo - 1] = servo_driver_angle_to_ccr(servo, angle);
+  __HAL_TIM_SET_COMPARE(servo_timers[ch->timer].htim, ch->channel, servo_ccr[servo - 1]);
+  return true;
+}
+
+// ============================================================================
+// HABILITACIÓN DE SALIDAS
+// ============================================================================
+
+bool servo_driver_enable(uint8_t servo) {
+  if (servo < 1 || servo > SERVO_COUNT) return false;
+  if (servo_enabled[servo - 1]) return true;
+  
+  // Recargar el último CCR para que el primer pulso ya sea el correcto
+  const ServoChannel *ch = &servo_channels[servo - 1];
+  __HAL_TIM_SET_COMPARE(servo_timers[ch->timer].htim, ch->channel, servo_ccr[servo - 1]);
+  HAL_TIM_PWM_Start(servo_timers[ch->timer].htim, ch->channel);
+  servo_enabled[servo - 1] = true;
+  return true;
+}
+
+bool servo_driver_disable(uint8_t servo) {
+  if (servo < 1 || servo > SERVO_COUNT) return false;
+  if (!servo_enabled[servo - 1]) return true;
+  
+  // En TIM1 la HAL apaga MOE sólo cuando ya no queda ningún canal activo
+  const ServoChannel *ch = &servo_channels[servo - 1];
+  HAL_TIM_PWM_Stop(servo_timers[ch->timer].htim, ch->channel);
+  servo_enabled[servo - 1] = false;
+  return true;
+}
+
+bool servo_driver_is_enabled(uint8_t servo) {
+  if (servo < 1 || servo > SERVO_COUNT) return false;
+  return servo_enabled[servo - 1];
+}
+
+// ============================================================================
+// VERIFICACIÓN
+// ============================================================================
+
+// Frecuencia real del contador: cuentas del timer durante una ventana medida
+// con el contador de ciclos de la CPU, que no depende de PSC ni de los
+// prescalers de APB (profiler_init debe estar hecho)
+static uint32_t servo_driver_measure_tick_hz(const ServoTimebase *timer) {
+  TIM_TypeDef *tim = timer->htim->Instance;
+  uint32_t modulo = tim->ARR + 1;
+  uint32_t window = (uint32_t)(((uint64_t)SystemCoreClock * SERVO_VERIFY_WINDOW_US) / 1000000);
+  
+  uint32_t start = profiler_cycles();
+  uint32_t first = tim->CNT;
+  uint32_t elapsed;
+  do {
+    elapsed = profiler_cycles() - start;
+  } while (elapsed < window);
+  uint32_t last = tim->CNT;
+  
+  uint32_t counts = (last + modulo - first) % modulo;
+  return (uint32_t)(((uint64_t)counts * SystemCoreClock + elapsed / 2) / elapsed);
+}
+
+// Convierte una cuenta del timer a microsegundos con la frecuencia medida
+static uint32_t servo_driver_counts_to_us(uint32_t tick_hz, uint32_t counts) {
+  if (tick_hz == 0) return 0;
+  return (uint32_t)(((uint64_t)counts * 1000000 + tick_hz / 2) / tick_hz);
+}
+
+static bool servo_driver_within(uint32_t value, uint32_t expected, uint32_t tolerance) {
+  return value + tolerance >= expected && value <= expected + tolerance;
+}
+
+bool servo_driver_verify(void) {
+  bool ok = true;
+  
+  for (uint8_t t = 0; t < SERVO_TIMER_COUNT; t++) {
+    servo_timers[t].measured_hz = servo_driver_measure_tick_hz(&servo_timers[t]);
+  }
+  
+  for (uint8_t servo = 1; servo <= SERVO_COUNT; servo++) {
+    const ServoTimebase *timer = &servo_timers[servo_channels[servo - 1].timer];
+    
+    uint32_t period_us = servo_driver_counts_to_us(timer->measured_hz, timer->htim->Instance->ARR + 1);
+    uint32_t min_us = servo_driver_counts_to_us(timer->measured_hz, servo_driver_angle_to_ccr(servo, 0));
+    uint32_t max_us = servo_driver_counts_to_us(timer->measured_hz, servo_driver_angle_to_ccr(servo, 180));
+    
+    // Tolerancia: 0.5% del período y ±10 us de pulso
+    bool servo_ok = servo_driver_within(period_us, SERVO_PWM_PERIOD_US, SERVO_PWM_PERIOD_US / 200) &&
+                    servo_driver_within(min_us, SERVO_MIN_PULSE, 10) &&
+                    servo_driver_within(max_us, SERVO_MAX_PULSE, 10);
+                    
+    if (!servo_ok) {
+      printf("Servo %d: período %lu us, pulso %lu-%lu us ✗\r\n",
+             servo, (unsigned long)period_us, (unsigned long)min_us, (unsigned long)max_us);
+      ok = false;
+    }
+  }
+  
+  return ok;
+}
+
+void servo_driver_show_status(void) {
+  static const char *timer_names[SERVO_TIMER_COUNT] = { BOARD_SERVO_TIM_A_NAME, BOARD_SERVO_TIM_B_NAME };
+  
+  printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
+  printf("║                BASE DE TIEMPO DE SERVOS                  ║\r\n");
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  bool ok = servo_driver_verify();
+  for (uint8_t t = 0; t < SERVO_TIMER_COUNT; t++) {
+    const ServoTimebase *timer = &servo_timers[t];
+    printf("║ %s: clk %lu Hz | PSC %lu | ARR %lu | tick %lu Hz (medido %lu)\r\n",
+           timer_names[t], (unsigned long)timer->clock_hz, (unsigned long)timer->prescaler,
+           (unsigned long)timer->period, (unsigned long)timer->tick_hz,
+           (unsigned long)timer->measured_hz);
+    printf("║   CCR 0°=%d 90°=%d 180°=%d\r\n",
+           ccr_table[t][0], ccr_table[t][90], ccr_table[t][180]);
+  }
+  printf("║ Verificación: %s\r\n", ok ? "✓ OK" : "✗ FALLA");
+  printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -0,0 +1,407 @@
+/**
+ * @file shell.c
+ * @brief Implementación de la consola de comandos por UART
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "shell.h"
+#include "actuators.h"
+#include "boot.h"
+#include "classifier.h"
+#include "display.h"
+#include "event_log.h"
+#include "fill_estimator.h"
+#include "flash_store.h"
+#include "fmt.h"
+#include "i2c_bus.h"
+#include "params.h"
+#include "profiler.h"
+#include "sensors.h"
+#include "servo_driver.h"
+#include "statistics.h"
+#include "telemetry.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+#define SHELL_MAX_ARGS            4
+#define SHELL_PROF_CLASSIFY_RUNS  8   // 'prof': primera llamada y la más rápida
+
+typedef struct {
+  const char *name;
+  void (*handler)(uint8_t argc, char **argv);
+  bool idle_only;           // Espera a que la plataforma esté libre
+  const char *help;
+} ShellCommand;
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+// Cola de recepción: head la mueve la IRQ, tail el loop principal
+static volatile uint8_t rx_ring[SHELL_RX_BUFFER];
+static volatile uint16_t rx_head = 0;
+static volatile uint16_t rx_tail = 0;
+static volatile bool rx_idle = false;       // Terminó una ráfaga (línea ociosa)
+static volatile uint32_t rx_overflows = 0;
+
+static char line[SHELL_LINE_MAX];
+static uint8_t line_len = 0;
+
+// Comando esperando a que termine el depósito en curso
+static char pending_line[SHELL_LINE_MAX];
+static bool pending = false;
+
+static Statistics *shell_stats = NULL;
+
+// ============================================================================
+// RECEPCIÓN (IRQ)
+// ============================================================================
+
+// Desde la RAM: la consola sigue recibiendo durante un borrado de la Flash
+BOARD_RAM_FUNC void shell_uart_irq(void) {
+  uint8_t byte;
+  uint8_t events = board_console_irq(&byte);
+  
+  if (events & BOARD_CONSOLE_RX) {
+    uint16_t next = (rx_head + 1) % SHELL_RX_BUFFER;
+    if (next != rx_tail) {
+      rx_ring[rx_head] = byte;
+      rx_head = next;
+    } else {
+      rx_overflows++;
+    }
+  }
+  if (events & BOARD_CONSOLE_IDLE) {
+    rx_idle = true;
+  }
+}
+
+static uint16_t shell_rx_count(void) {
+  return (uint16_t)((rx_head + SHELL_RX_BUFFER - rx_tail) % SHELL_RX_BUFFER);
+}
+
+// ============================================================================
+// COMANDOS
+// ============================================================================
+
+static void cmd_help(uint8_t argc, char **argv);
+
+static void cmd_get(uint8_t argc, char **argv) {
+  params_print(argc > 1 ? argv[1] : NULL);
+}
+
+static void cmd_set(uint8_t argc, char **argv) {
+  if (argc < 3) {
+    printf("Uso: set <parámetro> <valor>\r\n");
+    return;
+  }
+  
+  const ParamInfo *info = params_find(argv[1]);
+  if (info == NULL) {
+    printf("Parámetro desconocido: %s\r\n", argv[1]);
+  } else if (!params_set(argv[1], argv[2])) {
+    printf("Valor inválido (rango %.0f a %.0f%s)\r\n", info->min, info->max,
+           info->type == PARAM_U32 ? ", entero" : "");
+  } else {
+    params_print(argv[1]);
+  }
+}
+
+static void cmd_save(uint8_t argc, char **argv) {
+  params_save();
+}
+
+static void cmd_sensors(uint8_t argc, char **argv) {
+  sensors_diagnostic();
+}
+
+static void cmd_truth(uint8_t argc, char **argv) {
+  classifier_show_truth_table();
+}
+
+static void cmd_servos(uint8_t argc, char **argv) {
+  servo_driver_show_status();
+  actuators_show_status();
+}
+
+static void cmd_test(uint8_t argc, char **argv) {
+  actuators_test_all_servos();
+}
+
+static void cmd_calib(uint8_t argc, char **argv) {
+  actuators_calibrate_timing();
+}
+
+static void cmd_timing(uint8_t argc, char **argv) {
+  actuators_show_timing();
+}
+
+static void cmd_display(uint8_t argc, char **argv) {
+  if (argc > 2 && strcmp(argv[1], "mirror") == 0) {
+    display_set_sink_enabled("consola", strcmp(argv[2], "on") == 0);
+  }
+  display_diagnostic();
+}
+
+static void cmd_stats(uint8_t argc, char **argv) {
+  statistics_print(shell_stats);
+}
+
+static void cmd_hist(uint8_t argc, char **argv) {
+  statistics_print_history(shell_stats);
+}
+
+static void cmd_fill(uint8_t argc, char **argv) {
+  fill_show_status();
+}
+
+static void cmd_log(uint8_t argc, char **argv) {
+  bool started = (argc > 1 && strcmp(argv[1], "raw") == 0) ? event_log_dump() : event_log_print();
+  
+  if (!started) {
+    printf("Error: Ya hay un volcado del registro en curso\r\n");
+  }
+}
+
+static void cmd_flash(uint8_t argc, char **argv) {
+  flash_store_show_status();
+}
+
+// Mismo guardado que la IRQ del PVD, sin cortar la alimentación
+static void cmd_pvd(uint8_t argc, char **argv) {
+  statistics_test_emergency_flush();
+}
+
+static void cmd_prof(uint8_t argc, char **argv) {
+  MotionStats motion = actuators_get_motion_stats();
+  
+  statistics_show_flush_budget();
+  telemetry_show_status();
+  printf("Cola de servos: %d (máx %d) | completados %lu | rechazados %lu\r\n",
+         motion.depth, motion.max_depth, motion.completed, motion.rejected);
+  printf("Consola: %lu bytes perdidos por cola llena\r\n", rx_overflows);
+  profiler_show_stack();
+  
+  // Costo del formateo con una línea típica del log (texto, %s y %.1f)
+  char sample[SHELL_LINE_MAX];
+  uint32_t start = profiler_cycles();
+  fmt_snprintf(sample, sizeof(sample), "✓ Material identificado: %s (%.1f%% confianza)",
+               "Plástico", 87.5f);
+  uint32_t cycles = profiler_cycles() - start;
+  printf("Formateo: %lu ciclos (%lu us) por línea de log\r\n",
+         cycles, profiler_cycles_to_us(cycles));
+  
+  // Código caliente (board.h): una muestra fija de plástico, para comparar
+  // con la compilación RAM_CODE=0 (Makefile). Desde la Flash la primera
+  // llamada paga las líneas que no estaban en sus caches; las siguientes no
+  SensorDigitalData digital = { false, true, true };
+  SensorAnalogData analog = { 2000, 2000, 0, 0 };
+  uint32_t classify_first = 0;
+  uint32_t classify_min = UINT32_MAX;
+  for (uint8_t i = 0; i < SHELL_PROF_CLASSIFY_RUNS; i++) {
+    start = profiler_cycles();
+    ClassificationResult sample_result = classifier_classify(digital, analog);
+    cycles = profiler_cycles() - start;
+    (void)sample_result;
+    if (i == 0) classify_first = cycles;
+    if (cycles < classify_min) classify_min = cycles;
+  }
+  
+  // Con SysTick en la RAM el tick avanza lo mismo que dura el borrado
+  uint32_t erase_us, erase_ticks;
+  board_flash_erase_timing(&erase_us, &erase_ticks);
+  printf("Código caliente en %s | clasificar: %lu ciclos la primera vez, %lu repetido\r\n",
+         BOARD_HOT_CODE, classify_first, classify_min);
+  printf("Último borrado: %lu us, SysTick contó %lu ms\r\n", erase_us, erase_ticks);
+}
+
+static void cmd_boot(uint8_t argc, char **argv) {
+  boot_show_status();
+}
+
+static void cmd_i2c(uint8_t argc, char **argv) {
+  i2c_bus_show_status();
+}
+
+static void cmd_telem(uint8_t argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "on") == 0) {
+    telemetry_set_enabled(true);
+  } else if (argc > 1 && strcmp(argv[1], "off") == 0) {
+    telemetry_set_enabled(false);
+  }
+  telemetry_show_status();
+}
+
+static void cmd_reset(uint8_t argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "stats") == 0) {
+    statistics_reset(shell_stats);
+    statistics_flush(shell_stats);
+  } else if (argc > 1 && strcmp(argv[1], "timing") == 0) {
+    actuators_reset_timing();
+  } else if (argc > 1 && strcmp(argv[1], "params") == 0) {
+    params_reset();
+    printf("Parámetros en valores por defecto ('save' para guardarlos)\r\n");
+  } else {
+    printf("Uso: reset stats|timing|params\r\n");
+  }
+}
+
+static const ShellCommand commands[] = {
+  { "help",    cmd_help,    false, "Lista de comandos" },
+  { "get",     cmd_get,     false, "get [parámetro]: ver parámetros" },
+  { "set",     cmd_set,     false, "set <parámetro> <valor>: cambiar un parámetro" },
+  { "save",    cmd_save,    true,  "Guardar los parámetros en Flash" },
+  { "sensors", cmd_sensors, true,  "Diagnóstico de sensores" },
+  { "truth",   cmd_truth,   true,  "Tabla de verdad del clasificador" },
+  { "servos",  cmd_servos,  true,  "Estado de servos y base de tiempo" },
+  { "test",    cmd_test,    true,  "Prueba de todos los servos" },
+  { "calib",   cmd_calib,   true,  "Calibración de tiempos con B1" },
+  { "timing",  cmd_timing,  true,  "Tiempos aprendidos de los servos" },
+  { "display", cmd_display, true,  "display [mirror on|off]: LEDs, LCD y salidas" },
+  { "stats",   cmd_stats,   true,  "Estadísticas" },
+  { "hist",    cmd_hist,    true,  "Historial por hora y día" },
+  { "fill",    cmd_fill,    true,  "Llenado de contenedores" },
+  { "log",     cmd_log,     true,  "log [raw]: registro de eventos (CSV o binario)" },
+  { "flash",   cmd_flash,   true,  "Estado del almacenamiento en Flash" },
+  { "prof",    cmd_prof,    false, "Tiempos de loop, guardado y colas" },
+  { "pvd",     cmd_pvd,     true,  "Medir el guardado del aviso PVD frente al margen de corte" },
+  { "telem",   cmd_telem,   false, "telem [on|off]: telemetría binaria" },
+  { "boot",    cmd_boot,    false, "Tiempos del arranque y tareas diferidas" },
+  { "i2c",     cmd_i2c,     false, "Ocupación y errores del bus I2C1" },
+  { "reset",   cmd_reset,   true,  "reset stats|timing|params" },
+};
+
+#define SHELL_COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+static void cmd_help(uint8_t argc, char **argv) {
+  for (uint8_t i = 0; i < SHELL_COMMAND_COUNT; i++) {
+    printf("  %-8s %s\r\n", commands[i].name, commands[i].help);
+  }
+}
+
+// ============================================================================
+// INTERPRETACIÓN
+// ============================================================================
+
+static const ShellCommand *shell_find(const char *text) {
+  // Sólo la primera palabra identifica el comando
+  size_t len = strcspn(text, " ");
+  
+  for (uint8_t i = 0; i < SHELL_COMMAND_COUNT; i++) {
+    if (strlen(commands[i].name) == len && strncmp(commands[i].name, text, len) == 0) {
+      return &commands[i];
+    }
+  }
+  return NULL;
+}
+
+static void shell_execute(char *text) {
+  char *argv[SHELL_MAX_ARGS];
+  uint8_t argc = 0;
+  char *save;
+  
+  // strtok_r: strtok de newlib-nano reserva su estado en el heap
+  for (char *token = strtok_r(text, " ", &save); token != NULL && argc < SHELL_MAX_ARGS;
+       token = strtok_r(NULL, " ", &save)) {
+    argv[argc++] = token;
+  }
+  if (argc == 0) return;
+  
+  const ShellCommand *command = shell_find(argv[0]);
+  if (command != NULL) {
+    command->handler(argc, argv);
+  }
+}
+
+static void shell_dispatch(char *text) {
+  const ShellCommand *command = shell_find(text);
+  if (command == NULL) {
+    printf("Comando desconocido: %s ('help' para la lista)\r\n", text);
+    return;
+  }
+  
+  // No frenar una secuencia de depósito con salida larga o movimientos
+  if (command->idle_only && actuators_is_busy()) {
+    strcpy(pending_line, text);
+    pending = true;
+    printf("(en espera: plataforma ocupada)\r\n");
+    return;
+  }
+  
+  shell_execute(text);
+}
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void shell_init(Statistics *stats) {
+  shell_stats = stats;
+  rx_head = 0;
+  rx_tail = 0;
+  
+  board_console_rx_enable();
+  
+  printf("Consola lista ('help' para la lista de comandos)\r\n");
+}
+
+void shell_service(void) {
+  if (pending) {
+    if (actuators_is_busy()) return;
+    pending = false;
+    shell_execute(pending_line);
+  }
+  
+  // La HAL apaga la interrupción de recepción si procesa un error
+  board_console_rx_enable();
+  
+  // Procesar al terminar cada ráfaga (o antes si la cola se llena)
+  if (!rx_idle && shell_rx_count() < SHELL_RX_BUFFER / 2) return;
+  rx_idle = false;
+  
+  char echo[SHELL_RX_BUFFER];
+  uint16_t echo_len = 0;
+  
+  while (rx_tail != rx_head) {
+    char c = (char)rx_ring[rx_tail];
+    rx_tail = (rx_tail + 1) % SHELL_RX_BUFFER;
+    
+    if (c == '\r' || c == '\n') {
+      if (line_len == 0) continue;
+      if (echo_len > 0) printf("%.*s", echo_len, echo);
+      printf("\r\n");
+      
+      line[line_len] = '\0';
+      line_len = 0;
+      shell_dispatch(line);
+      
+      // Un comando por iteración: el resto se procesa en la próxima
+      if (rx_tail != rx_head) rx_idle = true;
+      return;
+    }
+    
+    if (c == '\b' || c == 0x7F) {
+      if (line_len > 0) {
+        line_len--;
+        if (echo_len + 3u <= sizeof(echo)) {
+          memcpy(&echo[echo_len], "\b \b", 3);
+          echo_len += 3;
+        }
+      }
+    } else if (c >= ' ' && line_len < SHELL_LINE_MAX - 1) {
+      line[line_len++] = c;
+      if (echo_len < sizeof(echo)) echo[echo_len++] = c;
+    }
+  }
+  
+  if (echo_len > 0) printf("%.*s", echo_len, echo);
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -6,32 +6,132 @@
  */
 
 #include "statistics.h"
+#include "actuators.h"
+#include "flash_store.h"
+#include "params.h"
+#include "profiler.h"
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
-// Dirección en Flash para guardar estadísticas (ajustar según tu mapa de memoria)
-#define STATS_FLASH_ADDR    0x08010000  // Página de Flash para datos
+// Versión del registro de estadísticas (subir si cambia Statistics)
+#define STATS_RECORD_VERSION    3
+
+// Registro del aviso PVD: los campos iniciales de Statistics (contadores,
+// promedio y tiempo de operación), sin historial ni percentiles
+#define STATS_COUNTERS_VERSION  1
+#define STATS_COUNTERS_SIZE     offsetof(Statistics, por_hora)
+
+#define STATS_CONFIDENCE_BIN    2   // Ancho de bin de confianza (%)
+
+#define STATS_MS_PER_HOUR       3600000UL
+#define STATS_HOURS_PER_DAY     24
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+// Las estadísticas viven en RAM; a Flash van por intervalo o por aviso PVD
+static Statistics *stats_ram = NULL;
+static bool stats_dirty = false;
+static uint32_t stats_last_flush = 0;
+static uint32_t stats_last_tick = 0;     // Para acumular el tiempo de operación
+
+// Ítem en curso: se mide cuando termina su secuencia de depósito
+static bool item_pending = false;
+static uint32_t item_detect_tick = 0;
+
+// Versiones anteriores del registro: mismos campos iniciales, sin los nuevos
+static const struct {
+  uint8_t version;
+  uint16_t size;
+} stats_record_versions[] = {
+  { STATS_RECORD_VERSION, sizeof(Statistics) },
+  { 2, offsetof(Statistics, dist_confianza) },        // Sin percentiles
+  { 1, offsetof(Statistics, tiempo_operacion_ms) },   // Sin historial
+};
+
+// Tiempo del guardado periódico de la imagen completa (sólo sin borrado)
+static uint32_t flush_last_us = 0;
+static uint32_t flush_max_us = 0;
+static uint32_t flush_count = 0;
+
+// Tiempo del guardado por aviso PVD, frente a STATS_HOLDUP_BUDGET_US
+static uint32_t emergency_last_us = 0;
+static uint32_t emergency_max_us = 0;
+static uint32_t emergency_flush_count = 0;
+static uint32_t emergency_flush_dropped = 0;  // Avisos PVD sin lugar o con la Flash ocupada
+
+static void statistics_load_counters(Statistics *stats);
 
 // ============================================================================
 // INICIALIZACIÓN
 // ============================================================================
 
 void statistics_init(Statistics *stats) {
+  stats_ram = stats;
+  stats_dirty = false;
+  stats_last_flush = HAL_GetTick();
+  stats_last_tick = stats_last_flush;
+  
   // Intentar cargar desde Flash
   if (!statistics_load_from_flash(stats)) {
     // Si no hay datos guardados, inicializar en cero
     statistics_reset(stats);
     printf("Estadísticas inicializadas desde cero\r\n");
   } else {
+    // El resumen completo lo imprime el arranque diferido (ver boot.h)
     printf("Estadísticas cargadas desde Flash\r\n");
-    statistics_print(stats);
   }
+  
+  // Contadores guardados por un aviso PVD después de la última imagen
+  statistics_load_counters(stats);
+  
+  // Aviso de caída de alimentación: board_power_fail() guarda las estadísticas
+  board_pvd_enable();
 }
 
 // ============================================================================
 // ACTUALIZACIÓN
 // ============================================================================
 
+// Índice de material en el historial (-1 si no es un material)
+static int8_t statistics_material_index(MaterialType material) {
+  switch (material) {
+    case MATERIAL_METAL:    return 0;
+    case MATERIAL_PAPEL:    return 1;
+    case MATERIAL_PLASTICO: return 2;
+    case MATERIAL_VIDRIO:   return 3;
+    default:                return -1;
+  }
+}
+
+static void statistics_init_distributions(Statistics *stats) {
+  quantile_init(&stats->dist_confianza, STATS_CONFIDENCE_BIN);
+  quantile_init(&stats->dist_ciclo_ms, 0);
+  quantile_init(&stats->dist_latencia_ms, 0);
+}
+
+static void statistics_record_confidence(Statistics *stats, ClassificationResult result) {
+  float confidence = result.confidence;
+  if (confidence < 0.0f) confidence = 0.0f;
+  quantile_add(&stats->dist_confianza, (uint32_t)(confidence + 0.5f));
+}
+
+// Avanza una hora de operación y limpia las casillas que se reutilizan
+static void statistics_advance_hour(Statistics *stats) {
+  stats->tiempo_operacion_horas++;
+  memset(stats->por_hora[stats->tiempo_operacion_horas % STATS_HOURS_HISTORY], 0,
+         sizeof(stats->por_hora[0]));
+         
+  if (stats->tiempo_operacion_horas % STATS_HOURS_PER_DAY == 0) {
+    uint32_t day = stats->tiempo_operacion_horas / STATS_HOURS_PER_DAY;
+    memset(stats->por_dia[day % STATS_DAYS_HISTORY], 0, sizeof(stats->por_dia[0]));
+  }
+  
+  stats_dirty = true;
+}
+
 void statistics_update(Statistics *stats, ClassificationResult result) {
   // Incrementar total
   stats->total_clasificados++;
@@ -55,16 +155,26 @@ void statistics_update(Statistics *stats, ClassificationResult result) {
       break;
   }
   
+  // Historial por hora y por día (la hora en curso ya está limpia)
+  int8_t index = statistics_material_index(result.material);
+  if (index >= 0) {
+    uint16_t *hour = &stats->por_hora[stats->tiempo_operacion_horas % STATS_HOURS_HISTORY][index];
+    uint16_t *day = &stats->por_dia[(stats->tiempo_operacion_horas / STATS_HOURS_PER_DAY) % STATS_DAYS_HISTORY][index];
+    if (*hour < UINT16_MAX) (*hour)++;
+    if (*day < UINT16_MAX) (*day)++;
+  }
+  
+  // Distribución de confianza
+  statistics_record_confidence(stats, result);
+  
   // Actualizar promedio de confianza (promedio incremental)
   if (result.isValid) {
     float n = (float)(stats->total_clasificados - stats->clasificaciones_erroneas);
     stats->promedio_confianza = ((stats->promedio_confianza * (n - 1.0f)) + result.confidence) / n;
   }
   
-  // Guardar en Flash cada 10 clasificaciones
-  if (stats->total_clasificados % 10 == 0) {
-    statistics_save_to_flash(stats);
-  }
+  // Se guarda en Flash desde statistics_service() o ante un aviso PVD
+  stats_dirty = true;
   
   // Log
   printf("Stats actualizado: Total=%lu, Metal=%lu, Papel=%lu, Plast=%lu, Vidrio=%lu, Avg=%.1f%%\r\n",
@@ -98,67 +208,204 @@ uint32_t statistics_get_material_count(Statistics *stats, MaterialType material)
   }
 }
 
+uint32_t statistics_get_percentile(Statistics *stats, StatsDistribution distribution, uint8_t percent) {
+  switch (distribution) {
+    case STATS_DIST_CONFIDENCE: return quantile_get(&stats->dist_confianza, percent);
+    case STATS_DIST_CYCLE_MS:   return quantile_get(&stats->dist_ciclo_ms, percent);
+    case STATS_DIST_LATENCY_MS: return quantile_get(&stats->dist_latencia_ms, percent);
+    default:                    return 0;
+  }
+}
+
+uint16_t statistics_get_hourly(Statistics *stats, uint16_t hours_ago, MaterialType material) {
+  int8_t index = statistics_material_index(material);
+  if (index < 0 || hours_ago >= STATS_HOURS_HISTORY || hours_ago > stats->tiempo_operacion_horas) {
+    return 0;
+  }
+  
+  uint32_t hour = stats->tiempo_operacion_horas - hours_ago;
+  return stats->por_hora[hour % STATS_HOURS_HISTORY][index];
+}
+
+uint16_t statistics_get_daily(Statistics *stats, uint16_t days_ago, MaterialType material) {
+  uint32_t today = stats->tiempo_operacion_horas / STATS_HOURS_PER_DAY;
+  int8_t index = statistics_material_index(material);
+  if (index < 0 || days_ago >= STATS_DAYS_HISTORY || days_ago > today) {
+    return 0;
+  }
+  
+  return stats->por_dia[(today - days_ago) % STATS_DAYS_HISTORY][index];
+}
+
 // ============================================================================
 // PERSISTENCIA EN FLASH
 // ============================================================================
 
 bool statistics_save_to_flash(Statistics *stats) {
-  HAL_StatusTypeDef status;
+  // Sólo se mide el presupuesto cuando la página de reserva ya estaba borrada
+  bool measurable = flash_store_is_ready();
+  uint32_t start = profiler_cycles();
   
-  // Desbloquear Flash
-  HAL_FLASH_Unlock();
+  if (!flash_store_write_record(FLASH_RECORD_STATS, STATS_RECORD_VERSION, stats, sizeof(Statistics))) {
+    printf("Error guardando estadísticas en Flash\r\n");
+    return false;
+  }
   
-  // Borrar sector (ajustar según STM32F410RB)
-  FLASH_EraseInitTypeDef EraseInitStruct;
-  uint32_t PageError;
+  if (measurable) {
+    flush_last_us = profiler_cycles_to_us(profiler_cycles() - start);
+    if (flush_last_us > flush_max_us) flush_max_us = flush_last_us;
+    flush_count++;
+  }
   
-  EraseInitStruct.TypeErase = FLASH_TYPEERASE_PAGES;
-  EraseInitStruct.PageAddress = STATS_FLASH_ADDR;
-  EraseInitStruct.NbPages = 1;
+  stats_dirty = false;
+  stats_last_flush = HAL_GetTick();
+  printf("Estadísticas guardadas en Flash (%lu us)\r\n", flush_last_us);
+  return true;
+}
+
+void statistics_record_rejected(Statistics *stats, ClassificationResult result) {
+  // Sin depósito ni contadores: sólo la cola baja de confianza
+  statistics_record_confidence(stats, result);
+  stats_dirty = true;
+}
+
+void statistics_item_started(Statistics *stats, uint32_t detect_tick) {
+  (void)stats;
+  item_pending = true;
+  item_detect_tick = detect_tick;
+}
+
+// Tiempos del ítem cuando su secuencia terminó
+static void statistics_item_finished(Statistics *stats) {
+  MotionStats motion = actuators_get_motion_stats();
   
-  status = HAL_FLASHEx_Erase(&EraseInitStruct, &PageError);
-  if (status != HAL_OK) {
-    HAL_FLASH_Lock();
-    printf("Error borrando Flash: %d\r\n", status);
-    return false;
+  quantile_add(&stats->dist_ciclo_ms, motion.last_completion_tick - item_detect_tick);
+  if ((int32_t)(motion.last_drop_tick - item_detect_tick) >= 0) {
+    quantile_add(&stats->dist_latencia_ms, motion.last_drop_tick - item_detect_tick);
   }
   
-  // Escribir datos (word por word)
-  uint32_t *data = (uint32_t *)stats;
-  uint32_t address = STATS_FLASH_ADDR;
-  size_t words = sizeof(Statistics) / 4;
+  item_pending = false;
+  stats_dirty = true;
+}
+
+void statistics_service(Statistics *stats) {
+  if (item_pending && !actuators_is_busy()) {
+    statistics_item_finished(stats);
+  }
   
-  for (size_t i = 0; i < words; i++) {
-    status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, data[i]);
-    if (status != HAL_OK) {
-      HAL_FLASH_Lock();
-      printf("Error escribiendo Flash: %d\r\n", status);
-      return false;
-    }
-    address += 4;
+  
+  // Tiempo de operación
+  uint32_t now = HAL_GetTick();
+  stats->tiempo_operacion_ms += now - stats_last_tick;
+  stats_last_tick = now;
+  while (stats->tiempo_operacion_ms >= STATS_MS_PER_HOUR) {
+    stats->tiempo_operacion_ms -= STATS_MS_PER_HOUR;
+    statistics_advance_hour(stats);
   }
   
-  // Bloquear Flash
-  HAL_FLASH_Lock();
+  if (stats_dirty && (HAL_GetTick() - stats_last_flush) >= params.stats_flush_ms) {
+    statistics_save_to_flash(stats);
+  }
+}
+
+bool statistics_flush(Statistics *stats) {
+  if (!stats_dirty) return true;
+  return statistics_save_to_flash(stats);
+}
+
+// El guardado del aviso PVD, medido de punta a punta: sólo los contadores
+// agregados detrás de la imagen activa (unos 50 bytes, sin copiar la imagen
+// ni borrar). El historial y los percentiles desde el último guardado
+// periódico se pierden; la imagen completa no entra en el margen de corte
+static bool statistics_save_counters(void) {
+  uint32_t start = profiler_cycles();
+  
+  if (!flash_store_append_record(FLASH_RECORD_STATS_COUNTERS, STATS_COUNTERS_VERSION,
+                                 stats_ram, STATS_COUNTERS_SIZE)) {
+    emergency_flush_dropped++;
+    return false;
+  }
   
-  printf("Estadísticas guardadas en Flash\r\n");
+  emergency_last_us = profiler_cycles_to_us(profiler_cycles() - start);
+  if (emergency_last_us > emergency_max_us) emergency_max_us = emergency_last_us;
+  emergency_flush_count++;
   return true;
 }
 
+void statistics_emergency_flush(void) {
+  // Desde la IRQ del PVD: sin printf. stats_dirty sigue en true para que,
+  // si la alimentación vuelve, el guardado periódico escriba la imagen completa
+  if (stats_ram == NULL || !stats_dirty) return;
+  statistics_save_counters();
+}
+
+void statistics_test_emergency_flush(void) {
+  if (stats_ram == NULL) return;
+  
+  if (!statistics_save_counters()) {
+    printf("Error: Sin lugar detrás de la imagen o Flash ocupada\r\n");
+    return;
+  }
+  
+  printf("Guardado por aviso PVD: %lu us (%u bytes)\r\n", emergency_last_us, (unsigned)STATS_COUNTERS_SIZE);
+  statistics_show_flush_budget();
+}
+
+void statistics_show_flush_budget(void) {
+  printf("Guardado periódico (imagen completa): último %lu us | máximo %lu us | medidos %lu\r\n",
+         flush_last_us, flush_max_us, flush_count);
+  if (emergency_flush_count == 0) {
+    printf("Guardado por aviso PVD: sin medir ('pvd') | presupuesto %lu us de %lu us de margen\r\n",
+           (uint32_t)STATS_HOLDUP_BUDGET_US, (uint32_t)STATS_HOLDUP_US);
+  } else {
+    printf("Guardado por aviso PVD: último %lu us | máximo %lu us | presupuesto %lu us de %lu us de margen %s\r\n",
+           emergency_last_us, emergency_max_us, (uint32_t)STATS_HOLDUP_BUDGET_US, (uint32_t)STATS_HOLDUP_US,
+           (emergency_max_us <= STATS_HOLDUP_BUDGET_US) ? "✓" : "✗ EXCEDE");
+  }
+  printf("Avisos PVD: guardados %lu | descartados %lu | pendiente: %s\r\n",
+         emergency_flush_count, emergency_flush_dropped, stats_dirty ? "sí" : "no");
+}
+
+void statistics_get_flush_time(uint32_t *last_us, uint32_t *max_us) {
+  *last_us = flush_last_us;
+  *max_us = flush_max_us;
+}
+
 bool statistics_load_from_flash(Statistics *stats) {
-  // Leer desde Flash
-  uint32_t *flash_addr = (uint32_t *)STATS_FLASH_ADDR;
+  // El almacén sólo entrega registros de imágenes confirmadas y con CRC válido.
+  // Un registro viejo se migra: los campos nuevos arrancan vacíos
+  for (uint8_t i = 0; i < sizeof(stats_record_versions) / sizeof(stats_record_versions[0]); i++) {
+    memset(stats, 0, sizeof(Statistics));
+    if (flash_store_read_record(FLASH_RECORD_STATS, stats_record_versions[i].version, stats,
+                                stats_record_versions[i].size)) {
+      if (stats_record_versions[i].version < 3) {
+        statistics_init_distributions(stats);
+      }
+      return true;
+    }
+  }
   
-  // Verificar si hay datos válidos (simple check: total > 0 y < 1 millón)
-  uint32_t total = flash_addr[0];
-  if (total == 0xFFFFFFFF || total == 0 || total > 1000000) {
-    return false;  // No hay datos válidos
+  return false;
+}
+
+// Un registro agregado es más nuevo que la imagen: sus contadores mandan. Las
+// horas que pasaron desde la imagen se avanzan para limpiar sus casillas
+static void statistics_load_counters(Statistics *stats) {
+  uint32_t hours = stats->tiempo_operacion_horas;
+  
+  if (!flash_store_read_appended(FLASH_RECORD_STATS_COUNTERS, STATS_COUNTERS_VERSION, stats, STATS_COUNTERS_SIZE)) {
+    return;
   }
   
-  // Copiar datos
-  memcpy(stats, (void *)STATS_FLASH_ADDR, sizeof(Statistics));
+  uint32_t saved_hours = stats->tiempo_operacion_horas;
+  stats->tiempo_operacion_horas = hours;
+  while ((int32_t)(saved_hours - stats->tiempo_operacion_horas) > 0) {
+    statistics_advance_hour(stats);
+  }
   
-  return true;
+  // La imagen completa se reescribe en el próximo guardado periódico
+  stats_dirty = true;
+  printf("Contadores recuperados del aviso PVD (total %lu)\r\n", stats->total_clasificados);
 }
 
 // ============================================================================
@@ -174,6 +421,11 @@ void statistics_reset(Statistics *stats) {
   stats->clasificaciones_erroneas = 0;
   stats->promedio_confianza = 0.0f;
   stats->tiempo_operacion_horas = 0;
+  stats->tiempo_operacion_ms = 0;
+  memset(stats->por_hora, 0, sizeof(stats->por_hora));
+  memset(stats->por_dia, 0, sizeof(stats->por_dia));
+  statistics_init_distributions(stats);
+  stats_dirty = true;
   
   printf("Estadísticas reseteadas\r\n");
 }
@@ -190,6 +442,17 @@ void statistics_print(Statistics *stats) {
   printf("║ Errores:               %6lu                            ║\r\n", stats->clasificaciones_erroneas);
   printf("║ Confianza promedio:    %6.1f%%                          ║\r\n", stats->promedio_confianza);
   printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║                        p10     p50     p90     p99       ║\r\n");
+  printf("║ Confianza (%%):      %6lu  %6lu  %6lu  %6lu       ║\r\n",
+         quantile_get(&stats->dist_confianza, 10), quantile_get(&stats->dist_confianza, 50),
+         quantile_get(&stats->dist_confianza, 90), quantile_get(&stats->dist_confianza, 99));
+  printf("║ Ciclo (ms):          %6s  %6lu  %6lu  %6lu       ║\r\n", "-",
+         quantile_get(&stats->dist_ciclo_ms, 50), quantile_get(&stats->dist_ciclo_ms, 90),
+         quantile_get(&stats->dist_ciclo_ms, 99));
+  printf("║ Latencia (ms):       %6s  %6lu  %6lu  %6lu       ║\r\n", "-",
+         quantile_get(&stats->dist_latencia_ms, 50), quantile_get(&stats->dist_latencia_ms, 90),
+         quantile_get(&stats->dist_latencia_ms, 99));
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
   printf("║ Metal:                 %6lu  ", stats->contador_metal);
   if (stats->total_clasificados > 0) {
     printf("(%5.1f%%)          ║\r\n", (float)stats->contador_metal * 100.0f / stats->total_clasificados);
@@ -217,6 +480,62 @@ void statistics_print(Statistics *stats) {
   printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
 }
 
+void statistics_print_history(Statistics *stats) {
+  static const MaterialType materials[STATS_MATERIALS] = {
+    MATERIAL_METAL, MATERIAL_PAPEL, MATERIAL_PLASTICO, MATERIAL_VIDRIO
+  };
+  
+  printf("\n╔══════════════════════════════════════════════════════════╗\r\n");
+  printf("║         HISTORIAL (horas de operación: %6lu)            ║\r\n", stats->tiempo_operacion_horas);
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║ Hace  Metal Papel Plást Vidrio  Total   (últimas 24 h)\r\n");
+  
+  // Últimas 24 horas y hora pico de los últimos 7 días
+  uint16_t peak_hour = 0;
+  uint32_t peak_hour_total = 0;
+  for (uint16_t ago = 0; ago < STATS_HOURS_HISTORY; ago++) {
+    uint32_t total = 0;
+    for (uint8_t m = 0; m < STATS_MATERIALS; m++) {
+      total += statistics_get_hourly(stats, ago, materials[m]);
+    }
+    if (total > peak_hour_total) {
+      peak_hour_total = total;
+      peak_hour = ago;
+    }
+    if (ago < STATS_HOURS_PER_DAY) {
+      printf("║ %3dh %6d%6d%6d%7d%7lu\r\n", ago,
+             statistics_get_hourly(stats, ago, MATERIAL_METAL),
+             statistics_get_hourly(stats, ago, MATERIAL_PAPEL),
+             statistics_get_hourly(stats, ago, MATERIAL_PLASTICO),
+             statistics_get_hourly(stats, ago, MATERIAL_VIDRIO), total);
+    }
+  }
+  
+  // Día pico y promedio diario de los últimos 90 días
+  uint32_t today = stats->tiempo_operacion_horas / STATS_HOURS_PER_DAY;
+  uint16_t days = (today + 1 < STATS_DAYS_HISTORY) ? (uint16_t)(today + 1) : STATS_DAYS_HISTORY;
+  uint16_t peak_day = 0;
+  uint32_t peak_day_total = 0;
+  uint32_t all_days_total = 0;
+  for (uint16_t ago = 0; ago < days; ago++) {
+    uint32_t total = 0;
+    for (uint8_t m = 0; m < STATS_MATERIALS; m++) {
+      total += statistics_get_daily(stats, ago, materials[m]);
+    }
+    all_days_total += total;
+    if (total > peak_day_total) {
+      peak_day_total = total;
+      peak_day = ago;
+    }
+  }
+  
+  printf("╠══════════════════════════════════════════════════════════╣\r\n");
+  printf("║ Hora pico (7 días): hace %d h con %lu ítems\r\n", peak_hour, peak_hour_total);
+  printf("║ Día pico (%d días): hace %d días con %lu ítems\r\n", days, peak_day, peak_day_total);
+  printf("║ Promedio: %lu ítems por día de operación\r\n", all_days_total / days);
+  printf("╚══════════════════════════════════════════════════════════╝\r\n\n");
+}
+
 // ============================================================================
 // FIN DEL ARCHIVO
 // ============================================================================
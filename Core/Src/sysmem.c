@@ -21,9 +21,14 @@
  */
 
 /* Includes */
+#include "main.h"
+#include "config.h"
 #include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#if !HEAP_FREE_BUILD
+
 /**
  * Pointer to the current high watermark of the heap usage
  */
@@ -77,3 +82,78 @@ void *_sbrk(ptrdiff_t incr)
 
   return (void *)prev_heap_end;
 }
+
+#else /* HEAP_FREE_BUILD */
+
+// ============================================================================
+// SIN HEAP: CUALQUIER RESERVA DINÁMICA DETIENE EL SISTEMA
+// ============================================================================
+
+// Dirección de quien pidió memoria (verla con el depurador tras la trampa)
+volatile uint32_t heap_trap_caller = 0;
+
+struct _reent;
+
+static void heap_trap(void *caller)
+{
+  __disable_irq();
+  heap_trap_caller = (uint32_t)(uintptr_t)caller;
+  Error_Handler();
+}
+
+// newlib llama a _sbrk desde su malloc; las versiones _r las usa la
+// propia libc (stdio, strtod) sin pasar por malloc
+void *_sbrk(ptrdiff_t incr)
+{
+  heap_trap(__builtin_return_address(0));
+  errno = ENOMEM;
+  return (void *)-1;
+}
+
+void *malloc(size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void *calloc(size_t count, size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void free(void *ptr)
+{
+  if (ptr != NULL) heap_trap(__builtin_return_address(0));
+}
+
+void *_malloc_r(struct _reent *r, size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void *_calloc_r(struct _reent *r, size_t count, size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void *_realloc_r(struct _reent *r, void *ptr, size_t size)
+{
+  heap_trap(__builtin_return_address(0));
+  return NULL;
+}
+
+void _free_r(struct _reent *r, void *ptr)
+{
+  if (ptr != NULL) heap_trap(__builtin_return_address(0));
+}
+
+#endif /* HEAP_FREE_BUILD */
@@ -0,0 +1,372 @@
+/**
+ * @file telemetry.c
+ * @brief Implementación de la telemetría binaria por UART
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#include "telemetry.h"
+#include "actuators.h"
+#include "display.h"
+#include "fill_estimator.h"
+#include "flash_store.h"
+#include "params.h"
+#include "profiler.h"
+#include "statistics.h"
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// TIPOS PRIVADOS
+// ============================================================================
+
+#define TELEMETRY_HEADER_SIZE   8
+#define TELEMETRY_CRC_SIZE      4
+#define TELEMETRY_MAX_BODY      40
+#define TELEMETRY_MAX_PAYLOAD   (TELEMETRY_HEADER_SIZE + TELEMETRY_MAX_BODY + TELEMETRY_CRC_SIZE)
+// COBS agrega 1 byte cada 254 más los dos delimitadores
+#define TELEMETRY_MAX_FRAME     (TELEMETRY_MAX_PAYLOAD + TELEMETRY_MAX_PAYLOAD / 254 + 3)
+
+#define TELEMETRY_NO_HOURS      0xFFFF
+
+// Constructor de mensajes (little endian)
+typedef struct {
+  uint8_t data[TELEMETRY_MAX_PAYLOAD];
+  uint16_t len;
+} TelemetryMessage;
+
+// ============================================================================
+// VARIABLES PRIVADAS
+// ============================================================================
+
+// Cola circular de bytes ya codificados: head la mueve el loop, tail la IRQ
+static uint8_t tx_ring[TELEMETRY_TX_BUFFER];
+static volatile uint16_t tx_head = 0;
+static volatile uint16_t tx_tail = 0;
+static volatile uint16_t tx_chunk = 0;        // Bytes en vuelo (0 = UART libre)
+
+static bool telemetry_enabled = TELEMETRY_AUTOSTART;
+static uint32_t last_periodic_tick = 0;
+static uint8_t sequence = 0;
+
+// Contadores de la cola
+static uint32_t frames_sent = 0;
+static uint32_t frames_dropped = 0;
+static uint16_t ring_peak = 0;
+
+// Tiempos del loop principal desde el último mensaje de perfil
+static uint32_t loop_count = 0;
+static uint64_t loop_cycles_sum = 0;
+static uint32_t loop_cycles_max = 0;
+
+// ============================================================================
+// CONSTRUCCIÓN DE MENSAJES
+// ============================================================================
+
+static void msg_u8(TelemetryMessage *msg, uint8_t value) {
+  msg->data[msg->len++] = value;
+}
+
+static void msg_u16(TelemetryMessage *msg, uint16_t value) {
+  msg_u8(msg, (uint8_t)value);
+  msg_u8(msg, (uint8_t)(value >> 8));
+}
+
+static void msg_u32(TelemetryMessage *msg, uint32_t value) {
+  msg_u16(msg, (uint16_t)value);
+  msg_u16(msg, (uint16_t)(value >> 16));
+}
+
+// Texto de ancho fijo: corta sin partir una secuencia UTF-8 y rellena con 0
+static void msg_text(TelemetryMessage *msg, const char *text, uint8_t width) {
+  const uint8_t *p = (const uint8_t *)text;
+  uint8_t len = 0;
+  
+  while (p[len] != '\0') {
+    uint8_t seq = 1;
+    while ((p[len + seq] & 0xC0) == 0x80) seq++;
+    if (len + seq > width) break;
+    len += seq;
+  }
+  for (uint8_t i = 0; i < width; i++) {
+    msg_u8(msg, (i < len) ? p[i] : 0);
+  }
+}
+
+static void msg_begin(TelemetryMessage *msg, TelemetryMessageType type) {
+  msg->len = 0;
+  msg_u8(msg, TELEMETRY_PROTOCOL_VERSION);
+  msg_u8(msg, (uint8_t)type);
+  msg_u8(msg, TELEMETRY_STATION_ID);
+  msg_u8(msg, sequence++);
+  msg_u32(msg, HAL_GetTick());
+}
+
+static uint16_t clamp_u16(uint32_t value) {
+  return (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+}
+
+// ============================================================================
+// COBS Y COLA DE TRANSMISIÓN
+// ============================================================================
+
+// Codifica sin ceros; el llamador agrega los delimitadores
+static uint16_t telemetry_cobs_encode(const uint8_t *src, uint16_t len, uint8_t *dst) {
+  uint16_t code_index = 0;
+  uint16_t write = 1;
+  uint8_t code = 1;
+  
+  for (uint16_t read = 0; read < len; read++) {
+    if (src[read] == 0) {
+      dst[code_index] = code;
+      code = 1;
+      code_index = write++;
+    } else {
+      dst[write++] = src[read];
+      code++;
+      if (code == 0xFF) {
+        dst[code_index] = code;
+        code = 1;
+        code_index = write++;
+      }
+    }
+  }
+  dst[code_index] = code;
+  return write;
+}
+
+static uint16_t telemetry_ring_used(void) {
+  return (uint16_t)((tx_head + TELEMETRY_TX_BUFFER - tx_tail) % TELEMETRY_TX_BUFFER);
+}
+
+// Arranca el siguiente bloque contiguo si la UART está libre
+static void telemetry_tx_kick(void) {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  
+  if (tx_chunk == 0 && tx_head != tx_tail) {
+    uint16_t end = (tx_head > tx_tail) ? tx_head : TELEMETRY_TX_BUFFER;
+    uint16_t chunk = end - tx_tail;
+    if (HAL_UART_Transmit_IT(&BOARD_CONSOLE_UART, &tx_ring[tx_tail], chunk) == HAL_OK) {
+      tx_chunk = chunk;
+    }
+  }
+  
+  __set_PRIMASK(primask);
+}
+
+// Copia bytes a la cola (el llamador ya verificó que entran) y arranca la UART
+static void telemetry_ring_push(const uint8_t *data, uint16_t len) {
+  uint16_t head = tx_head;
+  for (uint16_t i = 0; i < len; i++) {
+    tx_ring[head] = data[i];
+    head = (head + 1) % TELEMETRY_TX_BUFFER;
+  }
+  tx_head = head;
+  
+  uint16_t used = telemetry_ring_used();
+  if (used > ring_peak) ring_peak = used;
+  
+  telemetry_tx_kick();
+}
+
+// Encola una trama completa o ninguna
+static bool telemetry_send(TelemetryMessage *msg) {
+  if (!telemetry_enabled) return false;
+  
+  uint32_t crc = flash_store_crc32(msg->data, msg->len);
+  msg_u32(msg, crc);
+  
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+  uint16_t frame_len = 0;
+  frame[frame_len++] = 0x00;
+  frame_len += telemetry_cobs_encode(msg->data, msg->len, &frame[frame_len]);
+  frame[frame_len++] = 0x00;
+  
+  if (frame_len > telemetry_tx_free()) {
+    frames_dropped++;
+    return false;
+  }
+  
+  telemetry_ring_push(frame, frame_len);
+  frames_sent++;
+  return true;
+}
+
+uint16_t telemetry_tx_free(void) {
+  // Un byte libre siempre queda sin usar para distinguir cola llena de vacía
+  return (uint16_t)(TELEMETRY_TX_BUFFER - 1 - telemetry_ring_used());
+}
+
+bool telemetry_write(const uint8_t *data, uint16_t len) {
+  if (len > telemetry_tx_free()) return false;
+  
+  telemetry_ring_push(data, len);
+  return true;
+}
+
+void telemetry_tx_complete(void) {
+  tx_tail = (tx_tail + tx_chunk) % TELEMETRY_TX_BUFFER;
+  tx_chunk = 0;
+  telemetry_tx_kick();
+}
+
+void telemetry_wait_idle(void) {
+  while (tx_chunk != 0 || tx_head != tx_tail) {
+    // La IRQ de la UART vacía la cola
+  }
+}
+
+// ============================================================================
+// MENSAJES
+// ============================================================================
+
+void telemetry_send_item(const ClassificationResult *result, SensorDigitalData digital,
+                         SensorAnalogData analog, uint8_t outcome) {
+  TelemetryMessage msg;
+  msg_begin(&msg, TELEMETRY_MSG_ITEM);
+  msg_u8(&msg, (uint8_t)result->material);
+  msg_u8(&msg, (uint8_t)(result->confidence + 0.5f));
+  msg_u8(&msg, outcome);
+  msg_u8(&msg, (uint8_t)((digital.inductivo ? 0x01 : 0) |
+                         (digital.capacitivo ? 0x02 : 0) |
+                         (digital.pir ? 0x04 : 0) |
+                         (result->isValid ? 0x80 : 0)));
+  msg_u16(&msg, analog.ldr_laser);
+  msg_u16(&msg, analog.microfono);
+  telemetry_send(&msg);
+}
+
+static void telemetry_send_stats(Statistics *stats) {
+  TelemetryMessage msg;
+  msg_begin(&msg, TELEMETRY_MSG_STATS);
+  msg_u32(&msg, stats->total_clasificados);
+  msg_u32(&msg, stats->contador_metal);
+  msg_u32(&msg, stats->contador_papel);
+  msg_u32(&msg, stats->contador_plastico);
+  msg_u32(&msg, stats->contador_vidrio);
+  msg_u32(&msg, stats->clasificaciones_erroneas);
+  msg_u16(&msg, (uint16_t)(stats->promedio_confianza * 100.0f));
+  msg_u32(&msg, stats->tiempo_operacion_horas);
+  msg_u16(&msg, clamp_u16(statistics_get_percentile(stats, STATS_DIST_CYCLE_MS, 50)));
+  msg_u16(&msg, clamp_u16(statistics_get_percentile(stats, STATS_DIST_CYCLE_MS, 90)));
+  msg_u16(&msg, clamp_u16(statistics_get_percentile(stats, STATS_DIST_LATENCY_MS, 50)));
+  msg_u16(&msg, clamp_u16(statistics_get_percentile(stats, STATS_DIST_LATENCY_MS, 90)));
+  telemetry_send(&msg);
+}
+
+static void telemetry_send_levels(void) {
+  static const MaterialType materials[4] = {
+    MATERIAL_METAL, MATERIAL_PAPEL, MATERIAL_PLASTICO, MATERIAL_VIDRIO
+  };
+  
+  TelemetryMessage msg;
+  msg_begin(&msg, TELEMETRY_MSG_LEVELS);
+  for (uint8_t i = 0; i < 4; i++) {
+    FillEstimate e = fill_get_estimate(materials[i]);
+    uint16_t hours = TELEMETRY_NO_HOURS;
+    if (e.valid) hours = clamp_u16((uint32_t)(e.hours_to_full * 10.0f));
+    
+    msg_u8(&msg, (uint8_t)(e.level_pct + 0.5f));
+    msg_u8(&msg, (uint8_t)((e.valid ? 0x01 : 0) | (fill_is_full(materials[i]) ? 0x02 : 0)));
+    msg_u16(&msg, (uint16_t)(int16_t)(e.rate_pct_h * 100.0f));   // 0.01 %/h
+    msg_u16(&msg, hours);                                          // 0.1 h
+  }
+  telemetry_send(&msg);
+}
+
+static void telemetry_send_profile(void) {
+  uint32_t flush_last_us = 0, flush_max_us = 0;
+  statistics_get_flush_time(&flush_last_us, &flush_max_us);
+  MotionStats motion = actuators_get_motion_stats();
+  
+  uint32_t loop_avg = loop_count ? (uint32_t)(loop_cycles_sum / loop_count) : 0;
+  
+  TelemetryMessage msg;
+  msg_begin(&msg, TELEMETRY_MSG_PROFILE);
+  msg_u32(&msg, loop_count);
+  msg_u32(&msg, profiler_cycles_to_us(loop_avg));
+  msg_u32(&msg, profiler_cycles_to_us(loop_cycles_max));
+  msg_u32(&msg, flush_last_us);
+  msg_u32(&msg, flush_max_us);
+  msg_u8(&msg, motion.max_depth);
+  msg_u32(&msg, motion.rejected);
+  msg_u32(&msg, frames_dropped);
+  msg_u16(&msg, ring_peak);
+  telemetry_send(&msg);
+  
+  loop_count = 0;
+  loop_cycles_sum = 0;
+  loop_cycles_max = 0;
+}
+
+// Salida de la capa de visualización: una trama por refresco del modelo
+static void telemetry_display_render(const DisplayModel *model, uint8_t changed) {
+  TelemetryMessage msg;
+  msg_begin(&msg, TELEMETRY_MSG_DISPLAY);
+  msg_u8(&msg, model->leds);
+  msg_u8(&msg, model->leds_animated);
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    msg_text(&msg, model->text[row], LCD_COLS);
+  }
+  telemetry_send(&msg);
+}
+
+static DisplaySink telemetry_display_sink = { "telemetría", telemetry_display_render, true, 0 };
+
+// ============================================================================
+// FUNCIONES PÚBLICAS
+// ============================================================================
+
+void telemetry_init(void) {
+  tx_head = 0;
+  tx_tail = 0;
+  tx_chunk = 0;
+  last_periodic_tick = HAL_GetTick();
+  
+  display_add_sink(&telemetry_display_sink);
+}
+
+void telemetry_set_enabled(bool enabled) {
+  telemetry_enabled = enabled;
+}
+
+bool telemetry_is_enabled(void) {
+  return telemetry_enabled;
+}
+
+void telemetry_set_period(uint32_t period_ms) {
+  params.telemetria_periodo_ms = period_ms;
+}
+
+void telemetry_record_loop(uint32_t cycles) {
+  loop_count++;
+  loop_cycles_sum += cycles;
+  if (cycles > loop_cycles_max) loop_cycles_max = cycles;
+}
+
+void telemetry_service(Statistics *stats) {
+  if (!telemetry_enabled || params.telemetria_periodo_ms == 0) return;
+  
+  uint32_t now = HAL_GetTick();
+  if ((now - last_periodic_tick) < params.telemetria_periodo_ms) return;
+  last_periodic_tick = now;
+  
+  telemetry_send_stats(stats);
+  telemetry_send_levels();
+  telemetry_send_profile();
+}
+
+void telemetry_show_status(void) {
+  uint32_t loop_avg = loop_count ? (uint32_t)(loop_cycles_sum / loop_count) : 0;
+  
+  printf("Telemetría: %s | período %lu ms | tramas %lu | descartadas %lu | cola máx %u/%u bytes\r\n",
+         telemetry_enabled ? "activa" : "inactiva", params.telemetria_periodo_ms,
+         frames_sent, frames_dropped, ring_peak, (unsigned)TELEMETRY_TX_BUFFER);
+  printf("Loop principal: %lu iteraciones | promedio %lu us | máximo %lu us\r\n",
+         loop_count, profiler_cycles_to_us(loop_avg), profiler_cycles_to_us(loop_cycles_max));
+}
+
+// ============================================================================
+// FIN DEL ARCHIVO
+// ============================================================================
@@ -0,0 +1,26 @@
+/**
+ * @file arm_types.h
+ * @brief Tipos enteros de arm-none-eabi para compilar el firmware en la PC
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Se incluye antes que cualquier otro archivo (-include). En newlib,
+ * uint32_t e int32_t son long: con estos tipos los "%lu" del firmware y
+ * los (uint32_t) de direcciones se verifican igual que en la placa. Sólo
+ * sirve para revisar la sintaxis y las advertencias, no para ejecutar.
+ */
+
+#ifndef BOARD_CHECK_ARM_TYPES_H
+#define BOARD_CHECK_ARM_TYPES_H
+
+#define int32_t board_check_host_int32_t
+#define uint32_t board_check_host_uint32_t
+#include <stdint.h>
+#include <sys/types.h>
+#undef int32_t
+#undef uint32_t
+
+typedef long int32_t;
+typedef unsigned long uint32_t;
+
+#endif // BOARD_CHECK_ARM_TYPES_H
@@ -0,0 +1,584 @@
+/**
+ * @file stm32_hal_common.h
+ * @brief Partes de la HAL y de CMSIS iguales en STM32F4 y STM32L4
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Sólo declaraciones: alcanza para compilar el firmware con -fsyntax-only.
+ * Los registros se declaran como variables externas. Cada familia agrega
+ * lo suyo en stm32f4xx_hal.h o stm32l4xx_hal.h.
+ */
+
+#ifndef BOARD_CHECK_STM32_HAL_COMMON_H
+#define BOARD_CHECK_STM32_HAL_COMMON_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define __IO volatile
+#define __I  volatile const
+#define UNUSED(x) ((void)(x))
+
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR = 1,
+  HAL_BUSY = 2,
+  HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+// ============================================================================
+// NÚCLEO CORTEX-M4 (CMSIS)
+// ============================================================================
+
+typedef int IRQn_Type;
+
+#define NonMaskableInt_IRQn         (-14)
+#define HardFault_IRQn              (-13)
+#define MemoryManagement_IRQn       (-12)
+#define BusFault_IRQn               (-11)
+#define UsageFault_IRQn             (-10)
+#define SVCall_IRQn                 (-5)
+#define DebugMonitor_IRQn           (-4)
+#define PendSV_IRQn                 (-2)
+#define SysTick_IRQn                (-1)
+
+typedef struct {
+  __IO uint32_t ISER[8];
+  uint32_t RESERVED0[24];
+  __IO uint32_t ICER[8];
+  uint32_t RESERVED1[24];
+  __IO uint32_t ISPR[8];
+  uint32_t RESERVED2[24];
+  __IO uint32_t ICPR[8];
+  uint32_t RESERVED3[24];
+  __IO uint32_t IABR[8];
+  uint32_t RESERVED4[56];
+  __IO uint8_t IP[240];
+} NVIC_Type;
+
+typedef struct {
+  __I uint32_t CPUID;
+  __IO uint32_t ICSR, VTOR, AIRCR, SCR, CCR;
+  __IO uint8_t SHP[12];
+  __IO uint32_t SHCSR, CFSR, HFSR, DFSR, MMFAR, BFAR, AFSR;
+} SCB_Type;
+
+typedef struct {
+  __IO uint32_t CTRL, CYCCNT, CPICNT, EXCCNT, SLEEPCNT, LSUCNT, FOLDCNT;
+} DWT_Type;
+
+typedef struct {
+  __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR;
+} CoreDebug_Type;
+
+extern NVIC_Type board_check_nvic;
+extern SCB_Type board_check_scb;
+extern DWT_Type board_check_dwt;
+extern CoreDebug_Type board_check_coredebug;
+
+#define NVIC                        (&board_check_nvic)
+#define SCB                         (&board_check_scb)
+#define DWT                         (&board_check_dwt)
+#define CoreDebug                   (&board_check_coredebug)
+
+#define SCB_ICSR_VECTACTIVE_Msk     0x1FFU
+#define SCB_SCR_SLEEPONEXIT_Msk     (1U << 1)
+#define SCB_CFSR_MEMFAULTSR_Msk     0xFFU
+#define DWT_CTRL_CYCCNTENA_Msk      (1U << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1U << 24)
+
+void __enable_irq(void);
+void __disable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+uint32_t __get_IPSR(void);
+uint32_t __get_MSP(void);
+uint32_t __get_PSP(void);
+void __DSB(void);
+void __ISB(void);
+void __DMB(void);
+void __WFI(void);
+void __NOP(void);
+void __BKPT(uint32_t value);
+void NVIC_SystemReset(void);
+void NVIC_EnableIRQ(IRQn_Type irq);
+void NVIC_DisableIRQ(IRQn_Type irq);
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority);
+
+#define NVIC_PRIORITYGROUP_0        0x7U
+#define NVIC_PRIORITYGROUP_4        0x3U
+
+void HAL_NVIC_SetPriorityGrouping(uint32_t group);
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt, uint32_t sub);
+void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+void HAL_NVIC_DisableIRQ(IRQn_Type irq);
+void HAL_NVIC_SetPendingIRQ(IRQn_Type irq);
+uint32_t HAL_SYSTICK_Config(uint32_t ticks);
+
+// ============================================================================
+// HAL GENERAL
+// ============================================================================
+
+typedef enum {
+  HAL_TICK_FREQ_10HZ = 100,
+  HAL_TICK_FREQ_100HZ = 10,
+  HAL_TICK_FREQ_1KHZ = 1,
+  HAL_TICK_FREQ_DEFAULT = HAL_TICK_FREQ_1KHZ
+} HAL_TickFreqTypeDef;
+
+extern __IO uint32_t uwTick;
+extern HAL_TickFreqTypeDef uwTickFreq;
+extern uint32_t SystemCoreClock;
+
+HAL_StatusTypeDef HAL_Init(void);
+void HAL_MspInit(void);
+void HAL_IncTick(void);
+void HAL_Delay(uint32_t delay);
+uint32_t HAL_GetTick(void);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+void SystemInit(void);
+void SystemCoreClockUpdate(void);
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2], BRR;
+} GPIO_TypeDef;
+
+typedef struct {
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+  uint32_t Alternate;
+} GPIO_InitTypeDef;
+
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+extern GPIO_TypeDef board_check_gpio[8];
+
+#define GPIOA                       (&board_check_gpio[0])
+#define GPIOB                       (&board_check_gpio[1])
+#define GPIOC                       (&board_check_gpio[2])
+#define GPIOD                       (&board_check_gpio[3])
+#define GPIOH                       (&board_check_gpio[7])
+
+#define GPIO_PIN_0                  ((uint16_t)0x0001)
+#define GPIO_PIN_1                  ((uint16_t)0x0002)
+#define GPIO_PIN_2                  ((uint16_t)0x0004)
+#define GPIO_PIN_3                  ((uint16_t)0x0008)
+#define GPIO_PIN_4                  ((uint16_t)0x0010)
+#define GPIO_PIN_5                  ((uint16_t)0x0020)
+#define GPIO_PIN_6                  ((uint16_t)0x0040)
+#define GPIO_PIN_7                  ((uint16_t)0x0080)
+#define GPIO_PIN_8                  ((uint16_t)0x0100)
+#define GPIO_PIN_9                  ((uint16_t)0x0200)
+#define GPIO_PIN_10                 ((uint16_t)0x0400)
+#define GPIO_PIN_11                 ((uint16_t)0x0800)
+#define GPIO_PIN_12                 ((uint16_t)0x1000)
+#define GPIO_PIN_13                 ((uint16_t)0x2000)
+#define GPIO_PIN_14                 ((uint16_t)0x4000)
+#define GPIO_PIN_15                 ((uint16_t)0x8000)
+#define GPIO_PIN_All                ((uint16_t)0xFFFF)
+
+#define GPIO_MODE_INPUT             0x00000000U
+#define GPIO_MODE_OUTPUT_PP         0x00000001U
+#define GPIO_MODE_OUTPUT_OD         0x00000011U
+#define GPIO_MODE_AF_PP             0x00000002U
+#define GPIO_MODE_AF_OD             0x00000012U
+#define GPIO_MODE_ANALOG            0x00000003U
+#define GPIO_MODE_IT_RISING         0x10110000U
+#define GPIO_MODE_IT_FALLING        0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+
+#define GPIO_NOPULL                 0x00000000U
+#define GPIO_PULLUP                 0x00000001U
+#define GPIO_PULLDOWN               0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW         0x00000000U
+#define GPIO_SPEED_FREQ_MEDIUM      0x00000001U
+#define GPIO_SPEED_FREQ_HIGH        0x00000002U
+#define GPIO_SPEED_FREQ_VERY_HIGH   0x00000003U
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_DeInit(GPIO_TypeDef *port, uint32_t pin);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+void HAL_GPIO_TogglePin(GPIO_TypeDef *port, uint16_t pin);
+void HAL_GPIO_EXTI_IRQHandler(uint16_t pin);
+void HAL_GPIO_EXTI_Callback(uint16_t pin);
+
+// ============================================================================
+// TIMERS
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR;
+  __IO uint32_t CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR;
+} TIM_TypeDef;
+
+#define TIM_CCER_CC1E               (1U << 0)
+#define TIM_CCER_CC2E               (1U << 4)
+#define TIM_CCER_CC3E               (1U << 8)
+#define TIM_CCER_CC4E               (1U << 12)
+
+typedef struct {
+  uint32_t Prescaler;
+  uint32_t CounterMode;
+  uint32_t Period;
+  uint32_t ClockDivision;
+  uint32_t RepetitionCounter;
+  uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+  uint32_t OCMode;
+  uint32_t Pulse;
+  uint32_t OCPolarity;
+  uint32_t OCNPolarity;
+  uint32_t OCFastMode;
+  uint32_t OCIdleState;
+  uint32_t OCNIdleState;
+} TIM_OC_InitTypeDef;
+
+typedef struct {
+  uint32_t ClockSource;
+  uint32_t ClockPolarity;
+  uint32_t ClockPrescaler;
+  uint32_t ClockFilter;
+} TIM_ClockConfigTypeDef;
+
+typedef struct {
+  uint32_t MasterOutputTrigger;
+  uint32_t MasterOutputTrigger2;
+  uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+typedef struct {
+  uint32_t OffStateRunMode;
+  uint32_t OffStateIDLEMode;
+  uint32_t LockLevel;
+  uint32_t DeadTime;
+  uint32_t BreakState;
+  uint32_t BreakPolarity;
+  uint32_t BreakFilter;
+  uint32_t Break2State;
+  uint32_t Break2Polarity;
+  uint32_t Break2Filter;
+  uint32_t AutomaticOutput;
+} TIM_BreakDeadTimeConfigTypeDef;
+
+typedef struct {
+  TIM_TypeDef *Instance;
+  TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1               0x00000000U
+#define TIM_CHANNEL_2               0x00000004U
+#define TIM_CHANNEL_3               0x00000008U
+#define TIM_CHANNEL_4               0x0000000CU
+
+#define TIM_COUNTERMODE_UP          0x00000000U
+#define TIM_CLOCKDIVISION_DIV1      0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_DISABLE 0x00000000U
+#define TIM_AUTORELOAD_PRELOAD_ENABLE  0x00000080U
+#define TIM_CLOCKSOURCE_INTERNAL    0x00001000U
+#define TIM_TRGO_RESET              0x00000000U
+#define TIM_TRGO2_RESET             0x00000000U
+#define TIM_MASTERSLAVEMODE_DISABLE 0x00000000U
+#define TIM_OCMODE_PWM1             0x00000060U
+#define TIM_OCPOLARITY_HIGH         0x00000000U
+#define TIM_OCNPOLARITY_HIGH        0x00000000U
+#define TIM_OCFAST_DISABLE          0x00000000U
+#define TIM_OCIDLESTATE_RESET       0x00000000U
+#define TIM_OCNIDLESTATE_RESET      0x00000000U
+#define TIM_OSSR_DISABLE            0x00000000U
+#define TIM_OSSI_DISABLE            0x00000000U
+#define TIM_LOCKLEVEL_OFF           0x00000000U
+#define TIM_BREAK_DISABLE           0x00000000U
+#define TIM_BREAKPOLARITY_HIGH      0x00002000U
+#define TIM_BREAK2_DISABLE          0x00000000U
+#define TIM_BREAK2POLARITY_HIGH     0x02000000U
+#define TIM_AUTOMATICOUTPUT_DISABLE 0x00000000U
+#define TIM_IT_UPDATE               (1U << 0)
+#define TIM_EGR_UG                  (1U << 0)
+#define TIM_CR1_CEN                 (1U << 0)
+
+#define __HAL_TIM_SET_COMPARE(h, c, v) (*(&(h)->Instance->CCR1 + ((c) >> 2)) = (v))
+#define __HAL_TIM_GET_COMPARE(h, c)    (*(&(h)->Instance->CCR1 + ((c) >> 2)))
+#define __HAL_TIM_SET_PRESCALER(h, v)  ((h)->Instance->PSC = (v))
+#define __HAL_TIM_GET_PRESCALER(h)     ((h)->Instance->PSC)
+#define __HAL_TIM_SET_AUTORELOAD(h, v) ((h)->Instance->ARR = (v))
+#define __HAL_TIM_GET_AUTORELOAD(h)    ((h)->Instance->ARR)
+#define __HAL_TIM_SET_COUNTER(h, v)    ((h)->Instance->CNT = (v))
+#define __HAL_TIM_GET_COUNTER(h)       ((h)->Instance->CNT)
+#define __HAL_TIM_ENABLE_IT(h, i)      ((h)->Instance->DIER |= (i))
+#define __HAL_TIM_DISABLE_IT(h, i)     ((h)->Instance->DIER &= ~(i))
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Init(TIM_HandleTypeDef *htim);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_ConfigChannel(TIM_HandleTypeDef *htim, TIM_OC_InitTypeDef *config, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_ConfigClockSource(TIM_HandleTypeDef *htim, TIM_ClockConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef *htim, TIM_MasterConfigTypeDef *config);
+HAL_StatusTypeDef HAL_TIMEx_ConfigBreakDeadTime(TIM_HandleTypeDef *htim, TIM_BreakDeadTimeConfigTypeDef *config);
+void HAL_TIM_Base_MspInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_PWM_MspInit(TIM_HandleTypeDef *htim);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef *htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim);
+
+// ============================================================================
+// DMA
+// ============================================================================
+
+typedef struct {
+  uint32_t Channel;
+  uint32_t Request;
+  uint32_t Direction;
+  uint32_t PeriphInc;
+  uint32_t MemInc;
+  uint32_t PeriphDataAlignment;
+  uint32_t MemDataAlignment;
+  uint32_t Mode;
+  uint32_t Priority;
+  uint32_t FIFOMode;
+} DMA_InitTypeDef;
+
+typedef struct __DMA_HandleTypeDef {
+  void *Instance;
+  DMA_InitTypeDef Init;
+  void *Parent;
+} DMA_HandleTypeDef;
+
+#define DMA_PERIPH_TO_MEMORY        0x00000000U
+#define DMA_PINC_DISABLE            0x00000000U
+#define DMA_MINC_ENABLE             0x00000400U
+#define DMA_PDATAALIGN_HALFWORD     0x00000800U
+#define DMA_MDATAALIGN_HALFWORD     0x00002000U
+#define DMA_CIRCULAR                0x00000100U
+#define DMA_PRIORITY_HIGH           0x00020000U
+#define DMA_IT_TC                   (1U << 1)
+#define DMA_IT_HT                   (1U << 2)
+
+#define __HAL_LINKDMA(h, field, dma) do { (h)->field = &(dma); (dma).Parent = (h); } while (0)
+#define __HAL_DMA_DISABLE_IT(h, i)  ((void)(h), (void)(i))
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef *hdma);
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef *hdma);
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef *hdma);
+
+// ============================================================================
+// ADC
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR1, JOFR2, JOFR3, JOFR4, HTR, LTR;
+  __IO uint32_t SQR1, SQR2, SQR3, JSQR, JDR1, JDR2, JDR3, JDR4, DR;
+} ADC_TypeDef;
+
+typedef struct {
+  uint32_t Ratio;
+  uint32_t RightBitShift;
+  uint32_t TriggeredMode;
+  uint32_t OversamplingStopReset;
+} ADC_OversamplingTypeDef;
+
+typedef struct {
+  uint32_t ClockPrescaler;
+  uint32_t Resolution;
+  uint32_t DataAlign;
+  uint32_t ScanConvMode;
+  uint32_t EOCSelection;
+  FunctionalState LowPowerAutoWait;
+  FunctionalState ContinuousConvMode;
+  uint32_t NbrOfConversion;
+  FunctionalState DiscontinuousConvMode;
+  uint32_t NbrOfDiscConversion;
+  uint32_t ExternalTrigConv;
+  uint32_t ExternalTrigConvEdge;
+  FunctionalState DMAContinuousRequests;
+  uint32_t Overrun;
+  FunctionalState OversamplingMode;
+  ADC_OversamplingTypeDef Oversampling;
+} ADC_InitTypeDef;
+
+typedef struct {
+  uint32_t Channel;
+  uint32_t Rank;
+  uint32_t SamplingTime;
+  uint32_t SingleDiff;
+  uint32_t OffsetNumber;
+  uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct __ADC_HandleTypeDef {
+  ADC_TypeDef *Instance;
+  ADC_InitTypeDef Init;
+  DMA_HandleTypeDef *DMA_Handle;
+} ADC_HandleTypeDef;
+
+#define ADC_DATAALIGN_RIGHT         0x00000000U
+#define ADC_SOFTWARE_START          0x0F000001U
+#define ADC_EXTERNALTRIGCONVEDGE_NONE 0x00000000U
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *config);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef *hadc, uint32_t *data, uint32_t length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef *hadc);
+void HAL_ADC_MspInit(ADC_HandleTypeDef *hadc);
+void HAL_ADC_MspDeInit(ADC_HandleTypeDef *hadc);
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc);
+
+// ============================================================================
+// UART
+// ============================================================================
+
+typedef struct {
+  uint32_t BaudRate;
+  uint32_t WordLength;
+  uint32_t StopBits;
+  uint32_t Parity;
+  uint32_t Mode;
+  uint32_t HwFlowCtl;
+  uint32_t OverSampling;
+  uint32_t OneBitSampling;
+} UART_InitTypeDef;
+
+typedef struct {
+  uint32_t AdvFeatureInit;
+} UART_AdvFeatureInitTypeDef;
+
+typedef struct __UART_HandleTypeDef UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B          0x00000000U
+#define UART_STOPBITS_1             0x00000000U
+#define UART_PARITY_NONE            0x00000000U
+#define UART_MODE_TX_RX             0x0000000CU
+#define UART_HWCONTROL_NONE         0x00000000U
+#define UART_OVERSAMPLING_16        0x00000000U
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef *huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t size);
+void HAL_UART_MspInit(UART_HandleTypeDef *huart);
+void HAL_UART_MspDeInit(UART_HandleTypeDef *huart);
+void HAL_UART_IRQHandler(UART_HandleTypeDef *huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart);
+
+// ============================================================================
+// I2C
+// ============================================================================
+
+typedef struct {
+  uint32_t ClockSpeed;
+  uint32_t DutyCycle;
+  uint32_t Timing;
+  uint32_t OwnAddress1;
+  uint32_t AddressingMode;
+  uint32_t DualAddressMode;
+  uint32_t OwnAddress2;
+  uint32_t OwnAddress2Masks;
+  uint32_t GeneralCallMode;
+  uint32_t NoStretchMode;
+} I2C_InitTypeDef;
+
+typedef struct __I2C_HandleTypeDef I2C_HandleTypeDef;
+
+#define I2C_ADDRESSINGMODE_7BIT     0x00000001U
+#define I2C_DUALADDRESS_DISABLE     0x00000000U
+#define I2C_GENERALCALL_DISABLE     0x00000000U
+#define I2C_NOSTRETCH_DISABLE       0x00000000U
+#define I2C_MEMADD_SIZE_8BIT        0x00000001U
+#define I2C_FIRST_FRAME             0x00000001U
+#define I2C_LAST_FRAME              0x00000020U
+#define HAL_I2C_ERROR_NONE          0x00000000U
+#define HAL_I2C_ERROR_AF            0x00000004U
+
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size, uint32_t options);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint8_t *data, uint16_t size, uint32_t options);
+HAL_StatusTypeDef HAL_I2C_Mem_Write_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size);
+HAL_StatusTypeDef HAL_I2C_Mem_Read_IT(I2C_HandleTypeDef *hi2c, uint16_t address, uint16_t mem, uint16_t mem_size, uint8_t *data, uint16_t size);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MspInit(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MspDeInit(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_EV_IRQHandler(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ER_IRQHandler(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MasterRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c);
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c);
+
+// ============================================================================
+// RCC, PWR Y FLASH
+// ============================================================================
+
+typedef struct {
+  uint32_t ClockType;
+  uint32_t SYSCLKSource;
+  uint32_t AHBCLKDivider;
+  uint32_t APB1CLKDivider;
+  uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define RCC_CLOCKTYPE_SYSCLK        0x00000001U
+#define RCC_CLOCKTYPE_HCLK          0x00000002U
+#define RCC_CLOCKTYPE_PCLK1         0x00000004U
+#define RCC_CLOCKTYPE_PCLK2         0x00000008U
+#define RCC_SYSCLKSOURCE_PLLCLK     0x00000003U
+#define RCC_SYSCLK_DIV1             0x00000000U
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef *config, uint32_t latency);
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *config, uint32_t *latency);
+uint32_t HAL_RCC_GetSysClockFreq(void);
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+typedef struct {
+  uint32_t PVDLevel;
+  uint32_t Mode;
+} PWR_PVDTypeDef;
+
+#define PWR_PVD_MODE_IT_RISING      0x00010001U
+#define PWR_PVD_MODE_IT_FALLING     0x00010002U
+#define PWR_PVD_MODE_IT_RISING_FALLING 0x00010003U
+#define PWR_MAINREGULATOR_ON        0x00000000U
+#define PWR_SLEEPENTRY_WFI          ((uint8_t)0x01)
+
+void HAL_PWR_EnableBkUpAccess(void);
+void HAL_PWR_EnterSLEEPMode(uint32_t regulator, uint8_t entry);
+void HAL_PWR_PVD_IRQHandler(void);
+void HAL_PWR_PVDCallback(void);
+
+#define FLASH_BASE                  0x08000000UL
+#define SRAM_BASE                   0x20000000UL
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t address, uint64_t data);
+
+#endif // BOARD_CHECK_STM32_HAL_COMMON_H
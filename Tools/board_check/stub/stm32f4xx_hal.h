@@ -0,0 +1,333 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief HAL mínima de STM32F4 (F410RB) para revisar el firmware en la PC
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef BOARD_CHECK_STM32F4XX_HAL_H
+#define BOARD_CHECK_STM32F4XX_HAL_H
+
+#include "stm32_hal_common.h"
+
+// ============================================================================
+// INTERRUPCIONES (STM32F410Rx)
+// ============================================================================
+
+#define PVD_IRQn                    1
+#define RTC_Alarm_IRQn              41
+#define EXTI15_10_IRQn              40
+#define ADC_IRQn                    18
+#define TIM1_BRK_TIM9_IRQn          24
+#define TIM1_UP_IRQn                25
+#define TIM1_CC_IRQn                27
+#define I2C1_EV_IRQn                31
+#define I2C1_ER_IRQn                32
+#define USART1_IRQn                 37
+#define USART2_IRQn                 38
+#define TIM5_IRQn                   50
+#define TIM6_DAC_IRQn               54
+#define DMA2_Stream0_IRQn           56
+#define DMA2_Stream2_IRQn           58
+#define DMA2_Stream7_IRQn           70
+#define FPU_IRQn                    81
+
+// ============================================================================
+// PERIFÉRICOS
+// ============================================================================
+
+extern TIM_TypeDef board_check_tim[12];
+#define TIM1                        (&board_check_tim[1])
+#define TIM5                        (&board_check_tim[5])
+#define TIM6                        (&board_check_tim[6])
+#define TIM9                        (&board_check_tim[9])
+#define TIM11                       (&board_check_tim[11])
+
+extern ADC_TypeDef board_check_adc;
+#define ADC1                        (&board_check_adc)
+
+typedef struct {
+  __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+  __IO uint32_t LISR, HISR, LIFCR, HIFCR;
+} DMA_TypeDef;
+
+extern DMA_TypeDef board_check_dma2;
+extern DMA_Stream_TypeDef board_check_dma2_stream[8];
+#define DMA2                        (&board_check_dma2)
+#define DMA2_Stream0                (&board_check_dma2_stream[0])
+#define DMA2_Stream2                (&board_check_dma2_stream[2])
+#define DMA2_Stream7                (&board_check_dma2_stream[7])
+
+#define DMA_LISR_FEIF0              (1U << 0)
+#define DMA_LISR_DMEIF0             (1U << 2)
+#define DMA_LISR_TEIF0              (1U << 3)
+#define DMA_LISR_HTIF0              (1U << 4)
+#define DMA_LISR_TCIF0              (1U << 5)
+#define DMA_CHANNEL_0               0x00000000U
+#define DMA_FIFOMODE_DISABLE        0x00000000U
+
+typedef struct {
+  __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR;
+} USART_TypeDef;
+
+extern USART_TypeDef board_check_usart[7];
+#define USART1                      (&board_check_usart[1])
+#define USART2                      (&board_check_usart[2])
+#define USART6                      (&board_check_usart[6])
+
+#define USART_SR_ORE                (1U << 3)
+#define USART_SR_IDLE               (1U << 4)
+#define USART_SR_RXNE               (1U << 5)
+#define USART_SR_TC                 (1U << 6)
+#define USART_SR_TXE                (1U << 7)
+#define USART_CR1_IDLEIE            (1U << 4)
+#define USART_CR1_RXNEIE            (1U << 5)
+#define USART_CR1_TCIE              (1U << 6)
+#define USART_CR1_TXEIE             (1U << 7)
+
+struct __UART_HandleTypeDef {
+  USART_TypeDef *Instance;
+  UART_InitTypeDef Init;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+};
+
+#define UART_IT_IDLE                0x00000010U
+#define UART_IT_RXNE                0x00000020U
+#define UART_FLAG_IDLE              0x00000010U
+#define UART_FLAG_RXNE              0x00000020U
+#define __HAL_UART_ENABLE_IT(h, i)  ((h)->Instance->CR1 |= (i))
+#define __HAL_UART_DISABLE_IT(h, i) ((h)->Instance->CR1 &= ~(i))
+#define __HAL_UART_GET_FLAG(h, f)   (((h)->Instance->SR & (f)) == (f))
+
+typedef struct {
+  __IO uint32_t CR1, CR2, OAR1, OAR2, DR, SR1, SR2, CCR, TRISE, FLTR;
+} I2C_TypeDef;
+
+#define I2C_CR2_ITERREN             (1U << 8)
+#define I2C_CR2_ITEVTEN             (1U << 9)
+#define I2C_CR2_ITBUFEN             (1U << 10)
+
+extern I2C_TypeDef board_check_i2c[2];
+#define I2C1                        (&board_check_i2c[1])
+
+struct __I2C_HandleTypeDef {
+  I2C_TypeDef *Instance;
+  I2C_InitTypeDef Init;
+  __IO uint32_t ErrorCode;
+};
+
+#define I2C_DUTYCYCLE_2             0x00000000U
+#define I2C_DUTYCYCLE_16_9          0x00004000U
+#define I2C_FLAG_BUSY               0x00100002U
+#define __HAL_I2C_GET_FLAG(h, f)    (((h)->Instance->SR2 & ((f) & 0xFFFFU)) != 0U)
+
+// Canales y tiempos de muestreo del ADC
+#define ADC_CHANNEL_0               0x00000000U
+#define ADC_CHANNEL_1               0x00000001U
+#define ADC_CHANNEL_4               0x00000004U
+#define ADC_CHANNEL_6               0x00000006U
+#define ADC_CHANNEL_7               0x00000007U
+#define ADC_CHANNEL_8               0x00000008U
+#define ADC_CHANNEL_10              0x0000000AU
+#define ADC_CHANNEL_11              0x0000000BU
+#define ADC_CHANNEL_VREFINT         0x00000011U
+#define ADC_CLOCK_SYNC_PCLK_DIV4    0x00010000U
+#define ADC_RESOLUTION_12B          0x00000000U
+#define ADC_EOC_SINGLE_CONV         0x00000001U
+#define ADC_EOC_SEQ_CONV            0x00000000U
+#define ADC_SAMPLETIME_3CYCLES      0x00000000U
+#define ADC_SAMPLETIME_84CYCLES     0x00000004U
+#define ADC_SAMPLETIME_144CYCLES    0x00000006U
+#define ADC_SAMPLETIME_480CYCLES    0x00000007U
+
+// Funciones alternativas de los pines
+#define GPIO_AF1_TIM1               0x01U
+#define GPIO_AF2_TIM5               0x02U
+#define GPIO_AF4_I2C1               0x04U
+#define GPIO_AF7_USART1             0x07U
+#define GPIO_AF7_USART2             0x07U
+
+// ============================================================================
+// RCC Y PWR
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t CR, PLLCFGR, CFGR, CIR, AHB1RSTR, AHB2RSTR, RESERVED0[2], APB1RSTR, APB2RSTR;
+  uint32_t RESERVED1[2];
+  __IO uint32_t AHB1ENR, AHB2ENR, RESERVED2[2], APB1ENR, APB2ENR;
+  uint32_t RESERVED3[2];
+  __IO uint32_t AHB1LPENR, AHB2LPENR, RESERVED4[2], APB1LPENR, APB2LPENR;
+  uint32_t RESERVED5[2];
+  __IO uint32_t BDCR, CSR;
+} RCC_TypeDef;
+
+extern RCC_TypeDef board_check_rcc;
+#define RCC                         (&board_check_rcc)
+
+#define RCC_CFGR_PPRE1_Pos          10U
+#define RCC_CFGR_PPRE1              (0x7U << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos          13U
+#define RCC_CFGR_PPRE2              (0x7U << RCC_CFGR_PPRE2_Pos)
+#define RCC_CSR_BORRSTF             (1U << 25)
+#define RCC_CSR_PINRSTF             (1U << 26)
+#define RCC_CSR_PORRSTF             (1U << 27)
+#define RCC_CSR_SFTRSTF             (1U << 28)
+#define RCC_CSR_IWDGRSTF            (1U << 29)
+#define RCC_CSR_WWDGRSTF            (1U << 30)
+#define RCC_CSR_LPWRRSTF            (1U << 31)
+#define RCC_CSR_RMVF                (1U << 24)
+
+typedef struct {
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t PLLM;
+  uint32_t PLLN;
+  uint32_t PLLP;
+  uint32_t PLLQ;
+  uint32_t PLLR;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+  uint32_t OscillatorType;
+  uint32_t HSEState;
+  uint32_t LSEState;
+  uint32_t HSIState;
+  uint32_t HSICalibrationValue;
+  uint32_t LSIState;
+  RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_HSI_ON                  0x00000001U
+#define RCC_HSICALIBRATION_DEFAULT  0x10U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSI           0x00000000U
+#define RCC_PLLP_DIV2               0x00000002U
+#define RCC_HCLK_DIV1               0x00000000U
+#define RCC_HCLK_DIV2               0x00001000U
+#define RCC_HCLK_DIV4               0x00001400U
+#define RCC_HCLK_DIV8               0x00001800U
+#define RCC_HCLK_DIV16              0x00001C00U
+#define FLASH_LATENCY_3             0x00000003U
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *config);
+
+#define __HAL_RCC_PWR_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOH_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_I2C1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_I2C1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM5_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM5_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM9_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM11_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_USART1_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_USART1_CLK_DISABLE() ((void)0)
+#define __HAL_RCC_USART2_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_RTC_ENABLE()         ((void)0)
+#define __HAL_PWR_VOLTAGESCALING_CONFIG(x) ((void)(x))
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x0000C000U
+
+#define PWR_PVDLEVEL_0              0x00000000U
+#define PWR_PVDLEVEL_5              0x000000A0U
+#define PWR_PVDLEVEL_6              0x000000C0U
+#define PWR_PVDLEVEL_7              0x000000E0U
+
+void HAL_PWR_ConfigPVD(PWR_PVDTypeDef *config);
+void HAL_PWR_EnablePVD(void);
+void HAL_PWR_DisablePVD(void);
+
+typedef struct {
+  __IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR;
+} EXTI_TypeDef;
+
+extern EXTI_TypeDef board_check_exti;
+#define EXTI                        (&board_check_exti)
+#define PWR_EXTI_LINE_PVD           (1U << 16)
+#define __HAL_PWR_PVD_EXTI_GET_FLAG()   (EXTI->PR & PWR_EXTI_LINE_PVD)
+#define __HAL_PWR_PVD_EXTI_CLEAR_FLAG() (EXTI->PR = PWR_EXTI_LINE_PVD)
+
+typedef struct {
+  __IO uint32_t TR, DR, CR, ISR, PRER, WUTR, CALIBR, ALRMAR, ALRMBR, WPR, SSR, SHIFTR, TSTR;
+  __IO uint32_t TSDR, TSSSR, CALR, TAFCR, ALRMASSR, ALRMBSSR, RESERVED7;
+  __IO uint32_t BKP0R, BKP1R, BKP2R, BKP3R, BKP4R, BKP5R, BKP6R, BKP7R, BKP8R, BKP9R;
+  __IO uint32_t BKP10R, BKP11R, BKP12R, BKP13R, BKP14R, BKP15R, BKP16R, BKP17R, BKP18R, BKP19R;
+} RTC_TypeDef;
+
+extern RTC_TypeDef board_check_rtc;
+#define RTC                         (&board_check_rtc)
+
+// ============================================================================
+// FLASH (SECTORES)
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t ACR, KEYR, OPTKEYR, SR, CR, OPTCR;
+} FLASH_TypeDef;
+
+extern FLASH_TypeDef board_check_flash;
+#define FLASH                       (&board_check_flash)
+
+typedef struct {
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t Sector;
+  uint32_t NbSectors;
+  uint32_t VoltageRange;
+} FLASH_EraseInitTypeDef;
+
+#define FLASH_SR_EOP                (1U << 0)
+#define FLASH_SR_BSY                (1U << 16)
+#define FLASH_CR_PG                 (1U << 0)
+#define FLASH_CR_SER                (1U << 1)
+#define FLASH_CR_SNB_Pos            3U
+#define FLASH_CR_SNB                (0x1FU << FLASH_CR_SNB_Pos)
+#define FLASH_CR_PSIZE              (0x3U << 8)
+#define FLASH_CR_STRT               (1U << 16)
+#define FLASH_CR_LOCK               (1U << 31)
+#define FLASH_PSIZE_BYTE            0x00000000U
+#define FLASH_PSIZE_WORD            0x00000200U
+#define FLASH_ACR_ICEN              (1U << 9)
+#define FLASH_ACR_DCEN              (1U << 10)
+#define FLASH_ACR_ICRST             (1U << 11)
+#define FLASH_ACR_DCRST             (1U << 12)
+#define FLASH_FLAG_EOP              FLASH_SR_EOP
+#define FLASH_FLAG_OPERR            (1U << 1)
+#define FLASH_FLAG_WRPERR           (1U << 4)
+#define FLASH_FLAG_PGAERR           (1U << 5)
+#define FLASH_FLAG_PGPERR           (1U << 6)
+#define FLASH_FLAG_PGSERR           (1U << 7)
+#define FLASH_TYPEERASE_SECTORS     0x00000000U
+#define FLASH_VOLTAGE_RANGE_3       0x00000002U
+#define FLASH_TYPEPROGRAM_BYTE      0x00000000U
+#define FLASH_TYPEPROGRAM_HALFWORD  0x00000001U
+#define FLASH_TYPEPROGRAM_WORD      0x00000002U
+#define FLASH_SECTOR_0              0U
+#define FLASH_SECTOR_1              1U
+#define FLASH_SECTOR_2              2U
+#define FLASH_SECTOR_3              3U
+#define FLASH_SECTOR_4              4U
+
+#define __HAL_FLASH_CLEAR_FLAG(f)                 (FLASH->SR = (f))
+#define __HAL_FLASH_INSTRUCTION_CACHE_DISABLE()   (FLASH->ACR &= ~FLASH_ACR_ICEN)
+#define __HAL_FLASH_INSTRUCTION_CACHE_ENABLE()    (FLASH->ACR |= FLASH_ACR_ICEN)
+#define __HAL_FLASH_INSTRUCTION_CACHE_RESET()     do { FLASH->ACR |= FLASH_ACR_ICRST; FLASH->ACR &= ~FLASH_ACR_ICRST; } while (0)
+#define __HAL_FLASH_DATA_CACHE_DISABLE()          (FLASH->ACR &= ~FLASH_ACR_DCEN)
+#define __HAL_FLASH_DATA_CACHE_ENABLE()           (FLASH->ACR |= FLASH_ACR_DCEN)
+#define __HAL_FLASH_DATA_CACHE_RESET()            do { FLASH->ACR |= FLASH_ACR_DCRST; FLASH->ACR &= ~FLASH_ACR_DCRST; } while (0)
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *erase, uint32_t *sector_error);
+
+#endif // BOARD_CHECK_STM32F4XX_HAL_H
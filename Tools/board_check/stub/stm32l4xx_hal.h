@@ -0,0 +1,379 @@
+/**
+ * @file stm32l4xx_hal.h
+ * @brief HAL mínima de STM32L4 (L433RC) para revisar el firmware en la PC
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef BOARD_CHECK_STM32L4XX_HAL_H
+#define BOARD_CHECK_STM32L4XX_HAL_H
+
+#include "stm32_hal_common.h"
+
+// ============================================================================
+// INTERRUPCIONES (STM32L433xx)
+// ============================================================================
+
+#define PVD_PVM_IRQn                1
+#define RTC_Alarm_IRQn              41
+#define EXTI15_10_IRQn              40
+#define DMA1_Channel1_IRQn          11
+#define ADC1_IRQn                   18
+#define TIM1_BRK_TIM15_IRQn         24
+#define TIM1_UP_TIM16_IRQn          25
+#define TIM2_IRQn                   28
+#define I2C1_EV_IRQn                31
+#define I2C1_ER_IRQn                32
+#define USART1_IRQn                 37
+#define USART2_IRQn                 38
+#define TIM6_DAC_IRQn               54
+#define FPU_IRQn                    81
+
+// ============================================================================
+// PERIFÉRICOS
+// ============================================================================
+
+extern TIM_TypeDef board_check_tim[17];
+#define TIM1                        (&board_check_tim[1])
+#define TIM2                        (&board_check_tim[2])
+#define TIM6                        (&board_check_tim[6])
+#define TIM15                       (&board_check_tim[15])
+#define TIM16                       (&board_check_tim[16])
+
+extern ADC_TypeDef board_check_adc;
+#define ADC1                        (&board_check_adc)
+
+typedef struct {
+  __IO uint32_t CCR, CNDTR, CPAR, CMAR;
+} DMA_Channel_TypeDef;
+
+typedef struct {
+  __IO uint32_t ISR, IFCR;
+} DMA_TypeDef;
+
+extern DMA_TypeDef board_check_dma1;
+extern DMA_Channel_TypeDef board_check_dma1_channel[8];
+#define DMA1                        (&board_check_dma1)
+#define DMA1_Channel1               (&board_check_dma1_channel[1])
+
+#define DMA_ISR_GIF1                (1U << 0)
+#define DMA_ISR_TCIF1               (1U << 1)
+#define DMA_ISR_HTIF1               (1U << 2)
+#define DMA_ISR_TEIF1               (1U << 3)
+#define DMA_REQUEST_0               0x00000000U
+
+typedef struct {
+  __IO uint32_t CR1, CR2, CR3, BRR, GTPR, RTOR, RQR, ISR, ICR, RDR, TDR;
+} USART_TypeDef;
+
+extern USART_TypeDef board_check_usart[4];
+#define USART1                      (&board_check_usart[1])
+#define USART2                      (&board_check_usart[2])
+
+#define USART_ISR_ORE               (1U << 3)
+#define USART_ISR_IDLE              (1U << 4)
+#define USART_ISR_RXNE              (1U << 5)
+#define USART_ISR_TC                (1U << 6)
+#define USART_ISR_TXE               (1U << 7)
+#define USART_CR1_IDLEIE            (1U << 4)
+#define USART_CR1_RXNEIE            (1U << 5)
+#define USART_CR1_TCIE              (1U << 6)
+#define USART_CR1_TXEIE             (1U << 7)
+
+struct __UART_HandleTypeDef {
+  USART_TypeDef *Instance;
+  UART_InitTypeDef Init;
+  UART_AdvFeatureInitTypeDef AdvancedInit;
+  DMA_HandleTypeDef *hdmatx;
+  DMA_HandleTypeDef *hdmarx;
+};
+
+#define UART_ONE_BIT_SAMPLE_DISABLE 0x00000000U
+#define UART_ADVFEATURE_NO_INIT     0x00000000U
+#define UART_IT_IDLE                0x00000010U
+#define UART_IT_RXNE                0x00000020U
+#define UART_CLEAR_FEF              (1U << 1)
+#define UART_CLEAR_NEF              (1U << 2)
+#define UART_CLEAR_OREF             (1U << 3)
+#define UART_CLEAR_IDLEF            (1U << 4)
+#define __HAL_UART_ENABLE_IT(h, i)  ((h)->Instance->CR1 |= (i))
+#define __HAL_UART_DISABLE_IT(h, i) ((h)->Instance->CR1 &= ~(i))
+#define __HAL_UART_GET_FLAG(h, f)   (((h)->Instance->ISR & (f)) == (f))
+#define __HAL_UART_CLEAR_FLAG(h, f) ((h)->Instance->ICR = (f))
+
+typedef struct {
+  __IO uint32_t CR1, CR2, OAR1, OAR2, TIMINGR, TIMEOUTR, ISR, ICR, PECR, RXDR, TXDR;
+} I2C_TypeDef;
+
+#define I2C_CR1_TXIE                (1U << 1)
+#define I2C_CR1_RXIE                (1U << 2)
+#define I2C_CR1_ADDRIE              (1U << 3)
+#define I2C_CR1_NACKIE              (1U << 4)
+#define I2C_CR1_STOPIE              (1U << 5)
+#define I2C_CR1_TCIE                (1U << 6)
+#define I2C_CR1_ERRIE               (1U << 7)
+
+extern I2C_TypeDef board_check_i2c[4];
+#define I2C1                        (&board_check_i2c[1])
+
+struct __I2C_HandleTypeDef {
+  I2C_TypeDef *Instance;
+  I2C_InitTypeDef Init;
+  __IO uint32_t ErrorCode;
+};
+
+#define I2C_OA2_NOMASK              0x00000000U
+#define I2C_ANALOGFILTER_ENABLE     0x00000000U
+#define I2C_FLAG_BUSY               (1U << 15)
+#define __HAL_I2C_GET_FLAG(h, f)    (((h)->Instance->ISR & (f)) == (f))
+
+HAL_StatusTypeDef HAL_I2CEx_ConfigAnalogFilter(I2C_HandleTypeDef *hi2c, uint32_t filter);
+
+// ADC con sobremuestreo por hardware
+#define ADC_CHANNEL_1               0x04300002U
+#define ADC_CHANNEL_2               0x08600004U
+#define ADC_CHANNEL_3               0x0C900008U
+#define ADC_CHANNEL_4               0x10C00010U
+#define ADC_REGULAR_RANK_1          0x00000006U
+#define ADC_REGULAR_RANK_2          0x0000000CU
+#define ADC_REGULAR_RANK_3          0x00000012U
+#define ADC_REGULAR_RANK_4          0x00000018U
+#define ADC_CLOCK_ASYNC_DIV1        0x00000000U
+#define ADC_RESOLUTION_12B          0x00000000U
+#define ADC_SCAN_ENABLE             0x00000001U
+#define ADC_EOC_SINGLE_CONV         0x00000004U
+#define ADC_EOC_SEQ_CONV            0x00000008U
+#define ADC_OVR_DATA_OVERWRITTEN    0x00001000U
+#define ADC_OVERSAMPLING_RATIO_16   0x0000000CU
+#define ADC_RIGHTBITSHIFT_4         0x00000080U
+#define ADC_TRIGGEREDMODE_SINGLE_TRIGGER 0x00000000U
+#define ADC_REGOVERSAMPLING_CONTINUED_MODE 0x00000000U
+#define ADC_SAMPLETIME_47CYCLES_5   0x00000004U
+#define ADC_SAMPLETIME_247CYCLES_5  0x00000006U
+#define ADC_SINGLE_ENDED            0x0000007FU
+#define ADC_OFFSET_NONE             0x00000004U
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc, uint32_t single_diff);
+
+// Funciones alternativas de los pines
+#define GPIO_MODE_ANALOG_ADC_CONTROL 0x0000000BU
+#define GPIO_AF1_TIM1               0x01U
+#define GPIO_AF1_TIM2               0x01U
+#define GPIO_AF4_I2C1               0x04U
+#define GPIO_AF7_USART2             0x07U
+
+// ============================================================================
+// RCC Y PWR
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t CR, ICSCR, CFGR, PLLCFGR, PLLSAI1CFGR, RESERVED0, CIER, CIFR, CICR;
+  __IO uint32_t RESERVED1, AHB1RSTR, AHB2RSTR, AHB3RSTR, RESERVED2, APB1RSTR1, APB1RSTR2;
+  __IO uint32_t APB2RSTR, RESERVED3, AHB1ENR, AHB2ENR, AHB3ENR, RESERVED4, APB1ENR1;
+  __IO uint32_t APB1ENR2, APB2ENR, RESERVED5[9], CCIPR, RESERVED6, BDCR, CSR;
+} RCC_TypeDef;
+
+extern RCC_TypeDef board_check_rcc;
+#define RCC                         (&board_check_rcc)
+
+#define RCC_CFGR_PPRE1_Pos          8U
+#define RCC_CFGR_PPRE1              (0x7U << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos          11U
+#define RCC_CFGR_PPRE2              (0x7U << RCC_CFGR_PPRE2_Pos)
+#define RCC_CSR_RMVF                (1U << 23)
+#define RCC_CSR_OBLRSTF             (1U << 25)
+#define RCC_CSR_PINRSTF             (1U << 26)
+#define RCC_CSR_BORRSTF             (1U << 27)
+#define RCC_CSR_SFTRSTF             (1U << 28)
+#define RCC_CSR_IWDGRSTF            (1U << 29)
+#define RCC_CSR_WWDGRSTF            (1U << 30)
+#define RCC_CSR_LPWRRSTF            (1U << 31)
+
+typedef struct {
+  uint32_t PLLState;
+  uint32_t PLLSource;
+  uint32_t PLLM;
+  uint32_t PLLN;
+  uint32_t PLLP;
+  uint32_t PLLQ;
+  uint32_t PLLR;
+} RCC_PLLInitTypeDef;
+
+typedef struct {
+  uint32_t OscillatorType;
+  uint32_t HSEState;
+  uint32_t LSEState;
+  uint32_t HSIState;
+  uint32_t HSICalibrationValue;
+  uint32_t LSIState;
+  uint32_t MSIState;
+  uint32_t MSICalibrationValue;
+  uint32_t MSIClockRange;
+  uint32_t HSI48State;
+  RCC_PLLInitTypeDef PLL;
+} RCC_OscInitTypeDef;
+
+typedef struct {
+  uint32_t PLLSAI1Source;
+  uint32_t PLLSAI1M;
+  uint32_t PLLSAI1N;
+  uint32_t PLLSAI1P;
+  uint32_t PLLSAI1Q;
+  uint32_t PLLSAI1R;
+  uint32_t PLLSAI1ClockOut;
+} RCC_PLLSAI1InitTypeDef;
+
+typedef struct {
+  uint32_t PeriphClockSelection;
+  RCC_PLLSAI1InitTypeDef PLLSAI1;
+  uint32_t Usart2ClockSelection;
+  uint32_t I2c1ClockSelection;
+  uint32_t AdcClockSelection;
+} RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSI      0x00000002U
+#define RCC_HSI_ON                  0x00000100U
+#define RCC_HSICALIBRATION_DEFAULT  0x10U
+#define RCC_PLL_ON                  0x00000002U
+#define RCC_PLLSOURCE_HSI           0x00000002U
+#define RCC_PLLP_DIV7               0x00000007U
+#define RCC_PLLQ_DIV2               0x00000002U
+#define RCC_PLLR_DIV2               0x00000002U
+#define RCC_HCLK_DIV1               0x00000000U
+#define RCC_HCLK_DIV2               0x00000400U
+#define RCC_HCLK_DIV4               0x00000500U
+#define RCC_HCLK_DIV8               0x00000600U
+#define RCC_HCLK_DIV16              0x00000700U
+#define RCC_PERIPHCLK_USART2        0x00000002U
+#define RCC_PERIPHCLK_I2C1          0x00000040U
+#define RCC_PERIPHCLK_ADC           0x00004000U
+#define RCC_USART2CLKSOURCE_PCLK1   0x00000000U
+#define RCC_I2C1CLKSOURCE_PCLK1     0x00000000U
+#define RCC_ADCCLKSOURCE_PLLSAI1    0x10000000U
+#define RCC_PLLSAI1_ADC1CLK         0x01000000U
+#define FLASH_LATENCY_4             0x00000004U
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef *config);
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef *config);
+
+#define __HAL_RCC_PWR_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_GPIOH_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_ADC_CLK_ENABLE()     ((void)0)
+#define __HAL_RCC_ADC_CLK_DISABLE()    ((void)0)
+#define __HAL_RCC_I2C1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_I2C1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM1_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM1_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM2_CLK_ENABLE()    ((void)0)
+#define __HAL_RCC_TIM2_CLK_DISABLE()   ((void)0)
+#define __HAL_RCC_TIM15_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_TIM16_CLK_ENABLE()   ((void)0)
+#define __HAL_RCC_USART2_CLK_ENABLE()  ((void)0)
+#define __HAL_RCC_USART2_CLK_DISABLE() ((void)0)
+#define __HAL_RCC_RTC_ENABLE()         ((void)0)
+#define __HAL_RCC_RTCAPB_CLK_ENABLE()  ((void)0)
+
+#define PWR_REGULATOR_VOLTAGE_SCALE1 0x00000200U
+#define PWR_PVDLEVEL_0              0x00000000U
+#define PWR_PVDLEVEL_5              0x0000000AU
+#define PWR_PVDLEVEL_6              0x0000000CU
+
+HAL_StatusTypeDef HAL_PWREx_ControlVoltageScaling(uint32_t scale);
+HAL_StatusTypeDef HAL_PWR_ConfigPVD(PWR_PVDTypeDef *config);
+void HAL_PWR_EnablePVD(void);
+void HAL_PWR_DisablePVD(void);
+void HAL_PWREx_PVD_PVM_IRQHandler(void);
+
+typedef struct {
+  __IO uint32_t IMR1, EMR1, RTSR1, FTSR1, SWIER1, PR1, RESERVED1, RESERVED2;
+  __IO uint32_t IMR2, EMR2, RTSR2, FTSR2, SWIER2, PR2;
+} EXTI_TypeDef;
+
+extern EXTI_TypeDef board_check_exti;
+#define EXTI                        (&board_check_exti)
+#define PWR_EXTI_LINE_PVD           (1U << 16)
+#define __HAL_PWR_PVD_EXTI_GET_FLAG()   (EXTI->PR1 & PWR_EXTI_LINE_PVD)
+#define __HAL_PWR_PVD_EXTI_CLEAR_FLAG() (EXTI->PR1 = PWR_EXTI_LINE_PVD)
+void HAL_PWREx_PVD_Callback(void);
+
+typedef struct {
+  __IO uint32_t TR, DR, CR, ISR, PRER, WUTR, RESERVED, ALRMAR, ALRMBR, WPR, SSR, SHIFTR, TSTR;
+  __IO uint32_t TSDR, TSSSR, CALR, TAMPCR, ALRMASSR, ALRMBSSR, OR;
+  __IO uint32_t BKP0R, BKP1R, BKP2R, BKP3R, BKP4R, BKP5R, BKP6R, BKP7R, BKP8R, BKP9R;
+  __IO uint32_t BKP10R, BKP11R, BKP12R, BKP13R, BKP14R, BKP15R, BKP16R, BKP17R, BKP18R, BKP19R;
+  __IO uint32_t BKP20R, BKP21R, BKP22R, BKP23R, BKP24R, BKP25R, BKP26R, BKP27R, BKP28R, BKP29R;
+  __IO uint32_t BKP30R, BKP31R;
+} RTC_TypeDef;
+
+extern RTC_TypeDef board_check_rtc;
+#define RTC                         (&board_check_rtc)
+
+// ============================================================================
+// FLASH (PÁGINAS DE 2 KB)
+// ============================================================================
+
+typedef struct {
+  __IO uint32_t ACR, PDKEYR, KEYR, OPTKEYR, SR, CR, ECCR, RESERVED1, OPTR;
+  __IO uint32_t PCROP1SR, PCROP1ER, WRP1AR, WRP1BR;
+} FLASH_TypeDef;
+
+extern FLASH_TypeDef board_check_flash;
+#define FLASH                       (&board_check_flash)
+
+#define FLASH_PAGE_SIZE             0x00000800U
+#define FLASH_SR_EOP                (1U << 0)
+#define FLASH_SR_OPERR              (1U << 1)
+#define FLASH_SR_PROGERR            (1U << 3)
+#define FLASH_SR_WRPERR             (1U << 4)
+#define FLASH_SR_PGAERR             (1U << 5)
+#define FLASH_SR_SIZERR             (1U << 6)
+#define FLASH_SR_PGSERR             (1U << 7)
+#define FLASH_SR_MISERR             (1U << 8)
+#define FLASH_SR_FASTERR            (1U << 9)
+#define FLASH_SR_RDERR              (1U << 14)
+#define FLASH_SR_OPTVERR            (1U << 15)
+#define FLASH_SR_BSY                (1U << 16)
+#define FLASH_CR_PG                 (1U << 0)
+#define FLASH_CR_PER                (1U << 1)
+#define FLASH_CR_PNB_Pos            3U
+#define FLASH_CR_PNB                (0xFFU << FLASH_CR_PNB_Pos)
+#define FLASH_CR_STRT               (1U << 16)
+#define FLASH_CR_LOCK               (1U << 31)
+#define FLASH_ACR_ICEN              (1U << 9)
+#define FLASH_ACR_DCEN              (1U << 10)
+#define FLASH_ACR_ICRST             (1U << 11)
+#define FLASH_ACR_DCRST             (1U << 12)
+#define FLASH_ACR_SLEEP_PD          (1U << 14)
+#define FLASH_FLAG_ALL_ERRORS       (FLASH_SR_OPERR | FLASH_SR_PROGERR | FLASH_SR_WRPERR | \
+                                     FLASH_SR_PGAERR | FLASH_SR_SIZERR | FLASH_SR_PGSERR | \
+                                     FLASH_SR_MISERR | FLASH_SR_FASTERR | FLASH_SR_RDERR | \
+                                     FLASH_SR_OPTVERR)
+#define FLASH_TYPEERASE_PAGES       0x00000000U
+#define FLASH_BANK_1                0x00000001U
+#define FLASH_TYPEPROGRAM_DOUBLEWORD 0x00000000U
+
+typedef struct {
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t Page;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+#define __HAL_FLASH_CLEAR_FLAG(f)                 (FLASH->SR = (f))
+#define __HAL_FLASH_INSTRUCTION_CACHE_DISABLE()   (FLASH->ACR &= ~FLASH_ACR_ICEN)
+#define __HAL_FLASH_INSTRUCTION_CACHE_ENABLE()    (FLASH->ACR |= FLASH_ACR_ICEN)
+#define __HAL_FLASH_INSTRUCTION_CACHE_RESET()     do { FLASH->ACR |= FLASH_ACR_ICRST; FLASH->ACR &= ~FLASH_ACR_ICRST; } while (0)
+#define __HAL_FLASH_DATA_CACHE_DISABLE()          (FLASH->ACR &= ~FLASH_ACR_DCEN)
+#define __HAL_FLASH_DATA_CACHE_ENABLE()           (FLASH->ACR |= FLASH_ACR_DCEN)
+#define __HAL_FLASH_DATA_CACHE_RESET()            do { FLASH->ACR |= FLASH_ACR_DCRST; FLASH->ACR &= ~FLASH_ACR_DCRST; } while (0)
+#define __HAL_FLASH_SLEEP_POWERDOWN_ENABLE()      (FLASH->ACR |= FLASH_ACR_SLEEP_PD)
+#define __HAL_FLASH_SLEEP_POWERDOWN_DISABLE()     (FLASH->ACR &= ~FLASH_ACR_SLEEP_PD)
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *erase, uint32_t *page_error);
+
+#endif // BOARD_CHECK_STM32L4XX_HAL_H
@@ -0,0 +1,145 @@
+/**
+ * @file fmt_check.c
+ * @brief Compara fmt_snprintf con el snprintf de la libc
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Compila Core/Src/fmt.c tal cual y formatea los mismos casos que usa el
+ * firmware con las dos implementaciones: el texto tiene que ser idéntico,
+ * incluido el largo devuelto cuando el buffer no alcanza. Al final mide
+ * cuánto tarda cada una con una línea típica del log.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "fmt.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// fmt_printf escribe por _write, igual que en la placa
+int _write(int file, char *ptr, int len) {
+  return (int)write(file, ptr, (size_t)len);
+}
+
+// ============================================================================
+// CASOS
+// ============================================================================
+
+static unsigned failures = 0;
+static unsigned cases = 0;
+
+#define CHECK_SIZED(size, ...) do {                                         \
+    char expected[96], actual[96];                                          \
+    memset(actual, '#', sizeof(actual));                                    \
+    int expected_len = snprintf(expected, (size), __VA_ARGS__);             \
+    int actual_len = fmt_snprintf(actual, (size), __VA_ARGS__);             \
+    cases++;                                                                \
+    if (expected_len != actual_len || strcmp(expected, actual) != 0) {      \
+      failures++;                                                           \
+      printf("  %-28s libc \"%s\" (%d) | fmt \"%s\" (%d)\n",               \
+             #__VA_ARGS__, expected, expected_len, actual, actual_len);     \
+    }                                                                       \
+  } while (0)
+
+#define CHECK(...) CHECK_SIZED(sizeof(expected), __VA_ARGS__)
+
+static void check_integers(void) {
+  CHECK("Total: %lu", 4294967295UL);
+  CHECK("%6lu|%-8lu|", 42UL, 7UL);
+  CHECK("%d %d %d", 0, -1, -2147483647 - 1);
+  CHECK("%3d|%-3d|%03d", 5, -5, -5);
+  CHECK("%+d % d %+d", 12, 12, -12);
+  CHECK("%u", 3000000000U);
+  CHECK("%02X %02x %X", 0x0A, 0xFF, 0xDEADBEEF);
+  CHECK("%08lX", 0x1234UL);
+  CHECK("%.3d|%5.3d|%.0d|", 7, -7, 0);
+  CHECK("%lld %llu", -9000000000LL, 18446744073709551615ULL);
+  CHECK("%hu %hhd", 65535, 200);
+  CHECK("%zu", (size_t)1234);
+  CHECK("%*d|%-*d|", 5, 42, 5, 42);
+}
+
+static void check_fixed(void) {
+  CHECK("%.1f%%", 87.5);
+  CHECK("%.0f%%", 92.49);
+  CHECK("%.0f", 2.5);
+  CHECK("%5.1f cm", 3.25);
+  CHECK("%.1f cm", 142.04);
+  CHECK("%+5.2f|%-8.1f|", -0.5, 12.34);
+  CHECK("%08.3f", -3.14159);
+  CHECK("%f", 1.0 / 3.0);
+  CHECK("%.2f", 0.995);
+  CHECK("%.3f", 1000000.0005);
+  CHECK("M:%.0f P:%.0f", 12.0, 99.6);
+  CHECK("%.9f", 0.123456789);
+  CHECK("%.1f", -0.04);
+  CHECK("%.3f|%f|%.9f", 1e-300, -0.0, 4.9e-324);
+  CHECK("%.1f|%.0f", 4294967295.04, 4294967294.5);
+  CHECK("%5.1f|%-6f|%05.1f", __builtin_inf(), -__builtin_inf(), __builtin_nan(""));
+}
+
+static void check_text(void) {
+  CHECK("%s", "Plástico");
+  CHECK("%-15s|", "Vidrio");
+  CHECK("%10s|", "Papel");
+  CHECK("%.*s|", 4, "Metales");
+  CHECK("%-8s %s", "prof", "Tiempos de loop, guardado y colas");
+  CHECK("%c%c%-3c|", 'O', 'K', '!');
+  CHECK("100%% %s", "");
+  
+  // Buffer chico: se corta, termina en '\0' y devuelve el largo completo
+  CHECK_SIZED(8, "Total: %lu", 123456UL);
+  CHECK_SIZED(1, "%s", "nada");
+  CHECK_SIZED(17, "Conf: %.0f%% %s", 87.0, "(promedio)");
+}
+
+// ============================================================================
+// TIEMPOS
+// ============================================================================
+
+#define BENCH_LINES 1000000
+
+static double bench_ns(int use_fmt) {
+  char line[96];
+  volatile unsigned sink = 0;
+  struct timespec t0, t1;
+  
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (unsigned i = 0; i < BENCH_LINES; i++) {
+    float confidence = 50.0f + (float)(i % 500) / 10.0f;
+    if (use_fmt) {
+      sink += (unsigned)fmt_snprintf(line, sizeof(line), "✓ Material identificado: %s (%.1f%% confianza) #%lu",
+                                     "Plástico", confidence, (unsigned long)i);
+    } else {
+      sink += (unsigned)snprintf(line, sizeof(line), "✓ Material identificado: %s (%.1f%% confianza) #%lu",
+                                 "Plástico", confidence, (unsigned long)i);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  (void)sink;
+  
+  double ns = (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+  return ns / BENCH_LINES;
+}
+
+// ============================================================================
+// PRINCIPAL
+// ============================================================================
+
+int main(void) {
+  check_integers();
+  check_fixed();
+  check_text();
+  printf("Casos: %u | diferencias con la libc: %u\n", cases, failures);
+  
+  double libc_ns = bench_ns(0);
+  double fmt_ns = bench_ns(1);
+  printf("Línea de log: libc %.0f ns | fmt %.0f ns (%.2fx)\n", libc_ns, fmt_ns, libc_ns / fmt_ns);
+  
+  fmt_printf("fmt_printf: %s %5.1f %08lX\n", "ok", 3.25, 0xBEEFUL);
+  
+  printf("%s\n", failures == 0 ? "OK" : "FALLÓ");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,507 @@
+/**
+ * @file host_board.c
+ * @brief Prueba de la Flash de datos sobre la placa de PC (BOARD_HOST)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Compila Core/Src/flash_store.c y Core/Src/event_log.c tal cual con
+ * board_host.c, que simula la Flash con las reglas de la placa (unidad de
+ * programación alineada, cada unidad una sola vez entre borrados). Escribe
+ * registros y clasificaciones, simula reinicios y un corte a mitad de un
+ * registro o de un agregado, y verifica que todo se recupere igual. El volcado del registro
+ * se rearma desde lo que pasó por la cola de transmisión simulada.
+ */
+
+#include "board.h"
+#include "actuators.h"
+#include "classifier.h"
+#include "event_log.h"
+#include "flash_store.h"
+#include "telemetry.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// ============================================================================
+// ENTORNO SIMULADO
+// ============================================================================
+
+static uint32_t sim_ms = 0;
+static uint32_t failures = 0;
+
+uint32_t HAL_GetTick(void) {
+  return sim_ms;
+}
+
+void HAL_Delay(uint32_t ms) {
+  sim_ms += ms;
+}
+
+// event_log.c sólo consulta el fin de la secuencia de depósito
+bool actuators_is_busy(void) {
+  return false;
+}
+
+MotionStats actuators_get_motion_stats(void) {
+  MotionStats stats = {0};
+  stats.last_script_ms = 2400;
+  return stats;
+}
+
+const char* classifier_get_material_description(MaterialType material) {
+  static const char *names[] = { "Ninguno", "Metal", "Papel", "Plastico", "Vidrio" };
+  return (material <= MATERIAL_VIDRIO) ? names[material] : "Desconocido";
+}
+
+// fmt.c escribe la consola por _write, igual que en la placa
+int _write(int file, char *ptr, int len) {
+  return (int)write(file, ptr, (size_t)len);
+}
+
+// Cola de transmisión: se vacía entera entre iteraciones del loop
+// (tx_drain()) y lo que pasa por ella queda en tx_capture
+#define SIM_TX_BUFFER  512
+#define SIM_TX_CAPTURE 0x80000
+
+static uint16_t tx_used = 0;
+static uint8_t tx_capture[SIM_TX_CAPTURE];
+static uint32_t tx_captured = 0;
+
+uint16_t telemetry_tx_free(void) {
+  return (uint16_t)(SIM_TX_BUFFER - 1 - tx_used);
+}
+
+bool telemetry_write(const uint8_t *data, uint16_t len) {
+  if (len > telemetry_tx_free() || tx_captured + len > SIM_TX_CAPTURE) return false;
+  
+  memcpy(&tx_capture[tx_captured], data, len);
+  tx_captured += len;
+  tx_used += len;
+  return true;
+}
+
+static void tx_drain(void) {
+  tx_used = 0;
+}
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("FALLA: %s\n", what);
+    failures++;
+  }
+}
+
+// Un reinicio: vuelve la alimentación y los módulos leen todo desde la Flash
+static void reboot(void) {
+  board_host_power_restore();
+  flash_store_init();
+  event_log_init();
+}
+
+// ============================================================================
+// REGISTROS PERSISTENTES
+// ============================================================================
+
+// Tamaños que no son múltiplo de la unidad de programación
+typedef struct {
+  uint32_t total;
+  uint16_t per_material[4];
+  uint8_t tail[5];
+} SimStats;
+
+static void fill_stats(SimStats *stats, uint32_t seed) {
+  memset(stats, 0, sizeof(*stats));
+  stats->total = seed;
+  for (uint8_t i = 0; i < 4; i++) stats->per_material[i] = (uint16_t)(seed * (i + 3));
+  for (uint8_t i = 0; i < sizeof(stats->tail); i++) stats->tail[i] = (uint8_t)(seed + i);
+}
+
+static void test_records(void) {
+  SimStats stats;
+  uint8_t params[7];
+  
+  // Varias vueltas A/B con dos registros de largo distinto
+  for (uint32_t round = 1; round <= 9; round++) {
+    fill_stats(&stats, round);
+    check(flash_store_write_record(FLASH_RECORD_STATS, 2, &stats, sizeof(stats)), "escribir estadísticas");
+    
+    for (uint8_t i = 0; i < sizeof(params); i++) params[i] = (uint8_t)(round * 11 + i);
+    check(flash_store_write_record(FLASH_RECORD_PARAMS, 1, params, (uint16_t)(round % sizeof(params) + 1)),
+          "escribir parámetros");
+          
+    if (round % 3 == 0) flash_store_prepare();  // A veces la reserva ya está borrada
+  }
+  
+  reboot();
+  
+  SimStats read;
+  fill_stats(&stats, 9);
+  check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+        memcmp(&read, &stats, sizeof(stats)) == 0, "estadísticas tras reinicio");
+        
+  uint8_t read_params[sizeof(params)];
+  uint16_t len = 0;
+  check(flash_store_read_record_var(FLASH_RECORD_PARAMS, 1, read_params, sizeof(read_params), &len) &&
+        len == 9 % sizeof(params) + 1 && memcmp(read_params, params, len) == 0, "parámetros tras reinicio");
+        
+  check(!flash_store_read_record(FLASH_RECORD_STATS, 3, &read, sizeof(read)), "versión vieja descartada");
+}
+
+// Corte antes de cada unidad de una imagen A/B, del encabezado a la marca
+// de commit: al arrancar se carga la imagen previa completa
+static void test_torn_image(void) {
+  SimStats stats;
+  SimStats read;
+  uint8_t params[3] = { 0x5A, 0xA5, 0x3C };
+  
+  fill_stats(&stats, 100);
+  check(flash_store_write_record(FLASH_RECORD_STATS, 2, &stats, sizeof(stats)) &&
+        flash_store_write_record(FLASH_RECORD_PARAMS, 1, params, sizeof(params)), "imagen previa");
+  
+  uint32_t units = 0;
+  for (;; units++) {
+    SimStats torn;
+    fill_stats(&torn, 200 + units);
+    board_host_flash_cut_after(units);
+    bool written = flash_store_write_record(FLASH_RECORD_STATS, 2, &torn, sizeof(torn));
+    reboot();
+    
+    if (written) {
+      // Sin corte antes del commit la imagen nueva queda activa
+      check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+            memcmp(&read, &torn, sizeof(torn)) == 0, "imagen nueva tras completar la escritura");
+      break;
+    }
+    
+    check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+          memcmp(&read, &stats, sizeof(stats)) == 0, "imagen previa tras un corte antes del commit");
+          
+    uint8_t read_params[sizeof(params)];
+    uint16_t len = 0;
+    check(flash_store_read_record_var(FLASH_RECORD_PARAMS, 1, read_params, sizeof(read_params), &len) &&
+          len == sizeof(params) && memcmp(read_params, params, len) == 0,
+          "registros sin cambios tras un corte antes del commit");
+  }
+  
+  // Los cortes también caen a mitad de los registros, del CRC y del commit
+  check(units > (sizeof(stats) + sizeof(params)) / BOARD_FLASH_WRITE_UNIT, "un corte en cada unidad de la imagen");
+  printf("Imagen A/B: %lu cortes antes del commit, todos cargan la imagen previa\n", (unsigned long)units);
+}
+
+// Imagen con commit pero dañada después (un bit de la Flash): el CRC de la
+// candidata falla y se carga la otra página
+static void test_corrupt_image(void) {
+  SimStats stats;
+  SimStats newest;
+  SimStats read;
+  
+  fill_stats(&stats, 300);
+  fill_stats(&newest, 301);
+  check(flash_store_write_record(FLASH_RECORD_STATS, 2, &stats, sizeof(stats)) &&
+        flash_store_write_record(FLASH_RECORD_STATS, 2, &newest, sizeof(newest)), "imágenes A y B");
+  
+  // Dañar el registro de la imagen más nueva, esté en A o en B
+  bool damaged = false;
+  const uint32_t pages[2] = { FLASH_PAGE_A_ADDR, FLASH_PAGE_B_ADDR };
+  for (uint8_t p = 0; p < 2 && !damaged; p++) {
+    uint8_t *page = (uint8_t *)(uintptr_t)pages[p];
+    for (uint32_t offset = 0; offset + sizeof(newest) <= 256 && !damaged; offset += 4) {
+      if (memcmp(&page[offset], &newest, sizeof(newest)) == 0) {
+        page[offset] ^= 0x01;
+        damaged = true;
+      }
+    }
+  }
+  check(damaged, "registro de la imagen nueva encontrado");
+  
+  reboot();
+  check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+        memcmp(&read, &stats, sizeof(stats)) == 0, "imagen anterior tras un CRC inválido");
+  
+  // La siguiente escritura pisa la página dañada
+  check(flash_store_write_record(FLASH_RECORD_STATS, 2, &newest, sizeof(newest)), "escribir tras el CRC inválido");
+  reboot();
+  check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+        memcmp(&read, &newest, sizeof(newest)) == 0, "imagen nueva tras reescribir");
+}
+
+// Registros agregados detrás de la imagen (guardado del aviso PVD): un corte
+// antes de cada unidad deja el último agregado completo y la imagen intacta,
+// y lo que se agregue después no programa encima de lo cortado
+static void test_appended_records(void) {
+  SimStats stats;
+  SimStats counters;
+  SimStats read;
+  
+  fill_stats(&stats, 400);
+  fill_stats(&counters, 401);
+  
+  uint32_t units = 0;
+  for (;; units++) {
+    check(flash_store_write_record(FLASH_RECORD_STATS, 2, &stats, sizeof(stats)) &&
+          flash_store_append_record(FLASH_RECORD_STATS_COUNTERS, 1, &counters, sizeof(counters)),
+          "imagen y registro agregado");
+    
+    SimStats torn;
+    fill_stats(&torn, 500 + units);
+    board_host_flash_cut_after(units);
+    bool written = flash_store_append_record(FLASH_RECORD_STATS_COUNTERS, 1, &torn, sizeof(torn));
+    reboot();
+    
+    check(flash_store_read_record(FLASH_RECORD_STATS, 2, &read, sizeof(read)) &&
+          memcmp(&read, &stats, sizeof(stats)) == 0, "imagen intacta tras agregar");
+    
+    if (written) {
+      check(flash_store_read_appended(FLASH_RECORD_STATS_COUNTERS, 1, &read, sizeof(read)) &&
+            memcmp(&read, &torn, sizeof(torn)) == 0, "agregado nuevo tras completar la escritura");
+      break;
+    }
+    
+    check(flash_store_read_appended(FLASH_RECORD_STATS_COUNTERS, 1, &read, sizeof(read)) &&
+          memcmp(&read, &counters, sizeof(counters)) == 0, "agregado anterior tras un corte antes del commit");
+    
+    // Después de un corte: o hay lugar libre o no se agrega más
+    SimStats next;
+    fill_stats(&next, 600 + units);
+    if (flash_store_append_record(FLASH_RECORD_STATS_COUNTERS, 1, &next, sizeof(next))) {
+      reboot();
+      check(flash_store_read_appended(FLASH_RECORD_STATS_COUNTERS, 1, &read, sizeof(read)) &&
+            memcmp(&read, &next, sizeof(next)) == 0, "agregado después de un corte");
+    }
+  }
+  
+  check(units > sizeof(counters) / BOARD_FLASH_WRITE_UNIT, "un corte en cada unidad del agregado");
+  
+  // La imagen siguiente deja atrás lo agregado
+  check(flash_store_write_record(FLASH_RECORD_STATS, 2, &stats, sizeof(stats)), "imagen después de agregar");
+  reboot();
+  check(!flash_store_read_appended(FLASH_RECORD_STATS_COUNTERS, 1, &read, sizeof(read)),
+        "la imagen nueva descarta lo agregado");
+  printf("Agregados: %lu cortes antes del commit, todos cargan el agregado previo\n", (unsigned long)units);
+}
+
+// ============================================================================
+// REGISTRO DE EVENTOS
+// ============================================================================
+
+// idle: el loop pasa por reposo entre clasificaciones (event_log_prepare)
+static void log_events(uint32_t count, bool idle) {
+  for (uint32_t i = 0; i < count; i++) {
+    ClassificationResult result = {0};
+    result.material = (MaterialType)(1 + i % 4);
+    result.isValid = (i % 5) != 0;
+    result.confidence = (float)(60 + i % 41);
+    
+    SensorDigitalData digital = { i % 2 == 0, i % 3 == 0, true };
+    SensorAnalogData analog = { (uint16_t)(i * 37 % 4096), (uint16_t)(i * 91 % 4096), 0, 0 };
+    
+    sim_ms += 700 + (i % 13) * 450;
+    event_log_classification(&result, digital, analog, (i % 4) == 0);
+    event_log_update();
+    if (idle) event_log_prepare();
+  }
+}
+
+// El primer byte borrado al final del primer segmento (empieza en uso)
+static uint32_t log_end(void) {
+  uint32_t address = EVENT_LOG_ADDR + 8;
+  
+  while (address < EVENT_LOG_ADDR + EVENT_LOG_SIZE / EVENT_LOG_SEGMENTS) {
+    const uint8_t *unit = (const uint8_t *)(uintptr_t)address;
+    bool blank = true;
+    for (uint32_t i = 0; i < BOARD_FLASH_WRITE_UNIT; i++) {
+      if (unit[i] != 0xFF) blank = false;
+    }
+    if (blank) return address;
+    address += BOARD_FLASH_WRITE_UNIT;
+  }
+  
+  return address;
+}
+
+static void test_event_log(void) {
+  log_events(300, true);
+  uint32_t before = event_log_get_count();
+  
+  reboot();
+  check(event_log_get_count() == before, "clasificaciones tras reinicio");
+  
+  // Corte a mitad de un registro: el cuerpo quedó escrito y el encabezado no
+  const uint8_t body[] = { 0x07, 0x55, 0x12, 0x04, 0x21, 0x33, 0x02, 0x01, 0x09 };
+  check(board_flash_program(log_end() + BOARD_FLASH_WRITE_UNIT, body, sizeof(body)), "simular corte");
+  
+  reboot();
+  check(event_log_get_count() == before, "registro cortado descartado");
+  
+  log_events(25, true);
+  reboot();
+  check(event_log_get_count() == before + 25, "registro sigue después del salto");
+  
+  // Llenar el registro sin pasar por reposo: clasificar nunca borra, lo que
+  // no entra se pierde (sólo se avanza a un segmento que ya estaba borrado)
+  log_events(6000, false);
+  uint32_t full = event_log_get_count();
+  check(full < before + 6025, "el registro se llenó");
+  log_events(10, false);
+  check(event_log_get_count() == full, "sin borrado al clasificar");
+  
+  // En reposo se borra el segmento más viejo (con uno solo, el mismo)
+  event_log_prepare();
+  uint32_t kept = event_log_get_count();
+  log_events(25, true);
+  check(event_log_get_count() == kept + 25, "el registro sigue después del borrado en reposo");
+  if (EVENT_LOG_SEGMENTS > 1) {
+    check(kept > 0, "el segmento anterior sigue legible");
+  } else {
+    check(kept == 0, "el sector se borró en reposo");
+  }
+  
+  before = event_log_get_count();
+  reboot();
+  check(event_log_get_count() == before, "clasificaciones tras cambiar de segmento");
+  
+  // Varias vueltas con reposo entre clasificaciones: no se pierde ninguna
+  log_events(20000, true);
+  before = event_log_get_count();
+  reboot();
+  check(event_log_get_count() == before, "clasificaciones tras varias vueltas");
+  if (EVENT_LOG_SEGMENTS > 1) {
+    check(before > kept, "el segmento anterior sigue legible tras varias vueltas");
+  }
+}
+
+// ============================================================================
+// VOLCADO DEL REGISTRO
+// ============================================================================
+
+// Corre el loop hasta que termina el volcado; devuelve las iteraciones
+static uint32_t dump_run(void) {
+  uint32_t loops = 0;
+  
+  tx_captured = 0;
+  while (event_log_is_dumping() && loops < 100000) {
+    tx_drain();
+    event_log_update();
+    loops++;
+  }
+  
+  return loops;
+}
+
+// Lee una línea de texto de la captura; NULL al final
+static const char *dump_line(uint32_t *pos, char *line, uint32_t size) {
+  uint32_t n = 0;
+  
+  if (*pos >= tx_captured) return NULL;
+  while (*pos < tx_captured && tx_capture[*pos] != '\n') {
+    if (n + 1 < size && tx_capture[*pos] != '\r') line[n++] = (char)tx_capture[*pos];
+    (*pos)++;
+  }
+  (*pos)++;
+  line[n] = '\0';
+  return line;
+}
+
+// Rearma cada segmento del volcado crudo y lo compara con la Flash
+static uint8_t dump_check_raw(void) {
+  static uint8_t segment[EVENT_LOG_SIZE];
+  uint32_t pos = 0;
+  uint32_t length = 0;
+  uint8_t blocks = 0;
+  char line[80];
+  
+  while (dump_line(&pos, line, sizeof(line)) != NULL) {
+    unsigned long a, b;
+    
+    if (sscanf(line, "EVLOG DATA %lu %lu", &a, &b) == 2) {
+      check(a + b <= length && pos + b <= tx_captured, "bloque dentro del segmento");
+      if (a + b > length || pos + b > tx_captured) return blocks;
+      memcpy(&segment[a], &tx_capture[pos], b);
+      pos += b;
+    } else if (sscanf(line, "EVLOG END %lx", &a) == 1) {
+      check(a == flash_store_crc32(segment, length), "CRC del segmento volcado");
+      
+      bool found = false;
+      for (uint8_t i = 0; i < EVENT_LOG_SEGMENTS; i++) {
+        const uint8_t *flash = (const uint8_t *)(uintptr_t)(EVENT_LOG_ADDR + i * (EVENT_LOG_SIZE / EVENT_LOG_SEGMENTS));
+        if (memcmp(flash, segment, length) == 0) found = true;
+      }
+      check(found, "segmento volcado igual a la Flash");
+      blocks++;
+    } else if (sscanf(line, "EVLOG %lu", &a) == 1) {
+      check(a <= EVENT_LOG_SIZE / EVENT_LOG_SEGMENTS, "largo del segmento");
+      length = (a <= EVENT_LOG_SIZE / EVENT_LOG_SEGMENTS) ? a : 0;
+      memset(segment, 0xFF, length);
+    }
+  }
+  
+  return blocks;
+}
+
+static void test_event_log_dump(void) {
+  uint32_t count = event_log_get_count();
+  
+  // Crudo: los segmentos legibles en bloques por la cola, sin bloquear
+  check(event_log_dump(), "empezar volcado crudo");
+  check(!event_log_dump() && !event_log_print(), "un solo volcado a la vez");
+  check(!event_log_prepare(), "sin borrar durante el volcado");
+  uint32_t loops = dump_run();
+  check(!event_log_is_dumping(), "el volcado crudo termina");
+  check(loops > tx_captured / SIM_TX_BUFFER, "el volcado avanza de a una cola por iteración");
+  
+  uint8_t blocks = dump_check_raw();
+  check(blocks > 0 && blocks <= EVENT_LOG_SEGMENTS, "segmentos volcados");
+  
+  // CSV: una línea por clasificación, más encabezado y resumen
+  check(event_log_print(), "empezar volcado CSV");
+  dump_run();
+  
+  uint32_t pos = 0;
+  uint32_t lines = 0;
+  bool summary = false;
+  bool columns = true;
+  char line[160];
+  while (dump_line(&pos, line, sizeof(line)) != NULL) {
+    if (line[0] == '#') {
+      summary = (strtoul(&line[2], NULL, 10) == count);
+    } else if (strncmp(line, "sesion,", 7) != 0) {
+      uint8_t commas = 0;
+      for (const char *c = line; *c != '\0'; c++) commas += (*c == ',');
+      columns &= (commas == 10);
+      lines++;
+    }
+  }
+  check(lines == count, "una línea CSV por clasificación");
+  check(columns, "11 columnas por línea CSV");
+  check(summary, "resumen del CSV");
+  
+  // Con el volcado terminado, el reposo vuelve a preparar el siguiente segmento
+  log_events(3000, true);
+  check(event_log_get_count() > 0, "el registro sigue después del volcado");
+}
+
+// ============================================================================
+// PRINCIPAL
+// ============================================================================
+
+int main(void) {
+  board_init();
+  printf("Placa %s | unidad de programación %u bytes | %u segmentos de registro\n",
+         board_name(), BOARD_FLASH_WRITE_UNIT, EVENT_LOG_SEGMENTS);
+  
+  reboot();
+  test_records();
+  test_torn_image();
+  test_corrupt_image();
+  test_appended_records();
+  test_event_log();
+  test_event_log_dump();
+  
+  check(board_host_flash_violations() == 0, "programaciones no alineadas o sin borrar");
+  
+  printf("Violaciones de Flash: %lu | fallas: %lu\n",
+         (unsigned long)board_host_flash_violations(), (unsigned long)failures);
+  printf("%s\n", failures == 0 ? "OK" : "FALLA");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+/**
+ * @file main.h
+ * @brief Reemplazo de main.h para el simulador
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef SIM_MAIN_H
+#define SIM_MAIN_H
+
+#include "stm32f4xx_hal.h"
+
+void Error_Handler(void);
+
+#endif // SIM_MAIN_H
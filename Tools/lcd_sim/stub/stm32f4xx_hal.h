@@ -0,0 +1,94 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief HAL mínima para compilar lcd.c e i2c_bus.c en la PC (simulador)
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef SIM_STM32F4XX_HAL_H
+#define SIM_STM32F4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR = 1,
+  HAL_BUSY = 2,
+  HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+// Sólo se usan por puntero o como extern en config.h
+typedef struct { int unused; } ADC_HandleTypeDef;
+typedef struct { int unused; } TIM_HandleTypeDef;
+typedef struct { int unused; } UART_HandleTypeDef;
+
+typedef struct {
+  uint32_t ClockSpeed;
+  uint32_t DutyCycle;
+} I2C_InitTypeDef;
+
+typedef struct {
+  I2C_InitTypeDef Init;
+  uint32_t ErrorCode;
+} I2C_HandleTypeDef;
+
+#define I2C_DUTYCYCLE_2         0u
+#define I2C_FIRST_FRAME         0x01u
+#define I2C_LAST_FRAME          0x20u
+#define HAL_I2C_ERROR_AF        0x04u
+#define I2C_FLAG_BUSY           0x00100002u
+#define __HAL_I2C_GET_FLAG(h, flag) sim_i2c_busy_flag()
+
+typedef struct { int unused; } GPIO_TypeDef;
+
+typedef struct {
+  uint32_t Pin;
+  uint32_t Mode;
+  uint32_t Pull;
+  uint32_t Speed;
+} GPIO_InitTypeDef;
+
+typedef enum {
+  GPIO_PIN_RESET = 0,
+  GPIO_PIN_SET = 1
+} GPIO_PinState;
+
+extern GPIO_TypeDef sim_gpiob;
+#define GPIOB                   (&sim_gpiob)
+#define GPIO_PIN_6              0x0040u
+#define GPIO_PIN_9              0x0200u
+#define GPIO_MODE_OUTPUT_OD     0x11u
+#define GPIO_NOPULL             0u
+#define GPIO_SPEED_FREQ_HIGH    2u
+
+extern uint32_t SystemCoreClock;
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t ms);
+
+void HAL_GPIO_Init(GPIO_TypeDef *port, GPIO_InitTypeDef *init);
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+
+int sim_i2c_busy_flag(void);
+HAL_StatusTypeDef HAL_I2C_Init(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_DeInit(I2C_HandleTypeDef *hi2c);
+uint32_t HAL_I2C_GetError(I2C_HandleTypeDef *hi2c);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t address,
+                                          uint8_t *data, uint16_t len, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t address,
+                                             uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Master_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t address,
+                                            uint8_t *data, uint16_t len);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Transmit_IT(I2C_HandleTypeDef *hi2c, uint16_t address,
+                                                 uint8_t *data, uint16_t len, uint32_t options);
+HAL_StatusTypeDef HAL_I2C_Master_Seq_Receive_IT(I2C_HandleTypeDef *hi2c, uint16_t address,
+                                                uint8_t *data, uint16_t len, uint32_t options);
+
+// Sin interrupciones reales: las secciones críticas no hacen nada
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __disable_irq(void) {}
+static inline void __set_PRIMASK(uint32_t primask) { (void)primask; }
+
+#endif // SIM_STM32F4XX_HAL_H
@@ -0,0 +1,356 @@
+/**
+ * @file ram_map.cpp
+ * @brief Mapa de RAM por módulo a partir del .map del enlazador
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Uso:
+ *   ram_map [-v] MAPA
+ *
+ * Suma las secciones de entrada de .data, .bss y COMMON que caen en una
+ * región de RAM y las agrupa por objeto (main.o, telemetry.o...) o por
+ * biblioteca (libc_nano.a). El heap y la pila se toman de _Min_Heap_Size y
+ * _Min_Stack_Size. Con -v lista además cada buffer de cada módulo.
+ *
+ * El firmware no tiene heap (HEAP_FREE_BUILD): si el enlazador incluyó un
+ * miembro de la libc que reserva memoria dinámica, lo informa junto con
+ * quién lo pidió y termina con código 2. Así una llamada que en la placa
+ * caería en la trampa de sysmem.c se detecta al compilar.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+// Miembros de newlib que llaman a _malloc_r/_calloc_r (directamente o al
+// crear su estado): el allocator, stdio con buffer y los enteros grandes
+// de strtod/dtoa
+static const char *const kAllocatingMembers[] = {
+  "malloc", "calloc", "realloc", "freer", "sbrk", "mprec", "makebuf", "findfp",
+};
+
+// ============================================================================
+// MODELO
+// ============================================================================
+
+struct Region {
+  std::string name;
+  uint64_t origin = 0;
+  uint64_t length = 0;
+};
+
+struct Buffer {
+  std::string name;          // Sección de entrada (.bss.tx_buffer)
+  uint64_t size = 0;
+};
+
+struct Module {
+  uint64_t data = 0;
+  uint64_t bss = 0;
+  std::vector<Buffer> buffers;
+  uint64_t total() const { return data + bss; }
+};
+
+struct Inclusion {
+  std::string member;        // libc_nano.a(lib_a-mprec.o)
+  std::string reason;        // params.o (_Balloc)
+};
+
+struct RamMap {
+  std::vector<Region> regions;
+  std::map<std::string, Module> modules;
+  std::vector<Inclusion> allocators;
+  uint64_t heap = 0;
+  uint64_t stack = 0;
+  uint64_t fill = 0;         // Relleno de alineación
+};
+
+// ============================================================================
+// LECTURA DEL .map
+// ============================================================================
+
+static bool parse_hex(const std::string &text, uint64_t &value) {
+  if (text.size() < 3 || text[0] != '0' || (text[1] != 'x' && text[1] != 'X')) return false;
+  char *end = nullptr;
+  value = strtoull(text.c_str() + 2, &end, 16);
+  return *end == '\0';
+}
+
+static std::vector<std::string> split(const std::string &line) {
+  std::vector<std::string> tokens;
+  std::istringstream in(line);
+  std::string token;
+  while (in >> token) tokens.push_back(token);
+  return tokens;
+}
+
+static std::string basename_of(const std::string &path) {
+  size_t slash = path.find_last_of('/');
+  return (slash == std::string::npos) ? path : path.substr(slash + 1);
+}
+
+// "./Core/Src/main.o" -> "main.o"; ".../libc_nano.a(lib_a-impure.o)" -> "libc_nano.a"
+static std::string module_of(const std::string &file) {
+  if (file.empty()) return "(enlazador)";
+  size_t paren = file.find('(');
+  if (paren != std::string::npos) return basename_of(file.substr(0, paren));
+  return basename_of(file);
+}
+
+static bool is_ram(const RamMap &map, uint64_t address) {
+  for (const Region &region : map.regions) {
+    std::string upper = region.name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    if (upper.find("RAM") == std::string::npos) continue;
+    if (address >= region.origin && address < region.origin + region.length) return true;
+  }
+  return false;
+}
+
+static void parse_archives(std::istream &in, RamMap &map) {
+  std::string line, member;
+  while (std::getline(in, line)) {
+    if (line.rfind("Discarded input sections", 0) == 0 || line.rfind("Memory Configuration", 0) == 0) break;
+    if (line.empty()) continue;
+
+    if (line[0] != ' ') {
+      member = basename_of(line.substr(0, line.find(' ')));
+      continue;
+    }
+    if (member.empty()) continue;
+
+    // Línea con el motivo: archivo (símbolo)
+    for (const char *pattern : kAllocatingMembers) {
+      size_t paren = member.find('(');
+      if (paren != std::string::npos && member.find(pattern, paren) != std::string::npos) {
+        std::vector<std::string> tokens = split(line);
+        std::string reason;
+        if (!tokens.empty()) reason = basename_of(tokens[0]);
+        if (tokens.size() > 1) reason += " " + tokens[1];
+        map.allocators.push_back({ member, reason });
+        break;
+      }
+    }
+    member.clear();
+  }
+}
+
+static void parse_regions(std::istream &in, RamMap &map) {
+  std::string line;
+  bool in_table = false;
+  while (std::getline(in, line)) {
+    if (line.rfind("Memory Configuration", 0) == 0) in_table = true;
+    if (line.rfind("Linker script and memory map", 0) == 0) return;
+    if (!in_table) continue;
+    std::vector<std::string> tokens = split(line);
+    Region region;
+    if (tokens.size() >= 3 && parse_hex(tokens[1], region.origin) && parse_hex(tokens[2], region.length)) {
+      region.name = tokens[0];
+      if (region.name != "*default*") map.regions.push_back(region);
+    }
+  }
+}
+
+static void add_input(RamMap &map, const std::string &output, const std::string &section,
+                      uint64_t size, const std::string &file) {
+  if (size == 0) return;
+  if (section == "*fill*") {
+    map.fill += size;
+    return;
+  }
+
+  Module &module = map.modules[module_of(file)];
+  if (output.rfind(".bss", 0) == 0 || section == "COMMON" || section.rfind(".bss", 0) == 0) {
+    module.bss += size;
+  } else {
+    module.data += size;
+  }
+  module.buffers.push_back({ section, size });
+}
+
+static void parse_sections(std::istream &in, RamMap &map) {
+  std::string line;
+  std::string output;          // Sección de salida actual ("" = fuera de RAM)
+  std::string pending_output;  // Nombre largo: dirección en la línea siguiente
+  std::string pending_input;
+
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    std::vector<std::string> tokens = split(line);
+    if (tokens.empty()) continue;
+
+    // Sección de salida: empieza en la columna 0
+    if (line[0] != ' ') {
+      output.clear();
+      pending_output.clear();
+      pending_input.clear();
+      if (line[0] != '.') continue;
+      uint64_t address;
+      if (tokens.size() >= 2 && parse_hex(tokens[1], address)) {
+        if (is_ram(map, address)) output = tokens[0];
+      } else {
+        pending_output = tokens[0];
+      }
+      continue;
+    }
+
+    if (!pending_output.empty()) {
+      uint64_t address;
+      if (parse_hex(tokens[0], address) && is_ram(map, address)) output = pending_output;
+      pending_output.clear();
+      continue;
+    }
+
+    // Asignaciones del script: 0x200  _Min_Heap_Size = 0x200
+    if (tokens.size() >= 4 && tokens[2] == "=") {
+      uint64_t value;
+      if (parse_hex(tokens[0], value)) {
+        if (tokens[1] == "_Min_Heap_Size") map.heap = value;
+        if (tokens[1] == "_Min_Stack_Size") map.stack = value;
+      }
+      continue;
+    }
+
+    // El heap y la pila se informan aparte
+    if (output.empty() || output.find("heap") != std::string::npos) continue;
+
+    // Sección de entrada: un espacio y el nombre (la dirección puede ir abajo)
+    bool input_line = line.size() > 1 && line[1] != ' ';
+    if (input_line) {
+      if (tokens[0].rfind("*(", 0) == 0 || tokens[0].rfind("KEEP", 0) == 0) continue;   // Patrón del script
+      uint64_t address, size;
+      if (tokens.size() >= 3 && parse_hex(tokens[1], address) && parse_hex(tokens[2], size)) {
+        add_input(map, output, tokens[0], size, tokens.size() >= 4 ? tokens[3] : "");
+        pending_input.clear();
+      } else {
+        pending_input = tokens[0];
+      }
+      continue;
+    }
+
+    if (!pending_input.empty()) {
+      uint64_t address, size;
+      if (tokens.size() >= 2 && parse_hex(tokens[0], address) && parse_hex(tokens[1], size)) {
+        add_input(map, output, pending_input, size, tokens.size() >= 3 ? tokens[2] : "");
+      }
+      pending_input.clear();
+    }
+  }
+}
+
+// ============================================================================
+// INFORME
+// ============================================================================
+
+static uint64_t ram_size(const RamMap &map) {
+  for (const Region &region : map.regions) {
+    if (region.name == "RAM") return region.length;
+  }
+  return 0;
+}
+
+static void print_report(const RamMap &map, bool verbose) {
+  std::vector<std::pair<std::string, const Module *>> sorted;
+  for (const auto &entry : map.modules) sorted.push_back({ entry.first, &entry.second });
+  std::sort(sorted.begin(), sorted.end(), [](const auto &a, const auto &b) {
+    return a.second->total() > b.second->total();
+  });
+
+  uint64_t ram = ram_size(map);
+  uint64_t data = 0, bss = 0;
+
+  printf("%-32s %8s %8s %8s %6s\n", "Módulo", ".data", ".bss", "Total", "% RAM");
+  for (const auto &entry : sorted) {
+    const Module &module = *entry.second;
+    data += module.data;
+    bss += module.bss;
+    printf("%-31s %8llu %8llu %8llu %5.1f%%\n", entry.first.c_str(),
+           (unsigned long long)module.data, (unsigned long long)module.bss,
+           (unsigned long long)module.total(), ram ? 100.0 * module.total() / ram : 0.0);
+
+    if (!verbose) continue;
+    std::vector<Buffer> buffers = module.buffers;
+    std::sort(buffers.begin(), buffers.end(), [](const Buffer &a, const Buffer &b) { return a.size > b.size; });
+    for (const Buffer &buffer : buffers) {
+      printf("    %-40s %8llu\n", buffer.name.c_str(), (unsigned long long)buffer.size);
+    }
+  }
+
+  uint64_t used = data + bss + map.fill;
+  uint64_t reserved = used + map.heap + map.stack;
+  printf("\n%-31s %8llu %8llu %8llu\n", "Estático", (unsigned long long)data, (unsigned long long)bss,
+         (unsigned long long)(data + bss));
+  printf("Relleno de alineación: %llu | heap: %llu | pila: %llu\n",
+         (unsigned long long)map.fill, (unsigned long long)map.heap, (unsigned long long)map.stack);
+  if (ram > 0) {
+    printf("RAM: %llu de %llu bytes (%.1f%%), libres %lld\n", (unsigned long long)reserved,
+           (unsigned long long)ram, 100.0 * reserved / ram, (long long)ram - (long long)reserved);
+  }
+  if (map.heap > 0) {
+    printf("Aviso: el .ld reserva %llu bytes de heap que el firmware no usa (_Min_Heap_Size = 0)\n",
+           (unsigned long long)map.heap);
+  }
+}
+
+// ============================================================================
+// PRINCIPAL
+// ============================================================================
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "Uso: %s [-v] MAPA\n", argv0);
+}
+
+int main(int argc, char **argv) {
+  bool verbose = false;
+  const char *path = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) verbose = true;
+    else if (path == nullptr) path = argv[i];
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (path == nullptr) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::ifstream in(path);
+  if (!in) {
+    fprintf(stderr, "No se pudo abrir %s\n", path);
+    return 1;
+  }
+
+  RamMap map;
+  parse_archives(in, map);
+  in.clear();
+  in.seekg(0);
+  parse_regions(in, map);
+  parse_sections(in, map);
+  if (map.regions.empty()) {
+    fprintf(stderr, "%s no parece un .map de GNU ld (falta Memory Configuration)\n", path);
+    return 1;
+  }
+
+  print_report(map, verbose);
+
+  if (!map.allocators.empty()) {
+    printf("\nReserva dinámica enlazada (el firmware no tiene heap):\n");
+    for (const Inclusion &inclusion : map.allocators) {
+      printf("  %-36s <- %s\n", inclusion.member.c_str(), inclusion.reason.c_str());
+    }
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file servo_check.c
+ * @brief Verificación de la base de tiempo de servos (servo_driver.c) en la PC
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Compila Core/Src/servo_driver.c tal cual contra una HAL de PC. El RCC
+ * informa una configuración de relojes y los timers simulados cuentan con
+ * el reloj que tienen "de verdad", que puede no coincidir. Para cada caso
+ * se comparan PSC, ARR y los CCR escritos con valores calculados a mano y
+ * se comprueba que servo_driver_verify() detecte un reloj equivocado.
+ */
+
+#include "servo_driver.h"
+#include "profiler.h"
+#include <stdio.h>
+
+// ============================================================================
+// MODELO DE LA PLACA
+// ============================================================================
+
+#define SIM_CYCLES_PER_READ   97   // Ciclos de CPU entre dos lecturas del DWT
+
+typedef struct {
+  TIM_TypeDef *tim;
+  uint32_t clock_hz;         // Reloj real de entrada del timer
+  bool running;
+} TimerModel;
+
+static TIM_TypeDef tim_a;
+static TIM_TypeDef tim_b;
+TIM_HandleTypeDef htim1 = { &tim_a, { 0, 0 } };
+TIM_HandleTypeDef htim5 = { &tim_b, { 0, 0 } };
+
+static TimerModel timers[2] = { { &tim_a, 0, false }, { &tim_b, 0, false } };
+
+uint32_t SystemCoreClock;
+static uint32_t apb1_divider;
+static uint32_t apb2_divider;
+static uint64_t sim_cycles;
+
+static uint32_t divider_value(uint32_t divider) {
+  switch (divider) {
+    case RCC_HCLK_DIV2: return 2;
+    case RCC_HCLK_DIV4: return 4;
+    case RCC_HCLK_DIV8: return 8;
+    case RCC_HCLK_DIV16: return 16;
+    default: return 1;
+  }
+}
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *config, uint32_t *latency) {
+  config->APB1CLKDivider = apb1_divider;
+  config->APB2CLKDivider = apb2_divider;
+  *latency = 0;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+  return SystemCoreClock / divider_value(apb1_divider);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+  return SystemCoreClock / divider_value(apb2_divider);
+}
+
+static TimerModel *timer_model(TIM_HandleTypeDef *htim) {
+  return (htim->Instance == &tim_a) ? &timers[0] : &timers[1];
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel) {
+  (void)channel;
+  timer_model(htim)->running = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel) {
+  (void)channel;
+  (void)htim;
+  return HAL_OK;
+}
+
+// Cada lectura del contador de ciclos avanza el tiempo y los contadores
+uint32_t profiler_cycles(void) {
+  sim_cycles += SIM_CYCLES_PER_READ;
+
+  for (uint8_t t = 0; t < 2; t++) {
+    TimerModel *model = &timers[t];
+    if (!model->running) continue;
+    uint64_t ticks = sim_cycles * model->clock_hz / SystemCoreClock / (model->tim->PSC + 1);
+    model->tim->CNT = (uint32_t)(ticks % (model->tim->ARR + 1));
+  }
+  return (uint32_t)sim_cycles;
+}
+
+// ============================================================================
+// CASOS
+// ============================================================================
+
+typedef struct {
+  const char *name;
+  uint32_t hclk_hz;
+  uint32_t apb1_divider;     // Lo que informa el RCC
+  uint32_t apb2_divider;
+  uint32_t clock_a_hz;       // Reloj real de TIM1 (APB2)
+  uint32_t clock_b_hz;       // Reloj real del timer B (APB1)
+  uint32_t psc;              // Esperados, calculados a mano
+  uint32_t arr;
+  uint32_t ccr[3];           // 0°, 90°, 180°
+  bool verify;
+} ServoCase;
+
+// 12.5 MHz: PSC 12 -> tick 961538 Hz; ARR = 19230 - 1; CCR = 961538 × 1/1.5/2 ms
+static const ServoCase cases[] = {
+  { "F410RB 100 MHz, APB1 /2",  100000000, RCC_HCLK_DIV2,  RCC_HCLK_DIV1,  100000000, 100000000,
+    99, 19999, { 1000, 1500, 2000 }, true },
+  { "L433 80 MHz, APB /1",       80000000, RCC_HCLK_DIV1,  RCC_HCLK_DIV1,   80000000,  80000000,
+    79, 19999, { 1000, 1500, 2000 }, true },
+  { "Timers a 12.5 MHz",        100000000, RCC_HCLK_DIV16, RCC_HCLK_DIV16,  12500000,  12500000,
+    12, 19229, { 962, 1442, 1923 }, true },
+  { "Timer B a PCLK1 (sin x2)", 100000000, RCC_HCLK_DIV2,  RCC_HCLK_DIV1,  100000000,  50000000,
+    99, 19999, { 1000, 1500, 2000 }, false },
+  { "TIM1 al doble",            100000000, RCC_HCLK_DIV2,  RCC_HCLK_DIV1,  200000000, 100000000,
+    99, 19999, { 1000, 1500, 2000 }, false },
+};
+
+static uint32_t failures;
+
+static void check(bool condition, const char *what) {
+  if (!condition) {
+    printf("  FALLA: %s\n", what);
+    failures++;
+  }
+}
+
+static void run_case(const ServoCase *c) {
+  static const uint8_t angles[3] = { 0, 90, 180 };
+
+  printf("%s\n", c->name);
+  SystemCoreClock = c->hclk_hz;
+  apb1_divider = c->apb1_divider;
+  apb2_divider = c->apb2_divider;
+  timers[0].clock_hz = c->clock_a_hz;
+  timers[1].clock_hz = c->clock_b_hz;
+
+  servo_driver_init();
+
+  for (uint8_t t = 0; t < 2; t++) {
+    check(timers[t].tim->PSC == c->psc, "PSC");
+    check(timers[t].tim->ARR == c->arr, "ARR");
+  }
+
+  // Servos 1-2 en TIM1 (CH1, CH2), 4-5 en el timer B (CH1, CH2)
+  for (uint8_t i = 0; i < 3; i++) {
+    servo_driver_set_angle(1, angles[i]);
+    servo_driver_set_angle(2, angles[i]);
+    servo_driver_set_angle(4, angles[i]);
+    servo_driver_set_angle(5, angles[i]);
+    check(tim_a.CCR1 == c->ccr[i] && tim_a.CCR2 == c->ccr[i], "CCR de TIM1");
+    check(tim_b.CCR1 == c->ccr[i] && tim_b.CCR2 == c->ccr[i], "CCR del timer B");
+  }
+
+  check(servo_driver_verify() == c->verify,
+        c->verify ? "la verificación rechaza un reloj correcto" : "la verificación no detecta el reloj");
+}
+
+int main(void) {
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    run_case(&cases[i]);
+  }
+
+  printf("%s\n", failures == 0 ? "OK" : "FALLA");
+  return failures == 0 ? 0 : 1;
+}
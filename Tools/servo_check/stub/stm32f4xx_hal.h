@@ -0,0 +1,88 @@
+/**
+ * @file stm32f4xx_hal.h
+ * @brief HAL mínima para compilar servo_driver.c en la PC (verificación)
+ * @author Smart Waste Manager
+ * @date 2025
+ */
+
+#ifndef SIM_STM32F4XX_HAL_H
+#define SIM_STM32F4XX_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+  HAL_OK = 0,
+  HAL_ERROR = 1,
+  HAL_BUSY = 2,
+  HAL_TIMEOUT = 3
+} HAL_StatusTypeDef;
+
+// Sólo se usan por puntero o como extern en config.h
+typedef struct { int unused; } ADC_HandleTypeDef;
+typedef struct { int unused; } I2C_HandleTypeDef;
+typedef struct { int unused; } UART_HandleTypeDef;
+
+// ============================================================================
+// TIMERS
+// ============================================================================
+
+typedef struct {
+  uint32_t EGR;
+  uint32_t CNT;
+  uint32_t PSC;
+  uint32_t ARR;
+  uint32_t CCR1;
+  uint32_t CCR2;
+  uint32_t CCR3;
+  uint32_t CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+  uint32_t Prescaler;
+  uint32_t Period;
+} TIM_Base_InitTypeDef;
+
+typedef struct {
+  TIM_TypeDef *Instance;
+  TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1           0x00u
+#define TIM_CHANNEL_2           0x04u
+#define TIM_CHANNEL_3           0x08u
+#define TIM_CHANNEL_4           0x0Cu
+#define TIM_EGR_UG              0x01u
+
+#define __HAL_TIM_SET_PRESCALER(h, psc)   ((h)->Instance->PSC = (psc))
+#define __HAL_TIM_SET_AUTORELOAD(h, arr)  do { (h)->Instance->ARR = (arr); (h)->Init.Period = (arr); } while (0)
+#define __HAL_TIM_SET_COMPARE(h, ch, ccr) (*(&(h)->Instance->CCR1 + ((ch) >> 2)) = (ccr))
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel);
+
+// ============================================================================
+// RELOJES
+// ============================================================================
+
+typedef struct {
+  uint32_t ClockType;
+  uint32_t SYSCLKSource;
+  uint32_t AHBCLKDivider;
+  uint32_t APB1CLKDivider;
+  uint32_t APB2CLKDivider;
+} RCC_ClkInitTypeDef;
+
+#define RCC_HCLK_DIV1           0x00000000u
+#define RCC_HCLK_DIV2           0x00001000u
+#define RCC_HCLK_DIV4           0x00001400u
+#define RCC_HCLK_DIV8           0x00001800u
+#define RCC_HCLK_DIV16          0x00001C00u
+
+extern uint32_t SystemCoreClock;
+
+void HAL_RCC_GetClockConfig(RCC_ClkInitTypeDef *config, uint32_t *latency);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+#endif // SIM_STM32F4XX_HAL_H
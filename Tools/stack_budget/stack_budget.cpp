@@ -0,0 +1,600 @@
+/**
+ * @file stack_budget.cpp
+ * @brief Peor caso de pila por punto de entrada (.su + grafo de llamadas del ELF)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Uso:
+ *   stack_budget [-v] [-n NIVELES] [-s BYTES] [-b] [-a ANOTACIONES] ELF DIR_SU...
+ *
+ * El marco de cada función sale de los .su que genera -fstack-usage. Las
+ * llamadas se leen del código del ELF: BL (y B/B.W a otra función, que es
+ * una llamada de cola) decodificados en Thumb-2, sin objdump. Los puntos de
+ * entrada son los de la tabla de vectores: Reset_Handler (el loop
+ * principal) y cada handler de falla o interrupción.
+ *
+ * Peor caso total = hilo + las NIVELES interrupciones más profundas que
+ * pueden anidarse + la falla más profunda, cada excepción con su marco de
+ * hardware (104 bytes con contexto de FPU, 32 con -b). Con
+ * NVIC_PRIORITYGROUP_0 y todas las IRQ en prioridad 0 no hay anidamiento
+ * entre IRQ: NIVELES = 1.
+ *
+ * Las llamadas por puntero (BLX rN) no se pueden seguir: el archivo de
+ * anotaciones lista sus destinos posibles ("llamador: destino patrón*").
+ * Las que queden sin anotar se informan.
+ *
+ * Termina con código 2 si el peor caso supera _Min_Stack_Size (o -s).
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <fnmatch.h>
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+constexpr uint32_t kFrameBasic = 32;    // R0-R3, R12, LR, PC, xPSR
+constexpr uint32_t kFrameFpu = 104;     // + S0-S15, FPSCR y alineación
+constexpr size_t kFirstIrqVector = 11;  // SVCall; 2-6 son NMI y fallas
+
+// ============================================================================
+// LECTURA DEL ELF
+// ============================================================================
+
+struct Section {
+  std::string name;
+  uint32_t type = 0;
+  uint32_t flags = 0;
+  uint32_t addr = 0;
+  uint32_t offset = 0;
+  uint32_t size = 0;
+  uint32_t link = 0;
+};
+
+struct Function {
+  std::string name;
+  uint32_t addr = 0;
+  uint32_t size = 0;
+  std::vector<std::string> aliases;   // Otros nombres en la misma dirección (handlers débiles)
+};
+
+class Elf {
+public:
+  bool load(const char *path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    data_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (data_.size() < 52 || memcmp(data_.data(), "\x7f" "ELF", 4) != 0) return false;
+    if (data_[4] != 1 || data_[5] != 1) return false;   // ELF32 little endian
+
+    uint32_t shoff = u32(0x20);
+    uint16_t shentsize = u16(0x2E);
+    uint16_t shnum = u16(0x30);
+    uint16_t shstrndx = u16(0x32);
+    if (shoff == 0 || (size_t)shoff + (size_t)shnum * shentsize > data_.size()) return false;
+
+    for (uint16_t i = 0; i < shnum; i++) {
+      size_t base = shoff + (size_t)i * shentsize;
+      Section s;
+      s.type = u32(base + 4);
+      s.flags = u32(base + 8);
+      s.addr = u32(base + 12);
+      s.offset = u32(base + 16);
+      s.size = u32(base + 20);
+      s.link = u32(base + 24);
+      name_offsets_.push_back(u32(base));
+      sections_.push_back(s);
+    }
+    if (shstrndx < sections_.size()) {
+      for (size_t i = 0; i < sections_.size(); i++) {
+        sections_[i].name = str(sections_[shstrndx].offset + name_offsets_[i]);
+      }
+    }
+    load_symbols();
+    return true;
+  }
+
+  const std::vector<Function> &functions() const { return functions_; }
+
+  bool absolute(const std::string &name, uint32_t &value) const {
+    auto it = absolutes_.find(name);
+    if (it == absolutes_.end()) return false;
+    value = it->second;
+    return true;
+  }
+
+  // Lectura en la imagen cargada (secciones con contenido en Flash/RAM)
+  bool read16(uint32_t addr, uint16_t &value) const {
+    const Section *s = find_loaded(addr, 2);
+    if (s == nullptr) return false;
+    value = u16(s->offset + (addr - s->addr));
+    return true;
+  }
+
+  bool read32(uint32_t addr, uint32_t &value) const {
+    const Section *s = find_loaded(addr, 4);
+    if (s == nullptr) return false;
+    value = u32(s->offset + (addr - s->addr));
+    return true;
+  }
+
+  const Section *section(const std::string &name) const {
+    for (const Section &s : sections_) {
+      if (s.name == name) return &s;
+    }
+    return nullptr;
+  }
+
+private:
+  std::vector<uint8_t> data_;
+  std::vector<Section> sections_;
+  std::vector<uint32_t> name_offsets_;
+  std::vector<Function> functions_;
+  std::map<std::string, uint32_t> absolutes_;
+  std::set<std::string> weak_names_;
+
+  uint16_t u16(size_t off) const {
+    return off + 2 <= data_.size() ? (uint16_t)(data_[off] | (data_[off + 1] << 8)) : 0;
+  }
+
+  uint32_t u32(size_t off) const {
+    return off + 4 <= data_.size() ? (uint32_t)u16(off) | ((uint32_t)u16(off + 2) << 16) : 0;
+  }
+
+  std::string str(size_t off) const {
+    std::string out;
+    while (off < data_.size() && data_[off] != 0) out += (char)data_[off++];
+    return out;
+  }
+
+  const Section *find_loaded(uint32_t addr, uint32_t len) const {
+    for (const Section &s : sections_) {
+      if (s.type != 1 || !(s.flags & 0x2)) continue;   // PROGBITS + SHF_ALLOC
+      if (addr >= s.addr && addr - s.addr + len <= s.size) return &s;
+    }
+    return nullptr;
+  }
+
+  void load_symbols() {
+    for (const Section &symtab : sections_) {
+      if (symtab.type != 2 || symtab.link >= sections_.size()) continue;   // SHT_SYMTAB
+      const Section &strtab = sections_[symtab.link];
+
+      std::map<uint32_t, Function> by_addr;
+      for (uint32_t off = 0; off + 16 <= symtab.size; off += 16) {
+        size_t base = symtab.offset + off;
+        std::string name = str(strtab.offset + u32(base));
+        uint32_t value = u32(base + 4);
+        uint32_t size = u32(base + 8);
+        uint8_t info = data_[base + 12];
+        uint16_t shndx = u16(base + 14);
+        if (name.empty()) continue;
+
+        if (shndx == 0xFFF1) absolutes_[name] = value;   // SHN_ABS: símbolos del .ld
+        if ((info & 0x0F) != 2) continue;                // STT_FUNC
+
+        uint32_t addr = value & ~1u;
+        bool weak = (info >> 4) == 2;   // STB_WEAK
+        auto it = by_addr.find(addr);
+        if (it == by_addr.end()) {
+          by_addr[addr] = { name, addr, size, {} };
+          if (weak) weak_names_.insert(name);
+        } else if (!weak && weak_names_.count(it->second.name)) {
+          // El nombre propio (Default_Handler) antes que los alias débiles
+          it->second.aliases.push_back(it->second.name);
+          it->second.name = name;
+          it->second.size = std::max(it->second.size, size);
+        } else {
+          it->second.aliases.push_back(name);
+          it->second.size = std::max(it->second.size, size);
+          if (weak) weak_names_.insert(name);
+        }
+      }
+      for (auto &entry : by_addr) functions_.push_back(entry.second);
+    }
+  }
+};
+
+// ============================================================================
+// GRAFO DE LLAMADAS
+// ============================================================================
+
+struct Node {
+  const Function *fn = nullptr;
+  uint32_t frame = 0;
+  bool has_su = false;
+  bool dynamic = false;              // Marco variable (VLA/alloca) según el .su
+  std::set<size_t> calls;
+  std::set<size_t> tail_calls;
+  std::vector<uint32_t> indirect;    // Direcciones de BLX/BX rN sin resolver
+  bool annotated = false;
+
+  // Resultado de la búsqueda
+  int state = 0;                     // 0 = sin visitar, 1 = en curso, 2 = listo
+  uint32_t depth = 0;
+  size_t next = SIZE_MAX;            // Llamada del peor camino
+  bool recursive = false;
+};
+
+class CallGraph {
+public:
+  CallGraph(const Elf &elf, const std::map<std::string, std::pair<uint32_t, bool>> &frames) {
+    for (const Function &fn : elf.functions()) {
+      Node node;
+      node.fn = &fn;
+      auto it = frames.find(fn.name);
+      for (size_t i = 0; it == frames.end() && i < fn.aliases.size(); i++) it = frames.find(fn.aliases[i]);
+      if (it != frames.end()) {
+        node.frame = it->second.first;
+        node.dynamic = it->second.second;
+        node.has_su = true;
+      }
+      by_addr_[fn.addr] = nodes_.size();
+      by_name_[fn.name] = nodes_.size();
+      for (const std::string &alias : fn.aliases) by_name_[alias] = nodes_.size();
+      nodes_.push_back(node);
+    }
+    for (Node &node : nodes_) decode(elf, node);
+  }
+
+  size_t count() const { return nodes_.size(); }
+  Node &node(size_t i) { return nodes_[i]; }
+
+  bool find(const std::string &name, size_t &index) const {
+    auto it = by_name_.find(name);
+    if (it == by_name_.end()) return false;
+    index = it->second;
+    return true;
+  }
+
+  bool at(uint32_t addr, size_t &index) const {
+    auto it = by_addr_.find(addr & ~1u);
+    if (it == by_addr_.end()) return false;
+    index = it->second;
+    return true;
+  }
+
+  // Agrega los destinos de las llamadas por puntero de un llamador
+  bool annotate(const std::string &caller, const std::string &pattern) {
+    size_t from;
+    if (!find(caller, from)) return false;
+    nodes_[from].annotated = true;
+    for (size_t i = 0; i < nodes_.size(); i++) {
+      if (fnmatch(pattern.c_str(), nodes_[i].fn->name.c_str(), 0) == 0) nodes_[from].calls.insert(i);
+    }
+    return true;
+  }
+
+  uint32_t depth(size_t i) {
+    Node &n = nodes_[i];
+    if (n.state == 2) return n.depth;
+    if (n.state == 1) {
+      n.recursive = true;   // Ciclo: el peor caso no está acotado
+      return 0;
+    }
+    n.state = 1;
+
+    uint32_t deepest = n.frame;
+    for (size_t callee : n.calls) {
+      if (callee == i) {
+        n.recursive = true;
+        continue;
+      }
+      uint32_t d = n.frame + depth(callee);
+      if (d > deepest || n.next == SIZE_MAX) {
+        if (d > deepest) deepest = d;
+        n.next = callee;
+      }
+    }
+    // La llamada de cola libera el marco antes de saltar
+    for (size_t callee : n.tail_calls) {
+      if (callee == i) continue;
+      uint32_t d = depth(callee);
+      if (d > deepest) {
+        deepest = d;
+        n.next = callee;
+      }
+    }
+
+    n.depth = deepest;
+    n.state = 2;
+    return deepest;
+  }
+
+  // Recorre lo alcanzable desde una entrada (después de depth())
+  void reachable(size_t start, std::set<size_t> &out) const {
+    std::vector<size_t> pending = { start };
+    while (!pending.empty()) {
+      size_t i = pending.back();
+      pending.pop_back();
+      if (!out.insert(i).second) continue;
+      for (size_t c : nodes_[i].calls) pending.push_back(c);
+      for (size_t c : nodes_[i].tail_calls) pending.push_back(c);
+    }
+  }
+
+private:
+  std::vector<Node> nodes_;
+  std::map<uint32_t, size_t> by_addr_;
+  std::map<std::string, size_t> by_name_;
+
+  static int32_t sign_extend(uint32_t value, int bits) {
+    uint32_t mask = 1u << (bits - 1);
+    return (int32_t)((value ^ mask) - mask);
+  }
+
+  void add_branch(Node &node, uint32_t target, bool link) {
+    size_t callee;
+    if (!at(target, callee)) return;   // Salto dentro de la función o a datos
+    if (nodes_[callee].fn == node.fn) return;
+    if (link) node.calls.insert(callee);
+    else node.tail_calls.insert(callee);
+  }
+
+  void decode(const Elf &elf, Node &node) {
+    uint32_t start = node.fn->addr;
+    uint32_t end = start + node.fn->size;
+
+    for (uint32_t pc = start; pc + 2 <= end;) {
+      uint16_t hw1;
+      if (!elf.read16(pc, hw1)) return;
+
+      // Instrucción de 32 bits: 0b11101, 0b11110 o 0b11111 en los bits 15-11
+      if ((hw1 >> 11) >= 0x1D) {
+        uint16_t hw2;
+        if (pc + 4 > end || !elf.read16(pc + 2, hw2)) return;
+
+        if ((hw1 & 0xF800) == 0xF000 && (hw2 & 0x8000)) {
+          bool link = (hw2 & 0x4000) != 0;          // BL (T1)
+          bool wide = (hw2 & 0x1000) != 0;          // B.W (T4) si no es BL
+          if (wide && (link || (hw2 & 0xD000) == 0x9000)) {
+            uint32_t s = (hw1 >> 10) & 1;
+            uint32_t j1 = (hw2 >> 13) & 1;
+            uint32_t j2 = (hw2 >> 11) & 1;
+            uint32_t i1 = !(j1 ^ s);
+            uint32_t i2 = !(j2 ^ s);
+            uint32_t imm = (s << 24) | (i1 << 23) | (i2 << 22) | ((hw1 & 0x3FFu) << 12) | ((hw2 & 0x7FFu) << 1);
+            add_branch(node, pc + 4 + sign_extend(imm, 25), link);
+          }
+        }
+        pc += 4;
+        continue;
+      }
+
+      if ((hw1 & 0xFF87) == 0x4780) {
+        node.indirect.push_back(pc);                 // BLX rN
+      } else if ((hw1 & 0xFF87) == 0x4700 && ((hw1 >> 3) & 0xF) != 14) {
+        node.indirect.push_back(pc);                 // BX rN (salto por puntero)
+      } else if ((hw1 & 0xF800) == 0xE000) {
+        add_branch(node, pc + 4 + sign_extend((hw1 & 0x7FFu) << 1, 12), false);   // B (T2)
+      }
+      pc += 2;
+    }
+  }
+};
+
+// ============================================================================
+// ARCHIVOS .su Y ANOTACIONES
+// ============================================================================
+
+// archivo.c:línea:columna:función<TAB>bytes<TAB>static|dynamic|dynamic,bounded
+static void load_su_file(const std::string &path, std::map<std::string, std::pair<uint32_t, bool>> &frames) {
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t tab = line.find('\t');
+    if (tab == std::string::npos) continue;
+    size_t colon = line.rfind(':', tab);
+    if (colon == std::string::npos) continue;
+
+    std::string name = line.substr(colon + 1, tab - colon - 1);
+    std::istringstream rest(line.substr(tab + 1));
+    uint32_t bytes = 0;
+    std::string kind;
+    rest >> bytes >> kind;
+
+    // Funciones static con el mismo nombre en varios archivos: la mayor
+    auto &entry = frames[name];
+    entry.first = std::max(entry.first, bytes);
+    entry.second = entry.second || kind == "dynamic";
+  }
+}
+
+static void load_su_dir(const std::string &dir, std::map<std::string, std::pair<uint32_t, bool>> &frames,
+                        int &files) {
+  DIR *d = opendir(dir.c_str());
+  if (d == nullptr) return;
+  while (dirent *e = readdir(d)) {
+    std::string name = e->d_name;
+    if (name == "." || name == "..") continue;
+    std::string path = dir + "/" + name;
+    if (name.size() > 3 && name.compare(name.size() - 3, 3, ".su") == 0) {
+      load_su_file(path, frames);
+      files++;
+    } else if (e->d_type == DT_DIR) {
+      load_su_dir(path, frames, files);
+    }
+  }
+  closedir(d);
+}
+
+// llamador: destino destino_* ...   (# comentario)
+static bool load_annotations(const char *path, CallGraph &graph, bool verbose) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    line = line.substr(0, line.find('#'));
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) continue;
+
+    std::istringstream callers(line.substr(0, colon));
+    std::string caller;
+    callers >> caller;
+    std::istringstream targets(line.substr(colon + 1));
+    std::string target;
+    while (targets >> target) {
+      if (!graph.annotate(caller, target) && verbose) {
+        printf("Anotación sin efecto: %s no está en el ELF\n", caller.c_str());
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// INFORME
+// ============================================================================
+
+struct Entry {
+  size_t vector = 0;
+  size_t node = 0;
+  uint32_t depth = 0;
+};
+
+static void print_path(CallGraph &graph, size_t start) {
+  std::set<size_t> seen;
+  for (size_t i = start; i != SIZE_MAX && seen.insert(i).second; i = graph.node(i).next) {
+    Node &n = graph.node(i);
+    printf("      %-40s %5u%s\n", n.fn->name.c_str(), n.frame, n.has_su ? "" : "  (sin .su)");
+  }
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "Uso: %s [-v] [-n NIVELES] [-s BYTES] [-b] [-a ANOTACIONES] ELF DIR_SU...\n", argv0);
+}
+
+int main(int argc, char **argv) {
+  bool verbose = false;
+  bool basic_frame = false;
+  int levels = 1;
+  long budget_override = -1;
+  const char *annotations = nullptr;
+  std::vector<const char *> paths;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) verbose = true;
+    else if (strcmp(argv[i], "-b") == 0) basic_frame = true;
+    else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) levels = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) budget_override = strtol(argv[++i], nullptr, 0);
+    else if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) annotations = argv[++i];
+    else paths.push_back(argv[i]);
+  }
+  if (paths.size() < 2 || levels < 0) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  Elf elf;
+  if (!elf.load(paths[0])) {
+    fprintf(stderr, "No se pudo leer %s como ELF32 ARM\n", paths[0]);
+    return 1;
+  }
+
+  std::map<std::string, std::pair<uint32_t, bool>> frames;
+  int su_files = 0;
+  for (size_t i = 1; i < paths.size(); i++) load_su_dir(paths[i], frames, su_files);
+  if (su_files == 0) {
+    fprintf(stderr, "No hay archivos .su (compilar con -fstack-usage)\n");
+    return 1;
+  }
+
+  CallGraph graph(elf, frames);
+  if (annotations != nullptr && !load_annotations(annotations, graph, verbose)) {
+    fprintf(stderr, "No se pudo abrir %s\n", annotations);
+    return 1;
+  }
+
+  // Tabla de vectores: [0] = SP inicial, [1] = Reset_Handler, ...
+  const Section *vectors = elf.section(".isr_vector");
+  if (vectors == nullptr) {
+    fprintf(stderr, "El ELF no tiene .isr_vector\n");
+    return 1;
+  }
+  std::vector<Entry> entries;
+  std::set<size_t> seen;
+  for (size_t v = 1; v < vectors->size / 4; v++) {
+    uint32_t addr;
+    size_t node;
+    if (!elf.read32(vectors->addr + (uint32_t)v * 4, addr) || addr == 0) continue;
+    if (!graph.at(addr, node) || !seen.insert(node).second) continue;
+    entries.push_back({ v, node, graph.depth(node) });
+  }
+
+  uint32_t frame = basic_frame ? kFrameBasic : kFrameFpu;
+  uint32_t thread = 0, fault = 0;
+  std::vector<uint32_t> irqs;
+
+  printf("%-36s %7s %7s\n", "Entrada", "Vector", "Bytes");
+  for (const Entry &e : entries) {
+    Node &n = graph.node(e.node);
+    const char *kind = (e.vector == 1) ? "hilo" : (e.vector < kFirstIrqVector) ? "falla" : "";
+    printf("%-36s %7zu %7u %s%s\n", n.fn->name.c_str(), e.vector, e.depth, kind,
+           n.recursive ? " RECURSIVA" : "");
+    if (verbose) print_path(graph, e.node);
+
+    if (e.vector == 1) thread = e.depth;
+    else if (e.vector < kFirstIrqVector) fault = std::max(fault, e.depth + frame);
+    else irqs.push_back(e.depth + frame);
+  }
+
+  std::sort(irqs.rbegin(), irqs.rend());
+  uint32_t nested = 0;
+  for (int i = 0; i < levels && i < (int)irqs.size(); i++) nested += irqs[i];
+  uint32_t worst = thread + nested + fault;
+
+  uint32_t budget = 0;
+  bool have_budget = budget_override >= 0 || elf.absolute("_Min_Stack_Size", budget);
+  if (budget_override >= 0) budget = (uint32_t)budget_override;
+
+  printf("\nPeor caso: hilo %u + %d nivel(es) de IRQ %u + falla %u (marco %u) = %u bytes\n",
+         thread, levels, nested, fault, frame, worst);
+
+  // Lo que el cálculo no puede ver
+  std::set<size_t> reached;
+  for (const Entry &e : entries) graph.reachable(e.node, reached);
+  std::vector<std::string> no_su, indirect, recursive, dynamic;
+  for (size_t i : reached) {
+    Node &n = graph.node(i);
+    if (!n.has_su) no_su.push_back(n.fn->name);
+    if (!n.indirect.empty() && !n.annotated) indirect.push_back(n.fn->name);
+    if (n.recursive) recursive.push_back(n.fn->name);
+    if (n.dynamic) dynamic.push_back(n.fn->name);
+  }
+  auto list = [](const char *title, const std::vector<std::string> &names) {
+    if (names.empty()) return;
+    printf("%s (%zu):", title, names.size());
+    for (const std::string &name : names) printf(" %s", name.c_str());
+    printf("\n");
+  };
+  list("Sin .su, cuentan 0 bytes", no_su);
+  list("Llamadas por puntero sin anotar", indirect);
+  list("Recursión (no acotada)", recursive);
+  list("Marco dinámico (VLA/alloca)", dynamic);
+
+  if (!have_budget) {
+    printf("Sin presupuesto: el ELF no tiene _Min_Stack_Size (usar -s BYTES)\n");
+    return 0;
+  }
+  printf("Presupuesto: %u bytes (_Min_Stack_Size) | margen %lld\n", budget,
+         (long long)budget - (long long)worst);
+  if (worst > budget || !recursive.empty()) {
+    printf("EXCEDIDO\n");
+    return 2;
+  }
+  printf("OK\n");
+  return 0;
+}
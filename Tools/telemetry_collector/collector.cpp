@@ -0,0 +1,733 @@
+/**
+ * @file collector.cpp
+ * @brief Colector de telemetría de varias estaciones (Linux)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Uso:
+ *   collector [-o DIR] [-w HILOS] [-b BAUDIOS] FUENTE...
+ *   collector --bench ESTACIONES EVENTOS [-o DIR] [-w HILOS]
+ *
+ * FUENTE puede ser un puerto serie, un pty, un FIFO o un archivo con una
+ * captura cruda. Las fuentes con descriptor "pollable" se atienden con
+ * epoll (EPOLLONESHOT: un solo hilo por fuente a la vez); los archivos
+ * regulares se leen por bloques en el mismo pool de hilos.
+ */
+
+#include "protocol.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace telemetry;
+
+// ============================================================================
+// CONFIGURACIÓN
+// ============================================================================
+
+constexpr size_t kReadChunk = 64 * 1024;     // Por lectura
+constexpr size_t kReadBudget = 256 * 1024;   // Por turno de una fuente
+constexpr size_t kFlushRows = 4096;          // Filas por bloque de columnas
+constexpr int kStations = 256;               // ID de estación = 1 byte
+
+static std::atomic<bool> stop_requested{false};
+
+static uint64_t now_us() {
+  timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+// ============================================================================
+// AGREGADOS POR ESTACIÓN (contadores sin locks)
+// ============================================================================
+
+struct StationStats {
+  std::atomic<uint64_t> frames{0};
+  std::atomic<uint64_t> items{0};
+  std::atomic<uint64_t> per_material[5] = {};   // Ninguno, metal, papel, plástico, vidrio
+  std::atomic<uint64_t> deposited{0};
+  std::atomic<uint64_t> not_deposited{0};       // Retenido, rechazado o sin clasificar
+  std::atomic<uint64_t> seq_gaps{0};
+  std::atomic<uint32_t> last_seq{0x100};        // 0x100 = todavía sin tramas
+  std::atomic<uint32_t> last_tick{0};
+  std::atomic<uint32_t> loop_max_us{0};
+  std::atomic<uint32_t> tx_dropped{0};
+  std::atomic<uint8_t> level[4] = {};
+};
+
+static StationStats stations[kStations];
+
+static void update_max(std::atomic<uint32_t> &target, uint32_t value) {
+  uint32_t prev = target.load(std::memory_order_relaxed);
+  while (value > prev && !target.compare_exchange_weak(prev, value, std::memory_order_relaxed)) {
+  }
+}
+
+static void aggregate(const Message &msg) {
+  StationStats &st = stations[msg.station];
+  st.frames.fetch_add(1, std::memory_order_relaxed);
+  st.last_tick.store(msg.tick, std::memory_order_relaxed);
+
+  // Secuencia mod 256: un salto indica tramas perdidas en el enlace
+  uint32_t prev = st.last_seq.exchange(msg.seq, std::memory_order_relaxed);
+  if (prev <= 0xFF && (uint8_t)(prev + 1) != msg.seq) {
+    st.seq_gaps.fetch_add((uint8_t)(msg.seq - prev - 1), std::memory_order_relaxed);
+  }
+
+  switch (msg.type) {
+    case kMsgItem: {
+      st.items.fetch_add(1, std::memory_order_relaxed);
+      uint8_t material = msg.body[0];
+      if (material <= 4) st.per_material[material].fetch_add(1, std::memory_order_relaxed);
+      uint8_t outcome = msg.body[2];
+      // DEPOSIT_QUEUED = 0, DEPOSIT_DIVERTED = 1
+      if (outcome <= 1) st.deposited.fetch_add(1, std::memory_order_relaxed);
+      else st.not_deposited.fetch_add(1, std::memory_order_relaxed);
+      break;
+    }
+    case kMsgLevels:
+      for (int bin = 0; bin < 4; bin++) {
+        st.level[bin].store(msg.body[bin * 6], std::memory_order_relaxed);
+      }
+      break;
+    case kMsgProfile:
+      update_max(st.loop_max_us, get_u32(msg.body + 8));
+      st.tx_dropped.store(get_u32(msg.body + 25), std::memory_order_relaxed);
+      break;
+    default:
+      break;
+  }
+}
+
+// ============================================================================
+// SERIES DE TIEMPO EN COLUMNAS
+// ============================================================================
+
+// Cada tabla es un directorio con un archivo binario por columna (little
+// endian, ancho fijo) y un schema.txt. Todas las columnas tienen las mismas
+// filas: se agregan juntas bajo el mutex de la tabla.
+
+struct Field {
+  const char *name;
+  uint8_t width;     // bytes
+  bool is_signed;
+  bool is_text = false;   // Bytes de texto rellenos con 0 (tipo cN)
+};
+
+// Columnas comunes a todas las tablas
+static const Field kCommonFields[] = {
+  { "host_us", 8, false }, { "station", 1, false }, { "seq", 1, false }, { "tick_ms", 4, false },
+};
+
+// Cuerpo de cada mensaje, en el mismo orden que lo escribe el firmware
+static const std::vector<Field> kSchemas[kMsgTypeCount] = {
+  {},
+  { { "material", 1, false }, { "confidence", 1, false }, { "outcome", 1, false },
+    { "sensors", 1, false }, { "ldr", 2, false }, { "mic", 2, false } },
+  { { "total", 4, false }, { "metal", 4, false }, { "papel", 4, false },
+    { "plastico", 4, false }, { "vidrio", 4, false }, { "errores", 4, false },
+    { "confianza_x100", 2, false }, { "horas", 4, false },
+    { "ciclo_p50_ms", 2, false }, { "ciclo_p90_ms", 2, false },
+    { "latencia_p50_ms", 2, false }, { "latencia_p90_ms", 2, false } },
+  { { "metal_pct", 1, false }, { "metal_flags", 1, false }, { "metal_rate_x100", 2, true }, { "metal_h_x10", 2, false },
+    { "papel_pct", 1, false }, { "papel_flags", 1, false }, { "papel_rate_x100", 2, true }, { "papel_h_x10", 2, false },
+    { "plastico_pct", 1, false }, { "plastico_flags", 1, false }, { "plastico_rate_x100", 2, true }, { "plastico_h_x10", 2, false },
+    { "vidrio_pct", 1, false }, { "vidrio_flags", 1, false }, { "vidrio_rate_x100", 2, true }, { "vidrio_h_x10", 2, false } },
+  { { "loops", 4, false }, { "loop_avg_us", 4, false }, { "loop_max_us", 4, false },
+    { "flush_last_us", 4, false }, { "flush_max_us", 4, false }, { "queue_max", 1, false },
+    { "motion_rejected", 4, false }, { "tx_dropped", 4, false }, { "ring_peak", 2, false } },
+  { { "leds", 1, false }, { "leds_animated", 1, false },
+    { "line1", 16, false, true }, { "line2", 16, false, true } },
+};
+
+static const char *kTableNames[kMsgTypeCount] = { "", "items", "stats", "levels", "profile", "display" };
+
+class ColumnTable {
+ public:
+  bool open(const std::string &root, uint8_t type) {
+    std::string dir = root + "/" + kTableNames[type];
+    mkdir(root.c_str(), 0755);
+    mkdir(dir.c_str(), 0755);
+
+    std::string schema_path = dir + "/schema.txt";
+    FILE *schema = fopen(schema_path.c_str(), "w");
+    if (schema == nullptr) return false;
+    for (const Field &f : kCommonFields) add_column(dir, f, schema);
+    for (const Field &f : kSchemas[type]) add_column(dir, f, schema);
+    fclose(schema);
+
+    for (int fd : fds_) {
+      if (fd < 0) return false;
+    }
+    return true;
+  }
+
+  ~ColumnTable() {
+    for (int fd : fds_) {
+      if (fd >= 0) close(fd);
+    }
+  }
+
+  size_t columns() const { return fds_.size(); }
+
+  // Escribe un bloque de filas (una columna por vector)
+  void append(const std::vector<std::vector<uint8_t>> &block) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t c = 0; c < fds_.size(); c++) {
+      const uint8_t *data = block[c].data();
+      size_t left = block[c].size();
+      while (left > 0) {
+        ssize_t n = write(fds_[c], data, left);
+        if (n < 0) {
+          if (errno == EINTR) continue;
+          perror("write");
+          return;
+        }
+        data += n;
+        left -= (size_t)n;
+      }
+    }
+  }
+
+ private:
+  void add_column(const std::string &dir, const Field &f, FILE *schema) {
+    char type[8];
+    if (f.is_text) {
+      snprintf(type, sizeof(type), "c%d", f.width);
+    } else {
+      snprintf(type, sizeof(type), "%c%d", f.is_signed ? 'i' : 'u', f.width * 8);
+    }
+    fprintf(schema, "%s %s\n", f.name, type);
+    std::string path = dir + "/" + f.name + "." + type;
+    fds_.push_back(::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644));
+  }
+
+  std::vector<int> fds_;
+  std::mutex mutex_;
+};
+
+// Buffer de filas de un hilo para una tabla
+class TableBuffer {
+ public:
+  void reset(ColumnTable *table) {
+    table_ = table;
+    block_.assign(table ? table->columns() : 0, {});
+    rows_ = 0;
+  }
+
+  void add(const Message &msg, uint64_t host_us) {
+    if (table_ == nullptr) return;
+    size_t c = 0;
+    put(c++, &host_us, 8);
+    put(c++, &msg.station, 1);
+    put(c++, &msg.seq, 1);
+    put(c++, &msg.tick, 4);
+    const uint8_t *p = msg.body;
+    for (const Field &f : kSchemas[msg.type]) {
+      put(c++, p, f.width);
+      p += f.width;
+    }
+    if (++rows_ >= kFlushRows) flush();
+  }
+
+  void flush() {
+    if (table_ == nullptr || rows_ == 0) return;
+    table_->append(block_);
+    for (auto &column : block_) column.clear();
+    rows_ = 0;
+  }
+
+ private:
+  // El host es little endian como el firmware: se copian los bytes tal cual
+  void put(size_t column, const void *data, size_t width) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    block_[column].insert(block_[column].end(), bytes, bytes + width);
+  }
+
+  ColumnTable *table_ = nullptr;
+  std::vector<std::vector<uint8_t>> block_;
+  size_t rows_ = 0;
+};
+
+static std::unique_ptr<ColumnTable> tables[kMsgTypeCount];
+
+// ============================================================================
+// FUENTES Y DECODIFICACIÓN
+// ============================================================================
+
+struct Source {
+  int fd = -1;
+  std::string path;
+  bool pollable = false;
+  bool done = false;
+
+  // Estado del decodificador: sólo lo toca el hilo que atiende la fuente
+  std::vector<uint8_t> pending;
+  bool overflow = false;
+
+  std::atomic<uint64_t> bytes{0};
+  std::atomic<uint64_t> frames{0};
+  std::atomic<uint64_t> bad_crc{0};
+  std::atomic<uint64_t> noise{0};      // Bloques que no son tramas (texto de printf)
+};
+
+struct WorkerState {
+  TableBuffer buffers[kMsgTypeCount];
+};
+
+static void handle_block(Source &src, WorkerState &worker, uint64_t host_us) {
+  uint8_t payload[kMaxFrame];
+  size_t len = 0;
+  Message msg;
+
+  if (src.overflow || !cobs_decode(src.pending.data(), src.pending.size(), payload, &len)) {
+    src.noise.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  switch (parse(payload, len, &msg)) {
+    case ParseResult::kOk:
+      src.frames.fetch_add(1, std::memory_order_relaxed);
+      aggregate(msg);
+      worker.buffers[msg.type].add(msg, host_us);
+      break;
+    case ParseResult::kBadCrc:
+      src.bad_crc.fetch_add(1, std::memory_order_relaxed);
+      break;
+    default:
+      src.noise.fetch_add(1, std::memory_order_relaxed);
+      break;
+  }
+}
+
+static void decode_bytes(Source &src, WorkerState &worker, const uint8_t *data, size_t len) {
+  uint64_t host_us = now_us();
+  src.bytes.fetch_add(len, std::memory_order_relaxed);
+
+  for (size_t i = 0; i < len; i++) {
+    if (data[i] == 0x00) {
+      if (!src.pending.empty()) handle_block(src, worker, host_us);
+      src.pending.clear();
+      src.overflow = false;
+    } else if (src.pending.size() < kMaxFrame) {
+      src.pending.push_back(data[i]);
+    } else {
+      src.overflow = true;
+    }
+  }
+}
+
+// Lee hasta agotar la fuente o el turno; devuelve false al llegar al final
+static bool service_source(Source &src, WorkerState &worker) {
+  static thread_local uint8_t buffer[kReadChunk];
+  size_t budget = kReadBudget;
+
+  while (budget > 0) {
+    ssize_t n = read(src.fd, buffer, sizeof(buffer));
+    if (n > 0) {
+      decode_bytes(src, worker, buffer, (size_t)n);
+      budget -= std::min(budget, (size_t)n);
+      continue;
+    }
+    if (n < 0 && errno == EINTR) continue;
+    if (n < 0 && errno == EAGAIN) return true;
+    // 0 = fin de archivo/FIFO; EIO = pty sin el otro extremo
+    return false;
+  }
+  return true;
+}
+
+static bool configure_tty(int fd, int baud) {
+  termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  speed_t speed = B115200;
+  switch (baud) {
+    case 9600:   speed = B9600; break;
+    case 57600:  speed = B57600; break;
+    case 230400: speed = B230400; break;
+    case 460800: speed = B460800; break;
+    case 921600: speed = B921600; break;
+    default:     speed = B115200; break;
+  }
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  tio.c_cflag |= CLOCAL | CREAD;
+  return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+// ============================================================================
+// POOL DE HILOS + EPOLL
+// ============================================================================
+
+class Collector {
+ public:
+  Collector(int workers, bool write_tables) : worker_count_(workers), write_tables_(write_tables) {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  }
+
+  ~Collector() {
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+  }
+
+  // Agrega una fuente ya abierta (no bloqueante si es pollable)
+  void add(std::unique_ptr<Source> src) {
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLONESHOT;
+    ev.data.ptr = src.get();
+    src->pollable = (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, src->fd, &ev) == 0);
+    if (!src->pollable) {
+      // Archivo regular: epoll no lo admite, se lee por turnos en el pool
+      int flags = fcntl(src->fd, F_GETFL);
+      fcntl(src->fd, F_SETFL, flags & ~O_NONBLOCK);
+      enqueue(src.get());
+    }
+    active_.fetch_add(1);
+    sources_.push_back(std::move(src));
+  }
+
+  void run() {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < worker_count_; i++) {
+      threads.emplace_back([this] { worker_loop(); });
+    }
+
+    epoll_event events[64];
+    while (active_.load() > 0 && !stop_requested.load()) {
+      int n = epoll_wait(epoll_fd_, events, 64, 200);
+      for (int i = 0; i < n; i++) {
+        enqueue(static_cast<Source *>(events[i].data.ptr));
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      shutdown_ = true;
+    }
+    queue_cv_.notify_all();
+    for (auto &t : threads) t.join();
+  }
+
+  const std::vector<std::unique_ptr<Source>> &sources() const { return sources_; }
+
+ private:
+  void enqueue(Source *src) {
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.push_back(src);
+    }
+    queue_cv_.notify_one();
+  }
+
+  void worker_loop() {
+    WorkerState state;
+    for (int type = 1; type < kMsgTypeCount; type++) {
+      state.buffers[type].reset(write_tables_ ? tables[type].get() : nullptr);
+    }
+
+    while (true) {
+      Source *src = nullptr;
+      {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        queue_cv_.wait(lock, [this] { return shutdown_ || !queue_.empty(); });
+        if (queue_.empty()) break;
+        src = queue_.front();
+        queue_.pop_front();
+      }
+
+      bool alive = service_source(*src, state) && !stop_requested.load();
+      if (alive) {
+        if (src->pollable) {
+          // Rearmar: EPOLLONESHOT garantiza un solo hilo por fuente
+          epoll_event ev{};
+          ev.events = EPOLLIN | EPOLLONESHOT;
+          ev.data.ptr = src;
+          epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, src->fd, &ev);
+        } else {
+          enqueue(src);
+        }
+      } else {
+        if (src->pollable) epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, src->fd, nullptr);
+        close(src->fd);
+        src->done = true;
+        active_.fetch_sub(1);
+      }
+    }
+
+    for (int type = 1; type < kMsgTypeCount; type++) state.buffers[type].flush();
+  }
+
+  int worker_count_;
+  bool write_tables_;
+  int epoll_fd_ = -1;
+  std::atomic<int> active_{0};
+  std::vector<std::unique_ptr<Source>> sources_;
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<Source *> queue_;
+  bool shutdown_ = false;
+};
+
+// ============================================================================
+// SIMULACIÓN (--bench)
+// ============================================================================
+
+// Flujo de una estación: ítems con un juego de mensajes periódicos cada 20
+static std::vector<uint8_t> synth_stream(uint8_t station, uint32_t events) {
+  std::vector<uint8_t> out;
+  out.reserve((size_t)events * 24);
+  uint8_t seq = 0;
+  uint32_t tick = 0;
+  uint32_t counts[5] = {};
+  static const char *kNames[5] = { "", "Metal", "Papel", "Plastico", "Vidrio" };
+
+  for (uint32_t e = 0; e < events; e++) {
+    tick += 1500 + (e * 37) % 900;
+    uint8_t material = 1 + (uint8_t)((e * 7 + station) % 4);
+    counts[material]++;
+    std::vector<uint8_t> item = { material, (uint8_t)(70 + e % 30), (uint8_t)(e % 17 == 0 ? 3 : 0),
+                                  0x86, (uint8_t)e, 0x08, (uint8_t)(e >> 3), 0x04 };
+    build_frame(kMsgItem, station, seq++, tick, item, out);
+
+    // Refresco de la pantalla que sigue a cada ítem
+    std::vector<uint8_t> display = { (uint8_t)((1u << (material - 1)) | 0x20), 0x20 };
+    for (const char *line : { kNames[material], "87%" }) {
+      size_t len = strlen(line);
+      for (size_t i = 0; i < 16; i++) display.push_back(i < len ? (uint8_t)line[i] : 0);
+    }
+    build_frame(kMsgDisplay, station, seq++, tick, display, out);
+
+    if (e % 20 == 19) {
+      std::vector<uint8_t> stats;
+      put_u32(stats, e + 1);
+      for (int m = 1; m <= 4; m++) put_u32(stats, counts[m]);
+      put_u32(stats, e / 17);
+      stats.insert(stats.end(), { 0x10, 0x22 });
+      put_u32(stats, tick / 3600000);
+      stats.insert(stats.end(), { 0xDC, 0x05, 0x4C, 0x06, 0xB0, 0x04, 0x20, 0x05 });
+      build_frame(kMsgStats, station, seq++, tick, stats, out);
+
+      std::vector<uint8_t> levels;
+      for (int bin = 0; bin < 4; bin++) {
+        uint8_t pct = (uint8_t)((counts[bin + 1] / 4) % 100);
+        levels.insert(levels.end(), { pct, (uint8_t)(pct >= 90 ? 3 : 1), 0x96, 0x00, 0x2C, 0x01 });
+      }
+      build_frame(kMsgLevels, station, seq++, tick, levels, out);
+
+      std::vector<uint8_t> profile;
+      put_u32(profile, 500);
+      put_u32(profile, 180);
+      put_u32(profile, 2400);
+      put_u32(profile, 4100);
+      put_u32(profile, 6200);
+      profile.push_back(5);
+      put_u32(profile, 0);
+      put_u32(profile, 0);
+      profile.insert(profile.end(), { 0x80, 0x00 });
+      build_frame(kMsgProfile, station, seq++, tick, profile, out);
+    }
+  }
+  return out;
+}
+
+// Escribe los flujos en FIFOs anónimos desde un hilo productor
+static int run_bench(int station_count, uint32_t events, int workers, const char *out_dir) {
+  if (station_count < 1 || station_count > kStations) {
+    fprintf(stderr, "Estaciones: 1-%d\n", kStations);
+    return 1;
+  }
+
+  printf("Generando %d estaciones × %u eventos...\n", station_count, events);
+  std::vector<std::vector<uint8_t>> streams;
+  uint64_t total_bytes = 0;
+  for (int s = 0; s < station_count; s++) {
+    streams.push_back(synth_stream((uint8_t)s, events));
+    total_bytes += streams.back().size();
+  }
+
+  Collector collector(workers, out_dir != nullptr);
+  std::vector<int> writers;
+  for (int s = 0; s < station_count; s++) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0) {
+      perror("pipe2");
+      return 1;
+    }
+    auto src = std::make_unique<Source>();
+    src->fd = fds[0];
+    src->path = "bench:" + std::to_string(s);
+    collector.add(std::move(src));
+    writers.push_back(fds[1]);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::thread producer([&] {
+    std::vector<size_t> offset(station_count, 0);
+    int open_writers = station_count;
+    while (open_writers > 0 && !stop_requested.load()) {
+      bool progress = false;
+      for (int s = 0; s < station_count; s++) {
+        if (writers[s] < 0) continue;
+        size_t left = streams[s].size() - offset[s];
+        ssize_t n = (left > 0) ? write(writers[s], streams[s].data() + offset[s], std::min(left, (size_t)16384)) : 0;
+        if (n > 0) {
+          offset[s] += (size_t)n;
+          progress = true;
+        }
+        if (offset[s] == streams[s].size()) {
+          close(writers[s]);
+          writers[s] = -1;
+          open_writers--;
+        }
+      }
+      if (!progress) std::this_thread::yield();
+    }
+  });
+
+  collector.run();
+  producer.join();
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  uint64_t frames = 0, items = 0;
+  for (const auto &src : collector.sources()) frames += src->frames.load();
+  for (int s = 0; s < station_count; s++) items += stations[s].items.load();
+
+  printf("Tramas: %llu (%llu ítems) en %.3f s con %d hilos\n",
+         (unsigned long long)frames, (unsigned long long)items, seconds, workers);
+  printf("Ingesta: %.0f tramas/s | %.1f MB/s | %.0f eventos/s por estación (%d estaciones)\n",
+         frames / seconds, total_bytes / seconds / 1e6, items / seconds / station_count, station_count);
+  return 0;
+}
+
+// ============================================================================
+// RESUMEN
+// ============================================================================
+
+static void print_summary(const Collector &collector) {
+  printf("\n%-24s %12s %10s %8s %8s\n", "Fuente", "bytes", "tramas", "CRC", "ruido");
+  for (const auto &src : collector.sources()) {
+    printf("%-24s %12llu %10llu %8llu %8llu\n", src->path.c_str(),
+           (unsigned long long)src->bytes.load(), (unsigned long long)src->frames.load(),
+           (unsigned long long)src->bad_crc.load(), (unsigned long long)src->noise.load());
+  }
+
+  printf("\n%4s %9s %8s %6s %6s %6s %6s %8s %6s %6s %15s\n", "Est", "tramas", "ítems", "metal", "papel",
+         "plást", "vidrio", "no-dep", "saltos", "loop", "niveles %");
+  for (int s = 0; s < kStations; s++) {
+    const StationStats &st = stations[s];
+    if (st.frames.load() == 0) continue;
+    printf("%4d %9llu %8llu %6llu %6llu %6llu %6llu %8llu %6llu %6u %3u/%3u/%3u/%3u\n", s,
+           (unsigned long long)st.frames.load(), (unsigned long long)st.items.load(),
+           (unsigned long long)st.per_material[1].load(), (unsigned long long)st.per_material[2].load(),
+           (unsigned long long)st.per_material[3].load(), (unsigned long long)st.per_material[4].load(),
+           (unsigned long long)st.not_deposited.load(), (unsigned long long)st.seq_gaps.load(),
+           st.loop_max_us.load(), st.level[0].load(), st.level[1].load(), st.level[2].load(),
+           st.level[3].load());
+  }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "Uso: %s [-o DIR] [-w HILOS] [-b BAUDIOS] FUENTE...\n"
+          "     %s --bench ESTACIONES EVENTOS [-o DIR] [-w HILOS]\n", argv0, argv0);
+}
+
+int main(int argc, char **argv) {
+  const char *out_dir = nullptr;
+  bool out_dir_given = false;
+  int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+  int baud = 115200;
+  int bench_stations = 0;
+  uint32_t bench_events = 0;
+  std::vector<std::string> paths;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "-o" && i + 1 < argc) {
+      out_dir = argv[++i];
+      out_dir_given = true;
+    } else if (arg == "-w" && i + 1 < argc) {
+      workers = std::max(1, atoi(argv[++i]));
+    } else if (arg == "-b" && i + 1 < argc) {
+      baud = atoi(argv[++i]);
+    } else if (arg == "--bench" && i + 2 < argc) {
+      bench_stations = atoi(argv[++i]);
+      bench_events = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    } else if (arg[0] == '-') {
+      usage(argv[0]);
+      return 1;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+
+  struct sigaction sa{};
+  sa.sa_handler = [](int) { stop_requested.store(true); };
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+
+  // En simulación sólo se escriben columnas si se pide un directorio
+  if (bench_stations == 0 && !out_dir_given) out_dir = "telemetry_out";
+  if (out_dir != nullptr) {
+    for (uint8_t type = 1; type < kMsgTypeCount; type++) {
+      tables[type] = std::make_unique<ColumnTable>();
+      if (!tables[type]->open(out_dir, type)) {
+        fprintf(stderr, "No se pudo crear %s/%s\n", out_dir, kTableNames[type]);
+        return 1;
+      }
+    }
+  }
+
+  if (bench_stations > 0) return run_bench(bench_stations, bench_events, workers, out_dir);
+
+  if (paths.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  Collector collector(workers, true);
+  for (const std::string &path : paths) {
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_NOCTTY | O_CLOEXEC);
+    if (fd < 0) {
+      perror(path.c_str());
+      continue;
+    }
+    if (isatty(fd) && !configure_tty(fd, baud)) {
+      fprintf(stderr, "%s: no se pudo configurar el puerto\n", path.c_str());
+    }
+    auto src = std::make_unique<Source>();
+    src->fd = fd;
+    src->path = path;
+    collector.add(std::move(src));
+  }
+
+  collector.run();
+  print_summary(collector);
+  return 0;
+}
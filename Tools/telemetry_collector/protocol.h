@@ -0,0 +1,164 @@
+/**
+ * @file protocol.h
+ * @brief Protocolo de telemetría de las estaciones (espejo de Core/Inc/telemetry.h)
+ * @author Smart Waste Manager
+ * @date 2025
+ *
+ * Trama: 0x00 | COBS(encabezado | cuerpo | CRC-32) | 0x00
+ * Encabezado: versión, tipo, estación, secuencia, tick (u32), little endian.
+ */
+
+#ifndef COLLECTOR_PROTOCOL_H
+#define COLLECTOR_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace telemetry {
+
+// ============================================================================
+// CONSTANTES
+// ============================================================================
+
+constexpr uint8_t kProtocolVersion = 1;
+constexpr size_t kHeaderSize = 8;
+constexpr size_t kCrcSize = 4;
+constexpr size_t kMaxFrame = 256;     // Más largo que esto es ruido (texto)
+
+enum MessageType : uint8_t {
+  kMsgItem = 1,
+  kMsgStats = 2,
+  kMsgLevels = 3,
+  kMsgProfile = 4,
+  kMsgDisplay = 5,
+  kMsgTypeCount
+};
+
+// Largo del cuerpo de cada tipo en la versión 1 (0 = tipo desconocido)
+constexpr size_t kBodySize[kMsgTypeCount] = { 0, 8, 38, 24, 31, 34 };
+
+// ============================================================================
+// CRC-32 (IEEE 802.3, igual que flash_store_crc32)
+// ============================================================================
+
+inline uint32_t crc32(const uint8_t *data, size_t len) {
+  static const uint32_t table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+  };
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+inline uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+inline uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+inline void put_u32(std::vector<uint8_t> &out, uint32_t value) {
+  for (int i = 0; i < 4; i++) out.push_back((uint8_t)(value >> (8 * i)));
+}
+
+// ============================================================================
+// COBS
+// ============================================================================
+
+// Decodifica un bloque sin delimitadores; false si está mal formado
+inline bool cobs_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t *out_len) {
+  size_t read = 0, write = 0;
+  while (read < len) {
+    uint8_t code = src[read++];
+    if (code == 0 || read + code - 1 > len) return false;
+    for (uint8_t i = 1; i < code; i++) dst[write++] = src[read++];
+    if (code < 0xFF && read < len) dst[write++] = 0;
+  }
+  *out_len = write;
+  return true;
+}
+
+// Igual que telemetry_cobs_encode() del firmware, agregando los delimitadores
+inline void cobs_frame(const uint8_t *src, size_t len, std::vector<uint8_t> &out) {
+  out.push_back(0x00);
+  size_t code_index = out.size();
+  out.push_back(0);
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (src[i] == 0) {
+      out[code_index] = code;
+      code = 1;
+      code_index = out.size();
+      out.push_back(0);
+    } else {
+      out.push_back(src[i]);
+      if (++code == 0xFF) {
+        out[code_index] = code;
+        code = 1;
+        code_index = out.size();
+        out.push_back(0);
+      }
+    }
+  }
+  out[code_index] = code;
+  out.push_back(0x00);
+}
+
+// ============================================================================
+// MENSAJES
+// ============================================================================
+
+struct Message {
+  uint8_t version;
+  uint8_t type;
+  uint8_t station;
+  uint8_t seq;
+  uint32_t tick;
+  const uint8_t *body;
+  size_t body_len;
+};
+
+enum class ParseResult { kOk, kBadCrc, kBadLength, kUnknownType };
+
+// payload = encabezado | cuerpo | CRC-32 ya decodificado de COBS
+inline ParseResult parse(const uint8_t *payload, size_t len, Message *msg) {
+  if (len < kHeaderSize + kCrcSize) return ParseResult::kBadLength;
+  if (crc32(payload, len - kCrcSize) != get_u32(payload + len - kCrcSize)) {
+    return ParseResult::kBadCrc;
+  }
+  msg->version = payload[0];
+  msg->type = payload[1];
+  msg->station = payload[2];
+  msg->seq = payload[3];
+  msg->tick = get_u32(payload + 4);
+  msg->body = payload + kHeaderSize;
+  msg->body_len = len - kHeaderSize - kCrcSize;
+  if (msg->version != kProtocolVersion || msg->type == 0 || msg->type >= kMsgTypeCount) {
+    return ParseResult::kUnknownType;
+  }
+  if (msg->body_len != kBodySize[msg->type]) return ParseResult::kBadLength;
+  return ParseResult::kOk;
+}
+
+// Arma una trama completa (la usa el modo de simulación)
+inline void build_frame(uint8_t type, uint8_t station, uint8_t seq, uint32_t tick,
+                        const std::vector<uint8_t> &body, std::vector<uint8_t> &out) {
+  std::vector<uint8_t> payload = { kProtocolVersion, type, station, seq };
+  put_u32(payload, tick);
+  payload.insert(payload.end(), body.begin(), body.end());
+  put_u32(payload, crc32(payload.data(), payload.size()));
+  cobs_frame(payload.data(), payload.size(), out);
+}
+
+}  // namespace telemetry
+
+#endif  // COLLECTOR_PROTOCOL_H